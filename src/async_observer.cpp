@@ -54,7 +54,6 @@ CAsyncObserver::CAsyncObserver(shared_ptr<CGame> nGame, CConnection* nConnection
     m_MapReady(false),
     m_StateSynchronized(true),
     m_TimeSynchronized(false),
-    m_Offset(0),
     m_Goal(ASYNC_OBSERVER_GOAL_OBSERVER),
     m_UID(nUID),
     m_SID(nGame->GetSIDFromUID(nUID)),
@@ -76,13 +75,22 @@ CAsyncObserver::CAsyncObserver(shared_ptr<CGame> nGame, CConnection* nConnection
     m_LastPingTicks(APP_MIN_TICKS),
     m_LastProgressReportTime(APP_MIN_TICKS),
     m_LastProgressReportLog(0),
+    m_TimeoutTimer(0),
+    m_FrameTimer(0),
     m_Name(std::move(nName))
 {
   m_Socket->SetLogErrors(true);
+  m_FrameCursor.Open(&m_GameHistory->m_PlayingBuffer);
+  if (m_TimeoutTicks.has_value()) {
+    ScheduleTimeoutTimer();
+  }
 }
 
 CAsyncObserver::~CAsyncObserver()
 {
+  m_Aura->m_Timers.Cancel(m_TimeoutTimer);
+  m_Aura->m_Timers.Cancel(m_FrameTimer);
+  m_FrameCursor.Close();
   m_GameHistory.reset();
 
   if (HasLeftReason()) {
@@ -103,12 +111,48 @@ CAsyncObserver::~CAsyncObserver()
 void CAsyncObserver::SetTimeout(const int64_t delta)
 {
   m_TimeoutTicks = GetTicks() + delta;
+  ScheduleTimeoutTimer();
 }
 
 void CAsyncObserver::SetTimeoutAtLatest(const int64_t atLatestTicks)
 {
   if (!m_TimeoutTicks.has_value() || atLatestTicks < m_TimeoutTicks.value()) {
     m_TimeoutTicks = atLatestTicks;
+    ScheduleTimeoutTimer();
+  }
+}
+
+void CAsyncObserver::RunTimeoutTimer()
+{
+  if (m_DeleteMe) {
+    return;
+  }
+  SetLeftReasonGeneric("observer timeout");
+  m_DeleteMe = true;
+}
+
+void CAsyncObserver::ScheduleTimeoutTimer()
+{
+  const int64_t dueTicks = m_TimeoutTicks.value() + 1;
+  if (!m_Aura->m_Timers.Reschedule(m_TimeoutTimer, dueTicks)) {
+    m_TimeoutTimer = m_Aura->m_Timers.Schedule(dueTicks, [this]() {
+      RunTimeoutTimer();
+    });
+  }
+}
+
+void CAsyncObserver::ScheduleFrameTimer()
+{
+  // CNet::UpdateBeforeGames sends the frame
+  int64_t dueTicks = GetNextTimedActionByTicks();
+  if (dueTicks == APP_MAX_TICKS) {
+    // CGame::SendAllActions wakes up the main loop once there are new frames
+    m_Aura->m_Timers.Cancel(m_FrameTimer);
+    return;
+  }
+  dueTicks = max(dueTicks, GetTicks());
+  if (!m_Aura->m_Timers.Reschedule(m_FrameTimer, dueTicks)) {
+    m_FrameTimer = m_Aura->m_Timers.Schedule(dueTicks, nullptr);
   }
 }
 
@@ -123,7 +167,7 @@ void CAsyncObserver::Init()
 {
 }
 
-uint8_t CAsyncObserver::Update(fd_set* fd, fd_set* send_fd, int64_t timeout)
+uint8_t CAsyncObserver::Update(int64_t timeout)
 {
   if (!m_Socket || m_Socket->HasError()) {
     return ASYNC_OBSERVER_DESTROY;
@@ -131,46 +175,31 @@ uint8_t CAsyncObserver::Update(fd_set* fd, fd_set* send_fd, int64_t timeout)
 
   if (m_DeleteMe) {
     m_Socket->ClearRecvBuffer(); // in case there are pending bytes from a previous recv
-    m_Socket->Discard(fd);
+    m_Socket->Discard();
     return ASYNC_OBSERVER_DESTROY;
   }
 
   const int64_t Time = GetTime(), Ticks = GetTicks();
 
-  if (m_TimeoutTicks.has_value() && m_TimeoutTicks.value() < Ticks) {
-    SetLeftReasonGeneric("observer timeout");
-    return ASYNC_OBSERVER_DESTROY;
-  }
-
   uint8_t result = ASYNC_OBSERVER_OK;
   bool Abort = false;
   if (m_Type == INCON_TYPE_KICKED_PLAYER) {
-    m_Socket->Discard(fd);
-  } else if (m_Socket->DoRecv(fd)) {
+    m_Socket->Discard();
+  } else if (m_Socket->DoRecv()) {
     // extract as many packets as possible from the socket's receive buffer and process them
-    string*              RecvBuffer         = m_Socket->GetBytes();
-    std::vector<uint8_t> Bytes              = CreateByteArray((uint8_t*)RecvBuffer->c_str(), RecvBuffer->size());
-    uint32_t             LengthProcessed    = 0;
-
-    // a packet is at least 4 bytes so loop as long as the buffer contains 4 bytes
-
-    while (Bytes.size() >= 4) {
-      // bytes 2 and 3 contain the length of the packet
-      const uint16_t Length = ByteArrayToUInt16(Bytes, false, 2);
-      if (Length < 4) {
-        EventProtocolError();
-        Abort = true;
-        break;
-      }
-      if (Bytes.size() < Length) break;
-      const std::vector<uint8_t> Data = std::vector<uint8_t>(begin(Bytes), begin(Bytes) + Length);
+    CStreamBuffer*       RecvBuffer         = m_Socket->GetBytes();
+    CPacketFramer        Framer(*RecvBuffer);
+    PacketView           Data;
+
+    while (Framer.Next(Data)) {
+      const uint16_t Length = static_cast<uint16_t>(Data.size());
 
-      switch (Bytes[0]) {
+      switch (Data.GetHeader()) {
         case GameProtocol::Magic::W3GS_HEADER: {
-          switch (Bytes[1]) {
+          switch (Data.GetID()) {
             case GameProtocol::Magic::LEAVEGAME: {
-              if (ValidateLength(Data) && Data.size() >= 8) {
-                const uint32_t reason = ByteArrayToUInt32(Data, false, 4);
+              if (Data.size() >= 8) {
+                const uint32_t reason = Data.GetUInt32(4);
                 EventLeft(reason);
                 //m_Socket->SetLogErrors(false);
               } else {
@@ -276,7 +305,7 @@ uint8_t CAsyncObserver::Update(fd_set* fd, fd_set* send_fd, int64_t timeout)
         case GPSProtocol::Magic::GPS_HEADER: {
           // GProxy unsupported for observers
           //shared_ptr<CGame> game = m_Game.lock();
-          if (/*game && game->GetIsProxyReconnectable() && */Bytes[1] == GPSProtocol::Magic::INIT) {
+          if (/*game && game->GetIsProxyReconnectable() && */Data.GetID() == GPSProtocol::Magic::INIT) {
             Print(GetLogPrefix() + "client started GProxy handshake ");
           }
           break;
@@ -287,21 +316,22 @@ uint8_t CAsyncObserver::Update(fd_set* fd, fd_set* send_fd, int64_t timeout)
         }
       }
 
-      LengthProcessed += Length;
-
       if (Abort) {
         // Process no more packets
         break;
       }
+    }
 
-      Bytes = std::vector<uint8_t>(begin(Bytes) + Length, end(Bytes));
+    if (!Abort && Framer.GetIsMalformed()) {
+      EventProtocolError();
+      Abort = true;
     }
 
     if (Abort && result != ASYNC_OBSERVER_PROMOTED) {
       result = ASYNC_OBSERVER_DESTROY;
-      RecvBuffer->clear();
-    } else if (LengthProcessed > 0) {
-      *RecvBuffer = RecvBuffer->substr(LengthProcessed);
+      RecvBuffer->Clear();
+    } else {
+      RecvBuffer->Consume(Framer.GetProcessed());
     }
   } else if (Ticks >= m_Socket->GetLastRecv() + timeout) {
     SetLeftReasonGeneric("connection timed out");
@@ -326,7 +356,7 @@ uint8_t CAsyncObserver::Update(fd_set* fd, fd_set* send_fd, int64_t timeout)
       const size_t delta = SubtractClampZero(m_ActionFrameCounter, beforeCounter);
       if (beforeCounter <= 50 || delta > 1) Print(GetLogPrefix() + "pushed " + to_string(delta) + " action frames");
       //*/
-      if (m_FrameRate > 1 && canSendChat) {
+      if ((m_FrameRate > 1 || m_SeekTargetFrame.has_value()) && canSendChat) {
         if ((m_LastProgressReportTime + 30 <= Time && Ticks <= m_FinishedLoadingTicks + 120000) || m_LastProgressReportTime + 75 <= Time) {
           SendProgressReport();
           m_MissingLog = GetMissingLog();
@@ -348,7 +378,7 @@ uint8_t CAsyncObserver::Update(fd_set* fd, fd_set* send_fd, int64_t timeout)
     m_LastPingTicks = Ticks;
   }
 
-  m_Socket->DoSend(send_fd);
+  m_Socket->DoSend();
   return result;
 }
 
@@ -356,7 +386,7 @@ void CAsyncObserver::CheckGameOver()
 {
   if (!m_Game.expired() && !m_Game.lock()->GetIsGameOver()) return;
   FlushGameFrames();
-  if (m_GameHistory->m_PlayingBuffer.size() <= m_Offset) {
+  if (!m_FrameCursor.GetHasNext()) {
     m_PlaybackEnded = true;
     Print(GetLogPrefix() + "playback ended");
     SendChat("Playback ended. Game will exit automatically in 10 seconds.");
@@ -368,6 +398,16 @@ void CAsyncObserver::CheckGameOver()
 
 int64_t CAsyncObserver::GetNextTimedActionByTicks() const
 {
+  if (m_FrameCursor.GetIsWaiting()) {
+    // the next frame is being read back from disk
+    return GetTicks() + GAME_FRAME_LOAD_POLL_TICKS;
+  }
+  if (m_SeekTargetFrame.has_value() && m_FinishedLoading) {
+    if (m_Socket->GetSendBufferSize() < ASYNC_OBSERVER_SEEK_MAX_PENDING_BYTES) {
+      return APP_MIN_TICKS;
+    }
+    return GetTicks() + ASYNC_OBSERVER_SEEK_POLL_TICKS;
+  }
   if (m_GameHistory->GetNumActionFrames() <= m_ActionFrameCounter) {
     return APP_MAX_TICKS;
   }
@@ -376,6 +416,10 @@ int64_t CAsyncObserver::GetNextTimedActionByTicks() const
 
 bool CAsyncObserver::PushGameFrames(bool isFlush)
 {
+  if (m_SeekTargetFrame.has_value()) {
+    return PushSeekFrames();
+  }
+
   int64_t Ticks = GetTicks();
   // Note: Actually, each frame may have its own custom latency.
   int64_t gameDurationWanted = m_FrameRate * (Ticks - m_LastFrameTicks);
@@ -393,19 +437,28 @@ bool CAsyncObserver::PushGameFrames(bool isFlush)
   }
 
   bool success = false;
-  auto it = begin(m_GameHistory->m_PlayingBuffer) + m_Offset;
-  auto itEnd = end(m_GameHistory->m_PlayingBuffer);
-  while (it != itEnd && (m_Latency <= gameDurationWanted || it->GetType() == GAME_FRAME_TYPE_LATENCY)) {
-    //Print(GetLogPrefix() + "sending " + it->GetTypeName() + " frame");
-    switch (it->GetType()) {
+  while (m_FrameCursor.GetHasNext()) {
+    const GameFrame frame = m_FrameCursor.Peek();
+    if (m_Latency > gameDurationWanted && frame.GetType() != GAME_FRAME_TYPE_LATENCY) {
+      break;
+    }
+    //Print(GetLogPrefix() + "sending " + frame.GetTypeName() + " frame");
+    switch (frame.GetType()) {
       case GAME_FRAME_TYPE_GPROXY:
         // if stored, GAME_FRAME_TYPE_GPROXY always precedes GAME_FRAME_TYPE_ACTIONS
         Send(GameProtocol::SEND_W3GS_EMPTY_ACTIONS(m_GameHistory->GetGProxyEmptyActions()));
         break;
       case GAME_FRAME_TYPE_LATENCY:
         // it stored, GAME_FRAME_TYPE_LATENCY always goes after GAME_FRAME_TYPE_ACTIONS
-        m_Latency = ByteArrayToUInt16(it->GetBytes(), false, 0);
+        m_Latency = ByteArrayToUInt16(frame.GetData(), false);
         break;
+      case GAME_FRAME_TYPE_MISSING:
+        // skipping it would desync the client
+        EventFrameMissing();
+        return success;
+      case GAME_FRAME_TYPE_PENDING:
+        // try again once it's back in memory
+        return success;
       case GAME_FRAME_TYPE_ACTIONS:  
         gameDurationWanted -= m_Latency;
         m_GameTicks += m_Latency;
@@ -414,19 +467,88 @@ bool CAsyncObserver::PushGameFrames(bool isFlush)
         success = true;
         m_LastFrameTicks = Ticks;
         ++m_ActionFrameCounter;
-        Send(it->GetBytes());
+        SendFrame(frame);
         break;
       default:
         // GAME_FRAME_TYPE_LEAVER, GAME_FRAME_TYPE_CHAT
-        Send(it->GetBytes());
+        SendFrame(frame);
     }
-    ++it;
-    ++m_Offset;
+    m_FrameCursor.Advance();
   }
 
   return success;
 }
 
+bool CAsyncObserver::Seek(const int64_t gameTicks)
+{
+  if (gameTicks <= m_GameTicks) {
+    return false;
+  }
+  const size_t targetFrame = m_GameHistory->m_PlayingBuffer.GetFrameAtGameTicks(gameTicks);
+  if (targetFrame <= m_FrameCursor.GetPosition()) {
+    return false;
+  }
+  m_SeekTargetFrame = targetFrame;
+  return true;
+}
+
+bool CAsyncObserver::PushSeekFrames()
+{
+  // Game clients cannot skip simulation, so seeking is about getting every frame up to the target
+  // onto the wire as quickly as possible. Frames stored back to back are sent as a single slice.
+  const size_t targetFrame = m_SeekTargetFrame.value();
+  bool success = false;
+  GameFrame run(GAME_FRAME_TYPE_ACTIONS);
+  while (m_FrameCursor.GetPosition() < targetFrame && m_FrameCursor.GetHasNext()) {
+    if (m_Socket->GetSendBufferSize() + run.GetSize() >= ASYNC_OBSERVER_SEEK_MAX_PENDING_BYTES) {
+      break;
+    }
+    const GameFrame frame = m_FrameCursor.Peek();
+    switch (frame.GetType()) {
+      case GAME_FRAME_TYPE_GPROXY:
+        SendFrame(run);
+        run = GameFrame(GAME_FRAME_TYPE_ACTIONS);
+        Send(GameProtocol::SEND_W3GS_EMPTY_ACTIONS(m_GameHistory->GetGProxyEmptyActions()));
+        break;
+      case GAME_FRAME_TYPE_LATENCY:
+        m_Latency = ByteArrayToUInt16(frame.GetData(), false);
+        break;
+      case GAME_FRAME_TYPE_MISSING:
+        // skipping it would desync the client
+        SendFrame(run);
+        EventFrameMissing();
+        return success;
+      case GAME_FRAME_TYPE_PENDING:
+        SendFrame(run);
+        return success;
+      case GAME_FRAME_TYPE_ACTIONS:
+        m_GameTicks += m_Latency;
+        // falls through
+      case GAME_FRAME_TYPE_PAUSED:
+        success = true;
+        ++m_ActionFrameCounter;
+        // falls through
+      default:
+        if (frame.GetIsEmpty()) break;
+        if (!run.GetIsEmpty() && run.GetSegment() == frame.GetSegment() && run.GetOffset() + run.GetSize() == frame.GetOffset()) {
+          run.m_Size += frame.GetSize();
+        } else {
+          SendFrame(run);
+          run = frame;
+        }
+    }
+    m_FrameCursor.Advance();
+  }
+  SendFrame(run);
+
+  if (targetFrame <= m_FrameCursor.GetPosition() || !m_FrameCursor.GetHasNext()) {
+    m_SeekTargetFrame.reset();
+    m_LastFrameTicks = GetTicks();
+    SendChat("Playback is now at " + ToFormattedTimeStamp(m_GameTicks / 1000) + ".");
+  }
+  return success;
+}
+
 void CAsyncObserver::EventGameReset(shared_ptr<const CGame> nGame)
 {
   if (m_Game.lock() == nGame) {
@@ -493,10 +615,10 @@ void CAsyncObserver::UpdateDownloadProgression(const uint8_t downloadProgression
   Send(slotInfo);
 }
 
-uint8_t CAsyncObserver::NextSendMap()
+uint8_t CAsyncObserver::NextSendMap(const uint32_t maxBytes)
 {
   if (m_Game.expired()) return MAP_TRANSFER_NONE;
-  return m_Game.lock()->NextSendMap(this, GetUID(), GetMapTransfer()); 
+  return m_Game.lock()->NextSendMap(this, GetUID(), GetMapTransfer(), maxBytes);
 }
 
 void CAsyncObserver::EventDesync()
@@ -504,7 +626,7 @@ void CAsyncObserver::EventDesync()
   while (!m_CheckSums.empty()) {
     m_CheckSums.pop();
   }
-  string text = GetLogPrefix() + "desynchronized on " + ToOrdinalName(m_SyncCounter) + " checksum - sent " + to_string(m_Offset) + " total frames (" + to_string(m_ActionFrameCounter) + " actions)";
+  string text = GetLogPrefix() + "desynchronized on " + ToOrdinalName(m_SyncCounter) + " checksum - sent " + to_string(m_FrameCursor.GetPosition()) + " total frames (" + to_string(m_ActionFrameCounter) + " actions)";
   Print(text);
   m_Aura->LogPersistent(text);
 
@@ -680,10 +802,10 @@ void CAsyncObserver::EventLeft(const uint32_t clientReason)
   if (m_StartedLoading) {
     Print(GetLogPrefix() + "left the game at [" + ToFormattedTimeStamp(m_GameTicks / 1000) + "] (" + GameProtocol::LeftCodeToString(clientReason) + ")");
     /*
-    if (m_GameHistory->m_PlayingBuffer.size() <= m_Offset) {
+    if (!m_FrameCursor.GetHasNext()) {
       Print(GetLogPrefix() + "next frame was not available");
     } else {
-      Print(GetLogPrefix() + "next frame was " + m_GameHistory->m_PlayingBuffer[m_Offset].GetTypeName());
+      Print(GetLogPrefix() + "next frame was " + m_FrameCursor.Peek().GetTypeName());
     }
     */
   } else {
@@ -702,6 +824,16 @@ void CAsyncObserver::EventProtocolError()
   SetDeleteMe(true);
 }
 
+void CAsyncObserver::EventFrameMissing()
+{
+  Print(GetLogPrefix() + "game frame #" + to_string(m_FrameCursor.GetPosition()) + " could not be read back from disk");
+  if (!CloseConnection()) {
+    return;
+  }
+  SetLeftReasonGeneric("game history unavailable");
+  SetDeleteMe(true);
+}
+
 void CAsyncObserver::Send(const std::vector<uint8_t>& data)
 {
   if (m_Socket && !m_Socket->HasError()) {
@@ -709,6 +841,20 @@ void CAsyncObserver::Send(const std::vector<uint8_t>& data)
   }
 }
 
+void CAsyncObserver::Send(const SharedPacket& packet)
+{
+  if (m_Socket && !m_Socket->HasError()) {
+    m_Socket->PutPacket(packet);
+  }
+}
+
+void CAsyncObserver::SendFrame(const GameFrame& frame)
+{
+  if (m_Socket && !m_Socket->HasError() && !frame.GetIsEmpty()) {
+    m_Socket->PutSlice(frame.GetSegment(), frame.GetOffset(), frame.GetSize());
+  }
+}
+
 void CAsyncObserver::SendOtherPlayersInfo()
 {
   Send(m_GameHistory->m_PlayersBuffer);
@@ -764,6 +910,11 @@ uint8_t CAsyncObserver::GetMissingLog() const
 void CAsyncObserver::SendProgressReport()
 {
   double progress = (double)m_ActionFrameCounter / (double)m_GameHistory->GetNumActionFrames();
+  if (m_SeekTargetFrame.has_value()) {
+    SendChat(ToFormattedString(PERCENT_FACTOR * progress) + "% - Seeking - now at " + ToFormattedTimeStamp(m_GameTicks / 1000));
+    m_LastProgressReportTime = GetTime();
+    return;
+  }
   int64_t etaMilliSeconds = m_Latency * static_cast<int64_t>(m_GameHistory->GetNumActionFrames() - m_ActionFrameCounter) / (m_FrameRate - 1);
   // Let it fit in chat log (F12)
   SendChat(ToFormattedString(PERCENT_FACTOR * progress) + "% - Fast-forwarding at " + to_string(m_FrameRate) + "x - ETA " + ToDurationString(etaMilliSeconds / 1000));
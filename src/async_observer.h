@@ -33,6 +33,7 @@
 #include "map.h"
 #include "realm.h"
 #include "protocol/game_protocol.h"
+#include "timer_queue.h"
 
 //
 // CAsyncObserver
@@ -50,7 +51,8 @@ public:
   bool                                                          m_MapReady;                     // if we received a valid W3GS_MAPSIZE packet from the client matching the map size
   bool                                                          m_StateSynchronized;
   bool                                                          m_TimeSynchronized;
-  size_t                                                        m_Offset;
+  CGameFrameCursor                                              m_FrameCursor;                  // next frame to be sent
+  std::optional<size_t>                                         m_SeekTargetFrame;              // frames before this one are sent as fast as the socket allows
   uint8_t                                                       m_Goal;
   uint8_t                                                       m_UID;
   uint8_t                                                       m_SID;
@@ -83,6 +85,9 @@ public:
   int64_t                                                       m_LastProgressReportTime;
   uint8_t                                                       m_LastProgressReportLog;
 
+  TimerId                                                       m_TimeoutTimer;                 // destroys the observer at m_TimeoutTicks
+  TimerId                                                       m_FrameTimer;                   // wakes up the main loop when the next frame is due
+
   std::string                                                   m_Name;
   std::string                                                   m_LeftReason;
 
@@ -93,10 +98,13 @@ public:
 
   void SetTimeout(const int64_t nTicksDelta);
   void SetTimeoutAtLatest(const int64_t nTicks);
+  void RunTimeoutTimer();
+  void ScheduleTimeoutTimer();
+  void ScheduleFrameTimer();
 
   bool CloseConnection(bool recoverable = false);
   void Init();
-  [[nodiscard]] uint8_t Update(fd_set* fd, fd_set* send_fd, int64_t timeout);
+  [[nodiscard]] uint8_t Update(int64_t timeout);
 
   [[nodiscard]] inline MapTransfer&             GetMapTransfer() { return m_MapTransfer; }
   [[nodiscard]] inline const MapTransfer&       InspectMapTransfer() const { return m_MapTransfer; }
@@ -126,11 +134,14 @@ public:
   [[nodiscard]] inline uint8_t                  GetUID() const { return m_UID; }
   
   [[nodiscard]] inline int64_t                  GetGameTicks() const { return m_GameTicks; }
+  [[nodiscard]] inline bool                     GetIsSeeking() const { return m_SeekTargetFrame.has_value(); }
   int64_t                                       GetNextTimedActionByTicks() const;
 
   [[nodiscard]] inline bool                     GetIsRealmVerified() const { return false; }
 
   bool PushGameFrames(bool isFlush = false);
+  bool PushSeekFrames();
+  [[nodiscard]] bool Seek(const int64_t gameTicks);
   inline void FlushGameFrames() { PushGameFrames(true); }
   void CheckGameOver();
   void EventGameReset(std::shared_ptr<const CGame> nGame);
@@ -138,7 +149,7 @@ public:
   void UpdateClientGameState(const uint32_t checkSum);
   void CheckClientGameState();
   void UpdateDownloadProgression(const uint8_t downloadProgression);
-  [[nodiscard]] uint8_t NextSendMap();
+  [[nodiscard]] uint8_t NextSendMap(const uint32_t maxBytes);
   void EventDesync();
   void EventMapReady();
   void StartLoading();
@@ -147,10 +158,13 @@ public:
   void EventChat(const CIncomingChatMessage& chatPlayer);
   void EventLeft(const uint32_t clientReason);
   void EventProtocolError();
+  void EventFrameMissing();
 
   // other functions
 
   void Send(const std::vector<uint8_t>& data) final;
+  void Send(const SharedPacket& packet) final;
+  void SendFrame(const GameFrame& frame);
   void SendOtherPlayersInfo();
   void SendChat(const std::string& message);
   void SendGameLoadedReport();
@@ -60,6 +60,7 @@
 #include "config/config_game.h"
 #include "config/config_irc.h"
 #include "socket.h"
+#include "socket_poller.h"
 #include "connection.h"
 #include "realm.h"
 #include "map.h"
@@ -73,6 +74,7 @@
 #include "integration/irc.h"
 #include "protocol/vlan_protocol.h"
 #include "test/runner.h"
+#include "test/benchmark.h"
 #include <utf8/utf8.h>
 
 #include <csignal>
@@ -98,9 +100,6 @@
 
 using namespace std;
 
-#undef FD_SETSIZE
-#define FD_SETSIZE 512
-
 bool                  gRestart     = false;
 volatile sig_atomic_t gGracefulExit = 0;
 
@@ -401,6 +400,9 @@ int main(const int argc, char** argv)
           Print("[AURA] invalid CLI usage - please see CLI.md");
           exitCode = 1;
           break;
+        case CLIResult::kBenchmark:
+          exitCode = BenchmarkRunner::Run();
+          break;
         case CLIResult::kTest:
         case CLIResult::kOk:
         case CLIResult::kConfigAndQuit: {
@@ -499,6 +501,8 @@ CAura::CAura(CConfig& CFG, const CCLI& nCLI)
     m_CommandDefaultConfig(new CCommandConfig()),
 
     m_DB(nullptr),
+    m_BanExpiryTimer(0),
+    m_MapCatalogSaveTimer(0),
     //m_GameSetup(nullptr),
     //m_AutoRehostGameSetup(nullptr),
 
@@ -513,7 +517,9 @@ CAura::CAura(CConfig& CFG, const CCLI& nCLI)
     m_IRC(CIRC(CFG)),
     m_Net(CNet(CFG)),
     m_Config(CBotConfig(CFG)),
-    m_ConfigPath(CFG.GetFile())
+    m_ConfigPath(CFG.GetFile()),
+    m_MapFilesIndex(FILE_EXTENSIONS_MAP),
+    m_MapConfigFilesIndex(FILE_EXTENSIONS_CONFIG)
 {
   m_Discord.m_Aura = this;
   m_IRC.m_Aura = this;
@@ -541,11 +547,16 @@ CAura::CAura(CConfig& CFG, const CCLI& nCLI)
     return;
   }
   m_HistoryGameID = m_DB->GetLatestHistoryGameId();
+  ScheduleBanExpiry();
+
+  if (m_Net.m_Config.m_EnableGeoLocalization) {
+    LoadIPToCountryData(CFG);
+  }
 
   // Eagerly install as shell extension.
+
   if (m_DB->GetIsFirstRun()) {
     LoadMapAliases();
-    LoadIPToCountryData(CFG);
     if (nCLI.GetInitSystem().value_or(true)) {
       InitSystem();
     }
@@ -854,7 +865,14 @@ CAura::~CAura()
 
 #undef CLEAR_GAMES
 
+  if (m_MapCatalog.GetIsModified()) {
+    m_MapCatalog.Save();
+  }
+
   delete m_DB;
+
+  // write out any pending log lines
+  m_LogWriter.Stop();
 }
 
 vector<Version> CAura::GetSupportedVersionsCrossPlayRangeHeads() const
@@ -1122,10 +1140,8 @@ int64_t CAura::GetSelectBlockTime() const
 
   int64_t usecBlock = 50000;
 
-  for (const auto& game : m_StartedGames) {
-    game->UpdateSelectBlockTime(usecBlock);
-  }
-  m_Net.UpdateSelectBlockTime(usecBlock);
+  // game deadlines, observer frames and pending host name resolutions are all kept as timers
+  m_Timers.UpdateSelectBlockTime(usecBlock, GetTicks());
 
   if (usecBlock < 10000 && m_IsFastPolling && m_StartedFastPollingTicks + 1000 < m_LoopTicks) {
     // Block for at least 10 ms to avoid CPU starvation
@@ -1170,7 +1186,7 @@ bool CAura::Update()
   }
 
   if (m_AutoRehostGameSetup && !m_AutoReHosted) {
-    if (!(m_GameSetup && (m_GameSetup->GetIsDownloading() || m_GameSetup->GetMirror().GetIsSearching())) &&
+    if (!(m_GameSetup && (m_GameSetup->GetIsDownloading() || m_GameSetup->GetIsLoadingMap() || m_GameSetup->GetMirror().GetIsSearching())) &&
       (GetNewGameIsInQuotaAutoReHost() && !GetIsAutoHostThrottled())
     ) {
       m_AutoRehostGameSetup->SetActive();
@@ -1182,7 +1198,7 @@ bool CAura::Update()
   bool isStandby = (
     m_Lobbies.empty() && m_StartedGames.empty() &&
     m_Net.GetIsStandby() &&
-    !(m_GameSetup && (m_GameSetup->GetIsDownloading() || m_GameSetup->GetMirror().GetIsSearching())) &&
+    !(m_GameSetup && (m_GameSetup->GetIsDownloading() || m_GameSetup->GetIsLoadingMap() || m_GameSetup->GetMirror().GetIsSearching())) &&
     m_PendingActions.empty() &&
     !m_AutoRehostGameSetup
   );
@@ -1191,50 +1207,11 @@ bool CAura::Update()
     return true;
   }
 
-  uint32_t NumFDs = 0;
-
-  // take every socket we own and throw it in one giant select statement so we can block on all sockets
-
-  int32_t nfds = 0;
-  fd_set fd, send_fd;
-  FD_ZERO(&fd);
-  FD_ZERO(&send_fd);
-
-  // the current lobby's player sockets
-
-  for (const auto& lobby : m_Lobbies) {
-    NumFDs += lobby->SetFD(&fd, &send_fd, &nfds);
-  }
-
-  // all running games' player sockets
-
-  for (const auto& game : m_StartedGames) {
-    NumFDs += game->SetFD(&fd, &send_fd, &nfds);
-  }
-
-  // all battle.net sockets
-
-  for (const auto& realm : m_Realms) {
-    NumFDs += realm->SetFD(&fd, &send_fd, &nfds);
-  }
-
-  // irc socket
-  if (m_IRC.GetIsEnabled()) {
-    NumFDs += m_IRC.SetFD(&fd, &send_fd, &nfds);
-  }
-
-  // UDP sockets, outgoing test connections, observers
-  NumFDs += m_Net.SetFD(&fd, &send_fd, &nfds);
-
-  struct timeval tv;
-  tv.tv_sec  = 0;
-  tv.tv_usec = static_cast<long int>(GetSelectBlockTime());
+  // every socket we own is registered in this thread's poller, so we can block on all of them at once
+  CSocketPoller* poller = CSocketPoller::GetThreadPoller();
+  int64_t usecBlock = GetSelectBlockTime();
 
-  struct timeval send_tv;
-  send_tv.tv_sec  = 0;
-  send_tv.tv_usec = 0;
-
-  if (tv.tv_usec == 0) {
+  if (usecBlock == 0) {
     if (!m_IsFastPolling) {
       m_StartedFastPollingTicks = m_LoopTicks;
     }
@@ -1243,17 +1220,11 @@ bool CAura::Update()
     m_IsFastPolling = false;
   }
 
-#ifdef _WIN32
-  select(1, &fd, nullptr, nullptr, &tv);
-  select(1, nullptr, &send_fd, nullptr, &send_tv);
-#else
-  select(nfds + 1, &fd, nullptr, nullptr, &tv);
-  select(nfds + 1, nullptr, &send_fd, nullptr, &send_tv);
-#endif
+  poller->Wait(usecBlock);
 
-  if (NumFDs == 0) {
+  if (poller->GetSocketCount() == 0) {
     // we don't have any sockets (i.e. we aren't connected to battle.net and irc maybe due to a lost connection and there aren't any games running)
-    // select will return immediately and we'll chew up the CPU if we let it loop so just sleep for 200ms to kill some time
+    // the poller will return immediately and we'll chew up the CPU if we let it loop so just sleep for 200ms to kill some time
 
     this_thread::sleep_for(chrono::milliseconds(200));
   }
@@ -1267,12 +1238,14 @@ bool CAura::Update()
     }
   }
 
-  m_Net.UpdateBeforeGames(&fd, &send_fd);
+  m_Net.UpdateBeforeGames();
+
+  m_Timers.RunExpired(m_LoopTicks);
 
   // update games, starting from lobbies
 
   for (auto it = begin(m_Lobbies); it != end(m_Lobbies);) {
-    if ((*it)->Update(&fd, &send_fd)) {
+    if ((*it)->Update()) {
       if ((*it)->GetExiting()) {
         EventGameDeleted(*it);
         it->reset();
@@ -1282,13 +1255,13 @@ bool CAura::Update()
       it = m_Lobbies.erase(it);
       m_MetaDataNeedsUpdate = true;
     } else {
-      (*it)->UpdatePost(&send_fd);
+      (*it)->UpdatePost();
       ++it;
     }
   }
 
   for (auto it = begin(m_StartedGames); it != end(m_StartedGames);) {
-    if ((*it)->Update(&fd, &send_fd)) {
+    if ((*it)->Update()) {
       (*it)->FlushLogs();
       if ((*it)->GetExiting()) {
         EventGameDeleted(*it);
@@ -1299,20 +1272,20 @@ bool CAura::Update()
       it = m_StartedGames.erase(it);
       m_MetaDataNeedsUpdate = true;
     } else {
-      (*it)->UpdatePost(&send_fd);
+      (*it)->UpdatePost();
       ++it;
     }
   }
 
   for (const auto& realm : m_Realms) {
-    realm->Update(&fd, &send_fd);
+    realm->Update();
   }
 
-  m_IRC.Update(&fd, &send_fd);
+  m_IRC.Update();
   m_Discord.Update();
 
   // UDP sockets, outgoing test connections
-  m_Net.UpdateAfterGames(&fd, &send_fd);
+  m_Net.UpdateAfterGames();
 
   // move stuff from pending vectors to their intended places
   m_Net.MergeDownGradedConnections();
@@ -1592,6 +1565,7 @@ bool CAura::ReloadConfigs()
   optional<Version> WasDataVersion = m_Config.m_Warcraft3DataVersion;
   set<Version> WasVersions = set<Version>(m_Config.m_SupportedGameVersions.begin(), m_Config.m_SupportedGameVersions.end());
   bool WasCacheEnabled = m_Config.m_EnableCFGCache;
+  bool WasGeoLocalizationEnabled = m_Net.m_Config.m_EnableGeoLocalization;
   filesystem::path WasMapPath = m_Config.m_MapPath;
   filesystem::path WasCFGPath = m_Config.m_MapCFGPath;
   filesystem::path WasCachePath = m_Config.m_MapCachePath;
@@ -1665,6 +1639,11 @@ bool CAura::ReloadConfigs()
   } else if (reCachePresets) {
     UpdateCFGCacheEntries();
   }
+  if (!m_Net.m_Config.m_EnableGeoLocalization) {
+    m_GeoIndex.Clear();
+  } else if (!WasGeoLocalizationEnabled) {
+    LoadIPToCountryData(CFG);
+  }
   m_Net.OnConfigReload();
 
   return success;
@@ -1739,6 +1718,7 @@ bool CAura::LoadAllConfigs(CConfig& CFG)
 void CAura::OnLoadConfigs()
 {
   m_LogLevel = m_Config.m_LogLevel;
+  m_LogWriter.SetOptions(m_Config.m_LogFormat, static_cast<uint64_t>(m_Config.m_LogRotateSize) * 1024 * 1024, static_cast<int64_t>(m_Config.m_LogRotateInterval) * 3600);
 
   if (m_Config.m_Warcraft3Path.has_value()) {
     m_GameInstallPath = m_Config.m_Warcraft3Path.value();
@@ -1905,51 +1885,65 @@ bool CAura::LoadMapAliases()
   return true;
 }
 
-void CAura::LoadIPToCountryData(const CConfig& CFG)
+void CAura::ScheduleBanExpiry()
 {
-  ifstream in;
-  filesystem::path GeoFilePath = CFG.GetHomeDir() / filesystem::path("ip-to-country.csv");
-  in.open(GeoFilePath.native().c_str(), ios::in);
-
-  if (in.fail()) {
-    Print("[AURA] warning - unable to read file [ip-to-country.csv], geolocalization data not loaded");
+  optional<int64_t> nextExpiry = m_DB->GetBanIndex().GetNextExpiry();
+  if (!nextExpiry.has_value()) {
+    m_Timers.Cancel(m_BanExpiryTimer);
     return;
   }
-  // the begin and commit statements are optimizations
-  // we're about to insert ~4 MB of data into the database so if we allow the database to treat each insert as a transaction it will take a LONG time
+  // wall clock and ticks may drift apart, so check back at least daily
+  const int64_t delaySeconds = min<int64_t>(max<int64_t>(nextExpiry.value() - CBanIndex::GetUnixTime(), 0), 86400);
+  const int64_t dueTicks = GetTicks() + delaySeconds * 1000;
+  if (!m_Timers.Reschedule(m_BanExpiryTimer, dueTicks)) {
+    m_BanExpiryTimer = m_Timers.Schedule(dueTicks, [this]() {
+      const size_t expiredCount = m_DB->BanExpire();
+      if (expiredCount > 0 && MatchLogLevel(LogLevel::kInfo)) {
+        Print("[AURA] " + to_string(expiredCount) + " ban(s) expired");
+      }
+      ScheduleBanExpiry();
+    });
+  }
+}
 
-  if (!m_DB->Begin()) {
-    Print("[AURA] internal database error - geolocalization will not be available");
-    in.close();
+void CAura::ScheduleMapCatalogSave()
+{
+  if (m_Timers.GetIsScheduled(m_MapCatalogSaveTimer)) {
     return;
   }
+  m_MapCatalogSaveTimer = m_Timers.Schedule(GetTicks() + MAP_CATALOG_SAVE_DELAY, [this]() {
+    m_MapCatalogSaveTimer = 0;
+    if (m_MapCatalog.GetIsModified() && !m_MapCatalog.Save()) {
+      Print("[AURA] warning - unable to write map catalog [" + PathToString(m_MapCatalog.m_FilePath) + "]");
+    }
+  });
+}
 
-  string    Line, Skip, IP1, IP2, Country;
-  CSVParser parser;
-
-  in.seekg(0, ios::end);
-  in.seekg(0, ios::beg);
-
-  while (!in.eof()) {
-    getline(in, Line);
-
-    if (Line.empty())
-      continue;
+void CAura::LoadIPToCountryData(const CConfig& CFG)
+{
+  filesystem::path GeoFilePath = CFG.GetHomeDir() / filesystem::path("ip-to-country.csv");
+  filesystem::path SnapshotPath = CFG.GetHomeDir() / filesystem::path("ip-to-country.bin");
 
-    parser << Line;
-    parser >> Skip;
-    parser >> Skip;
-    parser >> IP1;
-    parser >> IP2;
-    parser >> Country;
-    static_cast<void>(m_DB->FromAdd(stoul(IP1), stoul(IP2), Country));
+  // the snapshot is only trusted if it was built from the current CSV
+  const size_t sourceSize = static_cast<size_t>(FileSize(GeoFilePath));
+  const int64_t sourceModified = GetMaybeModifiedTime(GeoFilePath).value_or(0);
+  if (m_GeoIndex.LoadSnapshot(SnapshotPath, sourceSize, sourceModified)) {
+    if (MatchLogLevel(LogLevel::kDebug)) {
+      Print("[AURA] loaded " + to_string(m_GeoIndex.GetSize()) + " geolocalization ranges from [ip-to-country.bin]");
+    }
+    return;
   }
 
-  if (!m_DB->Commit()) {
-    Print("[AURA] internal database error - geolocalization will not be available");
+  if (!m_GeoIndex.LoadCSV(GeoFilePath)) {
+    m_GeoIndex.Clear();
+    Print("[AURA] warning - unable to read file [ip-to-country.csv], geolocalization data not loaded");
+    return;
   }
 
-  in.close();
+  if (MatchLogLevel(LogLevel::kInfo)) {
+    Print("[AURA] loaded " + to_string(m_GeoIndex.GetSize()) + " geolocalization ranges from [ip-to-country.csv]");
+  }
+  m_GeoIndex.SaveSnapshot(SnapshotPath, sourceSize, sourceModified);
 }
 
 void CAura::InitContextMenu()
@@ -2016,10 +2010,36 @@ void CAura::UpdateCFGCacheEntries()
 {
   m_CFGCacheNamesByMapNames.clear();
 
+  filesystem::path catalogPath = m_Config.m_MapCachePath / filesystem::path("map-catalog.bin");
+  if (m_MapCatalog.m_FilePath != catalogPath) {
+    if (m_MapCatalog.GetIsModified()) {
+      m_MapCatalog.Save();
+    }
+    if (!m_MapCatalog.Load(catalogPath) && MatchLogLevel(LogLevel::kDebug)) {
+      Print("[AURA] map catalog not found - will be built as maps are loaded");
+    }
+  }
+
   // Preload map.Localpath -> mapcache entries
+  // only configs that changed since they were last cataloged need to be read
   const vector<filesystem::path> cacheFiles = FilesMatch(m_Config.m_MapCachePath, FILE_EXTENSIONS_CONFIG);
+  set<filesystem::path> cacheFileNames;
   for (const auto& cfgName : cacheFiles) {
-    string localPathString = CConfig::ReadString(m_Config.m_MapCachePath / cfgName, "map.local_path");
+    cacheFileNames.insert(cfgName);
+    string localPathString;
+    const MapCatalogEntry* catalogEntry = m_MapCatalog.Get(m_Config.m_MapCachePath, cfgName);
+    if (catalogEntry) {
+      auto it = catalogEntry->config.find("map.local_path");
+      if (it != catalogEntry->config.end()) localPathString = it->second;
+    } else {
+      // parse it once, so that the next boot is served from the catalog
+      CConfig cacheCFG;
+      if (cacheCFG.Read(m_Config.m_MapCachePath / cfgName)) {
+        m_MapCatalog.Update(m_Config.m_MapCachePath, cfgName, cacheCFG.GetEntries());
+        auto it = cacheCFG.GetEntries().find("map.local_path");
+        if (it != cacheCFG.GetEntries().end()) localPathString = it->second;
+      }
+    }
     filesystem::path localPath = localPathString;
     localPath = localPath.lexically_normal();
     try {
@@ -2033,6 +2053,11 @@ void CAura::UpdateCFGCacheEntries()
       // filesystem::absolute may throw errors
     }
   }
+
+  m_MapCatalog.Retain(cacheFileNames);
+  if (m_MapCatalog.GetIsModified()) {
+    ScheduleMapCatalogSave();
+  }
 }
 
 void CAura::ClearStaleContexts()
@@ -2067,28 +2092,12 @@ void CAura::ClearStaleFileChunks()
 
 void CAura::LogPersistent(const string& logText)
 {
-  ofstream writeStream;
-  writeStream.open(m_Config.m_MainLogPath.native().c_str(), ios::binary | ios::app);
-
-  if (writeStream.fail()) {
-    return;
-  }
-
-  LogStream(writeStream, logText, true);
-  writeStream.close();
+  m_LogWriter.Push(m_Config.m_MainLogPath, logText);
 }
 
 void CAura::LogRemoteFile(const string& logText)
 {
-  ofstream writeStream;
-  writeStream.open(m_Config.m_RemoteLogPath.native().c_str(), ios::binary | ios::app);
-
-  if (writeStream.fail()) {
-    return;
-  }
-
-  LogStream(writeStream, logText, true);
-  writeStream.close();
+  m_LogWriter.Push(m_Config.m_RemoteLogPath, logText);
 }
 
 void CAura::LogPerformanceWarning(const TaskType taskType, const void* taskPtr, const int64_t frameDrift, const int64_t oldInterval, const int64_t newInterval)
@@ -2200,7 +2209,7 @@ bool CAura::CheckGracefulExit()
   /* Already checked:
     (m_Lobbies.empty() && m_StartedGames.empty() &&
     !m_Net.m_HealthCheckInProgress &&
-    !(m_GameSetup && (m_GameSetup->GetIsDownloading() || m_GameSetup->GetMirror().GetIsSearching())) &&
+    !(m_GameSetup && (m_GameSetup->GetIsDownloading() || m_GameSetup->GetIsLoadingMap() || m_GameSetup->GetMirror().GetIsSearching())) &&
     m_PendingActions.empty())
   */
 
@@ -2215,6 +2224,9 @@ bool CAura::CheckGracefulExit()
   if (!m_Net.CheckGracefulExit()) {
     return false;
   }
+  if (m_DB->GetHasPendingWrites()) {
+    return false;
+  }
   return true;
 }
 
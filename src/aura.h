@@ -54,6 +54,11 @@
 #include "cli.h"
 #include "command.h"
 #include "game_setup.h"
+#include "geo_index.h"
+#include "log_writer.h"
+#include "map_catalog.h"
+#include "file_search_index.h"
+#include "timer_queue.h"
 #include "locations.h"
 #include "net.h"
 #include "util.h"
@@ -111,7 +116,11 @@ public:
   CRealmConfig*                                      m_RealmDefaultConfig;
   CCommandConfig*                                    m_CommandDefaultConfig;
 
+  CLogWriter                                         m_LogWriter;                  // background writer for log files, declared early so that it's destroyed late
+  CTimerQueue                                        m_Timers;                     // deadlines of games, declared before them so that it's destroyed after them
   CAuraDB*                                           m_DB;                         // database
+  TimerId                                            m_BanExpiryTimer;             // drops expired bans from the ban index
+  TimerId                                            m_MapCatalogSaveTimer;        // writes out the map catalog after it's modified
   std::shared_ptr<CGameSetup>                        m_GameSetup;                  // the currently loaded map
   std::shared_ptr<CGameSetup>                        m_AutoRehostGameSetup;        // game setup to be rehosted whenever free
 
@@ -134,6 +143,7 @@ public:
   CDiscord                                           m_Discord;                    // Discord client
   CIRC                                               m_IRC;                        // IRC client
   CNet                                               m_Net;                        // network manager
+  CGeoIndex                                          m_GeoIndex;                   // IP to country lookups
   CBotConfig                                         m_Config;
   std::filesystem::path                              m_ConfigPath;
   std::filesystem::path                              m_GameInstallPath;
@@ -146,6 +156,9 @@ public:
   std::vector<std::weak_ptr<CGame>>                  m_JoinInProgressGames;        // started games that can be joined in-progress (either as observer or player)
 
   std::map<std::filesystem::path, std::string>       m_CFGCacheNamesByMapNames;
+  CMapCatalog                                        m_MapCatalog;                 // parsed contents of cached map configs
+  CFileSearchIndex                                   m_MapFilesIndex;              // fuzzy search over m_MapPath
+  CFileSearchIndex                                   m_MapConfigFilesIndex;        // fuzzy search over m_MapCFGPath
   std::map<std::filesystem::path, TimedUint16>       m_MapFilesTimedBusyLocks;
   std::map<std::filesystem::path, FileChunkCached>   m_CachedFileContents;
   std::map<std::string, std::string>                 m_LastMapIdentifiersFromSuggestions;
@@ -242,6 +255,8 @@ public:
 
   bool LoadMapAliases();
   void LoadIPToCountryData(const CConfig& CFG);
+  void ScheduleBanExpiry();
+  void ScheduleMapCatalogSave();
   void InitContextMenu();
   void InitPathVariable();
   void InitSystem();
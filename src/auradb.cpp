@@ -45,6 +45,7 @@
 
 #include "aura.h"
 #include "auradb.h"
+#include "edit_distance.h"
 #include "game_controller_data.h"
 #include "json.h"
 #include "net.h"
@@ -129,13 +130,11 @@ uint8_t CSearchableMapData::Search(string& rwSearchName, const uint8_t searchDat
       rwSearchName = JoinStrings(inclusionMatches, false);
       return MAP_DATA_TYPE_ANY;
     } else if (!exactMatch) {
-      for (const string& element : m_Items) {
-        string::size_type distance = GetLevenshteinDistanceForSearch(element, fuzzyPattern, bestDistance);
-        if (distance < bestDistance) {
-          bestDistance = distance;
-          bestMatch = element;
-          bestMatchType = MAP_DATA_TYPE_ITEM;
-        }
+      optional<pair<size_t, string::size_type>> closest = CEditDistancePattern(fuzzyPattern).FindClosest(m_Items, bestDistance - 1);
+      if (closest.has_value()) {
+        bestDistance = closest->second;
+        bestMatch = m_Items[closest->first];
+        bestMatchType = MAP_DATA_TYPE_ITEM;
       }
     }
   }
@@ -307,13 +306,68 @@ CAuraDB::CAuraDB(CAura* nAura, CDataBaseConfig* dbConfig)
     }
 
     PreCompileStatements();
+    LoadBans();
+    OpenWriter();
+  }
+}
+
+void CAuraDB::OpenWriter()
+{
+  vector<string> pragmas;
+  switch (m_Config.m_Synchronous) {
+    case CDataBaseConfig::SynchronousMode::kOff:
+      pragmas.push_back("PRAGMA synchronous = OFF");
+      break;
+    case CDataBaseConfig::SynchronousMode::kNormal:
+      pragmas.push_back("PRAGMA synchronous = NORMAL");
+      break;
+    case CDataBaseConfig::SynchronousMode::kFull:
+      pragmas.push_back("PRAGMA synchronous = FULL");
+      break;
+    case CDataBaseConfig::SynchronousMode::kExtra:
+      pragmas.push_back("PRAGMA synchronous = EXTRA");
+      break;
+    IGNORE_ENUM_LAST(CDataBaseConfig::SynchronousMode)
+  }
+
+  // in other journal modes, each commit by the writer thread would lock out reads from the main thread
+  if (!GetIsWALMode()) {
+    PRINT_IF(LogLevel::kInfo, "[SQLITE3] database is not in WAL mode <db.journal_mode>, game history will be written synchronously")
+    m_Writer.OpenInline(m_DB);
+    return;
+  }
+
+  // both connections may write, WAL mode lets them read while the other one commits
+  m_DB->SetBusyTimeout(DB_MAIN_BUSY_TIMEOUT);
+  if (!m_Writer.Open(m_Config.m_File, pragmas)) {
+    PRINT_IF(LogLevel::kWarning, "[SQLITE3] failed to open a second connection to [" + PathToString(m_Config.m_File) + "], game history will be written synchronously")
+    m_Writer.OpenInline(m_DB);
   }
 }
 
+bool CAuraDB::GetIsWALMode()
+{
+  // the requested journal mode may not be available, e.g. for in-memory databases
+  bool isWAL = false;
+  sqlite3_stmt* Statement = nullptr;
+  m_DB->Prepare("PRAGMA journal_mode", reinterpret_cast<void**>(&Statement));
+  if (Statement) {
+    if (m_DB->Step(Statement) == SQLITE_ROW) {
+      const unsigned char* mode = sqlite3_column_text(Statement, 0);
+      isWAL = mode && ToLowerCase(string(reinterpret_cast<const char*>(mode))) == "wal";
+    }
+    m_DB->Finalize(Statement);
+  }
+  return isWAL;
+}
+
 CAuraDB::~CAuraDB()
 {
   PRINT_IF(LogLevel::kInfo, "[SQLITE3] closing database [" + PathToString(m_Config.m_File.filename()) + "]")
 
+  // pending game history is written before closing
+  m_Writer.Close();
+
   uint8_t i = STMT_CACHE_SIZE;
   while (i--) {
     if (m_StmtCache[i]) m_DB->Finalize(m_StmtCache[i]);
@@ -445,38 +499,13 @@ void CAuraDB::Initialize()
 
 void CAuraDB::PreCompileStatements()
 {
-  //m_DB->Prepare("INSERT INTO iptocountry VALUES ( ?, ?, ? )", &(m_StmtCache[FROM_ADD_IDX]), true);
-  //m_DB->Prepare("SELECT country FROM iptocountry WHERE ip1<=? AND ip2>=?", &(m_StmtCache[FROM_CHECK_IDX]), true);
-  m_DB->Prepare("INSERT OR REPLACE INTO config VALUES ( ?, ? )", &(m_StmtCache[LATEST_GAME_IDX]), true);
+  // statements for game history are prepared by m_Writer, on its own connection
   //m_DB->Prepare("INSERT OR REPLACE INTO aliases VALUES ( ?, ? )", &(m_StmtCache[ALIAS_ADD_IDX]), true);
   m_DB->Prepare("SELECT value FROM aliases WHERE alias=?", &(m_StmtCache[ALIAS_CHECK_IDX]), true);
-  m_DB->Prepare("SELECT name, server, authserver, ip, date, expiry, permanent, moderator, reason FROM bans WHERE name=? AND server=? AND authserver=?", &(m_StmtCache[USER_BAN_CHECK_IDX]), true);
-  m_DB->Prepare("SELECT name, server, authserver, ip, date, expiry, permanent, moderator, reason FROM bans WHERE ip=? AND authserver=?", &(m_StmtCache[IP_BAN_CHECK_IDX]), true);
+  m_DB->Prepare("SELECT name, server, authserver, ip, date, expiry, permanent, moderator, reason FROM bans WHERE name=? AND server=? AND authserver=?" + GetActiveBanFilter(), &(m_StmtCache[USER_BAN_CHECK_IDX]), true);
+  m_DB->Prepare("SELECT name, server, authserver, ip, date, expiry, permanent, moderator, reason FROM bans WHERE ip=? AND authserver=?" + GetActiveBanFilter(), &(m_StmtCache[IP_BAN_CHECK_IDX]), true);
   m_DB->Prepare("SELECT * FROM moderators WHERE server=? AND name=?", &(m_StmtCache[MODERATOR_CHECK_IDX]), true);
-  m_DB->Prepare("INSERT OR REPLACE INTO games ( id, creator, mapcpath, mapspath, crc32, playernames, playerids ) VALUES ( ?, ?, ?, ?, ?, ?, ? )", &(m_StmtCache[GAME_ADD_IDX]));
   m_DB->Prepare("SELECT games, loadingtime, duration, left FROM players WHERE name=? AND server=?", &(m_StmtCache[PLAYER_SUMMARY_IDX]), true);
-  m_DB->Prepare(
-    "INSERT INTO players (name, server, initialip, latestip, latestgame) "
-    "VALUES (?, ?, ?, ?, ?) "
-    "ON CONFLICT(name, server) "
-    "DO UPDATE SET "
-    "latestip = excluded.latestip, "
-    "latestgame = excluded.latestgame;",
-    &(m_StmtCache[UPDATE_PLAYER_START_IDX]), true
-  );
-  // gotta insert initialip, latestip here too, because those columns are NOT NULL
-  m_DB->Prepare(
-    "INSERT INTO players (name, server, initialip, latestip, games, loadingtime, duration, left) "
-    "VALUES (?, ?, ?, ?, 1, ?, ?, ?) "
-    "ON CONFLICT(name, server) "
-    "DO UPDATE SET "
-    "latestip = excluded.latestip, "
-    "games = games + 1, "
-    "loadingtime = loadingtime + excluded.loadingtime, "
-    "duration = duration + excluded.duration, "
-    "left = left + excluded.left;",
-    &(m_StmtCache[UPDATE_PLAYER_END_IDX]), true
-  );
 }
 
 filesystem::path CAuraDB::GetFile() const
@@ -514,39 +543,28 @@ uint64_t CAuraDB::GetLatestHistoryGameId()
   }
 }
 
-void CAuraDB::UpdateLatestHistoryGameId(uint64_t gameId)
+bool CAuraDB::UpdateLatestHistoryGameId(CDBWriter& writer, const uint64_t gameId)
 {
-  if (gameId < m_LatestGameId) {
-    //PRINT_IF(LogLevel::kDebug, "[SQLITE3] game ID " + to_string(gameId) + " skipped (" + to_string(m_LatestGameId) + " already started)");
-    return;
-  }
-
-  if (!m_StmtCache[LATEST_GAME_IDX]) {
-    m_DB->Prepare("INSERT OR REPLACE INTO config VALUES ( ?, ? )", &(m_StmtCache[LATEST_GAME_IDX]), true);
-  }
-
-  if (!m_StmtCache[LATEST_GAME_IDX]) {
-    //Print("[SQLITE3] prepare error updating latest game id [" + to_string(gameId) + "] - " + m_DB->GetError());
-    return;
+  sqlite3_stmt* Statement = writer.GetCachedStatement(LATEST_GAME_IDX, "INSERT OR REPLACE INTO config VALUES ( ?, ? )");
+  if (!Statement) {
+    Print("[SQLITE3] prepare error updating latest game id [" + to_string(gameId) + "] - " + writer.GetDB()->GetError());
+    return false;
   }
 
   bool Success = false;
-  sqlite3_bind_text(static_cast<sqlite3_stmt*>(m_StmtCache[LATEST_GAME_IDX]), 1, "latest_game_id", -1, SQLITE_TRANSIENT);
-  sqlite3_bind_int64(static_cast<sqlite3_stmt*>(m_StmtCache[LATEST_GAME_IDX]), 2, unsigned_to_signed_64(gameId));
+  sqlite3_bind_text(Statement, 1, "latest_game_id", -1, SQLITE_TRANSIENT);
+  sqlite3_bind_int64(Statement, 2, unsigned_to_signed_64(gameId));
 
-  int32_t RC = m_DB->Step(m_StmtCache[LATEST_GAME_IDX]);
+  const int32_t RC = writer.GetDB()->Step(Statement);
 
   if (RC == SQLITE_DONE) {
     Success = true;
   } else if (RC == SQLITE_ERROR) {
-    PRINT_IF(LogLevel::kError, "[SQLITE3] error updating latest game id [" + to_string(gameId) + "] - " + m_DB->GetError())
+    if (writer.GetLogErrors()) Print("[SQLITE3] error updating latest game id [" + to_string(gameId) + "] - " + writer.GetDB()->GetError());
   }
 
-  m_DB->Reset(m_StmtCache[LATEST_GAME_IDX]);
-
-  if (Success) {
-    m_LatestGameId = gameId;
-  }
+  writer.GetDB()->Reset(Statement);
+  return Success;
 }
 
 uint32_t CAuraDB::ModeratorCount(const string& server)
@@ -692,7 +710,7 @@ uint32_t CAuraDB::BanCount(const string& authserver)
 {
   uint32_t      Count = 0;
   sqlite3_stmt* Statement = nullptr;
-  m_DB->Prepare("SELECT COUNT(*) FROM bans WHERE authserver=?", reinterpret_cast<void**>(&Statement));
+  m_DB->Prepare("SELECT COUNT(*) FROM bans WHERE authserver=?" + GetActiveBanFilter(), reinterpret_cast<void**>(&Statement));
 
   if (Statement)
   {
@@ -714,13 +732,58 @@ uint32_t CAuraDB::BanCount(const string& authserver)
   return Count;
 }
 
+void CAuraDB::LoadBans()
+{
+  m_BanIndex.Clear();
+
+  sqlite3_stmt* Statement = nullptr;
+  m_DB->Prepare("SELECT name, server, authserver, ip, expiry, permanent FROM bans", reinterpret_cast<void**>(&Statement));
+
+  if (Statement)
+  {
+    int32_t RC;
+    while ((RC = m_DB->Step(Statement)) == SQLITE_ROW) {
+      const string name       = string(reinterpret_cast<const char*>(sqlite3_column_text(Statement, 0)));
+      const string server     = string(reinterpret_cast<const char*>(sqlite3_column_text(Statement, 1)));
+      const string authServer = string(reinterpret_cast<const char*>(sqlite3_column_text(Statement, 2)));
+      const string ip         = string(reinterpret_cast<const char*>(sqlite3_column_text(Statement, 3)));
+      const string expiry     = string(reinterpret_cast<const char*>(sqlite3_column_text(Statement, 4)));
+      const bool permanent    = sqlite3_column_int(Statement, 5) != 0;
+      m_BanIndex.Add(name, server, authServer, ip, permanent || !m_Config.m_BanExpiry ? nullopt : CBanIndex::ParseExpiry(expiry));
+    }
+    if (RC == SQLITE_ERROR) {
+      PRINT_IF(LogLevel::kError, "[SQLITE3] error loading bans - " + m_DB->GetError())
+    }
+    m_DB->Finalize(Statement);
+  }
+  else
+    Print("[SQLITE3] prepare error loading bans - " + m_DB->GetError());
+
+  // bans that expired while we were offline
+  const size_t expiredCount = BanExpire();
+  PRINT_IF(LogLevel::kInfo, "[SQLITE3] loaded " + to_string(m_BanIndex.GetSize()) + " bans (" + to_string(expiredCount) + " expired)")
+}
+
+size_t CAuraDB::BanExpire()
+{
+  // expired rows stay in the database, ban checks just skip them (see GetActiveBanFilter)
+  return m_BanIndex.Expire(CBanIndex::GetUnixTime());
+}
+
+string CAuraDB::GetActiveBanFilter() const
+{
+  // bans only expire if <db.bans.expiry.enabled> is set
+  if (!m_Config.m_BanExpiry) return string();
+  return " AND (permanent=1 OR expiry='' OR expiry>date('now'))";
+}
+
 CDBBan* CAuraDB::UserBanCheck(const string& rawName, const string& server, const string& authserver)
 {
   CDBBan* Ban = nullptr;
   const string user = ToLowerCase(rawName);
 
   if (!m_StmtCache[USER_BAN_CHECK_IDX]) {
-    m_DB->Prepare("SELECT name, server, authserver, ip, date, expiry, permanent, moderator, reason FROM bans WHERE name=? AND server=? AND authserver=?", &(m_StmtCache[USER_BAN_CHECK_IDX]), true);
+    m_DB->Prepare("SELECT name, server, authserver, ip, date, expiry, permanent, moderator, reason FROM bans WHERE name=? AND server=? AND authserver=?" + GetActiveBanFilter(), &(m_StmtCache[USER_BAN_CHECK_IDX]), true);
   }
 
   if (m_StmtCache[USER_BAN_CHECK_IDX])
@@ -765,7 +828,7 @@ CDBBan* CAuraDB::IPBanCheck(string ip, const string& authserver)
   CDBBan* Ban = nullptr;
 
   if (!m_StmtCache[IP_BAN_CHECK_IDX]) {
-    m_DB->Prepare("SELECT name, server, authserver, ip, date, expiry, permanent, moderator, reason FROM bans WHERE ip=? AND authserver=?", &(m_StmtCache[IP_BAN_CHECK_IDX]), true);
+    m_DB->Prepare("SELECT name, server, authserver, ip, date, expiry, permanent, moderator, reason FROM bans WHERE ip=? AND authserver=?" + GetActiveBanFilter(), &(m_StmtCache[IP_BAN_CHECK_IDX]), true);
   }
 
   if (m_StmtCache[IP_BAN_CHECK_IDX])
@@ -806,22 +869,12 @@ CDBBan* CAuraDB::IPBanCheck(string ip, const string& authserver)
 
 bool CAuraDB::GetIsUserBanned(const string& user, const string& server, const string& authserver)
 {
-  CDBBan* ban = UserBanCheck(user, server, authserver);
-  if (ban) {
-    delete ban;
-    return true;
-  }
-  return false;
+  return m_BanIndex.GetIsUserBanned(user, server, authserver, CBanIndex::GetUnixTime());
 }
 
 bool CAuraDB::GetIsIPBanned(string ip, const string& authserver)
 {
-  CDBBan* ban = IPBanCheck(ip, authserver);
-  if (ban) {
-    delete ban;
-    return true;
-  }
-  return false;
+  return m_BanIndex.GetIsIPBanned(ip, authserver, CBanIndex::GetUnixTime());
 }
 
 bool CAuraDB::BanAdd(const string& rawName, const string& server, const string& authserver, const string& ip, const string& moderator, const string& reason)
@@ -829,7 +882,15 @@ bool CAuraDB::BanAdd(const string& rawName, const string& server, const string&
   bool          Success = false;
   sqlite3_stmt* Statement = nullptr;
   const string user = ToLowerCase(rawName);
-  m_DB->Prepare("INSERT INTO bans ( name, server, authserver, ip, date, expiry, permanent, moderator, reason ) VALUES ( ?, ?, ?, ?, date('now'), date('now', '+10 days'), 0, ?, ? )", reinterpret_cast<void**>(&Statement));
+
+  // expired bans are kept in the table, so they may hold the primary key - replace them, but not active bans
+  const string replaceExpired = m_Config.m_BanExpiry ? "bans.permanent=0 AND bans.expiry<>'' AND bans.expiry<=date('now')" : "0";
+  m_DB->Prepare(
+    "INSERT INTO bans ( name, server, authserver, ip, date, expiry, permanent, moderator, reason ) VALUES ( ?, ?, ?, ?, date('now'), date('now', '+10 days'), 0, ?, ? ) "
+    "ON CONFLICT ( name, server, authserver ) DO UPDATE SET ip=excluded.ip, date=excluded.date, expiry=excluded.expiry, permanent=excluded.permanent, moderator=excluded.moderator, reason=excluded.reason "
+    "WHERE " + replaceExpired,
+    reinterpret_cast<void**>(&Statement)
+  );
 
   if (Statement)
   {
@@ -842,8 +903,17 @@ bool CAuraDB::BanAdd(const string& rawName, const string& server, const string&
 
     const int32_t RC = m_DB->Step(Statement);
 
-    if (RC == SQLITE_DONE) {
+    if (RC == SQLITE_DONE && m_DB->GetChanges() == 0) {
+      PRINT_IF(LogLevel::kWarning, "[SQLITE3] error adding ban [" + user + "@" + server + " : " + moderator + "@" + authserver + " : " + reason + " : " + ip + "] - already banned")
+    } else if (RC == SQLITE_DONE) {
       Success = true;
+      if (m_Config.m_BanExpiry) {
+        // matches date('now', '+10 days')
+        m_BanIndex.Add(user, server, authserver, ip, (CBanIndex::GetUnixTime() / 86400 + 10) * 86400);
+        m_Aura->ScheduleBanExpiry();
+      } else {
+        m_BanIndex.Add(user, server, authserver, ip, nullopt);
+      }
       Print("[SQLITE3] new ban added [" + user + "@" + server + " : " + moderator + "@" + authserver + " : " + reason + " : " + ip + "]");
     } else if (RC == SQLITE_ERROR) {
       PRINT_IF(LogLevel::kError, "[SQLITE3] error adding ban [" + user + "@" + server + " : " + moderator + "@" + authserver + " : " + reason + " : " + ip + "] - " + m_DB->GetError())
@@ -890,6 +960,7 @@ bool CAuraDB::BanRemove(const string& rawName, const string& server, const strin
 
     if (RC == SQLITE_DONE) {
       Success = true;
+      m_BanIndex.Remove(user, server, authserver);
     } else if (RC == SQLITE_ERROR) {
       PRINT_IF(LogLevel::kError, "[SQLITE3] error removing ban [" + server + " : " + user + "] - " + m_DB->GetError())
     }
@@ -907,7 +978,7 @@ vector<string> CAuraDB::ListBans(const string& authserver)
   vector<string> bans;
 
   sqlite3_stmt* Statement = nullptr;
-  m_DB->Prepare("SELECT * FROM bans WHERE authserver=?", reinterpret_cast<void**>(&Statement));
+  m_DB->Prepare("SELECT * FROM bans WHERE authserver=?" + GetActiveBanFilter(), reinterpret_cast<void**>(&Statement));
 
   if (Statement)
   {
@@ -926,94 +997,90 @@ vector<string> CAuraDB::ListBans(const string& authserver)
   return bans;
 }
 
-void CAuraDB::UpdateGamePlayerOnStart(const uint64_t gamePersistentId, const CGameController* controllerData)
+optional<DBGamePlayerRecord> CAuraDB::GetGamePlayerRecord(const CGameController* controllerData)
 {
+  optional<DBGamePlayerRecord> record;
   if (!controllerData || controllerData->GetType() != GameControllerType::kUser || controllerData->GetIsObserver()) {
-    return;
-  }
-  const string lowerName = ToLowerCase(controllerData->GetName());
-  const string server = controllerData->GetServer();
-  const string ip = controllerData->GetIP();
+    return record;
+  }
+  record.emplace();
+  record->m_Name = ToLowerCase(controllerData->GetName());
+  record->m_Server = controllerData->GetServer();
+  record->m_IP = controllerData->GetIP();
+  record->m_LoadingTime = controllerData->GetLoadingGameTime();
+  record->m_LeftTime = controllerData->GetLeftGameTime();
+  return record;
+}
 
-  if (!m_StmtCache[UPDATE_PLAYER_START_IDX]) {
-    m_DB->Prepare(
-      "INSERT INTO players (name, server, initialip, latestip, latestgame) "
-      "VALUES (?, ?, ?, ?, ?) "
-      "ON CONFLICT(name, server) "
-      "DO UPDATE SET "
-      "latestip = excluded.latestip, "
-      "latestgame = excluded.latestgame;",
-      &(m_StmtCache[UPDATE_PLAYER_START_IDX]), true
-    );
-  }
+bool CAuraDB::UpdateGamePlayerOnStart(CDBWriter& writer, const uint64_t gamePersistentId, const DBGamePlayerRecord& record)
+{
+  sqlite3_stmt* Statement = writer.GetCachedStatement(UPDATE_PLAYER_START_IDX,
+    "INSERT INTO players (name, server, initialip, latestip, latestgame) "
+    "VALUES (?, ?, ?, ?, ?) "
+    "ON CONFLICT(name, server) "
+    "DO UPDATE SET "
+    "latestip = excluded.latestip, "
+    "latestgame = excluded.latestgame;"
+  );
 
-  if (m_StmtCache[UPDATE_PLAYER_START_IDX] == nullptr) {
-    Print("[SQLITE3] prepare error adding gameuser on start [" + lowerName + "@" + server + "] - " + m_DB->GetError());
-    return;
+  if (Statement == nullptr) {
+    Print("[SQLITE3] prepare error adding gameuser on start [" + record.m_Name + "@" + record.m_Server + "] - " + writer.GetDB()->GetError());
+    return false;
   }
 
-  sqlite3_bind_text(static_cast<sqlite3_stmt*>(m_StmtCache[UPDATE_PLAYER_START_IDX]), 1, lowerName.c_str(), -1, SQLITE_TRANSIENT);
-  sqlite3_bind_text(static_cast<sqlite3_stmt*>(m_StmtCache[UPDATE_PLAYER_START_IDX]), 2, server.c_str(), -1, SQLITE_TRANSIENT);
-  sqlite3_bind_text(static_cast<sqlite3_stmt*>(m_StmtCache[UPDATE_PLAYER_START_IDX]), 3, ip.c_str(), -1, SQLITE_TRANSIENT);
-  sqlite3_bind_text(static_cast<sqlite3_stmt*>(m_StmtCache[UPDATE_PLAYER_START_IDX]), 4, ip.c_str(), -1, SQLITE_TRANSIENT);
-  sqlite3_bind_int64(static_cast<sqlite3_stmt*>(m_StmtCache[UPDATE_PLAYER_START_IDX]), 5, unsigned_to_signed_64(gamePersistentId));
+  sqlite3_bind_text(Statement, 1, record.m_Name.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(Statement, 2, record.m_Server.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(Statement, 3, record.m_IP.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(Statement, 4, record.m_IP.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_int64(Statement, 5, unsigned_to_signed_64(gamePersistentId));
 
-  const int32_t RC = m_DB->Step(m_StmtCache[UPDATE_PLAYER_START_IDX]);
+  const int32_t RC = writer.GetDB()->Step(Statement);
 
   if (RC != SQLITE_DONE) {
-    PRINT_IF(LogLevel::kError, "[SQLITE3] error initializing gameuser [" + lowerName + "@" + server + "] - " + m_DB->GetError())
+    if (writer.GetLogErrors()) Print("[SQLITE3] error initializing gameuser [" + record.m_Name + "@" + record.m_Server + "] - " + writer.GetDB()->GetError());
   }
 
-  m_DB->Reset(m_StmtCache[UPDATE_PLAYER_START_IDX]);
+  writer.GetDB()->Reset(Statement);
+  return RC == SQLITE_DONE;
 }
 
-void CAuraDB::UpdateGamePlayerOnEnd(const uint64_t /*gamePersistentId*/, const CGameController* controllerData, const uint64_t durationSeconds)
+bool CAuraDB::UpdateGamePlayerOnEnd(CDBWriter& writer, const DBGamePlayerRecord& record, const uint64_t durationSeconds)
 {
-  if (!controllerData || controllerData->GetType() != GameControllerType::kUser || controllerData->GetIsObserver()) {
-    return;
-  }
-  const string lowerName = ToLowerCase(controllerData->GetName());
-  const string server = controllerData->GetServer();
-  const string ip = controllerData->GetIP();
-  const uint64_t loadingTimeSeconds = controllerData->GetLoadingGameTime();
-  const uint64_t leftTimeSeconds = controllerData->GetLeftGameTime();
-
-  if (!m_StmtCache[UPDATE_PLAYER_END_IDX]) {
-    m_DB->Prepare(
-      "INSERT INTO players (name, server, initialip, latestip, games, loadingtime, duration, left) "
-      "VALUES (?, ?, ?, ?, 1, ?, ?, ?) "
-      "ON CONFLICT(name, server) "
-      "DO UPDATE SET "
-      "latestip = excluded.latestip, "
-      "games = games + 1, "
-      "loadingtime = loadingtime + excluded.loadingtime, "
-      "duration = duration + excluded.duration, "
-      "left = left + excluded.left;",
-      &(m_StmtCache[UPDATE_PLAYER_END_IDX]), true
-    );
-  }
-
-  if (m_StmtCache[UPDATE_PLAYER_END_IDX] == nullptr)
+  // gotta insert initialip, latestip here too, because those columns are NOT NULL
+  sqlite3_stmt* Statement = writer.GetCachedStatement(UPDATE_PLAYER_END_IDX,
+    "INSERT INTO players (name, server, initialip, latestip, games, loadingtime, duration, left) "
+    "VALUES (?, ?, ?, ?, 1, ?, ?, ?) "
+    "ON CONFLICT(name, server) "
+    "DO UPDATE SET "
+    "latestip = excluded.latestip, "
+    "games = games + 1, "
+    "loadingtime = loadingtime + excluded.loadingtime, "
+    "duration = duration + excluded.duration, "
+    "left = left + excluded.left;"
+  );
+
+  if (Statement == nullptr)
   {
-    Print("[SQLITE3] prepare error updating gameuser [" + lowerName + "@" + server + "] - " + m_DB->GetError());
-    return;
+    Print("[SQLITE3] prepare error updating gameuser [" + record.m_Name + "@" + record.m_Server + "] - " + writer.GetDB()->GetError());
+    return false;
   }
 
-  sqlite3_bind_text(static_cast<sqlite3_stmt*>(m_StmtCache[UPDATE_PLAYER_END_IDX]), 1, lowerName.c_str(), -1, SQLITE_TRANSIENT);
-  sqlite3_bind_text(static_cast<sqlite3_stmt*>(m_StmtCache[UPDATE_PLAYER_END_IDX]), 2, server.c_str(), -1, SQLITE_TRANSIENT);
-  sqlite3_bind_text(static_cast<sqlite3_stmt*>(m_StmtCache[UPDATE_PLAYER_END_IDX]), 3, ip.c_str(), -1, SQLITE_TRANSIENT);
-  sqlite3_bind_text(static_cast<sqlite3_stmt*>(m_StmtCache[UPDATE_PLAYER_END_IDX]), 4, ip.c_str(), -1, SQLITE_TRANSIENT);
-  sqlite3_bind_int64(static_cast<sqlite3_stmt*>(m_StmtCache[UPDATE_PLAYER_END_IDX]), 5, loadingTimeSeconds);
-  sqlite3_bind_int64(static_cast<sqlite3_stmt*>(m_StmtCache[UPDATE_PLAYER_END_IDX]), 6, durationSeconds);
-  sqlite3_bind_int64(static_cast<sqlite3_stmt*>(m_StmtCache[UPDATE_PLAYER_END_IDX]), 7, leftTimeSeconds);
+  sqlite3_bind_text(Statement, 1, record.m_Name.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(Statement, 2, record.m_Server.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(Statement, 3, record.m_IP.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(Statement, 4, record.m_IP.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_int64(Statement, 5, record.m_LoadingTime);
+  sqlite3_bind_int64(Statement, 6, durationSeconds);
+  sqlite3_bind_int64(Statement, 7, record.m_LeftTime);
 
-  const int32_t RC = m_DB->Step(m_StmtCache[UPDATE_PLAYER_END_IDX]);
+  const int32_t RC = writer.GetDB()->Step(Statement);
 
   if (RC != SQLITE_DONE) {
-    PRINT_IF(LogLevel::kError, "[SQLITE3] error updating gameuser on end [" + lowerName + "@" + server + "] - " + m_DB->GetError())
+    if (writer.GetLogErrors()) Print("[SQLITE3] error updating gameuser on end [" + record.m_Name + "@" + record.m_Server + "] - " + writer.GetDB()->GetError());
   }
 
-  m_DB->Reset(m_StmtCache[UPDATE_PLAYER_END_IDX]);
+  writer.GetDB()->Reset(Statement);
+  return RC == SQLITE_DONE;
 }
 
 CDBGamePlayerSummary* CAuraDB::GamePlayerSummaryCheck(const string& rawName, const string& server)
@@ -1062,23 +1129,23 @@ CDBGamePlayerSummary* CAuraDB::GamePlayerSummaryCheck(const string& rawName, con
   return GamePlayerSummary;
 }
 
-void CAuraDB::UpdateDotAPlayerOnEnd(const string& name, const string& server, uint8_t gameResult, const CDBDotAPlayer* dotaPlayer)
+bool CAuraDB::UpdateDotAPlayerOnEnd(CDBWriter& writer, const string& name, const string& server, uint8_t gameResult, const CDBDotAPlayer& dotaPlayer)
 {
-  uint32_t kills = dotaPlayer->GetKills();
-  uint32_t deaths = dotaPlayer->GetDeaths();
-  uint32_t assists = dotaPlayer->GetAssists();
-  //uint32_t gold = dotaPlayer->GetGold();
-  uint32_t creepkills = dotaPlayer->GetCreepKills();
-  uint32_t creepdenies = dotaPlayer->GetCreepDenies();
-  uint32_t neutralkills = dotaPlayer->GetNeutralKills();
-  uint32_t towerkills = dotaPlayer->GetTowerKills();
-  uint32_t raxkills = dotaPlayer->GetRaxKills();
-  uint32_t courierkills = dotaPlayer->GetCourierKills();
+  uint32_t kills = dotaPlayer.GetKills();
+  uint32_t deaths = dotaPlayer.GetDeaths();
+  uint32_t assists = dotaPlayer.GetAssists();
+  //uint32_t gold = dotaPlayer.GetGold();
+  uint32_t creepkills = dotaPlayer.GetCreepKills();
+  uint32_t creepdenies = dotaPlayer.GetCreepDenies();
+  uint32_t neutralkills = dotaPlayer.GetNeutralKills();
+  uint32_t towerkills = dotaPlayer.GetTowerKills();
+  uint32_t raxkills = dotaPlayer.GetRaxKills();
+  uint32_t courierkills = dotaPlayer.GetCourierKills();
 
   bool          Success = false;
   sqlite3_stmt* Statement = nullptr;
   string lowerName = ToLowerCase(name);
-  m_DB->Prepare("SELECT dotas, wins, losses, kills, deaths, creepkills, creepdenies, assists, neutralkills, towerkills, raxkills, courierkills FROM players WHERE name=? AND server=?", reinterpret_cast<void**>(&Statement));
+  writer.GetDB()->Prepare("SELECT dotas, wins, losses, kills, deaths, creepkills, creepdenies, assists, neutralkills, towerkills, raxkills, courierkills FROM players WHERE name=? AND server=?", reinterpret_cast<void**>(&Statement));
 
   int32_t  RC;
   uint32_t Dotas  = 1;
@@ -1092,14 +1159,14 @@ void CAuraDB::UpdateDotAPlayerOnEnd(const string& name, const string& server, ui
 
   if (Statement == nullptr)
   {
-    Print("[SQLITE3] prepare error adding dotaplayer [" + lowerName + "@" + server + "] - " + m_DB->GetError());
-    return;
+    Print("[SQLITE3] prepare error adding dotaplayer [" + lowerName + "@" + server + "] - " + writer.GetDB()->GetError());
+    return false;
   }
 
   sqlite3_bind_text(Statement, 1, lowerName.c_str(), -1, SQLITE_TRANSIENT);
   sqlite3_bind_text(Statement, 2, server.c_str(), -1, SQLITE_TRANSIENT);
 
-  RC = m_DB->Step(Statement);
+  RC = writer.GetDB()->Step(Statement);
 
   if (RC == SQLITE_ROW)
   {
@@ -1119,22 +1186,22 @@ void CAuraDB::UpdateDotAPlayerOnEnd(const string& name, const string& server, ui
     Success = true;
   }
 
-  m_DB->Finalize(Statement);
+  writer.GetDB()->Finalize(Statement);
 
   // there must be a row already because we add one, if not present, in UpdateGamePlayerOnStart( ) before the call to UpdateDotAPlayerOnEnd( )
 
   if (Success == false)
   {
-    PRINT_IF(LogLevel::kError, "[SQLITE3] error adding dotaplayer [" + lowerName + "@" + server + "] - no existing row")
-    return;
+    if (writer.GetLogErrors()) Print("[SQLITE3] error adding dotaplayer [" + lowerName + "@" + server + "] - no existing row");
+    return false;
   }
 
-  m_DB->Prepare("UPDATE players SET dotas=?, wins=?, losses=?, kills=?, deaths=?, creepkills=?, creepdenies=?, assists=?, neutralkills=?, towerkills=?, raxkills=?, courierkills=? WHERE name=? AND server=?", reinterpret_cast<void**>(&Statement));
+  writer.GetDB()->Prepare("UPDATE players SET dotas=?, wins=?, losses=?, kills=?, deaths=?, creepkills=?, creepdenies=?, assists=?, neutralkills=?, towerkills=?, raxkills=?, courierkills=? WHERE name=? AND server=?", reinterpret_cast<void**>(&Statement));
 
   if (Statement == nullptr)
   {
-    Print("[SQLITE3] prepare error updating dotaplayer [" + lowerName + "@" + server + "] - " + m_DB->GetError());
-    return;
+    Print("[SQLITE3] prepare error updating dotaplayer [" + lowerName + "@" + server + "] - " + writer.GetDB()->GetError());
+    return false;
   }
 
   sqlite3_bind_int(Statement, 1, Dotas);
@@ -1152,13 +1219,14 @@ void CAuraDB::UpdateDotAPlayerOnEnd(const string& name, const string& server, ui
   sqlite3_bind_text(Statement, 13, lowerName.c_str(), -1, SQLITE_TRANSIENT);
   sqlite3_bind_text(Statement, 14, server.c_str(), -1, SQLITE_TRANSIENT);
 
-  RC = m_DB->Step(Statement);
+  RC = writer.GetDB()->Step(Statement);
 
   if (RC != SQLITE_DONE) {
-    PRINT_IF(LogLevel::kError, "[SQLITE3] error adding dotaplayer [" + lowerName + "@" + server + "] - " + m_DB->GetError())
+    if (writer.GetLogErrors()) Print("[SQLITE3] error adding dotaplayer [" + lowerName + "@" + server + "] - " + writer.GetDB()->GetError());
   }
 
-  m_DB->Finalize(Statement);
+  writer.GetDB()->Finalize(Statement);
+  return RC == SQLITE_DONE;
 }
 
 CDBDotAPlayerSummary* CAuraDB::DotAPlayerSummaryCheck(const string& rawName, const string& server)
@@ -1357,119 +1425,149 @@ vector<string> CAuraDB::GetAlts(const string& addressLiteral)
   return altAccounts;
 }
 
-bool CAuraDB::GameAdd(const uint64_t gameId, const string& creator, const string& mapClientPath, const string& mapServerPath, const array<uint8_t, 4>& mapCRC32, const vector<string>& playerNames, const vector<uint8_t>& playerIDs, const vector<uint8_t>& slotIDs, const vector<uint8_t>& colorIDs)
+bool CAuraDB::GameAdd(CDBWriter& writer, const uint64_t gameId, const string& creator, const string& mapClientPath, const string& mapServerPath, const string& storageCRC32, const string& storagePlayerNames, const string& storageIDsText)
 {
-  string storageCRC32 = ByteArrayToDecString(mapCRC32);
-  string storagePlayerNames = JoinStrings(playerNames, false);
-
-  vector<uint8_t> storageIDs;
-  storageIDs.reserve(playerIDs.size() * 3);
-  storageIDs.insert(storageIDs.end(), playerIDs.begin(), playerIDs.end());
-  storageIDs.insert(storageIDs.end(), slotIDs.begin(), slotIDs.end());
-  storageIDs.insert(storageIDs.end(), colorIDs.begin(), colorIDs.end());
-  string storageIDsText = ByteArrayToDecString(storageIDs);
+  sqlite3_stmt* Statement = writer.GetCachedStatement(GAME_ADD_IDX, "INSERT OR REPLACE INTO games ( id, creator, mapcpath, mapspath, crc32, playernames, playerids ) VALUES ( ?, ?, ?, ?, ?, ?, ? )");
 
-  if (!m_StmtCache[GAME_ADD_IDX]) {
-    m_DB->Prepare("INSERT OR REPLACE INTO games ( id, creator, mapcpath, mapspath, crc32, playernames, playerids ) VALUES ( ?, ?, ?, ?, ?, ?, ? )", reinterpret_cast<void**>(&(m_StmtCache[GAME_ADD_IDX])));
-  }
-
-  if (!m_StmtCache[GAME_ADD_IDX]) {
-    Print("[SQLITE3] prepare error adding game [" + to_string(gameId) + ", created by " + creator + "] - " + m_DB->GetError());
+  if (!Statement) {
+    Print("[SQLITE3] prepare error adding game [" + to_string(gameId) + ", created by " + creator + "] - " + writer.GetDB()->GetError());
     return false;
   }
 
   bool Success = false;
-  sqlite3_bind_int64(m_StmtCache[GAME_ADD_IDX], 1, unsigned_to_signed_64(gameId));
-  sqlite3_bind_text(m_StmtCache[GAME_ADD_IDX], 2, creator.c_str(), -1, SQLITE_TRANSIENT);
-  sqlite3_bind_text(m_StmtCache[GAME_ADD_IDX], 3, mapClientPath.c_str(), -1, SQLITE_TRANSIENT);
-  sqlite3_bind_text(m_StmtCache[GAME_ADD_IDX], 4, mapServerPath.c_str(), -1, SQLITE_TRANSIENT);
-  sqlite3_bind_text(m_StmtCache[GAME_ADD_IDX], 5, storageCRC32.c_str(), -1, SQLITE_TRANSIENT);
-  sqlite3_bind_text(m_StmtCache[GAME_ADD_IDX], 6, storagePlayerNames.c_str(), -1, SQLITE_TRANSIENT);
-  sqlite3_bind_text(m_StmtCache[GAME_ADD_IDX], 7, storageIDsText.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_int64(Statement, 1, unsigned_to_signed_64(gameId));
+  sqlite3_bind_text(Statement, 2, creator.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(Statement, 3, mapClientPath.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(Statement, 4, mapServerPath.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(Statement, 5, storageCRC32.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(Statement, 6, storagePlayerNames.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(Statement, 7, storageIDsText.c_str(), -1, SQLITE_TRANSIENT);
 
-  const int32_t RC = m_DB->Step(m_StmtCache[GAME_ADD_IDX]);
+  const int32_t RC = writer.GetDB()->Step(Statement);
 
   if (RC == SQLITE_DONE) {
     Success = true;
   } else if (RC == SQLITE_ERROR) {
-    PRINT_IF(LogLevel::kError, "[SQLITE3] error adding game [" + to_string(gameId) + ", created by " + creator + "] - " + m_DB->GetError())
+    if (writer.GetLogErrors()) Print("[SQLITE3] error adding game [" + to_string(gameId) + ", created by " + creator + "] - " + writer.GetDB()->GetError());
   }
 
-  m_DB->Reset(m_StmtCache[GAME_ADD_IDX]);
+  writer.GetDB()->Reset(Statement);
   return Success;
 }
 
+void CAuraDB::SubmitGameLoaded(const uint64_t gameId, const string& creator, const string& mapClientPath, const string& mapServerPath, const array<uint8_t, 4>& mapCRC32, const vector<string>& playerNames, const vector<uint8_t>& playerIDs, const vector<uint8_t>& slotIDs, const vector<uint8_t>& colorIDs, const vector<CGameController*>& controllers)
+{
+  string storageCRC32 = ByteArrayToDecString(mapCRC32);
+  string storagePlayerNames = JoinStrings(playerNames, false);
+
+  vector<uint8_t> storageIDs;
+  storageIDs.reserve(playerIDs.size() * 3);
+  storageIDs.insert(storageIDs.end(), playerIDs.begin(), playerIDs.end());
+  storageIDs.insert(storageIDs.end(), slotIDs.begin(), slotIDs.end());
+  storageIDs.insert(storageIDs.end(), colorIDs.begin(), colorIDs.end());
+  string storageIDsText = ByteArrayToDecString(storageIDs);
+
+  CDBWriter::Batch batch("game loaded data [" + to_string(gameId) + "]", m_Aura->MatchLogLevel(LogLevel::kError));
+  if (gameId >= m_LatestGameId) {
+    m_LatestGameId = gameId;
+    batch.m_Jobs.push_back([gameId](CDBWriter& writer) {
+      return UpdateLatestHistoryGameId(writer, gameId);
+    });
+  }
+  batch.m_Jobs.push_back([=](CDBWriter& writer) {
+    return GameAdd(writer, gameId, creator, mapClientPath, mapServerPath, storageCRC32, storagePlayerNames, storageIDsText);
+  });
+  for (const auto& controllerData : controllers) {
+    optional<DBGamePlayerRecord> record = GetGamePlayerRecord(controllerData);
+    if (!record.has_value()) continue;
+    batch.m_Jobs.push_back([gameId, record = std::move(record.value())](CDBWriter& writer) {
+      return UpdateGamePlayerOnStart(writer, gameId, record);
+    });
+  }
+  m_Writer.Submit(std::move(batch));
+}
+
+void CAuraDB::SubmitGameEnded(const uint64_t gameId, const vector<CGameController*>& controllers, const uint64_t durationSeconds)
+{
+  CDBWriter::Batch batch("game end player data [" + to_string(gameId) + "]", m_Aura->MatchLogLevel(LogLevel::kError));
+  for (const auto& controllerData : controllers) {
+    optional<DBGamePlayerRecord> record = GetGamePlayerRecord(controllerData);
+    if (!record.has_value()) continue;
+    batch.m_Jobs.push_back([durationSeconds, record = std::move(record.value())](CDBWriter& writer) {
+      return UpdateGamePlayerOnEnd(writer, record, durationSeconds);
+    });
+  }
+  if (batch.m_Jobs.empty()) return;
+  m_Writer.Submit(std::move(batch));
+}
+
 void CAuraDB::SaveDotAStats(Dota::CDotaStats* dotaStats)
 {
-  if (Begin())
-  {
-    // since we only record the end game information it's possible we haven't recorded anything yet if the game didn't end with a tree/throne death
-    // this will happen if all the players leave before properly finishing the game
-    // the dotagame stats are always saved (with winner = 0 if the game didn't properly finish)
-    // the dotaplayer stats are only saved if the game is properly finished
+  // since we only record the end game information it's possible we haven't recorded anything yet if the game didn't end with a tree/throne death
+  // this will happen if all the players leave before properly finishing the game
+  // the dotagame stats are always saved (with winner = 0 if the game didn't properly finish)
+  // the dotaplayer stats are only saved if the game is properly finished
 
-    uint32_t Players = 0;
+  uint32_t Players = 0;
+  CDBWriter::Batch batch(dotaStats->GetLogPrefix() + "DotA player stats", m_Aura->MatchLogLevel(LogLevel::kError));
 
-    // check for invalid colours and duplicates
-    // this can only happen if DotA sends us garbage in the "id" value but we should check anyway
+  // check for invalid colours and duplicates
+  // this can only happen if DotA sends us garbage in the "id" value but we should check anyway
 
-    for (uint32_t i = 0; i < 12; ++i)
+  for (uint32_t i = 0; i < 12; ++i)
+  {
+    if (dotaStats->m_Players[i])
     {
-      if (dotaStats->m_Players[i])
-      {
-        const uint8_t Color = dotaStats->m_Players[i]->GetNewColor();
+      const uint8_t Color = dotaStats->m_Players[i]->GetNewColor();
 
-        if (!((Color >= 1 && Color <= 5) || (Color >= 7 && Color <= 11)))
-        {
-          Print(dotaStats->GetLogPrefix() + "discarding dotaPlayer data, invalid colour found");
-          delete dotaStats->m_Players[i];
-          dotaStats->m_Players[i] = nullptr;
-          continue;
-        }
+      if (!((Color >= 1 && Color <= 5) || (Color >= 7 && Color <= 11)))
+      {
+        Print(dotaStats->GetLogPrefix() + "discarding dotaPlayer data, invalid colour found");
+        delete dotaStats->m_Players[i];
+        dotaStats->m_Players[i] = nullptr;
+        continue;
+      }
 
-        for (uint32_t j = i + 1; j < 12; ++j)
+      for (uint32_t j = i + 1; j < 12; ++j)
+      {
+        if (dotaStats->m_Players[j] && Color == dotaStats->m_Players[j]->GetNewColor())
         {
-          if (dotaStats->m_Players[j] && Color == dotaStats->m_Players[j]->GetNewColor())
-          {
-            Print(dotaStats->GetLogPrefix() + "discarding dotaPlayer data, duplicate colour found");
-            delete dotaStats->m_Players[j];
-            dotaStats->m_Players[j] = nullptr;
-          }
+          Print(dotaStats->GetLogPrefix() + "discarding dotaPlayer data, duplicate colour found");
+          delete dotaStats->m_Players[j];
+          dotaStats->m_Players[j] = nullptr;
         }
       }
     }
+  }
 
-    for (auto& dotaPlayer : dotaStats->m_Players)
+  for (auto& dotaPlayer : dotaStats->m_Players)
+  {
+    if (dotaPlayer)
     {
-      if (dotaPlayer)
-      {
-        const uint8_t  Color = dotaPlayer->GetNewColor();
-        const CGameController* controller = dotaStats->m_Game.get().GetGameControllerFromColor(Color);
-        const string Name = controller->GetName();
-        const string Server = controller->GetServer();
+      const uint8_t  Color = dotaPlayer->GetNewColor();
+      const CGameController* controller = dotaStats->m_Game.get().GetGameControllerFromColor(Color);
+      const string Name = controller->GetName();
+      const string Server = controller->GetServer();
 
-        if (Name.empty())
-          continue;
+      if (Name.empty())
+        continue;
 
-        uint8_t result = GAME_RESULT_DRAWER;
+      uint8_t result = GAME_RESULT_DRAWER;
 
-        if ((dotaStats->m_Winner == Dota::WINNER_SENTINEL && Color >= 1 && Color <= 5) || (dotaStats->m_Winner == Dota::WINNER_SCOURGE && Color >= 7 && Color <= 11))
-          result = GAME_RESULT_WINNER;
-        else if ((dotaStats->m_Winner == Dota::WINNER_SCOURGE && Color >= 1 && Color <= 5) || (dotaStats->m_Winner == Dota::WINNER_SENTINEL && Color >= 7 && Color <= 11))
-          result = GAME_RESULT_LOSER;
+      if ((dotaStats->m_Winner == Dota::WINNER_SENTINEL && Color >= 1 && Color <= 5) || (dotaStats->m_Winner == Dota::WINNER_SCOURGE && Color >= 7 && Color <= 11))
+        result = GAME_RESULT_WINNER;
+      else if ((dotaStats->m_Winner == Dota::WINNER_SCOURGE && Color >= 1 && Color <= 5) || (dotaStats->m_Winner == Dota::WINNER_SENTINEL && Color >= 7 && Color <= 11))
+        result = GAME_RESULT_LOSER;
 
-        UpdateDotAPlayerOnEnd(Name, Server, result, dotaPlayer);
-        ++Players;
-      }
+      batch.m_Jobs.push_back([Name, Server, result, playerStats = CDBDotAPlayer(*dotaPlayer)](CDBWriter& writer) {
+        return UpdateDotAPlayerOnEnd(writer, Name, Server, result, playerStats);
+      });
+      ++Players;
     }
-
-    if (Commit())
-      Print(dotaStats->GetLogPrefix() + "saving " + to_string(Players) + " players");
-    else
-      Print(dotaStats->GetLogPrefix() + "unable to commit database transaction, data not saved");
   }
-  else
-    Print(dotaStats->GetLogPrefix() + "unable to begin database transaction, data not saved");
+
+  m_Writer.Submit(std::move(batch));
+  Print(dotaStats->GetLogPrefix() + "saving " + to_string(Players) + " players");
 }
 
 CDBGameSummary* CAuraDB::GameCheck(const uint64_t gameId)
@@ -1508,77 +1606,6 @@ CDBGameSummary* CAuraDB::GameCheck(const uint64_t gameId)
   }
 }
 
-string CAuraDB::FromCheck(uint32_t ip)
-{
-  // a big thank you to tjado for help with the iptocountry feature
-
-  string From = "??";
-
-  if (!m_StmtCache[FROM_CHECK_IDX]) {
-    m_DB->Prepare("SELECT country FROM iptocountry WHERE ip1<=? AND ip2>=?", &(m_StmtCache[FROM_CHECK_IDX]), true);
-  }
-
-  if (!m_StmtCache[FROM_CHECK_IDX]) {
-    Print("[SQLITE3] prepare error checking iptocountry [" + to_string(ip) + "] - " + m_DB->GetError());
-    return From;
-  }
-
-  sqlite3_bind_int(static_cast<sqlite3_stmt*>(m_StmtCache[FROM_CHECK_IDX]), 1, unsigned_to_signed_32(ip));
-  sqlite3_bind_int(static_cast<sqlite3_stmt*>(m_StmtCache[FROM_CHECK_IDX]), 2, unsigned_to_signed_32(ip));
-
-  const int32_t RC = m_DB->Step(m_StmtCache[FROM_CHECK_IDX]);
-
-  if (RC == SQLITE_ROW)
-  {
-    if (sqlite3_column_count(static_cast<sqlite3_stmt*>(m_StmtCache[FROM_CHECK_IDX])) == 1)
-      From = string((char*)sqlite3_column_text(static_cast<sqlite3_stmt*>(m_StmtCache[FROM_CHECK_IDX]), 0));
-    else
-      Print("[SQLITE3] error checking iptocountry [" + to_string(ip) + "] - row doesn't have 1 column");
-  }
-  else if (RC == SQLITE_ERROR) {
-    PRINT_IF(LogLevel::kError, "[SQLITE3] error checking iptocountry [" + to_string(ip) + "] - " + m_DB->GetError())
-  }
-
-  m_DB->Reset(m_StmtCache[FROM_CHECK_IDX]);
-
-  return From;
-}
-
-bool CAuraDB::FromAdd(uint32_t ip1, uint32_t ip2, const string& country)
-{
-  // a big thank you to tjado for help with the iptocountry feature
-
-  bool Success = false;
-
-  if (!m_StmtCache[FROM_ADD_IDX]) {
-    m_DB->Prepare("INSERT INTO iptocountry VALUES ( ?, ?, ? )", &(m_StmtCache[FROM_ADD_IDX]), true);
-  }
-
-  if (!m_StmtCache[FROM_ADD_IDX]) {
-    Print("[SQLITE3] prepare error adding iptocountry [" + to_string(ip1) + " : " + to_string(ip2) + " : " + country + "] - " + m_DB->GetError());
-    return false;
-  }
-
-  // Losslessly converting IPs to signed 32-bits integers rather than to same-value 64-bits integers
-  // This saves ~400 KB in initial database size, down from 3.6 MB to just about 3.17 MB
-  // (for reference, ip-to-country.csv is 5.92 MB)
-  sqlite3_bind_int(static_cast<sqlite3_stmt*>(m_StmtCache[FROM_ADD_IDX]), 1, unsigned_to_signed_32(ip1));
-  sqlite3_bind_int(static_cast<sqlite3_stmt*>(m_StmtCache[FROM_ADD_IDX]), 2, unsigned_to_signed_32(ip2));
-  sqlite3_bind_text(static_cast<sqlite3_stmt*>(m_StmtCache[FROM_ADD_IDX]), 3, country.c_str(), -1, SQLITE_TRANSIENT);
-
-  int32_t RC = m_DB->Step(m_StmtCache[FROM_ADD_IDX]);
-
-  if (RC == SQLITE_DONE) {
-    Success = true;
-  } else if (RC == SQLITE_ERROR) {
-    PRINT_IF(LogLevel::kError, "[SQLITE3] error adding iptocountry [" + to_string(ip1) + " : " + to_string(ip2) + " : " + country + "] - " + m_DB->GetError())
-  }
-
-  m_DB->Reset(m_StmtCache[FROM_ADD_IDX]);
-
-  return Success;
-}
-
 bool CAuraDB::AliasAdd(const string& alias, const string& target)
 {
   bool Success = false;
@@ -48,6 +48,8 @@
 
 #include "includes.h"
 #include "config/config_db.h"
+#include "ban_index.h"
+#include "db_writer.h"
 
 #include <filesystem>
 
@@ -65,19 +67,17 @@ constexpr uint8_t MAP_DATA_TYPE_DESTRUCTABLE = 3u;
 // ... Others
 constexpr uint8_t MAP_DATA_TYPE_ANY = 255u;
 
-constexpr uint8_t FROM_ADD_IDX = 0u;
-constexpr uint8_t FROM_CHECK_IDX = 1u;
-constexpr uint8_t LATEST_GAME_IDX = 2u;
-constexpr uint8_t ALIAS_ADD_IDX = 3u;
-constexpr uint8_t ALIAS_CHECK_IDX = 4u;
-constexpr uint8_t USER_BAN_CHECK_IDX = 5u;
-constexpr uint8_t IP_BAN_CHECK_IDX = 6u;
-constexpr uint8_t MODERATOR_CHECK_IDX = 7u;
-constexpr uint8_t GAME_ADD_IDX = 8u;
-constexpr uint8_t PLAYER_SUMMARY_IDX = 9u;
-constexpr uint8_t UPDATE_PLAYER_START_IDX = 10u;
-constexpr uint8_t UPDATE_PLAYER_END_IDX = 11u;
-constexpr uint8_t STMT_CACHE_SIZE = 12u;
+constexpr uint8_t LATEST_GAME_IDX = 0u;
+constexpr uint8_t ALIAS_ADD_IDX = 1u;
+constexpr uint8_t ALIAS_CHECK_IDX = 2u;
+constexpr uint8_t USER_BAN_CHECK_IDX = 3u;
+constexpr uint8_t IP_BAN_CHECK_IDX = 4u;
+constexpr uint8_t MODERATOR_CHECK_IDX = 5u;
+constexpr uint8_t GAME_ADD_IDX = 6u;
+constexpr uint8_t PLAYER_SUMMARY_IDX = 7u;
+constexpr uint8_t UPDATE_PLAYER_START_IDX = 8u;
+constexpr uint8_t UPDATE_PLAYER_END_IDX = 9u;
+constexpr uint8_t STMT_CACHE_SIZE = 10u;
 
 /**************
  *** SCHEMA ***
@@ -190,6 +190,7 @@ public:
 
   [[nodiscard]] inline bool        GetReady() const { return m_Ready; }
   [[nodiscard]] inline std::string GetError() const { return sqlite3_errmsg(static_cast<sqlite3*>(m_DB)); }
+  [[nodiscard]] inline int32_t     GetChanges() const { return sqlite3_changes(static_cast<sqlite3*>(m_DB)); }
 
   [[nodiscard]] inline int32_t Step(void* Statement) { return sqlite3_step(static_cast<sqlite3_stmt*>(Statement)); }
   inline int32_t Prepare(const std::string& query, void** Statement, bool forCache = false) {
@@ -209,9 +210,25 @@ public:
   inline int32_t Finalize(void* Statement) { return sqlite3_finalize(static_cast<sqlite3_stmt*>(Statement)); }
   inline int32_t Reset(void* Statement) { return sqlite3_reset(static_cast<sqlite3_stmt*>(Statement)); }
   inline int32_t Exec(const std::string& query) { return sqlite3_exec(static_cast<sqlite3*>(m_DB), query.c_str(), nullptr, nullptr, nullptr); }
+  inline int32_t SetBusyTimeout(const int32_t milliSeconds) { return sqlite3_busy_timeout(static_cast<sqlite3*>(m_DB), milliSeconds); }
   [[nodiscard]] inline const unsigned char* Column(void* Statement, const uint8_t index) { return sqlite3_column_text(static_cast<sqlite3_stmt*>(Statement), index); }
 };
 
+//
+// DBGamePlayerRecord
+//
+// What the players table needs from a game controller, copied so that it may be written after the game is gone.
+//
+
+struct DBGamePlayerRecord
+{
+  std::string                     m_Name;                   // lowercase
+  std::string                     m_Server;
+  std::string                     m_IP;
+  uint64_t                        m_LoadingTime;
+  uint64_t                        m_LeftTime;
+};
+
 //
 // CSearchableMapData
 //
@@ -276,6 +293,9 @@ private:
 
   std::map<uint8_t, CSearchableMapData*> m_SearchableMapData;
 
+  CBanIndex                       m_BanIndex;
+  CDBWriter                       m_Writer;                 // game history is written from a background thread
+
 public:
   explicit CAuraDB(CAura* nAura, CDataBaseConfig* dbConfig);
   ~CAuraDB();
@@ -290,15 +310,14 @@ public:
   [[nodiscard]] inline std::string            GetError() const { return m_Error; }
   [[nodiscard]] std::filesystem::path         GetFile() const;
   [[nodiscard]] uint64_t                      GetLatestHistoryGameId();
-  void                                        UpdateLatestHistoryGameId(uint64_t gameId);
+  void                                        OpenWriter();
+  [[nodiscard]] bool                          GetIsWALMode();
+  inline void                                 FlushWrites() { m_Writer.Flush(); }
+  [[nodiscard]] inline bool                   GetHasPendingWrites() { return m_Writer.GetHasPending(); }
 
   [[nodiscard]] inline bool                   Begin() const { return m_DB->Exec("BEGIN TRANSACTION") == SQLITE_OK; }
   inline bool                                 Commit() const { return m_DB->Exec("COMMIT TRANSACTION") == SQLITE_OK; }
 
-  // Geolocalization
-  [[nodiscard]] std::string                   FromCheck(uint32_t ip);
-  [[nodiscard]] bool                          FromAdd(uint32_t ip1, uint32_t ip2, const std::string& country);
-
   // Map aliases
   [[nodiscard]] bool                          AliasAdd(const std::string& alias, const std::string& target);
   [[nodiscard]] std::string                   AliasCheck(const std::string& alias);
@@ -312,6 +331,10 @@ public:
 
   // Bans
   [[nodiscard]] uint32_t                      BanCount(const std::string& authserver);
+  void                                        LoadBans();
+  size_t                                      BanExpire();
+  [[nodiscard]] std::string                   GetActiveBanFilter() const;
+  [[nodiscard]] inline CBanIndex&             GetBanIndex() { return m_BanIndex; }
   [[nodiscard]] CDBBan*                       UserBanCheck(const std::string& user, const std::string& server, const std::string& authserver);
   [[nodiscard]] CDBBan*                       IPBanCheck(std::string ip, const std::string& authserver);
   [[nodiscard]] bool                          GetIsUserBanned(const std::string& user, const std::string& server, const std::string& authserver);
@@ -325,10 +348,7 @@ public:
   [[nodiscard]] std::vector<std::string>      ListBans(const std::string& authserver);
 
   // Players
-  void                                        UpdateGamePlayerOnStart(const uint64_t gamePersistentId, const CGameController* controllerData);
-  void                                        UpdateGamePlayerOnEnd(const uint64_t gamePersistentId, const CGameController* controllerData, const uint64_t durationSeconds);
   [[nodiscard]] CDBGamePlayerSummary*         GamePlayerSummaryCheck(const std::string& name, const std::string& server);
-  void                                        UpdateDotAPlayerOnEnd(const std::string& name, const std::string& server, uint8_t result, const CDBDotAPlayer* dotaPlayer);
   [[nodiscard]] CDBDotAPlayerSummary*         DotAPlayerSummaryCheck(const std::string& name, const std::string& server);
   [[nodiscard]] std::string                   GetInitialIP(const std::string& name, const std::string& server);
   [[nodiscard]] std::string                   GetLatestIP(const std::string& name, const std::string& server);
@@ -338,9 +358,18 @@ public:
   void                                        SaveDotAStats(Dota::CDotaStats* dotaStats);
 
   // Games
-  bool                                        GameAdd(const uint64_t gameId, const std::string& creator, const std::string& mapClientPath, const std::string& mapServerPath, const std::array<uint8_t, 4>& mapCRC32, const std::vector<std::string>& playerNames, const std::vector<uint8_t>& playerIDs, const std::vector<uint8_t>& slotIDs, const std::vector<uint8_t>& colorIDs);
+  void                                        SubmitGameLoaded(const uint64_t gameId, const std::string& creator, const std::string& mapClientPath, const std::string& mapServerPath, const std::array<uint8_t, 4>& mapCRC32, const std::vector<std::string>& playerNames, const std::vector<uint8_t>& playerIDs, const std::vector<uint8_t>& slotIDs, const std::vector<uint8_t>& colorIDs, const std::vector<CGameController*>& controllers);
+  void                                        SubmitGameEnded(const uint64_t gameId, const std::vector<CGameController*>& controllers, const uint64_t durationSeconds);
   [[nodiscard]] CDBGameSummary*               GameCheck(const uint64_t gameId);
 
+  // Game history writes, run by m_Writer
+  [[nodiscard]] static std::optional<DBGamePlayerRecord> GetGamePlayerRecord(const CGameController* controllerData);
+  static bool                                 UpdateLatestHistoryGameId(CDBWriter& writer, const uint64_t gameId);
+  static bool                                 GameAdd(CDBWriter& writer, const uint64_t gameId, const std::string& creator, const std::string& mapClientPath, const std::string& mapServerPath, const std::string& storageCRC32, const std::string& storagePlayerNames, const std::string& storageIDsText);
+  static bool                                 UpdateGamePlayerOnStart(CDBWriter& writer, const uint64_t gamePersistentId, const DBGamePlayerRecord& record);
+  static bool                                 UpdateGamePlayerOnEnd(CDBWriter& writer, const DBGamePlayerRecord& record, const uint64_t durationSeconds);
+  static bool                                 UpdateDotAPlayerOnEnd(CDBWriter& writer, const std::string& name, const std::string& server, uint8_t result, const CDBDotAPlayer& dotaPlayer);
+
   void                                        InitMapData();
   [[nodiscard]] CSearchableMapData*           GetMapData(uint8_t mapType) const;
   [[nodiscard]] uint8_t                       FindData(const uint8_t mapType, const uint8_t searchDataType, std::string& objectName, const bool exactMatch) const;
@@ -0,0 +1,363 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#include "ban_index.h"
+#include "net.h"
+#include "util.h"
+
+using namespace std;
+
+namespace
+{
+  inline uint8_t GetBit(const CIPPrefixTrie::Key& key, const uint8_t index)
+  {
+    return (key[index >> 3] >> (7 - (index & 7))) & 1;
+  }
+
+  uint8_t GetCommonLength(const CIPPrefixTrie::Key& a, const CIPPrefixTrie::Key& b, const uint8_t maxLength)
+  {
+    uint8_t length = 0;
+    while (length < maxLength) {
+      const uint8_t diff = a[length >> 3] ^ b[length >> 3];
+      if (diff == 0) {
+        length = (length & ~7) + 8;
+        continue;
+      }
+      uint8_t bit = length & 7;
+      while (bit < 8 && !((diff >> (7 - bit)) & 1)) ++bit;
+      length = (length & ~7) + bit;
+      break;
+    }
+    return min(length, maxLength);
+  }
+
+  CIPPrefixTrie::Key GetMasked(const CIPPrefixTrie::Key& key, const uint8_t length)
+  {
+    CIPPrefixTrie::Key result = key;
+    for (uint8_t i = 0; i < 16; ++i) {
+      if (length >= (i + 1) * 8) continue;
+      if (length <= i * 8) {
+        result[i] = 0;
+      } else {
+        result[i] &= static_cast<uint8_t>(0xFF << (8 - (length - i * 8)));
+      }
+    }
+    return result;
+  }
+
+  // days since 1970-01-01 in the proleptic Gregorian calendar
+  int64_t GetDaysFromCivil(int64_t year, const int64_t month, const int64_t day)
+  {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const int64_t yearOfEra = year - era * 400;
+    const int64_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+  }
+};
+
+//
+// CIPPrefixTrie
+//
+
+CIPPrefixTrie::Node::Node(const Key& nPrefix, const uint8_t nLength, const uint32_t nCount)
+  : m_Prefix(GetMasked(nPrefix, nLength)),
+    m_Length(nLength),
+    m_Count(nCount)
+{
+}
+
+CIPPrefixTrie::Node::~Node() = default;
+
+CIPPrefixTrie::CIPPrefixTrie()
+  : m_Size(0)
+{
+}
+
+CIPPrefixTrie::~CIPPrefixTrie() = default;
+
+bool CIPPrefixTrie::GetContains(const Key& address) const
+{
+  const Node* node = m_Root.get();
+  while (node) {
+    if (GetCommonLength(node->m_Prefix, address, node->m_Length) < node->m_Length) return false;
+    if (node->m_Count > 0) return true;
+    if (node->m_Length >= 128) return false;
+    node = node->m_Children[GetBit(address, node->m_Length)].get();
+  }
+  return false;
+}
+
+void CIPPrefixTrie::Insert(const Key& prefix, const uint8_t length)
+{
+  ++m_Size;
+  unique_ptr<Node>* slot = &m_Root;
+  while (true) {
+    Node* node = slot->get();
+    if (!node) {
+      *slot = make_unique<Node>(prefix, length, 1);
+      return;
+    }
+    const uint8_t common = GetCommonLength(node->m_Prefix, prefix, min(node->m_Length, length));
+    if (common == node->m_Length) {
+      if (common == length) {
+        ++node->m_Count;
+        return;
+      }
+      slot = &node->m_Children[GetBit(prefix, common)];
+      continue;
+    }
+
+    // split the edge leading to this node
+    unique_ptr<Node> branch = make_unique<Node>(prefix, common, 0);
+    const uint8_t oldSide = GetBit(node->m_Prefix, common);
+    branch->m_Children[oldSide] = std::move(*slot);
+    if (common == length) {
+      branch->m_Count = 1;
+    } else {
+      branch->m_Children[oldSide ^ 1] = make_unique<Node>(prefix, length, 1);
+    }
+    *slot = std::move(branch);
+    return;
+  }
+}
+
+bool CIPPrefixTrie::Remove(const Key& prefix, const uint8_t length)
+{
+  if (!RemoveAt(m_Root, prefix, length)) return false;
+  --m_Size;
+  return true;
+}
+
+bool CIPPrefixTrie::RemoveAt(unique_ptr<Node>& slot, const Key& prefix, const uint8_t length)
+{
+  Node* node = slot.get();
+  if (!node || length < node->m_Length) return false;
+  if (GetCommonLength(node->m_Prefix, prefix, node->m_Length) < node->m_Length) return false;
+
+  if (node->m_Length == length) {
+    if (node->m_Count == 0) return false;
+    --node->m_Count;
+  } else if (!RemoveAt(node->m_Children[GetBit(prefix, node->m_Length)], prefix, length)) {
+    return false;
+  }
+
+  // nodes without prefixes of their own are only kept as branching points
+  if (node->m_Count == 0) {
+    if (!node->m_Children[0] || !node->m_Children[1]) {
+      unique_ptr<Node> child = std::move(node->m_Children[node->m_Children[0] ? 0 : 1]);
+      slot = std::move(child);
+    }
+  }
+  return true;
+}
+
+optional<CIPPrefixTrie::Key> CIPPrefixTrie::ParseAddress(const string& input)
+{
+  optional<Key> result;
+  optional<sockaddr_storage> address = CNet::ParseAddress(input, ACCEPT_ANY);
+  if (!address.has_value()) return result;
+
+  Key key;
+  if (address->ss_family == AF_INET6) {
+    const sockaddr_in6* addr6 = reinterpret_cast<const sockaddr_in6*>(&address.value());
+    memcpy(key.data(), &addr6->sin6_addr, 16);
+  } else {
+    const sockaddr_in* addr4 = reinterpret_cast<const sockaddr_in*>(&address.value());
+    key.fill(0);
+    key[10] = 0xFF;
+    key[11] = 0xFF;
+    memcpy(key.data() + 12, &addr4->sin_addr, 4);
+  }
+  result = key;
+  return result;
+}
+
+optional<pair<CIPPrefixTrie::Key, uint8_t>> CIPPrefixTrie::ParsePrefix(const string& input)
+{
+  optional<pair<Key, uint8_t>> result;
+  const string::size_type slash = input.find('/');
+  const string addressText = input.substr(0, slash);
+  optional<Key> key = ParseAddress(addressText);
+  if (!key.has_value()) return result;
+
+  const bool isIPv4 = addressText.find(':') == string::npos;
+  uint8_t length = 128;
+  if (slash != string::npos) {
+    const string lengthText = input.substr(slash + 1);
+    optional<uint32_t> maybeLength = ToUint32(lengthText);
+    if (lengthText.empty() || lengthText.find_first_not_of("0123456789") != string::npos || !maybeLength.has_value()) {
+      return result;
+    }
+    if (maybeLength.value() > (isIPv4 ? 32u : 128u)) return result;
+    length = static_cast<uint8_t>(maybeLength.value() + (isIPv4 ? 96u : 0u));
+  }
+  result = make_pair(GetMasked(key.value(), length), length);
+  return result;
+}
+
+//
+// CBanIndex
+//
+
+CBanIndex::CBanIndex()
+{
+}
+
+CBanIndex::~CBanIndex() = default;
+
+string CBanIndex::GetUserKey(const string& name, const string& server, const string& authServer)
+{
+  string key = ToLowerCase(name);
+  key.push_back('\0');
+  key.append(server);
+  key.push_back('\0');
+  key.append(authServer);
+  return key;
+}
+
+optional<int64_t> CBanIndex::GetNextExpiry() const
+{
+  optional<int64_t> result;
+  if (!m_Expiries.empty()) result = m_Expiries.begin()->first;
+  return result;
+}
+
+bool CBanIndex::GetIsUserBanned(const string& name, const string& server, const string& authServer, const int64_t now)
+{
+  Expire(now);
+  return m_UserBans.find(GetUserKey(name, server, authServer)) != m_UserBans.end();
+}
+
+bool CBanIndex::GetIsIPBanned(const string& ip, const string& authServer, const int64_t now)
+{
+  Expire(now);
+  auto it = m_IPBans.find(authServer);
+  if (it == m_IPBans.end()) return false;
+  optional<CIPPrefixTrie::Key> address = CIPPrefixTrie::ParseAddress(ip);
+  if (!address.has_value()) return false;
+  return it->second.GetContains(address.value());
+}
+
+void CBanIndex::Clear()
+{
+  m_UserBans.clear();
+  m_IPBans.clear();
+  m_Expiries.clear();
+}
+
+void CBanIndex::Add(const string& name, const string& server, const string& authServer, const string& ip, const optional<int64_t>& expiresAt)
+{
+  const string key = GetUserKey(name, server, authServer);
+  auto it = m_UserBans.find(key);
+  if (it != m_UserBans.end()) {
+    RemoveEntry(it);
+  }
+
+  if (!ip.empty()) {
+    optional<pair<CIPPrefixTrie::Key, uint8_t>> prefix = CIPPrefixTrie::ParsePrefix(ip);
+    if (prefix.has_value()) {
+      m_IPBans[authServer].Insert(prefix->first, prefix->second);
+    } else {
+      Print("[AURA] ignoring ban with invalid IP address [" + ip + "]");
+    }
+  }
+  if (expiresAt.has_value()) {
+    m_Expiries.emplace(expiresAt.value(), key);
+  }
+  m_UserBans.emplace(key, UserBan{authServer, ip, expiresAt});
+}
+
+bool CBanIndex::Remove(const string& name, const string& server, const string& authServer)
+{
+  auto it = m_UserBans.find(GetUserKey(name, server, authServer));
+  if (it == m_UserBans.end()) return false;
+  RemoveEntry(it);
+  return true;
+}
+
+void CBanIndex::RemoveEntry(unordered_map<string, UserBan>::iterator it)
+{
+  const UserBan& ban = it->second;
+  if (!ban.m_IP.empty()) {
+    optional<pair<CIPPrefixTrie::Key, uint8_t>> prefix = CIPPrefixTrie::ParsePrefix(ban.m_IP);
+    auto trieIt = m_IPBans.find(ban.m_AuthServer);
+    if (prefix.has_value() && trieIt != m_IPBans.end()) {
+      trieIt->second.Remove(prefix->first, prefix->second);
+      if (trieIt->second.GetIsEmpty()) m_IPBans.erase(trieIt);
+    }
+  }
+  if (ban.m_ExpiresAt.has_value()) {
+    auto range = m_Expiries.equal_range(ban.m_ExpiresAt.value());
+    for (auto expiryIt = range.first; expiryIt != range.second; ++expiryIt) {
+      if (expiryIt->second == it->first) {
+        m_Expiries.erase(expiryIt);
+        break;
+      }
+    }
+  }
+  m_UserBans.erase(it);
+}
+
+size_t CBanIndex::Expire(const int64_t now)
+{
+  size_t count = 0;
+  while (!m_Expiries.empty() && m_Expiries.begin()->first <= now) {
+    auto it = m_UserBans.find(m_Expiries.begin()->second);
+    if (it == m_UserBans.end()) {
+      m_Expiries.erase(m_Expiries.begin());
+      continue;
+    }
+    RemoveEntry(it);
+    ++count;
+  }
+  return count;
+}
+
+optional<int64_t> CBanIndex::ParseExpiry(const string& expiry)
+{
+  // SQLite date() format: YYYY-MM-DD, in UTC
+  optional<int64_t> result;
+  if (expiry.size() < 10 || expiry[4] != '-' || expiry[7] != '-') return result;
+  int64_t parts[3] = {0, 0, 0};
+  const uint8_t offsets[3] = {0, 5, 8};
+  const uint8_t sizes[3] = {4, 2, 2};
+  for (uint8_t i = 0; i < 3; ++i) {
+    for (uint8_t j = 0; j < sizes[i]; ++j) {
+      const char c = expiry[offsets[i] + j];
+      if (c < '0' || '9' < c) return result;
+      parts[i] = parts[i] * 10 + (c - '0');
+    }
+  }
+  if (parts[1] < 1 || 12 < parts[1] || parts[2] < 1 || 31 < parts[2]) return result;
+  result = GetDaysFromCivil(parts[0], parts[1], parts[2]) * 86400;
+  return result;
+}
+
+int64_t CBanIndex::GetUnixTime()
+{
+  return static_cast<int64_t>(chrono::system_clock::to_time_t(chrono::system_clock::now()));
+}
@@ -0,0 +1,126 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#ifndef AURA_BAN_INDEX_H_
+#define AURA_BAN_INDEX_H_
+
+#include "includes.h"
+
+#include <array>
+#include <unordered_map>
+
+//
+// CIPPrefixTrie
+//
+// Set of IPv4 and IPv6 prefixes (e.g. 203.0.113.7, 198.51.100.0/24, 2001:db8::/32), as a path-compressed binary trie.
+// IPv4 prefixes are stored as IPv4-mapped IPv6 prefixes, so that both address families share a single tree.
+// A lookup visits at most one node per distinct prefix length on its path, regardless of how many prefixes are stored.
+// The same prefix may be inserted several times, and stays in the set until removed as many times.
+//
+
+class CIPPrefixTrie
+{
+public:
+  typedef std::array<uint8_t, 16> Key;
+
+  struct Node
+  {
+    Key                                         m_Prefix;
+    uint8_t                                     m_Length;
+    uint32_t                                    m_Count;
+    std::unique_ptr<Node>                       m_Children[2];
+
+    Node(const Key& nPrefix, const uint8_t nLength, const uint32_t nCount);
+    ~Node();
+  };
+
+  std::unique_ptr<Node>                         m_Root;
+  size_t                                        m_Size;
+
+  CIPPrefixTrie();
+  ~CIPPrefixTrie();
+  CIPPrefixTrie(CIPPrefixTrie&) = delete;
+  CIPPrefixTrie(CIPPrefixTrie&&) = default;
+
+  [[nodiscard]] inline size_t                   GetSize() const { return m_Size; }
+  [[nodiscard]] inline bool                     GetIsEmpty() const { return m_Size == 0; }
+  [[nodiscard]] bool                            GetContains(const Key& address) const;
+
+  void                                          Insert(const Key& prefix, const uint8_t length);
+  bool                                          Remove(const Key& prefix, const uint8_t length);
+
+  [[nodiscard]] static std::optional<std::pair<Key, uint8_t>> ParsePrefix(const std::string& input);
+  [[nodiscard]] static std::optional<Key>       ParseAddress(const std::string& input);
+
+private:
+  bool                                          RemoveAt(std::unique_ptr<Node>& slot, const Key& prefix, const uint8_t length);
+};
+
+//
+// CBanIndex
+//
+// In-memory copy of the bans table, so that joins are checked without querying the database.
+// It's loaded once at startup, and kept up to date by CAuraDB::BanAdd() and CAuraDB::BanRemove().
+// User bans are hashed by (name, server, authserver). IP bans are kept in a CIPPrefixTrie per authserver,
+// so that the ip column may also hold subnets in CIDR notation.
+//
+
+class CBanIndex
+{
+public:
+  struct UserBan
+  {
+    std::string                                 m_AuthServer;
+    std::string                                 m_IP;
+    std::optional<int64_t>                      m_ExpiresAt;  // unix time
+  };
+
+  std::unordered_map<std::string, UserBan>      m_UserBans;
+  std::unordered_map<std::string, CIPPrefixTrie> m_IPBans;
+  std::multimap<int64_t, std::string>           m_Expiries;
+
+  CBanIndex();
+  ~CBanIndex();
+  CBanIndex(CBanIndex&) = delete;
+
+  [[nodiscard]] inline size_t                   GetSize() const { return m_UserBans.size(); }
+  [[nodiscard]] std::optional<int64_t>          GetNextExpiry() const;
+  [[nodiscard]] bool                            GetIsUserBanned(const std::string& name, const std::string& server, const std::string& authServer, const int64_t now);
+  [[nodiscard]] bool                            GetIsIPBanned(const std::string& ip, const std::string& authServer, const int64_t now);
+
+  void                                          Clear();
+  void                                          Add(const std::string& name, const std::string& server, const std::string& authServer, const std::string& ip, const std::optional<int64_t>& expiresAt);
+  bool                                          Remove(const std::string& name, const std::string& server, const std::string& authServer);
+  size_t                                        Expire(const int64_t now);
+
+  [[nodiscard]] static std::optional<int64_t>   ParseExpiry(const std::string& expiry);
+  [[nodiscard]] static int64_t                  GetUnixTime();
+
+private:
+  [[nodiscard]] static std::string              GetUserKey(const std::string& name, const std::string& server, const std::string& authServer);
+  void                                          RemoveEntry(std::unordered_map<std::string, UserBan>::iterator it);
+};
+
+#endif // AURA_BAN_INDEX_H_
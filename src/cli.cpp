@@ -53,7 +53,8 @@ CCLI::CCLI()
    m_ExecAuth(CommandAuth::kAuto),
    m_ExecBroadcast(false),
    m_ExecOnline(true),
-   m_RunTests(false)
+   m_RunTests(false),
+   m_RunBenchmarks(false)
 {
 }
 
@@ -798,6 +799,9 @@ CLIResult CCLI::Parse(const int argc, char** argv)
   app.add_flag(  "--test", m_RunTests,
     "Run tests to ensure Aura is working correctly."
   );
+  app.add_flag(  "--benchmark", m_RunBenchmarks,
+    "Run benchmarks for performance-sensitive routines, and exit."
+  );
 
   try {
     app.parse(argc, argv);
@@ -811,6 +815,10 @@ CLIResult CCLI::Parse(const int argc, char** argv)
     return CLIResult::kError;
   }
 
+  if (m_RunBenchmarks) {
+    return CLIResult::kBenchmark;
+  }
+
   if (about || examples || m_RunTests) {
     if (about) {
       m_InfoAction = CLIAction::kAbout;
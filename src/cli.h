@@ -51,6 +51,7 @@ enum class CLIResult : uint8_t
   kInfoAndQuit   = 2u,
   kConfigAndQuit = 3u,
   kTest = 4u,
+  kBenchmark = 5u,
 };
 
 //
@@ -211,6 +212,7 @@ public:
   bool                                        m_ExecOnline;
 
   bool                                        m_RunTests;
+  bool                                        m_RunBenchmarks;
 
   CCLI();
   ~CCLI();
@@ -1655,7 +1655,7 @@ void CCommandContext::Run(const string& cmdToken, const string& baseCommand, con
       }
       string FromFragment;
       if (m_Aura->m_Net.m_Config.m_EnableGeoLocalization) {
-        FromFragment = ", From: " + m_Aura->m_DB->FromCheck(ByteArrayToUInt32(targetPlayer->GetIPv4(), true));
+        FromFragment = ", From: " + m_Aura->m_GeoIndex.GetCountry(ByteArrayToUInt32(targetPlayer->GetIPv4(), true));
       }
       string realmFragment = "Realm: " + (targetPlayer->GetRealmHostName().empty() ? "LAN" : targetPlayer->GetRealmHostName());
       string versionFragment;
@@ -2490,7 +2490,7 @@ void CCommandContext::Run(const string& cmdToken, const string& baseCommand, con
 
         Froms += (*i)->GetDisplayName();
         Froms += ": (";
-        Froms += m_Aura->m_DB->FromCheck(ByteArrayToUInt32((*i)->GetIPv4(), true));
+        Froms += m_Aura->m_GeoIndex.GetCountry(ByteArrayToUInt32((*i)->GetIPv4(), true));
         Froms += ")";
 
         if (i != end(targetGame->m_Users) - 1)
@@ -3255,7 +3255,7 @@ void CCommandContext::Run(const string& cmdToken, const string& baseCommand, con
           ErrorReply("Not allowed to host games.");
           break;
         }
-        if (!m_Aura->m_GameSetup || m_Aura->m_GameSetup->GetIsDownloading()) {
+        if (!m_Aura->m_GameSetup || (m_Aura->m_GameSetup->GetIsDownloading() || m_Aura->m_GameSetup->GetIsLoadingMap())) {
           ErrorReply("A map must be loaded with " + (sourceRealm ? sourceRealm->GetCommandToken() : "!") + "map first.");
           break;
         }
@@ -3288,7 +3288,7 @@ void CCommandContext::Run(const string& cmdToken, const string& baseCommand, con
         }
         targetGame->m_CreationTime = targetGame->m_LastRefreshTime = GetTime();
       } else {
-        if (!m_Aura->m_GameSetup || m_Aura->m_GameSetup->GetIsDownloading()) {
+        if (!m_Aura->m_GameSetup || (m_Aura->m_GameSetup->GetIsDownloading() || m_Aura->m_GameSetup->GetIsLoadingMap())) {
           ErrorReply("A map must be loaded with " + (sourceRealm ? sourceRealm->GetCommandToken() : "!") + "map first.");
           break;
         }
@@ -3330,7 +3330,7 @@ void CCommandContext::Run(const string& cmdToken, const string& baseCommand, con
         break;
       }
 
-      if (!m_Aura->m_GameSetup || m_Aura->m_GameSetup->GetIsDownloading()) {
+      if (!m_Aura->m_GameSetup || (m_Aura->m_GameSetup->GetIsDownloading() || m_Aura->m_GameSetup->GetIsLoadingMap())) {
         ErrorReply("A map must be loaded with " + (sourceRealm ? sourceRealm->GetCommandToken() : "!") + "map first.");
         break;
       }
@@ -3567,6 +3567,7 @@ void CCommandContext::Run(const string& cmdToken, const string& baseCommand, con
         targetGame->m_AutoStartRequirements.clear();
       }
       targetGame->m_AutoStartRequirements.push_back(make_pair(minReadyControllers, dueTime));
+      targetGame->ScheduleAutoStartTimer(GetTicks());
       targetGame->SendAllAutoStart();
       break;
     }
@@ -3593,6 +3594,7 @@ void CCommandContext::Run(const string& cmdToken, const string& baseCommand, con
         break;
       }
       targetGame->m_AutoStartRequirements.clear();
+      targetGame->ScheduleAutoStartTimer(GetTicks());
       SendReply("Autostart removed.");
       break;
     }
@@ -4005,12 +4007,14 @@ void CCommandContext::Run(const string& cmdToken, const string& baseCommand, con
         targetGame->StopCountDown();
         if (targetGame->GetIsAutoStartDue()) {
           targetGame->m_AutoStartRequirements.clear();
+          targetGame->ScheduleAutoStartTimer(GetTicks());
           SendAll("Countdown stopped by " + GetSender() + ". Autostart removed.");
         } else {
           SendAll("Countdown stopped by " + GetSender() + ".");
         }
       } else {
         targetGame->m_AutoStartRequirements.clear();
+        targetGame->ScheduleAutoStartTimer(GetTicks());
         SendAll("Autostart removed.");
       }
       break;
@@ -7028,7 +7032,7 @@ void CCommandContext::Run(const string& cmdToken, const string& baseCommand, con
 
         shared_ptr<CMap> parsedMap = nullptr;
         try {
-          parsedMap = make_shared<CMap>(m_Aura, &MapCFG);
+          parsedMap = make_shared<CMap>(m_Aura, &MapCFG, MapLoaderConfig(m_Aura));
         } catch (...) {
           Print("[AURA] warning - map [" + nameString + "] is not valid.");
           badCounter++;
@@ -7640,7 +7644,7 @@ void CCommandContext::Run(const string& cmdToken, const string& baseCommand, con
 
     case HashCode("loadcfg"): {
       if (target.empty()) {
-        if (!m_Aura->m_GameSetup || m_Aura->m_GameSetup->GetIsDownloading()) {
+        if (!m_Aura->m_GameSetup || (m_Aura->m_GameSetup->GetIsDownloading() || m_Aura->m_GameSetup->GetIsLoadingMap())) {
           SendReply("There is no map/config file loaded.");
           break;
         }
@@ -7651,7 +7655,7 @@ void CCommandContext::Run(const string& cmdToken, const string& baseCommand, con
         ErrorReply("Not allowed to host games.");
         break;
       }
-      if (m_Aura->m_GameSetup && m_Aura->m_GameSetup->GetIsDownloading()) {
+      if (m_Aura->m_GameSetup && (m_Aura->m_GameSetup->GetIsDownloading() || m_Aura->m_GameSetup->GetIsLoadingMap())) {
         ErrorReply("Another user is hosting a map.");
         break;
       }
@@ -7857,14 +7861,14 @@ void CCommandContext::Run(const string& cmdToken, const string& baseCommand, con
           }
           break;
         }
-        if (!m_Aura->m_GameSetup || m_Aura->m_GameSetup->GetIsDownloading()) {
+        if (!m_Aura->m_GameSetup || (m_Aura->m_GameSetup->GetIsDownloading() || m_Aura->m_GameSetup->GetIsLoadingMap())) {
           SendReply("There is no map/config file loaded.", CHAT_SEND_SOURCE_ALL);
           break;
         }
         SendReply("The currently loaded map/config file is: [" + m_Aura->m_GameSetup->GetInspectName() + "]", CHAT_SEND_SOURCE_ALL);
         break;
       }
-      if (m_Aura->m_GameSetup && m_Aura->m_GameSetup->GetIsDownloading()) {
+      if (m_Aura->m_GameSetup && (m_Aura->m_GameSetup->GetIsDownloading() || m_Aura->m_GameSetup->GetIsLoadingMap())) {
         ErrorReply("Another user is hosting a game.");
         break;
       }
@@ -7946,7 +7950,7 @@ void CCommandContext::Run(const string& cmdToken, const string& baseCommand, con
         break;
       }
 
-      if (!m_Aura->m_GameSetup || m_Aura->m_GameSetup->GetIsDownloading()) {
+      if (!m_Aura->m_GameSetup || (m_Aura->m_GameSetup->GetIsDownloading() || m_Aura->m_GameSetup->GetIsLoadingMap())) {
         ErrorReply("A map must first be loaded with " + (sourceRealm ? sourceRealm->GetCommandToken() : "!") + "map.");
         break;
       }
@@ -8243,6 +8247,27 @@ void CCommandContext::Run(const string& cmdToken, const string& baseCommand, con
       break;
     }
 
+    case HashCode("seek"): {
+      auto gameSource = GetGameSource();
+      if (!gameSource.GetIsSpectator()) {
+        ErrorReply("This command can only be used in spectator mode.");
+        break;
+      }
+      CAsyncObserver* spectator = gameSource.GetSpectator();
+      optional<int64_t> targetSeconds = ParseTimeStamp(target);
+      if (!targetSeconds.has_value()) {
+        ErrorReply("Usage: " + cmdToken + "seek <TIME>");
+        ErrorReply("Example: " + cmdToken + "seek 15:00");
+        break;
+      }
+      if (!spectator->Seek(targetSeconds.value() * 1000)) {
+        ErrorReply("Cannot seek to " + ToFormattedTimeStamp(targetSeconds.value()) + " - playback is at " + ToFormattedTimeStamp(spectator->GetGameTicks() / 1000) + ".");
+        break;
+      }
+      spectator->SendChat("Seeking to " + ToFormattedTimeStamp(targetSeconds.value()) + "...");
+      break;
+    }
+
     case HashCode("sync"): {
       auto gameSource = GetGameSource();
       if (!gameSource.GetIsSpectator()) {
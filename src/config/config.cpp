@@ -198,6 +198,13 @@ bool CConfig::Read(const filesystem::path& file, CConfig* adapterConfig)
   return true;
 }
 
+void CConfig::Load(const filesystem::path& file, const map<string, string>& entries)
+{
+  // same as Read(), for entries that were already parsed
+  m_File = file;
+  m_CFG = entries;
+}
+
 bool CConfig::Exists(const string& key)
 {
   m_ValidKeys.insert(key);
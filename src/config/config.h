@@ -106,6 +106,7 @@ public:
   ~CConfig();
 
   [[nodiscard]] bool Read(const std::filesystem::path& file, CConfig* adapterConfig = nullptr);
+  void Load(const std::filesystem::path& file, const std::map<std::string, std::string>& entries);
   [[nodiscard]] bool Exists(const std::string& key);
   void Accept(const std::string& key);
   void Delete(const std::string& key);
@@ -52,12 +52,16 @@ CBotConfig::CBotConfig(CConfig& CFG)
   m_MapCachePath                 = CFG.GetDirectory("bot.map_cache_path", CFG.GetHomeDir() / filesystem::path("mapcache"));
   m_JASSPath                     = CFG.GetDirectory("bot.jass_path", CFG.GetHomeDir() / filesystem::path("jass"));
   m_GameSavePath                 = CFG.GetDirectory("bot.save_path", CFG.GetHomeDir() / filesystem::path("saves"));
+  m_ReplayPath                   = CFG.GetDirectory("bot.replays_path", CFG.GetHomeDir() / filesystem::path("replays"));
 
   // Non-configurable
   m_AliasesPath                  = CFG.GetHomeDir() / filesystem::path("aliases.ini");
 
   m_MainLogPath                  = CFG.GetPath("bot.log_path", CFG.GetHomeDir() / filesystem::path("aura.log"));
   m_RemoteLogPath                = CFG.GetPath("hosting.log_remote.file", CFG.GetHomeDir() / filesystem::path("remote.log"));
+  m_LogFormat                    = CFG.GetStringIndex("bot.log_format", {"text", "binary"}, LOG_FORMAT_TEXT);
+  m_LogRotateSize                = CFG.GetUint32("bot.log_rotate.max_size", 0);
+  m_LogRotateInterval            = CFG.GetUint32("bot.log_rotate.interval", 0);
 
   set<string> supportedGameVersionStrings = CFG.GetSetSensitive("hosting.game_versions.supported", ',', true, false, {});
   set<Version> supportedGameVersions;
@@ -50,10 +50,14 @@ struct CBotConfig
   std::filesystem::path                   m_MapCachePath;                // map cache path
   std::filesystem::path                   m_JASSPath;                    // JASS files path
   std::filesystem::path                   m_GameSavePath;                // save files path
+  std::filesystem::path                   m_ReplayPath;                  // replay files path
 
   std::filesystem::path                   m_AliasesPath;                 // aliases path
   std::filesystem::path                   m_MainLogPath;                 // main log path (default aura.log)
   std::filesystem::path                   m_RemoteLogPath;               // remote log path (default remote.log)
+  uint8_t                                 m_LogFormat;                   // text, or binary records
+  uint32_t                                m_LogRotateSize;               // rotate log files past this size (MB), 0 to disable
+  uint32_t                                m_LogRotateInterval;           // rotate log files after these many hours, 0 to disable
 
   std::filesystem::path                   m_GreetingPath;                // the path of the greeting the bot sends to all players joining a game
   std::vector<std::string>                m_Greeting;                    // read from m_GreetingPath
@@ -40,6 +40,7 @@ CDataBaseConfig::CDataBaseConfig(CConfig& CFG)
   m_JournalMode = CFG.GetEnum<JournalMode>("db.journal_mode", TO_ARRAY("delete", "truncate", "persist", "memory", "wal", "off"), JournalMode::kDel);
   m_Synchronous = CFG.GetEnum<SynchronousMode>("db.synchronous", TO_ARRAY("off", "normal", "full", "extra"), SynchronousMode::kFull);
   m_WALInterval = CFG.GetUint16("db.wal_autocheckpoint", 100);
+  m_BanExpiry = CFG.GetBool("db.bans.expiry.enabled", false);
   CFG.SetStrictMode(wasStrict);
 }
 
@@ -50,6 +51,7 @@ CDataBaseConfig::CDataBaseConfig(const CDataBaseConfig& other)
   m_JournalMode = other.m_JournalMode;
   m_Synchronous = other.m_Synchronous;
   m_WALInterval = other.m_WALInterval;
+  m_BanExpiry = other.m_BanExpiry;
 }
 
 bool CDataBaseConfig::operator==(const CDataBaseConfig& other) const
@@ -59,7 +61,8 @@ bool CDataBaseConfig::operator==(const CDataBaseConfig& other) const
     m_TWRPGFile == other.m_TWRPGFile &&
     m_JournalMode == other.m_JournalMode &&
     m_Synchronous == other.m_Synchronous &&
-    m_WALInterval == other.m_WALInterval
+    m_WALInterval == other.m_WALInterval &&
+    m_BanExpiry == other.m_BanExpiry
   );
 }
 
@@ -71,6 +74,7 @@ CDataBaseConfig& CDataBaseConfig::operator=(const CDataBaseConfig& other)
     m_JournalMode = other.m_JournalMode;
     m_Synchronous = other.m_Synchronous;
     m_WALInterval = other.m_WALInterval;
+    m_BanExpiry = other.m_BanExpiry;
   }
 
   return *this;
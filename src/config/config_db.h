@@ -60,6 +60,7 @@ struct CDataBaseConfig
   CDataBaseConfig::JournalMode            m_JournalMode;
   CDataBaseConfig::SynchronousMode        m_Synchronous;
   uint16_t                                m_WALInterval;
+  bool                                    m_BanExpiry;                   // whether bans are lifted once their expiry date is past
 
   explicit CDataBaseConfig(CConfig& CFG);
   CDataBaseConfig(const CDataBaseConfig& other);
@@ -68,6 +68,8 @@ CGameConfig::CGameConfig(CConfig& CFG)
   m_PlayersReadyMode                       = CFG.GetEnum<PlayersReadyMode>("hosting.game_ready.mode", TO_ARRAY("fast", "race", "explicit"), PlayersReadyMode::kExpectRace);
   m_AutoStartRequiresBalance               = CFG.GetBool("hosting.autostart.requires_balance", true);
   m_SaveStats                              = CFG.GetBool("db.game_stats.enabled", true);
+  m_SaveReplays                            = CFG.GetBool("hosting.replays.enabled", false);
+  m_ReplayBuildNumber                      = CFG.GetUint16("hosting.replays.build_number", 6059);
 
   m_AutoKickPing                           = CFG.GetUint32("hosting.high_ping.kick_ms", 250);
   m_WarnHighPing                           = CFG.GetUint32("hosting.high_ping.warn_ms", 175);
@@ -182,6 +184,7 @@ CGameConfig::CGameConfig(CConfig& CFG)
   m_FakeUsersShareUnitsMode                = CFG.GetEnum<FakeUsersShareUnitsMode>("hosting.fake_users.share_units.mode", TO_ARRAY("never", "auto", "team", "all"), FakeUsersShareUnitsMode::kAuto);
   m_EnableJoinObserversInProgress          = CFG.GetBool("hosting.join_in_progress.observers", false);
   m_EnableJoinPlayersInProgress            = CFG.GetBool("hosting.join_in_progress.players", false);
+  m_JoinInProgressMaxMemory                = CFG.GetUint32("hosting.join_in_progress.max_memory", 16384);
 
   m_LoggedWords                            = CFG.GetSet("hosting.log_words", ',', true, false, {});
   m_LogChatTypes                           = CFG.GetBool("hosting.log_non_ascii", false) ? LOG_CHAT_TYPE_NON_ASCII : 0;
@@ -229,6 +232,8 @@ CGameConfig::CGameConfig(CGameConfig* nRootConfig, shared_ptr<CMap> nMap, shared
   INHERIT_MAP_OR_CUSTOM(m_PlayersReadyMode, m_PlayersReadyMode, m_PlayersReadyMode)
   INHERIT_MAP_OR_CUSTOM(m_AutoStartRequiresBalance, m_AutoStartRequiresBalance, m_AutoStartRequiresBalance)
   INHERIT(m_SaveStats);
+  INHERIT(m_SaveReplays);
+  INHERIT(m_ReplayBuildNumber);
 
   INHERIT_MAP_OR_CUSTOM(m_AutoKickPing, m_AutoKickPing, m_AutoKickPing)
   INHERIT_MAP_OR_CUSTOM(m_WarnHighPing, m_WarnHighPing, m_WarnHighPing)
@@ -318,6 +323,7 @@ CGameConfig::CGameConfig(CGameConfig* nRootConfig, shared_ptr<CMap> nMap, shared
   INHERIT_MAP_OR_CUSTOM(m_FakeUsersShareUnitsMode, m_FakeUsersShareUnitsMode, m_FakeUsersShareUnitsMode)
   INHERIT_MAP_OR_CUSTOM(m_EnableJoinObserversInProgress, m_EnableJoinObserversInProgress, m_EnableJoinObserversInProgress)
   INHERIT_MAP_OR_CUSTOM(m_EnableJoinPlayersInProgress, m_EnableJoinPlayersInProgress, m_EnableJoinPlayersInProgress)
+  INHERIT(m_JoinInProgressMaxMemory)
 
   INHERIT(m_LoggedWords)
   INHERIT(m_LogChatTypes)
@@ -49,6 +49,8 @@ struct CGameConfig
   PlayersReadyMode                 m_PlayersReadyMode;
   bool                             m_AutoStartRequiresBalance;
   bool                             m_SaveStats;
+  bool                             m_SaveReplays;
+  uint16_t                         m_ReplayBuildNumber;          // must match the game version, e.g. 6059 for v1.24, 6401 for v1.26
   
   uint32_t                         m_AutoKickPing;               // auto kick players with ping higher than this
   uint32_t                         m_WarnHighPing;               // announce on chat when players have a ping higher than this value
@@ -115,6 +117,7 @@ struct CGameConfig
   FakeUsersShareUnitsMode          m_FakeUsersShareUnitsMode;
   bool                             m_EnableJoinObserversInProgress;
   bool                             m_EnableJoinPlayersInProgress;
+  uint32_t                         m_JoinInProgressMaxMemory;    // KB of game frames kept in memory before spilling them to disk
 
   std::set<std::string>            m_LoggedWords;
   uint8_t                          m_LogChatTypes;
@@ -210,6 +210,7 @@ CNetConfig::CNetConfig(CConfig& CFG)
   }
 #endif
   m_DownloadTimeout              = CFG.GetUint32("hosting.map_downloads.timeout", 15000);
+  m_DownloadMaxSpeed             = CFG.GetUint32("hosting.map_downloads.max_speed", 0);
   m_MapRepositories              = CFG.GetSet("hosting.map_downloads.repositories", ',', true, false, {"epicwar", "wc3maps"});
   m_AllowTransfers               = CFG.GetStringIndex("hosting.map_transfers.mode", {"never", "auto", "manual"}, MAP_TRANSFERS_AUTOMATIC);
   m_MaxDownloaders               = CFG.GetUint32("hosting.map_transfers.max_players", 3);
@@ -63,6 +63,7 @@ struct CNetConfig
 
   bool                                    m_AllowDownloads;             // allow map downloads or not
   uint32_t                                m_DownloadTimeout;
+  uint32_t                                m_DownloadMaxSpeed;           // maximum map download speed in KB/sec (0 = unlimited)
   std::set<std::string>                   m_MapRepositories;            // enabled map repositories
   uint8_t                                 m_AllowTransfers;             // map transfers mode
   uint32_t                                m_MaxDownloaders;             // maximum number of map downloaders at the same time
@@ -68,13 +68,6 @@ CConnection::~CConnection()
   m_Socket = nullptr;
 }
 
-uint32_t CConnection::SetFD(fd_set* fd, fd_set* send_fd, int32_t* nfds) const
-{
-  if (!m_Socket) return 0;
-  m_Socket->SetFD(fd, send_fd, nfds);
-  return 1;
-}
-
 void CConnection::SetTimeout(const int64_t delta)
 {
   m_TimeoutTicks = GetTicks() + delta;
@@ -87,7 +80,7 @@ bool CConnection::CloseConnection()
   return true;
 }
 
-uint8_t CConnection::Update(fd_set* fd, fd_set* send_fd, int64_t timeout)
+uint8_t CConnection::Update(int64_t timeout)
 {
   if (m_DeleteMe || !m_Socket || m_Socket->HasError()) {
     return INCON_UPDATE_DESTROY;
@@ -102,31 +95,23 @@ uint8_t CConnection::Update(fd_set* fd, fd_set* send_fd, int64_t timeout)
   uint8_t result = INCON_UPDATE_OK;
   bool Abort = false;
   if (m_Type == INCON_TYPE_KICKED_PLAYER) {
-    m_Socket->Discard(fd);
-  } else if (m_Socket->DoRecv(fd)) {
+    m_Socket->Discard();
+  } else if (m_Socket->DoRecv()) {
     // extract as many packets as possible from the socket's receive buffer and process them
-    string*              RecvBuffer         = m_Socket->GetBytes();
-    std::vector<uint8_t> Bytes              = CreateByteArray((uint8_t*)RecvBuffer->c_str(), RecvBuffer->size());
-    uint32_t             LengthProcessed    = 0;
+    CStreamBuffer*       RecvBuffer         = m_Socket->GetBytes();
+    CPacketFramer        Framer(*RecvBuffer);
+    PacketView           Data;
+    size_t               LengthProcessed    = 0;
 
-    // a packet is at least 4 bytes so loop as long as the buffer contains 4 bytes
+    while (Framer.Next(Data)) {
+      const uint16_t Length = static_cast<uint16_t>(Data.size());
 
-    while (Bytes.size() >= 4) {
-      // bytes 2 and 3 contain the length of the packet
-      const uint16_t Length = ByteArrayToUInt16(Bytes, false, 2);
-      if (Length < 4) {
-        Abort = true;
-        break;
-      }
-      if (Bytes.size() < Length) break;
-      const std::vector<uint8_t> Data = std::vector<uint8_t>(begin(Bytes), begin(Bytes) + Length);
-
-      switch (Bytes[0]) {
+      switch (Data.GetHeader()) {
         case GameProtocol::Magic::W3GS_HEADER:
-          if (Bytes[1] == GameProtocol::Magic::REQJOIN) {
+          if (Data.GetID() == GameProtocol::Magic::REQJOIN) {
             CIncomingJoinRequest joinRequest = GameProtocol::RECEIVE_W3GS_REQJOIN(Data);
             if (!joinRequest.GetIsValid()) {
-              DPRINT_IF(LogLevel::kTrace2, "[AURA] Got invalid REQJOIN <" + ByteArrayToDecString(Bytes) + ">")
+              DPRINT_IF(LogLevel::kTrace2, "[AURA] Got invalid REQJOIN <" + ByteArrayToDecString(Data.ToVector()) + ">")
               Abort = true;
               break;
             }
@@ -165,7 +150,7 @@ uint8_t CConnection::Update(fd_set* fd, fd_set* send_fd, int64_t timeout)
               m_Type = INCON_TYPE_OBSERVER;
             }
             Abort = true;
-          } else if (GameProtocol::Magic::SEARCHGAME <= Bytes[1] && Bytes[1] <= GameProtocol::Magic::DECREATEGAME) {
+          } else if (GameProtocol::Magic::SEARCHGAME <= Data.GetID() && Data.GetID() <= GameProtocol::Magic::DECREATEGAME) {
             if (Length > 1024) {
               Abort = true;
               break;
@@ -173,7 +158,7 @@ uint8_t CConnection::Update(fd_set* fd, fd_set* send_fd, int64_t timeout)
             struct UDPPkt pkt;
             pkt.socket = m_Socket;
             pkt.sender = &(m_Socket->m_RemoteHost);
-            memcpy(pkt.buf, Bytes.data(), Length);
+            memcpy(pkt.buf, Data.data(), Length);
             pkt.length = Length;
             m_Aura->m_Net.HandleUDP(&pkt);
           } else {
@@ -183,14 +168,14 @@ uint8_t CConnection::Update(fd_set* fd, fd_set* send_fd, int64_t timeout)
           break;
 
         case GPSProtocol::Magic::GPS_HEADER: {
-          if (Length >= 13 && Bytes[1] == GPSProtocol::Magic::RECONNECT && m_Type == INCON_TYPE_NONE && m_Aura->m_Net.m_Config.m_ProxyReconnect > 0) {
-            const uint32_t reconnectKey = ByteArrayToUInt32(Bytes, false, 5);
-            const uint32_t lastPacket = ByteArrayToUInt32(Bytes, false, 9);
+          if (Length >= 13 && Data.GetID() == GPSProtocol::Magic::RECONNECT && m_Type == INCON_TYPE_NONE && m_Aura->m_Net.m_Config.m_ProxyReconnect > 0) {
+            const uint32_t reconnectKey = Data.GetUInt32(5);
+            const uint32_t lastPacket = Data.GetUInt32(9);
             GameUser::CGameUser* targetUser = nullptr;
             if (Length >= 17) {
-              targetUser = m_Aura->m_Net.GetReconnectTargetUser(ByteArrayToUInt32(Bytes, false, 13), Bytes[4]);
+              targetUser = m_Aura->m_Net.GetReconnectTargetUser(Data.GetUInt32(13), Data[4]);
             } else {
-              targetUser = m_Aura->m_Net.GetReconnectTargetUserLegacy(Bytes[4], reconnectKey);
+              targetUser = m_Aura->m_Net.GetReconnectTargetUserLegacy(Data[4], reconnectKey);
             }
             if (!targetUser || targetUser->GetGProxyReconnectKey() != reconnectKey) {
               m_Socket->PutBytes(GPSProtocol::SEND_GPSS_REJECT(targetUser == nullptr ? REJECTGPS_NOTFOUND : REJECTGPS_INVALID));
@@ -202,7 +187,7 @@ uint8_t CConnection::Update(fd_set* fd, fd_set* send_fd, int64_t timeout)
               result = INCON_UPDATE_RECONNECTED;
               Abort = true;
             }          
-          } else if (Length >= 4 && Bytes[1] == GPSProtocol::Magic::UDPSYN && m_Aura->m_Net.m_Config.m_EnableTCPWrapUDP) {
+          } else if (Length >= 4 && Data.GetID() == GPSProtocol::Magic::UDPSYN && m_Aura->m_Net.m_Config.m_EnableTCPWrapUDP) {
             // in-house extension
             m_Aura->m_Net.RegisterGameSeeker(this, INCON_TYPE_UDP_TUNNEL);
             result = INCON_UPDATE_PROMOTED;
@@ -234,15 +219,17 @@ uint8_t CConnection::Update(fd_set* fd, fd_set* send_fd, int64_t timeout)
         // Process no more packets
         break;
       }
+    }
 
-      Bytes = std::vector<uint8_t>(begin(Bytes) + Length, end(Bytes));
+    if (Framer.GetIsMalformed()) {
+      Abort = true;
     }
 
     if (Abort && result != INCON_UPDATE_PROMOTED && result != INCON_UPDATE_PROMOTED_PASSTHROUGH && result != INCON_UPDATE_RECONNECTED) {
       result = INCON_UPDATE_DESTROY;
-      RecvBuffer->clear();
+      RecvBuffer->Clear();
     } else if (LengthProcessed > 0) {
-      *RecvBuffer = RecvBuffer->substr(LengthProcessed);
+      RecvBuffer->Consume(LengthProcessed);
     }
   } else if (Ticks - m_Socket->GetLastRecv() >= timeout) {
     return INCON_UPDATE_DESTROY;
@@ -263,7 +250,7 @@ uint8_t CConnection::Update(fd_set* fd, fd_set* send_fd, int64_t timeout)
     return INCON_UPDATE_DESTROY;
   }
 
-  m_Socket->DoSend(send_fd);
+  m_Socket->DoSend();
 
   if (m_Type == INCON_TYPE_KICKED_PLAYER && !m_Socket->GetIsSendPending()) {
     return INCON_UPDATE_DESTROY;
@@ -278,3 +265,18 @@ void CConnection::Send(const std::vector<uint8_t>& data)
     m_Socket->PutBytes(data);
   }
 }
+
+void CConnection::Send(const SharedPacket& packet)
+{
+  if (m_Socket && !m_Socket->HasError()) {
+    m_Socket->PutPacket(packet);
+  }
+}
+
+void CConnection::SendWithPayload(const std::vector<uint8_t>& header, const SharedPacket& payload, const size_t offset, const size_t size)
+{
+  if (m_Socket && !m_Socket->HasError()) {
+    m_Socket->PutBytes(header);
+    m_Socket->PutSlice(payload, offset, size);
+  }
+}
@@ -28,6 +28,7 @@
 
 #include "includes.h"
 #include "socket.h"
+#include "protocol/packet_view.h"
 
 //
 // CConnection
@@ -66,15 +67,17 @@ public:
 
   // processing functions
 
-  uint32_t SetFD(fd_set* fd, fd_set* send_fd, int32_t* nfds) const;
   void SetTimeout(const int64_t nTicks);
 
   bool CloseConnection();
-  [[nodiscard]] uint8_t Update(fd_set* fd, fd_set* send_fd, int64_t timeout);
+  [[nodiscard]] uint8_t Update(int64_t timeout);
 
   // other functions
 
   virtual void Send(const std::vector<uint8_t>& data);
+  virtual void Send(const SharedPacket& packet);
+  // Sends a packet whose header is built on the fly, but whose payload is a slice of a shared buffer (e.g. map parts)
+  virtual void SendWithPayload(const std::vector<uint8_t>& header, const SharedPacket& payload, const size_t offset, const size_t size);
 };
 
 #endif // AURA_CONNECTION_H_
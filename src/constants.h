@@ -193,6 +193,20 @@ constexpr uint8_t PARSER_BOOLEAN_ALLOW_ALL = PARSER_BOOLEAN_ALLOW_ENABLE | PARSE
 constexpr size_t FILE_SEARCH_FUZZY_MAX_RESULTS = 5;
 constexpr std::string::size_type FILE_SEARCH_FUZZY_MAX_DISTANCE = 10;
 
+// geo_index.h
+
+// Bump whenever the snapshot layout changes, so that stale snapshots are rebuilt from the CSV.
+constexpr uint32_t GEO_INDEX_SNAPSHOT_VERSION = 1u;
+constexpr size_t GEO_INDEX_SNAPSHOT_HEADER_SIZE = 28u;
+constexpr size_t GEO_INDEX_MAX_SOURCE_SIZE = 0x8000000u; // 128 MB
+constexpr uint16_t GEO_INDEX_COUNTRY_UNKNOWN = 0x3F3Fu; // "??"
+
+// map_catalog.h
+
+constexpr uint32_t MAP_CATALOG_VERSION = 1u;
+constexpr size_t MAP_CATALOG_MAX_SIZE = 0x10000000u; // 256 MB
+constexpr int64_t MAP_CATALOG_SAVE_DELAY = 60000; // ms - batches catalog updates from maps hosted in a row
+
 // map.h
 
 constexpr uint32_t MAX_MAP_SIZE_1_23 = 0x400000;
@@ -346,6 +360,7 @@ enum class MapFeatureToggle : uint8_t {
 // Load map fragments in memory max 8 MB at a time.
 constexpr uint32_t MAP_FILE_MAX_CHUNK_SIZE = 0x800000;
 // May also choose a chunk size different from the max cache chunk size.
+// Hashing keeps two of these blocks in memory, one being read while the other one is hashed.
 constexpr uint32_t MAP_FILE_PROCESSING_CHUNK_SIZE = 0x800000;
 
 constexpr uint8_t MAP_CONFIG_SCHEMA_NUMBER = 5;
@@ -531,6 +546,7 @@ constexpr uint8_t PING_EQUALIZER_DEFAULT_FRAMES = 7u;
 
 // 10 players x 150 APM x (1 min / 60000 ms) x (100 ms latency) = 2.5
 constexpr size_t DEFAULT_ACTIONS_PER_FRAME = 3u;
+constexpr size_t DEFAULT_ACTION_FRAME_ENCODED_SIZE = 256u;
 
 constexpr uint8_t SYNCHRONIZATION_CHECK_MIN_FRAMES = 5u;
 
@@ -547,6 +563,8 @@ constexpr uint8_t GAME_FRAME_TYPE_LEAVER = 2u;
 constexpr uint8_t GAME_FRAME_TYPE_CHAT = 3u;
 constexpr uint8_t GAME_FRAME_TYPE_LATENCY = 4u;
 constexpr uint8_t GAME_FRAME_TYPE_GPROXY = 5u;
+constexpr uint8_t GAME_FRAME_TYPE_PENDING = 254u; // being read back from the spill file, try again later
+constexpr uint8_t GAME_FRAME_TYPE_MISSING = 255u; // could not be read back from the spill file
 
 enum class GameFrameType : uint8_t {
   kActions = 0,
@@ -782,6 +800,9 @@ constexpr int64_t GAME_USER_UNVERIFIED_KICK_TICKS = 60000;
 constexpr int64_t AUTO_REALM_VERIFY_LATENCY = 5000;
 constexpr int64_t CHECK_STATUS_LATENCY = 5000;
 constexpr int64_t READY_REMINDER_PERIOD = 20000;
+constexpr int64_t READY_REMINDER_RETRY_PERIOD = 5000;
+constexpr int64_t AUTO_START_RETRY_PERIOD = 1000;
+constexpr int64_t LOBBY_TIMEOUT_RETRY_PERIOD = 1000;
 
 constexpr int64_t SYSTEM_RTT_POLLING_PERIOD = 10000;
 
@@ -822,6 +843,9 @@ enum class AsyncObserver : uint8_t {
   LAST = 3,
 };
 
+constexpr size_t ASYNC_OBSERVER_SEEK_MAX_PENDING_BYTES = 262144u;
+constexpr int64_t ASYNC_OBSERVER_SEEK_POLL_TICKS = 20;
+
 // game_setup.h
 
 constexpr uint8_t SEARCH_TYPE_ONLY_MAP = 1;
@@ -883,6 +907,9 @@ enum class MapOnready : uint8_t {
 };
 
 constexpr int64_t SUGGESTIONS_TIMEOUT = 3000;
+
+// Interrupted map downloads are resumed from where they stopped, up to this many times per request.
+constexpr uint8_t MAP_DOWNLOAD_MAX_ATTEMPTS = 4;
 constexpr int64_t GAMESETUP_STALE_TICKS = 180000;
 
 // game_protocol.h
@@ -1132,6 +1159,9 @@ enum class LogGameChat : uint8_t {
   LAST = 3,
 };
 
+constexpr uint8_t LOG_FORMAT_TEXT = 0u;
+constexpr uint8_t LOG_FORMAT_BINARY = 1u;
+
 constexpr uint8_t LOG_REMOTE_MODE_NONE = 0u;
 constexpr uint8_t LOG_REMOTE_MODE_FILE = 1u;
 constexpr uint8_t LOG_REMOTE_MODE_NETWORK = 2u;
@@ -1426,6 +1456,91 @@ enum class CommandPermissions : uint8_t {
   LAST = 12,
 };
 
+// socket.h
+
+// Edge-triggered pollers won't notify again until a socket is drained,
+// but a single busy socket shouldn't starve the whole loop turn either.
+constexpr size_t SOCKET_RECV_BUFFER_SIZE = 4096u;
+constexpr size_t SOCKET_RECV_MAX_BYTES_PER_UPDATE = 65536u;
+constexpr uint16_t SOCKET_ACCEPT_MAX_PER_UPDATE = 64u;
+
+// Listening sockets that run out of descriptors or buffers stop polling for this long.
+constexpr int64_t SOCKET_POLL_RESUME_TICKS = 250;
+
+// Each DoSend() call gathers at most this many queued slices into a single writev-style call.
+// Shared payloads smaller than the copy threshold are staged instead, since a copy is cheaper than an extra slice.
+constexpr size_t SOCKET_SEND_MAX_SLICES = 64u;
+constexpr size_t SOCKET_SEND_COPY_THRESHOLD = 128u;
+
+// socket_poller.h
+
+constexpr int SOCKET_POLLER_MAX_EVENTS = 256;
+
+// log_writer.h
+
+// Queued lines are written at least this often, even if the writer isn't woken up.
+constexpr int64_t LOG_WRITER_FLUSH_INTERVAL_MS = 1000;
+// Past this many queued lines, producers wake up the writer right away.
+constexpr size_t LOG_WRITER_WAKE_THRESHOLD = 256u;
+
+// dns_resolver.h
+
+// getaddrinfo() doesn't report record TTLs, so cached answers expire after a fixed time.
+constexpr uint8_t DNS_RESOLVER_MAX_THREADS = 2u;
+constexpr int64_t DNS_CACHE_TTL_TICKS = 300000;
+constexpr int64_t DNS_NEGATIVE_CACHE_TTL_TICKS = 30000;
+constexpr int64_t DNS_RESOLVER_POLL_TICKS = 20;
+
+// db_writer.h
+
+constexpr int32_t DB_WRITER_BUSY_TIMEOUT = 5000;
+constexpr int32_t DB_MAIN_BUSY_TIMEOUT = 250;
+
+// map_upload_scheduler.h
+
+constexpr uint32_t MAP_PART_SIZE = 1442u;
+constexpr uint32_t MAP_UPLOAD_QUANTUM = MAP_PART_SIZE * 4u;
+constexpr uint8_t MAP_UPLOAD_WEIGHT_PLAYER = 4u;
+constexpr uint8_t MAP_UPLOAD_WEIGHT_OBSERVER = 1u;
+// Map parts queued ahead of lobby traffic should be delivered within this many milliseconds.
+constexpr uint32_t MAP_UPLOAD_TARGET_QUEUE_DELAY = 200u;
+// Assumed until TCP reports a round-trip time (e.g. on Windows.)
+constexpr uint32_t MAP_UPLOAD_DEFAULT_RTT = 150u;
+constexpr uint32_t MAP_UPLOAD_INITIAL_WINDOW = MAP_PART_SIZE * 32u;
+constexpr uint32_t MAP_UPLOAD_MIN_WINDOW = MAP_PART_SIZE * 4u;
+constexpr uint64_t MAP_UPLOAD_WINDOW_GAIN_PERCENT = 125u;
+constexpr int64_t MAP_UPLOAD_ACK_RATE_INTERVAL = 100;
+
+// game_frame_log.h
+
+constexpr size_t GAME_FRAME_SEGMENT_SIZE = 65536u;
+constexpr size_t GAME_FRAME_CHECKPOINT_INTERVAL = 256u;
+constexpr size_t GAME_FRAME_MAX_RESIDENT_BYTES = 16777216u;
+constexpr int64_t GAME_FRAME_LOAD_POLL_TICKS = 20;
+
+// replay_writer.h
+
+constexpr uint32_t REPLAY_HEADER_SIZE = 68u;
+constexpr size_t REPLAY_BLOCK_SIZE = 8192u;
+// zlib may grow incompressible input by 0.1% plus 12 bytes
+constexpr size_t REPLAY_BLOCK_COMPRESS_BOUND = 8213u;
+constexpr uint16_t REPLAY_FLAGS_MULTIPLAYER = 0x8000u;
+constexpr uint32_t REPLAY_LANGUAGE_ID = 0x0018F8B0u;
+
+constexpr uint8_t REPLAY_BLOCK_LEAVE_GAME = 0x17u;
+constexpr uint8_t REPLAY_BLOCK_PLAYER_RECORD = 0x16u;
+constexpr uint8_t REPLAY_BLOCK_GAME_START_RECORD = 0x19u;
+constexpr uint8_t REPLAY_BLOCK_FIRST_START = 0x1Au;
+constexpr uint8_t REPLAY_BLOCK_SECOND_START = 0x1Bu;
+constexpr uint8_t REPLAY_BLOCK_THIRD_START = 0x1Cu;
+constexpr uint8_t REPLAY_BLOCK_TIME_SLOT = 0x1Fu;
+constexpr uint8_t REPLAY_BLOCK_CHAT = 0x20u;
+
+// stream_buffer.h
+
+constexpr size_t STREAM_BUFFER_MIN_CAPACITY = 4096u;
+constexpr size_t STREAM_BUFFER_MAX_IDLE_CAPACITY = 65536u;
+
 // net.h
 
 constexpr uint8_t CONNECTION_TYPE_DEFAULT = 0;
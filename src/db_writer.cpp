@@ -0,0 +1,185 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#include "db_writer.h"
+#include "auradb.h"
+
+using namespace std;
+
+//
+// CDBWriter
+//
+
+CDBWriter::Batch::Batch(string nDescription, const bool nLogErrors)
+  : m_Description(std::move(nDescription)),
+    m_LogErrors(nLogErrors)
+{
+}
+
+CDBWriter::Batch::~Batch() = default;
+
+CDBWriter::CDBWriter()
+  : m_DB(nullptr),
+    m_OwnsDB(false),
+    m_StmtCache(STMT_CACHE_SIZE, nullptr),
+    m_Running(0),
+    m_Exiting(false),
+    m_LogErrors(true)
+{
+}
+
+CDBWriter::~CDBWriter()
+{
+  Close();
+}
+
+bool CDBWriter::Open(const filesystem::path& filePath, const vector<string>& pragmas)
+{
+  CSQLITE3* db = new CSQLITE3(filePath);
+  if (!db->GetReady()) {
+    delete db;
+    return false;
+  }
+  // the main connection may be writing as well
+  db->SetBusyTimeout(DB_WRITER_BUSY_TIMEOUT);
+  for (const auto& pragma : pragmas) {
+    db->Exec(pragma);
+  }
+  m_DB = db;
+  m_OwnsDB = true;
+  m_Worker = thread(&CDBWriter::RunWorker, this);
+  return true;
+}
+
+void CDBWriter::OpenInline(CSQLITE3* mainDB)
+{
+  m_DB = mainDB;
+  m_OwnsDB = false;
+}
+
+bool CDBWriter::GetHasPending()
+{
+  lock_guard<mutex> lock(m_Mutex);
+  return !m_Queue.empty() || m_Running > 0;
+}
+
+sqlite3_stmt* CDBWriter::GetCachedStatement(const uint8_t index, const char* query)
+{
+  if (!m_StmtCache[index]) {
+    m_DB->Prepare(query, &(m_StmtCache[index]), true);
+  }
+  return m_StmtCache[index];
+}
+
+void CDBWriter::Submit(Batch&& batch)
+{
+  if (!m_DB) return;
+  if (!GetIsAsync()) {
+    RunBatch(batch);
+    return;
+  }
+  {
+    lock_guard<mutex> lock(m_Mutex);
+    m_Queue.push_back(std::move(batch));
+  }
+  m_WakeUp.notify_one();
+}
+
+void CDBWriter::Flush()
+{
+  if (!GetIsAsync()) return;
+  unique_lock<mutex> lock(m_Mutex);
+  m_Drained.wait(lock, [this] { return m_Queue.empty() && m_Running == 0; });
+}
+
+void CDBWriter::Close()
+{
+  if (GetIsAsync()) {
+    {
+      lock_guard<mutex> lock(m_Mutex);
+      m_Exiting = true;
+    }
+    m_WakeUp.notify_one();
+    m_Worker.join();
+  }
+  ClearStatements();
+  if (m_OwnsDB) {
+    delete m_DB;
+  }
+  m_DB = nullptr;
+  m_OwnsDB = false;
+}
+
+void CDBWriter::ClearStatements()
+{
+  for (auto& statement : m_StmtCache) {
+    if (statement) {
+      m_DB->Finalize(statement);
+      statement = nullptr;
+    }
+  }
+}
+
+void CDBWriter::RunBatch(Batch& batch)
+{
+  m_LogErrors = batch.m_LogErrors;
+  if (m_DB->Exec("BEGIN TRANSACTION") != SQLITE_OK) {
+    if (m_LogErrors) Print("[SQLITE3] failed to begin transaction for " + batch.m_Description + " - " + m_DB->GetError());
+    return;
+  }
+  size_t failedCount = 0;
+  for (auto& job : batch.m_Jobs) {
+    if (!job(*this)) ++failedCount;
+  }
+  if (m_DB->Exec("COMMIT TRANSACTION") != SQLITE_OK) {
+    if (m_LogErrors) Print("[SQLITE3] failed to commit " + batch.m_Description + " - " + m_DB->GetError());
+    m_DB->Exec("ROLLBACK TRANSACTION");
+    return;
+  }
+  if (failedCount > 0 && m_LogErrors) {
+    Print("[SQLITE3] " + to_string(failedCount) + " of " + to_string(batch.m_Jobs.size()) + " writes failed for " + batch.m_Description);
+  }
+}
+
+void CDBWriter::RunWorker()
+{
+  while (true) {
+    optional<Batch> batch;
+    {
+      unique_lock<mutex> lock(m_Mutex);
+      m_WakeUp.wait(lock, [this] { return m_Exiting || !m_Queue.empty(); });
+      if (m_Queue.empty()) break;
+      batch.emplace(std::move(m_Queue.front()));
+      m_Queue.pop_front();
+      ++m_Running;
+    }
+    RunBatch(batch.value());
+    {
+      lock_guard<mutex> lock(m_Mutex);
+      --m_Running;
+    }
+    m_Drained.notify_all();
+  }
+}
@@ -0,0 +1,100 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#ifndef AURA_DB_WRITER_H_
+#define AURA_DB_WRITER_H_
+
+#include "includes.h"
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+#include <sqlite3/sqlite3.h>
+
+//
+// CDBWriter
+//
+// Write-behind queue for the database.
+//
+// Writes are submitted as batches, which a background thread runs in order, each one in a single transaction,
+// through a connection of its own. The main loop keeps its connection for reads and occasional writes,
+// and never waits for the disk to sync whatever games record when they load or end.
+//
+// If the second connection cannot be opened, batches run synchronously on the main connection instead.
+//
+
+class CDBWriter
+{
+public:
+  typedef std::function<bool(CDBWriter& writer)> Job;
+
+  struct Batch
+  {
+    std::string                                 m_Description;
+    std::vector<Job>                            m_Jobs;
+    bool                                        m_LogErrors;            // read on the main thread, which owns the log level
+
+    Batch(std::string nDescription, const bool nLogErrors);
+    ~Batch();
+  };
+
+  CSQLITE3*                                     m_DB;
+  bool                                          m_OwnsDB;
+  std::vector<sqlite3_stmt*>                    m_StmtCache;
+  std::thread                                   m_Worker;
+  std::mutex                                    m_Mutex;
+  std::condition_variable                       m_WakeUp;
+  std::condition_variable                       m_Drained;
+  std::deque<Batch>                             m_Queue;
+  size_t                                        m_Running;              // batches popped but not yet committed
+  bool                                          m_Exiting;
+  bool                                          m_LogErrors;            // of the batch being run
+
+  CDBWriter();
+  ~CDBWriter();
+  CDBWriter(CDBWriter&) = delete;
+
+  [[nodiscard]] inline CSQLITE3*                GetDB() { return m_DB; }
+  [[nodiscard]] inline bool                     GetIsAsync() const { return m_Worker.joinable(); }
+  [[nodiscard]] inline bool                     GetLogErrors() const { return m_LogErrors; }
+  [[nodiscard]] bool                            GetHasPending();
+  [[nodiscard]] sqlite3_stmt*                   GetCachedStatement(const uint8_t index, const char* query);
+
+  [[nodiscard]] bool                            Open(const std::filesystem::path& filePath, const std::vector<std::string>& pragmas);
+  void                                          OpenInline(CSQLITE3* mainDB);
+  void                                          Submit(Batch&& batch);
+  void                                          Flush();
+  void                                          Close();
+
+private:
+  void                                          RunBatch(Batch& batch);
+  void                                          RunWorker();
+  void                                          ClearStatements();
+};
+
+#endif // AURA_DB_WRITER_H_
@@ -0,0 +1,210 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#include "dns_resolver.h"
+#include "util.h"
+
+#include <thread>
+
+using namespace std;
+
+//
+// CDNSResolver::SharedState
+//
+
+CDNSResolver::SharedState::SharedState()
+ : m_Stopping(false)
+{
+}
+
+CDNSResolver::SharedState::~SharedState()
+{
+}
+
+//
+// CDNSResolver
+//
+
+CDNSResolver::CDNSResolver()
+ : CDNSResolver(&CDNSResolver::ResolveBlocking)
+{
+}
+
+CDNSResolver::CDNSResolver(DNSResolveFunction resolveFunction)
+ : m_ResolveFunction(move(resolveFunction)),
+   m_State(make_shared<SharedState>()),
+   m_ThreadCount(0)
+{
+}
+
+CDNSResolver::~CDNSResolver()
+{
+  // workers are detached, so that a stuck getaddrinfo() call doesn't delay shutdown
+  lock_guard<mutex> lock(m_State->m_Mutex);
+  m_State->m_Stopping = true;
+  m_State->m_Ready.notify_all();
+}
+
+DNSStatus CDNSResolver::Lookup(const string& hostName, const int family, sockaddr_storage& address)
+{
+  const QueryKey key = make_pair(family, hostName);
+  auto cacheIt = m_Cache.find(key);
+  if (cacheIt != m_Cache.end()) {
+    if (GetTicks() < cacheIt->second.expiresTicks) {
+      if (!cacheIt->second.address.has_value()) {
+        return DNSStatus::kFailed;
+      }
+      memcpy(&address, &(cacheIt->second.address.value()), sizeof(sockaddr_storage));
+      return DNSStatus::kResolved;
+    }
+    m_Cache.erase(cacheIt);
+  }
+
+  if (m_Pending.find(key) == m_Pending.end()) {
+    m_Pending[key];
+    Enqueue(key);
+  }
+  return DNSStatus::kPending;
+}
+
+void CDNSResolver::Query(const string& hostName, const int family, DNSCallback callback)
+{
+  sockaddr_storage address;
+  switch (Lookup(hostName, family, address)) {
+    case DNSStatus::kResolved:
+      callback(address);
+      break;
+    case DNSStatus::kFailed:
+      callback(nullopt);
+      break;
+    case DNSStatus::kPending:
+      m_Pending[make_pair(family, hostName)].push_back(move(callback));
+      break;
+  }
+}
+
+void CDNSResolver::Update()
+{
+  if (m_Pending.empty()) {
+    return;
+  }
+
+  vector<pair<QueryKey, DNSQueryResult>> completed;
+  {
+    lock_guard<mutex> lock(m_State->m_Mutex);
+    completed.swap(m_State->m_Completed);
+  }
+
+  const int64_t ticks = GetTicks();
+  for (auto& entry : completed) {
+    const QueryKey& key = entry.first;
+    DNSQueryResult& result = entry.second;
+    if (!result.address.has_value()) {
+      Print("[DNS] cannot resolve address for " + key.second + " - " + result.error);
+      Print("[DNS] warning - check your Internet connection");
+    }
+    m_Cache[key] = DNSCacheEntry{result.address, ticks + (result.address.has_value() ? DNS_CACHE_TTL_TICKS : DNS_NEGATIVE_CACHE_TTL_TICKS)};
+
+    auto pendingIt = m_Pending.find(key);
+    if (pendingIt == m_Pending.end()) {
+      // a key is only enqueued while it has no pending entry, so this just guards against a duplicate result
+      continue;
+    }
+    vector<DNSCallback> callbacks = move(pendingIt->second);
+    m_Pending.erase(pendingIt);
+    for (auto& callback : callbacks) {
+      callback(result.address);
+    }
+  }
+}
+
+void CDNSResolver::Flush()
+{
+  // queries in flight are kept, their callbacks still run, and their results are cached when they complete
+  m_Cache.clear();
+}
+
+void CDNSResolver::Enqueue(const QueryKey& key)
+{
+  {
+    lock_guard<mutex> lock(m_State->m_Mutex);
+    m_State->m_Requests.push(key);
+  }
+  if (m_ThreadCount < DNS_RESOLVER_MAX_THREADS && m_ThreadCount < m_Pending.size()) {
+    thread(&CDNSResolver::RunWorker, m_State, m_ResolveFunction).detach();
+    ++m_ThreadCount;
+  }
+  m_State->m_Ready.notify_one();
+}
+
+void CDNSResolver::RunWorker(shared_ptr<SharedState> state, DNSResolveFunction resolveFunction)
+{
+  unique_lock<mutex> lock(state->m_Mutex);
+  while (true) {
+    state->m_Ready.wait(lock, [&state]() { return state->m_Stopping || !state->m_Requests.empty(); });
+    if (state->m_Stopping) {
+      return;
+    }
+    QueryKey key = state->m_Requests.front();
+    state->m_Requests.pop();
+    lock.unlock();
+    DNSQueryResult result = resolveFunction(key.second, key.first);
+    lock.lock();
+    state->m_Completed.emplace_back(move(key), move(result));
+  }
+}
+
+DNSQueryResult CDNSResolver::ResolveBlocking(const string& hostName, const int family)
+{
+  DNSQueryResult result;
+  struct addrinfo hints, *p;
+  int status;
+
+  memset(&hints, 0, sizeof hints);
+  hints.ai_family = family;
+  hints.ai_socktype = SOCK_STREAM;
+
+  if ((status = getaddrinfo(hostName.c_str(), nullptr, &hints, &p)) != 0) {
+#ifdef _WIN32
+    result.error = "error " + to_string(status);
+#else
+    result.error = gai_strerror(status);
+#endif
+    return result;
+  }
+
+  if (p == nullptr) {
+    result.error = "no addresses found";
+    return result;
+  }
+
+  sockaddr_storage address;
+  memset(&address, 0, sizeof(sockaddr_storage));
+  memcpy(&address, p->ai_addr, p->ai_addrlen);
+  result.address = address;
+
+  freeaddrinfo(p);
+  return result;
+}
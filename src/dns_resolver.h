@@ -0,0 +1,113 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#ifndef AURA_DNS_RESOLVER_H_
+#define AURA_DNS_RESOLVER_H_
+
+#include "includes.h"
+#include "socket.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+
+//
+// CDNSResolver
+//
+// Resolves host names without blocking the main loop.
+// Lookups are handed to a small pool of worker threads running getaddrinfo(),
+// and their completions are delivered from Update(), in the main thread.
+//
+// Concurrent lookups for the same host name and family are coalesced into a single query.
+// Both successful and failed answers are cached for a while, so that unreachable hosts
+// are not queried again on every reconnect attempt.
+//
+
+enum class DNSStatus : uint8_t
+{
+  kResolved = 0u,
+  kPending = 1u,
+  kFailed = 2u,
+};
+
+struct DNSQueryResult
+{
+  std::optional<sockaddr_storage>  address;
+  std::string                      error;
+};
+
+typedef std::function<DNSQueryResult(const std::string& hostName, const int family)> DNSResolveFunction;
+typedef std::function<void(const std::optional<sockaddr_storage>& address)> DNSCallback;
+
+struct DNSCacheEntry
+{
+  std::optional<sockaddr_storage>  address;
+  int64_t                          expiresTicks;
+};
+
+class CDNSResolver
+{
+public:
+  typedef std::pair<int, std::string> QueryKey;
+
+  // shared with worker threads, which may outlive the resolver while stuck in getaddrinfo()
+  struct SharedState
+  {
+    std::mutex                                        m_Mutex;
+    std::condition_variable                           m_Ready;
+    std::queue<QueryKey>                              m_Requests;
+    std::vector<std::pair<QueryKey, DNSQueryResult>>  m_Completed;
+    bool                                              m_Stopping;
+
+    SharedState();
+    ~SharedState();
+  };
+
+  DNSResolveFunction                                  m_ResolveFunction;
+  std::shared_ptr<SharedState>                        m_State;
+  uint8_t                                             m_ThreadCount;
+  std::map<QueryKey, DNSCacheEntry>                   m_Cache;
+  std::map<QueryKey, std::vector<DNSCallback>>        m_Pending;
+
+  CDNSResolver();
+  explicit CDNSResolver(DNSResolveFunction resolveFunction);
+  ~CDNSResolver();
+  CDNSResolver(CDNSResolver&) = delete;
+
+  [[nodiscard]] inline bool       GetHasPending() const { return !m_Pending.empty(); }
+  [[nodiscard]] DNSStatus         Lookup(const std::string& hostName, const int family, sockaddr_storage& address);
+  void                            Query(const std::string& hostName, const int family, DNSCallback callback);
+  void                            Update();
+  void                            Flush();
+
+  [[nodiscard]] static DNSQueryResult ResolveBlocking(const std::string& hostName, const int family);
+
+private:
+  void                            Enqueue(const QueryKey& key);
+  static void                     RunWorker(std::shared_ptr<SharedState> state, DNSResolveFunction resolveFunction);
+};
+
+#endif // AURA_DNS_RESOLVER_H_
@@ -0,0 +1,177 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#include "edit_distance.h"
+
+using namespace std;
+
+namespace
+{
+  [[nodiscard]] inline bool GetIsDigit(const char c)
+  {
+    return '0' <= c && c <= '9';
+  }
+
+  [[nodiscard]] inline string::size_type GetSubstitutionCost(const char a, const char b)
+  {
+    if (a == b) return 0;
+    return (GetIsDigit(a) || GetIsDigit(b)) ? 3 : 1;
+  }
+}
+
+//
+// CEditDistancePattern
+//
+
+CEditDistancePattern::CEditDistancePattern(string nPattern)
+  : m_Pattern(move(nPattern)),
+    m_CharRows({}),
+    m_DigitRows(0),
+    m_IsBitParallel(m_Pattern.size() <= 64)
+{
+  if (!m_IsBitParallel) return;
+  for (size_t i = 0; i < m_Pattern.size(); ++i) {
+    m_CharRows[static_cast<uint8_t>(m_Pattern[i])] |= static_cast<uint64_t>(1) << i;
+    if (GetIsDigit(m_Pattern[i])) {
+      m_DigitRows |= static_cast<uint64_t>(1) << i;
+    }
+  }
+}
+
+CEditDistancePattern::~CEditDistancePattern() = default;
+
+string::size_type CEditDistancePattern::GetDistance(const string& text, const string::size_type maxDistance) const
+{
+  const size_t m = m_Pattern.size();
+  const size_t n = text.size();
+  const size_t lengthGap = m > n ? m - n : n - m;
+  if (lengthGap > maxDistance || m == 0 || n == 0) {
+    return lengthGap;
+  }
+  if (!m_IsBitParallel) {
+    return GetBandedEditDistance(m_Pattern, text, maxDistance);
+  }
+
+  // Each column of the table is encoded as its vertical deltas, in the bit vectors vp (+1) and vn (-1).
+  // hp and hn hold the horizontal deltas between consecutive columns.
+  const uint64_t lastRow = static_cast<uint64_t>(1) << (m - 1);
+  uint64_t vp = ~static_cast<uint64_t>(0);
+  uint64_t vn = 0;
+  string::size_type score = m;
+
+  for (size_t j = 0; j < n; ++j) {
+    const char c = text[j];
+    const uint64_t eq = m_CharRows[static_cast<uint8_t>(c)];
+    const uint64_t noSubstitution = ~eq & (GetIsDigit(c) ? ~static_cast<uint64_t>(0) : m_DigitRows);
+    const uint64_t xv = eq | vn;
+    const uint64_t xh = (((eq & vp) + vp) ^ vp) | eq;
+    const uint64_t hn = vp & xh;
+
+    // Where substitutions are not worth it, a +1 horizontal delta carries over to the next row,
+    // as long as the vertical delta is also +1. Resolve that chain with a single addition.
+    const uint64_t generate = vn | ~(xh | vp);
+    const uint64_t propagate = vp & noSubstitution;
+    const uint64_t carries = ((generate | propagate) + generate + 1) ^ propagate;
+    const uint64_t hp = generate | (propagate & carries);
+
+    if (hp & lastRow) {
+      ++score;
+    } else if (hn & lastRow) {
+      --score;
+    }
+
+    const uint64_t hpShifted = (hp << 1) | 1;
+    const uint64_t hnShifted = hn << 1;
+    vp = hnShifted | ~(xv | hpShifted) | (hpShifted & propagate);
+    vn = hpShifted & xv;
+
+    // Each remaining column lowers the score by 1 at most.
+    const size_t remaining = n - j - 1;
+    if (score > maxDistance + remaining) {
+      return score - remaining;
+    }
+  }
+
+  return score;
+}
+
+optional<pair<size_t, string::size_type>> CEditDistancePattern::FindClosest(const vector<string>& candidates, const string::size_type maxDistance) const
+{
+  optional<pair<size_t, string::size_type>> result;
+  string::size_type cutoff = maxDistance;
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    string::size_type distance = GetDistance(candidates[i], cutoff);
+    if (distance > cutoff) continue;
+    result = make_pair(i, distance);
+    if (distance == 0) break;
+    // Ties keep the first candidate found.
+    cutoff = distance - 1;
+  }
+  return result;
+}
+
+string::size_type GetBandedEditDistance(const string& s1, const string& s2, const string::size_type maxDistance)
+{
+  const size_t m = s1.size();
+  const size_t n = s2.size();
+  const size_t lengthGap = m > n ? m - n : n - m;
+  if (lengthGap > maxDistance) {
+    return lengthGap;
+  }
+
+  // Cells farther than maxDistance from the diagonal are never within maxDistance.
+  const string::size_type band = min(maxDistance, m + n);
+  const string::size_type cap = band + 1;
+  vector<string::size_type> previous(n + 1);
+  vector<string::size_type> current(n + 1, cap);
+  for (size_t j = 0; j <= n; ++j) {
+    previous[j] = min(j, cap);
+  }
+
+  for (size_t i = 1; i <= m; ++i) {
+    const size_t from = i > band ? i - band : 1;
+    const size_t to = min(n, i + band);
+    current[from - 1] = from == 1 ? min(i, cap) : cap;
+    string::size_type rowMin = current[from - 1];
+    for (size_t j = from; j <= to; ++j) {
+      current[j] = min({
+        previous[j - 1] + GetSubstitutionCost(s1[i - 1], s2[j - 1]),
+        previous[j] + 1,
+        current[j - 1] + 1,
+        cap
+      });
+      rowMin = min(rowMin, current[j]);
+    }
+    if (to < n) {
+      current[to + 1] = cap;
+    }
+    if (rowMin > band) {
+      return cap;
+    }
+    previous.swap(current);
+  }
+
+  return previous[n];
+}
@@ -0,0 +1,64 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#ifndef AURA_EDIT_DISTANCE_H_
+#define AURA_EDIT_DISTANCE_H_
+
+#include "includes.h"
+
+#include <optional>
+
+//
+// CEditDistancePattern
+//
+// Scores a fixed pattern against any number of strings, with the same costs as GetLevenshteinDistance:
+// insertions, deletions and substitutions cost 1, except that substitutions involving digits cost 3
+// (so that they never beat a deletion plus an insertion).
+//
+// Patterns of up to 64 characters use the bit-vector algorithm of Myers, as formulated by Hyyrö,
+// extended with a second carry chain for columns where a substitution is not worth it.
+// Longer patterns fall back to a banded dynamic programming table.
+//
+// All distances are exact up to maxDistance. Above that, any value greater than maxDistance may be returned.
+//
+
+class CEditDistancePattern
+{
+public:
+  std::string                         m_Pattern;
+  std::array<uint64_t, 256>           m_CharRows;     // bit i is set iff m_Pattern[i] is the given char
+  uint64_t                            m_DigitRows;    // bit i is set iff m_Pattern[i] is a digit
+  bool                                m_IsBitParallel;
+
+  explicit CEditDistancePattern(std::string nPattern);
+  ~CEditDistancePattern();
+
+  [[nodiscard]] std::string::size_type GetDistance(const std::string& text, const std::string::size_type maxDistance) const;
+  [[nodiscard]] std::optional<std::pair<size_t, std::string::size_type>> FindClosest(const std::vector<std::string>& candidates, const std::string::size_type maxDistance) const;
+};
+
+[[nodiscard]] std::string::size_type GetBandedEditDistance(const std::string& s1, const std::string& s2, const std::string::size_type maxDistance);
+
+#endif // AURA_EDIT_DISTANCE_H_
@@ -0,0 +1,253 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+#include "file_hash.h"
+
+#include <crc32/crc32.h>
+#include <sha1/sha1.h>
+
+#include <condition_variable>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+//
+// FileHashDigest
+//
+
+FileHashDigest::FileHashDigest()
+ : size(0),
+   crc32(0)
+{
+  sha1.fill(0);
+}
+
+//
+// CFileHashStream
+//
+
+CFileHashStream::CFileHashStream()
+ : m_Size(0),
+   m_CRC32(0)
+{
+  m_SHA1.Reset();
+}
+
+void CFileHashStream::Reset()
+{
+  m_Size = 0;
+  m_CRC32 = 0;
+  m_SHA1.Reset();
+}
+
+void CFileHashStream::Update(const uint8_t* data, const size_t size)
+{
+  if (size == 0) return;
+  m_Size += size;
+  m_CRC32 = CRC32::CalculateCRC(data, size, m_CRC32);
+  m_SHA1.Update(data, size);
+}
+
+FileHashDigest CFileHashStream::Final()
+{
+  FileHashDigest digest;
+  digest.size = m_Size;
+  digest.crc32 = m_CRC32;
+  m_SHA1.Final();
+  m_SHA1.GetHash(digest.sha1.data());
+  return digest;
+}
+
+FileHashDigest HashBufferParallel(const uint8_t* data, const size_t size)
+{
+  FileHashDigest digest;
+  digest.size = size;
+
+  // SHA-1 is several times slower than CRC32, so it stays on the calling thread
+  future<uint32_t> crc32 = async(launch::async, [data, size]() {
+    return CRC32::CalculateCRC(data, size);
+  });
+
+  CSHA1 sha1;
+  sha1.Reset();
+  sha1.Update(data, size);
+  sha1.Final();
+  sha1.GetHash(digest.sha1.data());
+
+  digest.crc32 = crc32.get();
+  return digest;
+}
+
+//
+// CSHA1Worker
+//
+// A single thread that keeps feeding blocks into a SHA-1 context for the whole file,
+// so that streaming a large file doesn't spawn threads per block.
+//
+
+class CSHA1Worker
+{
+public:
+  CSHA1&                    m_SHA1;
+  mutex                     m_Mutex;
+  condition_variable        m_Ready;
+  const uint8_t*            m_Data;
+  size_t                    m_Size;
+  bool                      m_Busy;
+  bool                      m_Exiting;
+  thread                    m_Thread;
+
+  explicit CSHA1Worker(CSHA1& sha1)
+   : m_SHA1(sha1),
+     m_Data(nullptr),
+     m_Size(0),
+     m_Busy(false),
+     m_Exiting(false),
+     m_Thread([this]() { Run(); })
+  {
+  }
+
+  ~CSHA1Worker()
+  {
+    {
+      lock_guard<mutex> lock(m_Mutex);
+      m_Exiting = true;
+    }
+    m_Ready.notify_all();
+    m_Thread.join();
+  }
+
+  CSHA1Worker(CSHA1Worker&) = delete;
+
+  // waits for the previous block to be hashed, so its buffer may be reused afterwards
+  void Wait()
+  {
+    unique_lock<mutex> lock(m_Mutex);
+    m_Ready.wait(lock, [this]() { return !m_Busy; });
+  }
+
+  void Post(const uint8_t* data, const size_t size)
+  {
+    {
+      unique_lock<mutex> lock(m_Mutex);
+      m_Ready.wait(lock, [this]() { return !m_Busy; });
+      m_Data = data;
+      m_Size = size;
+      m_Busy = true;
+    }
+    m_Ready.notify_all();
+  }
+
+private:
+  void Run()
+  {
+    unique_lock<mutex> lock(m_Mutex);
+    while (true) {
+      m_Ready.wait(lock, [this]() { return m_Busy || m_Exiting; });
+      if (!m_Busy) break;
+      lock.unlock();
+      m_SHA1.Update(m_Data, m_Size);
+      lock.lock();
+      m_Busy = false;
+      m_Ready.notify_all();
+    }
+  }
+};
+
+optional<FileHashDigest> HashFileParallel(const filesystem::path& filePath, const size_t blockSize, const size_t maxSize)
+{
+  optional<FileHashDigest> digest;
+  ifstream fileStream(filePath, ios::in | ios::binary);
+  if (!fileStream.is_open()) {
+    return digest;
+  }
+
+  // don't allocate more than the file needs - the size is only a hint, reads still go until EOF
+  error_code ec;
+  uintmax_t expectedSize = filesystem::file_size(filePath, ec);
+  size_t bufferSize = blockSize;
+  if (!ec && expectedSize < bufferSize) {
+    bufferSize = static_cast<size_t>(expectedSize) + 1;
+  }
+
+  // double buffering: one block is being hashed while the other one is filled
+  array<vector<uint8_t>, 2> blocks;
+  blocks[0].resize(bufferSize);
+
+  auto readBlock = [&fileStream](vector<uint8_t>& block) -> size_t {
+    fileStream.read(reinterpret_cast<char*>(block.data()), block.size());
+    return static_cast<size_t>(fileStream.gcount());
+  };
+
+  CSHA1 sha1;
+  sha1.Reset();
+  uint32_t crc32 = 0;
+  size_t totalSize = 0;
+  uint8_t current = 0;
+  size_t readSize = readBlock(blocks[current]);
+
+  if (readSize < bufferSize) {
+    // the whole file fits in a single block - not worth a thread
+    totalSize = readSize;
+    if (totalSize > maxSize || fileStream.bad()) {
+      return digest;
+    }
+    crc32 = CRC32::CalculateCRC(blocks[current].data(), readSize);
+    sha1.Update(blocks[current].data(), readSize);
+  } else {
+    blocks[1].resize(bufferSize);
+
+    // SHA-1 is several times slower than CRC32, so CRC32 and disk reads stay on the calling thread
+    CSHA1Worker sha1Worker(sha1);
+    while (readSize > 0) {
+      totalSize += readSize;
+      if (totalSize > maxSize) {
+        return digest;
+      }
+
+      const uint8_t* data = blocks[current].data();
+      sha1Worker.Post(data, readSize);
+      crc32 = CRC32::CalculateCRC(data, readSize, crc32);
+
+      // the worker is done with the other buffer, since Post() waited for it
+      current ^= 1;
+      readSize = readBlock(blocks[current]);
+    }
+    sha1Worker.Wait();
+
+    if (fileStream.bad()) {
+      return digest;
+    }
+  }
+
+  digest.emplace();
+  digest->size = totalSize;
+  digest->crc32 = crc32;
+  sha1.Final();
+  sha1.GetHash(digest->sha1.data());
+  return digest;
+}
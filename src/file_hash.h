@@ -0,0 +1,79 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+#ifndef AURA_FILE_HASH_H_
+#define AURA_FILE_HASH_H_
+
+#include "includes.h"
+
+#include <filesystem>
+
+#include <sha1/sha1.h>
+
+//
+// FileHashDigest
+//
+// Whole-file fingerprints, as stored in <map.file_hash.*>.
+// CRC32 and SHA-1 are independent, so SHA-1 runs on a helper thread while CRC32 runs on the caller's.
+// When streaming from disk, the next block is read while SHA-1 is still busy with the current one,
+// so that the file is only read once, and hashing overlaps with I/O. Files that fit in a single block are hashed inline.
+//
+
+struct FileHashDigest
+{
+  size_t                    size;
+  uint32_t                  crc32;
+  std::array<uint8_t, 20>   sha1;
+
+  FileHashDigest();
+  ~FileHashDigest() = default;
+};
+
+//
+// CFileHashStream
+//
+// Incremental counterpart of HashFileParallel, for data that arrives in pieces of arbitrary size
+// (e.g. from a network transfer), so that the digest is ready as soon as the last piece is fed.
+//
+
+class CFileHashStream
+{
+public:
+  size_t                    m_Size;
+  uint32_t                  m_CRC32;
+  CSHA1                     m_SHA1;
+
+  CFileHashStream();
+  ~CFileHashStream() = default;
+
+  void Reset();
+  void Update(const uint8_t* data, const size_t size);
+  [[nodiscard]] FileHashDigest Final();
+  [[nodiscard]] inline size_t GetSize() const { return m_Size; }
+};
+
+[[nodiscard]] FileHashDigest HashBufferParallel(const uint8_t* data, const size_t size);
+[[nodiscard]] std::optional<FileHashDigest> HashFileParallel(const std::filesystem::path& filePath, const size_t blockSize, const size_t maxSize);
+
+#endif // AURA_FILE_HASH_H_
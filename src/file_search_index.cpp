@@ -0,0 +1,285 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#include "file_search_index.h"
+#include "edit_distance.h"
+#include "file_util.h"
+#include "util.h"
+
+using namespace std;
+
+//
+// FileSearchEntry
+//
+
+FileSearchEntry::FileSearchEntry(string nFileName, PLATFORM_STRING_TYPE nExtension)
+  : fileName(move(nFileName)),
+    extension(move(nExtension)),
+    prefixKey(PrepareMapPatternForFuzzySearch(fileName)),
+    fuzzyKey(ToLowerCase(RemoveNonAlphanumeric(fileName)))
+{
+}
+
+FileSearchEntry::~FileSearchEntry() = default;
+
+//
+// CFileSearchIndex
+//
+
+CFileSearchIndex::CFileSearchIndex(const vector<PLATFORM_STRING_TYPE>& nExtensions)
+  : m_Extensions(nExtensions)
+{
+}
+
+CFileSearchIndex::~CFileSearchIndex() = default;
+
+void CFileSearchIndex::Clear()
+{
+  m_DirectoryModified.reset();
+  m_Entries.clear();
+  m_EntriesByLength.clear();
+  m_PrefixTrigrams.clear();
+  m_FuzzyTrigrams.clear();
+}
+
+bool CFileSearchIndex::Refresh(const filesystem::path& directory)
+{
+  optional<filesystem::file_time_type> directoryModified;
+  error_code e;
+  filesystem::file_time_type lastWriteTime = filesystem::last_write_time(directory, e);
+  if (!e) directoryModified = lastWriteTime;
+
+  if (directory == m_Directory && directoryModified.has_value() && directoryModified == m_DirectoryModified) {
+    return false;
+  }
+
+  m_Directory = directory;
+  Rebuild(FilesMatch(directory, m_Extensions));
+  m_DirectoryModified = directoryModified;
+  return true;
+}
+
+void CFileSearchIndex::Rebuild(const vector<filesystem::path>& fileNames)
+{
+  Clear();
+
+  set<filesystem::path> sortedFileNames(fileNames.begin(), fileNames.end());
+  m_Entries.reserve(sortedFileNames.size());
+  for (const auto& fileName : sortedFileNames) {
+    if (fileName.empty()) continue;
+    PLATFORM_STRING_TYPE lowerFileName = fileName.native();
+    transform(begin(lowerFileName), end(lowerFileName), begin(lowerFileName), [](auto c) { return static_cast<decltype(c)>(std::tolower(c)); });
+    m_Entries.emplace_back(PathToString(fileName), GetFileExtension(lowerFileName));
+  }
+
+  m_EntriesByLength.resize(m_Entries.size());
+  for (uint32_t i = 0; i < m_Entries.size(); ++i) {
+    m_EntriesByLength[i] = i;
+    for (const uint32_t trigram : GetTrigrams(m_Entries[i].prefixKey)) {
+      m_PrefixTrigrams[trigram].push_back(i);
+    }
+    for (const uint32_t trigram : GetTrigrams(m_Entries[i].fuzzyKey)) {
+      m_FuzzyTrigrams[trigram].push_back(i);
+    }
+  }
+  stable_sort(m_EntriesByLength.begin(), m_EntriesByLength.end(), [this](const uint32_t a, const uint32_t b) {
+    return m_Entries[a].fuzzyKey.size() < m_Entries[b].fuzzyKey.size();
+  });
+}
+
+vector<uint32_t> CFileSearchIndex::GetTrigrams(const string& key)
+{
+  // Distinct trigrams, sorted.
+  vector<uint32_t> trigrams;
+  if (key.size() < 3) return trigrams;
+  trigrams.reserve(key.size() - 2);
+  for (size_t i = 0; i + 2 < key.size(); ++i) {
+    trigrams.push_back(
+      static_cast<uint32_t>(static_cast<uint8_t>(key[i])) << 16 |
+      static_cast<uint32_t>(static_cast<uint8_t>(key[i + 1])) << 8 |
+      static_cast<uint32_t>(static_cast<uint8_t>(key[i + 2]))
+    );
+  }
+  sort(trigrams.begin(), trigrams.end());
+  trigrams.erase(unique(trigrams.begin(), trigrams.end()), trigrams.end());
+  return trigrams;
+}
+
+bool CFileSearchIndex::GetIsExtensionAllowed(const FileSearchEntry& entry, const vector<PLATFORM_STRING_TYPE>& extensions) const
+{
+  return find(extensions.begin(), extensions.end(), entry.extension) != extensions.end();
+}
+
+vector<uint32_t> CFileSearchIndex::GetPrefixCandidates(const string& fuzzyPattern) const
+{
+  // Any name containing the pattern contains every trigram of the pattern.
+  vector<uint32_t> trigrams = GetTrigrams(fuzzyPattern);
+  if (trigrams.empty()) {
+    vector<uint32_t> candidates(m_Entries.size());
+    for (uint32_t i = 0; i < m_Entries.size(); ++i) candidates[i] = i;
+    return candidates;
+  }
+
+  vector<const vector<uint32_t>*> postings;
+  postings.reserve(trigrams.size());
+  for (const uint32_t trigram : trigrams) {
+    auto match = m_PrefixTrigrams.find(trigram);
+    if (match == m_PrefixTrigrams.end()) return vector<uint32_t>();
+    postings.push_back(&match->second);
+  }
+  sort(postings.begin(), postings.end(), [](const vector<uint32_t>* a, const vector<uint32_t>* b) {
+    return a->size() < b->size();
+  });
+
+  vector<uint32_t> candidates = *postings[0];
+  vector<uint32_t> intersection;
+  for (size_t i = 1; i < postings.size() && !candidates.empty(); ++i) {
+    intersection.clear();
+    set_intersection(candidates.begin(), candidates.end(), postings[i]->begin(), postings[i]->end(), back_inserter(intersection));
+    candidates.swap(intersection);
+  }
+  return candidates;
+}
+
+vector<uint32_t> CFileSearchIndex::GetFuzzyCandidates(const string& fuzzyPattern, const string::size_type maxDistance) const
+{
+  // Only names whose length is within maxDistance of the pattern may be close enough.
+  auto lengthBegin = lower_bound(m_EntriesByLength.begin(), m_EntriesByLength.end(), fuzzyPattern.size() > maxDistance ? fuzzyPattern.size() - maxDistance : 0,
+    [this](const uint32_t index, const size_t length) { return m_Entries[index].fuzzyKey.size() < length; }
+  );
+  auto lengthEnd = upper_bound(lengthBegin, m_EntriesByLength.end(), fuzzyPattern.size() + maxDistance,
+    [this](const size_t length, const uint32_t index) { return length < m_Entries[index].fuzzyKey.size(); }
+  );
+  vector<uint32_t> candidates(lengthBegin, lengthEnd);
+
+  // Back to name order, so that ranking doesn't depend on name lengths.
+  sort(candidates.begin(), candidates.end());
+
+  // Each edit operation breaks at most 3 trigrams of the pattern,
+  // so names within maxDistance share at least (trigrams - 3 * maxDistance) of them.
+  vector<uint32_t> trigrams = GetTrigrams(fuzzyPattern);
+  if (trigrams.size() <= 3 * maxDistance) {
+    return candidates;
+  }
+  size_t minShared = trigrams.size() - 3 * maxDistance;
+  vector<uint16_t> sharedCounts(m_Entries.size(), 0);
+  for (const uint32_t trigram : trigrams) {
+    auto match = m_FuzzyTrigrams.find(trigram);
+    if (match == m_FuzzyTrigrams.end()) continue;
+    for (const uint32_t index : match->second) {
+      ++sharedCounts[index];
+    }
+  }
+  candidates.erase(remove_if(candidates.begin(), candidates.end(), [&sharedCounts, minShared](const uint32_t index) {
+    return sharedCounts[index] < minShared;
+  }), candidates.end());
+  return candidates;
+}
+
+vector<pair<string, int>> CFileSearchIndex::Search(const string& rawPattern) const
+{
+  // If the pattern has a valid extension, restrict the results to files with that extension.
+#ifdef _WIN32
+  wstring rawExtension = filesystem::path(rawPattern).wstring();
+#else
+  string rawExtension = filesystem::path(rawPattern).string();
+#endif
+  vector<PLATFORM_STRING_TYPE> extensions;
+  if (!rawExtension.empty() && find(m_Extensions.begin(), m_Extensions.end(), rawExtension) != m_Extensions.end()) {
+    extensions = vector<PLATFORM_STRING_TYPE>(1, rawExtension);
+  } else {
+    extensions = m_Extensions;
+  }
+  string fuzzyPattern = PrepareMapPatternForFuzzySearch(rawPattern);
+
+  // 1. Try files that start with the given pattern (up to digits and parens).
+  //    These have triple weight.
+  vector<pair<string, int>> inclusionMatches;
+  for (const uint32_t index : GetPrefixCandidates(fuzzyPattern)) {
+    const FileSearchEntry& entry = m_Entries[index];
+    if (!GetIsExtensionAllowed(entry, extensions)) continue;
+    size_t fuzzyPatternIndex = entry.prefixKey.find(fuzzyPattern);
+    if (fuzzyPatternIndex == string::npos) {
+      continue;
+    }
+    bool startsWithPattern = true;
+    for (uint8_t i = 0; i < fuzzyPatternIndex; ++i) {
+      if (!isdigit(entry.fileName[i]) && entry.fileName[i] != '(' && entry.fileName[i] != ')') {
+        startsWithPattern = false;
+        break;
+      }
+    }
+    if (startsWithPattern) {
+      pair<string, int> foundMatch = make_pair(entry.fileName, static_cast<int>(entry.fileName.length() - fuzzyPattern.length()));
+      auto pos = lower_bound(inclusionMatches.begin(), inclusionMatches.end(), foundMatch);
+      inclusionMatches.insert(pos, move(foundMatch));
+      if (inclusionMatches.size() >= FILE_SEARCH_FUZZY_MAX_RESULTS) {
+        break;
+      }
+    }
+  }
+  if (!inclusionMatches.empty()) {
+    return inclusionMatches;
+  }
+
+  // 2. Try fuzzy searching
+  string::size_type maxDistance = FILE_SEARCH_FUZZY_MAX_DISTANCE;
+  if (fuzzyPattern.size() < 3 * (maxDistance - 4)) {
+    // This formula approximates how PS !esdata fuzzy-matches
+    // It's my hope that it works here as well.
+    // 3->0, 4->1, 8->2
+    // 3->5, 4->5, 8->6
+    //
+    // I add approx +4 because PrepareMapPatternForFuzzySearch removes .w3m/.w3x extension
+    // In the case of 3->0, I effectively add +5, because 3->0 has always been too strict.
+    maxDistance = fuzzyPattern.size() / 3 + 4;
+  }
+
+  CEditDistancePattern distancePattern(fuzzyPattern);
+  vector<pair<string, int>> distances;
+  for (const uint32_t index : GetFuzzyCandidates(fuzzyPattern, maxDistance)) {
+    const FileSearchEntry& entry = m_Entries[index];
+    if (!GetIsExtensionAllowed(entry, extensions)) continue;
+    string::size_type distance = distancePattern.GetDistance(entry.fuzzyKey, maxDistance); // source to target
+    if (distance <= maxDistance) {
+      distances.emplace_back(entry.fileName, static_cast<int>(distance * 3));
+    }
+  }
+
+  size_t resultCount = min(FILE_SEARCH_FUZZY_MAX_RESULTS, distances.size());
+  partial_sort(
+    distances.begin(),
+    distances.begin() + resultCount,
+    distances.end(),
+    [](const pair<string, int>& a, const pair<string, int>& b) {
+        // Ties are broken by name, so that results don't depend on how partial_sort orders them.
+        if (a.second != b.second) return a.second < b.second;
+        return a.first < b.first;
+    }
+  );
+
+  vector<pair<string, int>> fuzzyMatches(distances.begin(), distances.begin() + resultCount);
+  return fuzzyMatches;
+}
@@ -0,0 +1,86 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#ifndef AURA_FILE_SEARCH_INDEX_H_
+#define AURA_FILE_SEARCH_INDEX_H_
+
+#include "includes.h"
+
+#include <filesystem>
+#include <optional>
+#include <unordered_map>
+
+//
+// CFileSearchIndex
+//
+// In-memory index over the file names of a single directory, used to fuzzy-search maps and map configs.
+// File names are normalised once, when the directory listing is (re)built, and every normalised name
+// is split into trigrams, whose posting lists shortlist candidates before any string is compared.
+//
+// The directory listing is refreshed lazily, whenever the modification time of the directory changes.
+//
+
+struct FileSearchEntry
+{
+  std::string                 fileName;
+  PLATFORM_STRING_TYPE        extension;
+  std::string                 prefixKey;  // PrepareMapPatternForFuzzySearch(fileName)
+  std::string                 fuzzyKey;   // lowercase, alphanumeric fileName
+
+  FileSearchEntry(std::string nFileName, PLATFORM_STRING_TYPE nExtension);
+  ~FileSearchEntry();
+};
+
+class CFileSearchIndex
+{
+public:
+  std::filesystem::path                               m_Directory;
+  std::vector<PLATFORM_STRING_TYPE>                   m_Extensions;
+  std::optional<std::filesystem::file_time_type>      m_DirectoryModified;
+  std::vector<FileSearchEntry>                        m_Entries;        // sorted by file name
+  std::vector<uint32_t>                               m_EntriesByLength; // sorted by fuzzyKey length
+  std::unordered_map<uint32_t, std::vector<uint32_t>> m_PrefixTrigrams;
+  std::unordered_map<uint32_t, std::vector<uint32_t>> m_FuzzyTrigrams;
+
+  CFileSearchIndex(const std::vector<PLATFORM_STRING_TYPE>& nExtensions);
+  ~CFileSearchIndex();
+  CFileSearchIndex(CFileSearchIndex&) = delete;
+
+  [[nodiscard]] inline size_t     GetSize() const { return m_Entries.size(); }
+
+  void                            Clear();
+  bool                            Refresh(const std::filesystem::path& directory);
+  void                            Rebuild(const std::vector<std::filesystem::path>& fileNames);
+  [[nodiscard]] std::vector<std::pair<std::string, int>> Search(const std::string& rawPattern) const;
+
+  [[nodiscard]] static std::vector<uint32_t> GetTrigrams(const std::string& key);
+
+private:
+  [[nodiscard]] bool              GetIsExtensionAllowed(const FileSearchEntry& entry, const std::vector<PLATFORM_STRING_TYPE>& extensions) const;
+  [[nodiscard]] std::vector<uint32_t> GetPrefixCandidates(const std::string& fuzzyPattern) const;
+  [[nodiscard]] std::vector<uint32_t> GetFuzzyCandidates(const std::string& fuzzyPattern, const std::string::size_type maxDistance) const;
+};
+
+#endif // AURA_FILE_SEARCH_INDEX_H_
@@ -44,6 +44,7 @@ CODE PORTED FROM THE ORIGINAL GHOST PROJECT
 */
 
 #include "file_util.h"
+#include "file_search_index.h"
 #include "util.h"
 
 #include <algorithm>
@@ -407,92 +408,9 @@ filesystem::path CaseInsensitiveFileExists(const filesystem::path& path, const s
 
 vector<pair<string, int>> FuzzySearchFiles(const filesystem::path& directory, const vector<PLATFORM_STRING_TYPE>& baseExtensions, const string& rawPattern)
 {
-  // If the pattern has a valid extension, restrict the results to files with that extension.
-#ifdef _WIN32
-  wstring rawExtension = filesystem::path(rawPattern).wstring();
-#else
-  string rawExtension = filesystem::path(rawPattern).string();
-#endif
-  vector<PLATFORM_STRING_TYPE> extensions;
-  if (!rawExtension.empty() && find(baseExtensions.begin(), baseExtensions.end(), rawExtension) != baseExtensions.end()) {
-    extensions = vector<PLATFORM_STRING_TYPE>(1, rawExtension);
-  } else {
-    extensions = baseExtensions;
-  }
-  string fuzzyPattern = PrepareMapPatternForFuzzySearch(rawPattern);
-  vector<filesystem::path> folderContents = FilesMatch(directory, extensions);
-  set<filesystem::path> filesSet(folderContents.begin(), folderContents.end());
-
-  // 1. Try files that start with the given pattern (up to digits and parens).
-  //    These have triple weight.
-  vector<pair<string, int>> inclusionMatches;
-  for (const auto& mapName : filesSet) {
-    string mapString = PathToString(mapName);
-    if (mapName.empty()) continue;
-    string cmpName = PrepareMapPatternForFuzzySearch(mapString);
-    size_t fuzzyPatternIndex = cmpName.find(fuzzyPattern);
-    if (fuzzyPatternIndex == string::npos) {
-      continue;
-    }
-    bool startsWithPattern = true;
-    for (uint8_t i = 0; i < fuzzyPatternIndex; ++i) {
-      if (!isdigit(mapString[i]) && mapString[i] != '(' && mapString[i] != ')') {
-        startsWithPattern = false;
-        break;
-      }
-    }
-    if (startsWithPattern) {
-      pair<string, int> foundMatch = make_pair<string, int>(move(mapString), static_cast<int>(mapString.length() - fuzzyPattern.length()));
-      auto pos = lower_bound(inclusionMatches.begin(), inclusionMatches.end(), foundMatch);
-      inclusionMatches.insert(pos, foundMatch);
-      if (inclusionMatches.size() >= FILE_SEARCH_FUZZY_MAX_RESULTS) {
-        break;
-      }
-    }
-  }
-  if (!inclusionMatches.empty()) {
-    return inclusionMatches;
-  }
-
-  // 2. Try fuzzy searching
-  string::size_type maxDistance = FILE_SEARCH_FUZZY_MAX_DISTANCE;
-  if (fuzzyPattern.size() < 3 * (maxDistance - 4)) {
-    // This formula approximates how PS !esdata fuzzy-matches
-    // It's my hope that it works here as well.
-    // 3->0, 4->1, 8->2
-    // 3->5, 4->5, 8->6
-    //
-    // I add approx +4 because PrepareMapPatternForFuzzySearch removes .w3m/.w3x extension
-    // In the case of 3->0, I effectively add +5, because 3->0 has always been too strict.
-    maxDistance = fuzzyPattern.size() / 3 + 4;
-  }
-
-  vector<pair<string, int>> distances;
-  for (const auto& mapName : filesSet) {
-    string mapString = PathToString(mapName);
-    if (mapString.empty()) continue;
-    string cmpName = RemoveNonAlphanumeric(mapString);
-    transform(begin(cmpName), end(cmpName), begin(cmpName), [](char c) { return static_cast<char>(std::tolower(c)); });
-    if ((fuzzyPattern.size() <= cmpName.size() + maxDistance) && (cmpName.size() <= maxDistance + fuzzyPattern.size())) {
-      string::size_type distance = GetLevenshteinDistance(fuzzyPattern, cmpName); // source to target
-      if (distance <= maxDistance) {
-        distances.emplace_back(mapString, static_cast<int>(distance * 3));
-      }
-    }
-  }
-
-  size_t resultCount = min(FILE_SEARCH_FUZZY_MAX_RESULTS, distances.size());
-  partial_sort(
-    distances.begin(),
-    distances.begin() + resultCount,
-    distances.end(),
-    [](const pair<string, int>& a, const pair<string, int>& b) {
-        return a.second < b.second;
-    }
-  );
-
-  vector<pair<string, int>> fuzzyMatches(distances.begin(), distances.begin() + resultCount);
-  return fuzzyMatches;
+  CFileSearchIndex searchIndex(baseExtensions);
+  searchIndex.Refresh(directory);
+  return searchIndex.Search(rawPattern);
 }
 
 bool OpenMPQArchive(void** MPQ, const filesystem::path& filePath)
@@ -35,6 +35,7 @@
 class CAsyncObserver;
 class CAura;
 class CAuraDB;
+class CBanIndex;
 class CMDNS;
 class CBNCSUtilInterface;
 class CCLI;
@@ -42,6 +43,7 @@ class CCommandContext;
 class CConfig;
 class CConnection;
 class CDBBan;
+class CDBWriter;
 class CDBDotAPlayer;
 class CDBDotAPlayerSummary;
 class CDBGamePlayerSummary;
@@ -49,6 +51,8 @@ class CDBGameSummary;
 class CDiscord;
 class CGame;
 class CGameController;
+class CGameFrameCursor;
+class CGameFrameLog;
 class CGameInteractiveHost;
 class CGameSeeker;
 class CGameSetup;
@@ -58,15 +62,21 @@ class CIncomingChatEvent;
 class CIncomingChatMessage;
 class CIncomingJoinRequest;
 class CIncomingMapFileSize;
+class CIPPrefixTrie;
 class CIRC;
 class CMap;
+class CMapDownload;
+class CMapUploadScheduler;
 class CNet;
 class CPacked;
 class CQueuedChatMessage;
 class CRealm;
+class CReplayWriter;
 class CSaveGame;
 class CSHA1;
 class CSocket;
+class CSocketPoller;
+class CSQLITE3;
 class CStreamIOSocket;
 class CTCPClient;
 class CTCPServer;
@@ -125,10 +135,12 @@ struct AppAction;
 struct BannableUserSearchResult;
 struct CGameLogRecord;
 struct CommandHistory;
+struct DBGamePlayerRecord;
 struct FileChunkCached;
 struct FileChunkTransient;
 struct GameControllerSearchResult;
 struct GameDiscoveryInterface;
+struct GameFrame;
 struct GameHistory;
 struct GameHost;
 struct GameInfo;
@@ -143,9 +155,11 @@ struct GameResults;
 struct GameResultTeamAnalysis;
 struct GameResultConstraints;
 struct LazyCommandContext;
+struct MapLoaderConfig;
 struct MapTransfer;
 struct NetworkGameInfo;
 struct RealmUserSearchResult;
+struct ReplayHeaderInfo;
 struct ServiceUser;
 struct SimpleNestedLocation;
 struct UDPPkt;
@@ -48,6 +48,7 @@
 #include "game.h"
 #include "game_interactive_host.h"
 #include "game_result.h"
+#include "game_stat.h"
 #include "game_structs.h"
 #include "command.h"
 #include "aura.h"
@@ -73,6 +74,7 @@
 #include "stats/w3mmd.h"
 #include "integration/irc.h"
 #include "file_util.h"
+#include "replay_writer.h"
 
 #include <bitset>
 #include <ctime>
@@ -143,6 +145,14 @@ CGame::CGame(CAura* nAura, shared_ptr<CGameSetup> nGameSetup)
     m_MapSiteURL(nGameSetup->m_Map->GetMapSiteURL()),
     m_CreationTime(GetTime()),
     m_LastPingTicks(APP_MIN_TICKS),
+    m_PingTimer(0),
+    m_ActionTimer(0),
+    m_CountDownTimer(0),
+    m_AutoStartTimer(0),
+    m_LobbyTimeoutTimer(0),
+    m_LoadingTimer(0),
+    m_LagScreenTimer(0),
+    m_ObserverTimer(0),
     m_LastCheckActionsTicks(APP_MIN_TICKS),
     m_LastRefreshTime(GetTime()),
     m_LastDownloadCounterResetTicks(GetTicks()),
@@ -202,6 +212,7 @@ CGame::CGame(CAura* nAura, shared_ptr<CGameSetup> nGameSetup)
     m_CountDownStarted(false),
     m_CountDownFast(false),
     m_CountDownUserInitiated(false),
+    m_CountDownFinished(false),
     m_GameLoading(false),
     m_GameLoaded(false),
     m_LobbyLoading(false),
@@ -345,6 +356,9 @@ CGame::CGame(CAura* nAura, shared_ptr<CGameSetup> nGameSetup)
       }
     }
   }
+
+  ScheduleAutoStartTimer(GetTicks());
+  ScheduleLobbyTimeoutTimer();
 }
 
 void CGame::InitSlots()
@@ -569,6 +583,7 @@ void CGame::ClearActions()
 
 void CGame::Reset()
 {
+  CloseReplay();
   m_PauseUser = nullptr;
   m_HMCVirtualUser.reset();
   m_AHCLVirtualUser.reset();
@@ -768,20 +783,8 @@ void CGame::TrySaveStats() const
   // store the CDBGamePlayers in the database
   // add non-dota stats
   if (!m_GameControllers.empty()) {
-    int64_t Ticks = GetTicks();
     LOG_APP_IF(LogLevel::kDebug, "[STATS] saving game end player data to database")
-    if (m_Aura->m_DB->Begin()) {
-      for (auto& controllerData : m_GameControllers) {
-        m_Aura->m_DB->UpdateGamePlayerOnEnd(m_PersistentId, controllerData, m_EffectiveTicks / 1000);
-      }
-      if (!m_Aura->m_DB->Commit()) {
-        LOG_APP_IF(LogLevel::kWarning, "[STATS] failed to commit game end player data")
-      } else {
-        LOG_APP_IF(LogLevel::kDebug, "[STATS] commited game end player data in " + to_string(GetTicks() - Ticks) + " ms")
-      }
-    } else {
-      LOG_APP_IF(LogLevel::kWarning, "[STATS] failed to begin transaction game end player data")
-    }
+    m_Aura->m_DB->SubmitGameEnded(m_PersistentId, m_GameControllers, m_EffectiveTicks / 1000);
   }
 
   if (m_DotaStats) {
@@ -871,6 +874,7 @@ void CGame::StartGameOverTimer(bool isMMD)
 CGame::~CGame()
 {
   Reset();
+  CancelTimers();
   ReleaseMapBusyTimedLock();
 
   m_Socket.reset();
@@ -944,29 +948,6 @@ bool CGame::GetIsCustomForces() const
   return GetMap()->GetMapLayoutStyle() != MAPLAYOUT_ANY;
 }
 
-void CGame::UpdateSelectBlockTime(int64_t& usecBlockTime) const
-{
-  // return the number of ticks (ms) until the next "timed action", which for our purposes is the next game update
-  // the main Aura loop will make sure the next loop update happens at or before this value
-  // note: there's no reason this function couldn't take into account the game's other timers too but they're far less critical
-  // warning: this function must take into account when actions are not being sent (e.g. during loading or lagging)
-
-  if (!m_GameLoaded || m_IsLagging || usecBlockTime == 0)
-    return;
-
-  const int64_t ticksSinceLastUpdate = GetTicks() - m_LastActionSentTicks;
-
-  if (ticksSinceLastUpdate > m_LatencyTicks - m_LastActionLateBy) {
-    usecBlockTime = 0;
-    return;
-  }
-
-  int64_t maybeBlockTime = (m_LatencyTicks - m_LastActionLateBy - ticksSinceLastUpdate) * 1000;
-  if (maybeBlockTime < usecBlockTime) {
-    usecBlockTime = maybeBlockTime;
-  }
-}
-
 uint32_t CGame::GetSlotsOccupied() const
 {
   uint32_t NumSlotsOccupied = 0;
@@ -1349,19 +1330,6 @@ ImmutableUserList CGame::GetWaitingReconnectPlayers() const
   return players;
 }
 
-uint32_t CGame::SetFD(fd_set* fd, fd_set* send_fd, int32_t* nfds) const
-{
-  uint32_t NumFDs = 0;
-
-  for (auto& user : m_Users) {
-    if (user->GetDisconnected()) continue;
-    user->GetSocket()->SetFD(fd, send_fd, nfds);
-    ++NumFDs;
-  }
-
-  return NumFDs;
-}
-
 void CGame::UpdateJoinable()
 {
   const int64_t Time = GetTime(), Ticks = GetTicks();
@@ -1409,11 +1377,7 @@ bool CGame::UpdateLobby()
     m_SlotInfoChanged &= ~SLOTS_ALIGNMENT_CHANGED;
   }
 
-  if (GetIsAutoStartDue()) {
-    SendAllChat("Game automatically starting in. . .");
-    StartCountDown(false, true);
-  }
-
+  // see RunLobbyTimeoutTimer
   if (!m_Users.empty()) {
     m_LastUserSeen = Ticks;
     if (HasOwnerInGame()) {
@@ -1421,36 +1385,13 @@ bool CGame::UpdateLobby()
     }
   }
 
-  // countdown every m_LobbyCountDownInterval ms (default 500 ms)
-
-  if (m_CountDownStarted && Ticks - m_LastCountDownTicks >= m_Config.m_LobbyCountDownInterval) {
-    bool shouldStartLoading = false;
-    if (m_CountDownCounter > 0) {
-      // we use a countdown counter rather than a "finish countdown time" here because it might alternately round up or down the count
-      // this sometimes resulted in a countdown of e.g. "6 5 3 2 1" during my testing which looks pretty dumb
-      // doing it this way ensures it's always "5 4 3 2 1" but each interval might not be *exactly* the same length
-
-      SendAllChat(to_string(m_CountDownCounter--) + ". . .");
-    } else if (GetNumJoinedUsers() >= 1) { // allow observing AI vs AI matches
-      shouldStartLoading = true;
-    } else {
-      // Some operations may remove fake users during countdown.
-      // Ensure that the game doesn't start if there are neither real nor fake users.
-      // (If a user leaves or joins, the countdown is stopped elsewhere.)
-      LOG_APP_IF(LogLevel::kDebug, "countdown stopped - lobby is empty.")
-      StopCountDown();
-    }
-
-    m_LastCountDownTicks = Ticks;
-    if (shouldStartLoading) {
-      EventGameStartedLoading();
-      return true;
-    }
+  // see RunCountDownTimer
+  if (m_CountDownStarted && m_CountDownFinished) {
+    m_CountDownFinished = false;
+    EventGameStartedLoading();
+    return true;
   }
 
-  // release abandoned lobbies, so other users can take ownership
-  CheckLobbyTimeouts();
-
   if (m_Exiting) {
     return true;
   }
@@ -1469,8 +1410,6 @@ bool CGame::UpdateLobby()
 
 void CGame::UpdateLoading()
 {
-  const int64_t Time = GetTime(), Ticks = GetTicks();
-
   bool finishedLoading = true;
   bool anyLoaded = false;
   for (auto& user : m_Users) {
@@ -1490,18 +1429,9 @@ void CGame::UpdateLoading()
       // Flush leaver queue to allow players and the game itself to be destroyed.
       SendAllActionsCallback();
     }
-  } else {
-    if (m_Config.m_LoadingTimeoutMode == GameLoadingTimeoutMode::kStrict) {
-      if (Ticks - m_StartedLoadingTicks > static_cast<int64_t>(m_Config.m_LoadingTimeout)) {
-        StopLoadPending("was automatically dropped after " + to_string(m_Config.m_LoadingTimeout / 1000) + " seconds");
-      }
-    }
-
-    // Warcraft III disconnects if it doesn't receive an action packet for more than ~65 seconds
-    if (m_Config.m_LoadInGame && anyLoaded && Time - m_LastLagScreenResetTime >= 60 ) {
-      ResetLagScreen();
-    }
   }
+
+  // loading timeouts, see RunLoadingTimer
 }
 
 void CGame::UpdateLoaded()
@@ -1562,6 +1492,8 @@ void CGame::UpdateLoaded()
           m_IsLagging = true;
           m_StartedLaggingTime = Time;
           m_LastLagScreenResetTime = Time;
+          UpdateActionTimer();
+          ScheduleLagScreenTimer();
 
           // print debug information
           double worstLaggerSeconds = static_cast<double>(worstLaggerFrames) * static_cast<double>(m_LatencyTicks) / static_cast<double>(1000.);
@@ -1573,42 +1505,7 @@ void CGame::UpdateLoaded()
       }
     }
   } else if (!m_Users.empty()) { // m_IsLagging == true (context: CGame::UpdateLoaded())
-    pair<int64_t, int64_t> waitTicks = GetReconnectWaitTicks();
-    UserList droppedUsers;
-    for (auto& user : m_Users) {
-      if (!user->GetIsLagging()) {
-        continue;
-      }
-      bool timeExceeded = false;
-      if (user->GetDisconnected() && user->GetGProxyExtended()) {
-        timeExceeded = Ticks - user->GetStartedLaggingTicks() > waitTicks.second;
-      } else if (user->GetDisconnected() && user->GetGProxyAny()) {
-        timeExceeded = Ticks - user->GetStartedLaggingTicks() > waitTicks.first;
-      } else {
-        timeExceeded = Ticks - user->GetStartedLaggingTicks() > 60000;
-      }
-      if (timeExceeded) {
-        if (user->GetDisconnected()) {
-          StopLagger(user, "failed to reconnect within " + to_string((Ticks - user->GetStartedLaggingTicks()) / 1000) + " seconds");
-        } else {
-          StopLagger(user, "was automatically dropped after " + to_string((Ticks - user->GetStartedLaggingTicks()) / 1000) + " seconds");
-        }
-        droppedUsers.push_back(user);
-      }
-    }
-    if (!droppedUsers.empty()) {
-      bool saved = false;
-      for (const auto& user : droppedUsers) {
-        TryShareUnitsOnDisconnect(user, false);
-        if (!saved) saved = TrySaveOnDisconnect(user, false);
-      }
-      ResetDropVotes();
-    }
-
-    // Warcraft III disconnects if it doesn't receive an action packet for more than ~65 seconds
-    if (Time - m_LastLagScreenResetTime >= 60) {
-      ResetLagScreen();
-    }
+    // lag screen timeouts, see RunLagScreenTimer
 
     // check if anyone has stopped lagging normally
     // we consider a user to have stopped lagging if they're less than m_SyncLimitSafe keepalives behind
@@ -1647,6 +1544,8 @@ void CGame::UpdateLoaded()
       m_LastActionSentTicks = Ticks - m_LatencyTicks;
       m_LastActionLateBy = 0;
       m_PingReportedSinceLagTimes = 0;
+      UpdateActionTimer();
+      m_Aura->m_Timers.Cancel(m_LagScreenTimer);
       LOG_APP_IF(LogLevel::kInfo, "stopped lagging after " + ToFormattedString(static_cast<double>(Time - m_StartedLaggingTime)) + " seconds")
     }
   }
@@ -1657,19 +1556,6 @@ void CGame::UpdateLoaded()
 
     // keep track of the last lag screen time so we can avoid timing out users
     m_LastLagScreenTime = Time;
-
-    // every 17 seconds, report most recent lag data
-    if (Time - m_StartedLaggingTime >= m_PingReportedSinceLagTimes * 17) {
-      ReportAllPings();
-      ++m_PingReportedSinceLagTimes;
-    }
-    if (m_Config.m_SyncNormalize) {
-      if (m_PingReportedSinceLagTimes == 2 && Ticks - m_FinishedLoadingTicks < 60000) {
-        NormalizeSyncCounters();
-      } else if (m_PingReportedSinceLagTimes == 3 && Ticks - m_FinishedLoadingTicks < 180000) {
-        NormalizeSyncCounters();
-      }
-    }
   }
 
   switch (m_Config.m_PlayingTimeoutMode) {
@@ -1714,43 +1600,14 @@ void CGame::UpdateLoaded()
   */
 }
 
-bool CGame::Update(fd_set* fd, fd_set* send_fd)
+bool CGame::Update()
 {
   const int64_t Time = GetTime(), Ticks = GetTicks();
 
-  // ping every 5 seconds
-  // changed this to ping during game loading as well to hopefully fix some problems with people disconnecting during loading
-  // changed this to ping during the game as well
-
-  if (!m_LobbyLoading && (Ticks >= m_LastPingTicks + 5000)) {
-    // we must send pings to users who are downloading the map because
-    // Warcraft III disconnects from the lobby if it doesn't receive a ping every ~90 seconds
-    // so if the user takes longer than 90 seconds to download the map they would be disconnected unless we keep sending pings
-
-    vector<uint8_t> pingPacket = GameProtocol::SEND_W3GS_PING_FROM_HOST(m_Aura->GetLoopTicks());
-    for (auto& user : m_Users) {
-      // Avoid ping-spamming GProxy-reconnected players
-      if (!user->GetDisconnected()) {
-        user->Send(pingPacket);
-      }
-    }
-
-    // we also broadcast the game to the local network every 5 seconds so we hijack this timer for our nefarious purposes
-    if (GetUDPEnabled() && GetIsStageAcceptingJoins()) {
-      if (!(m_Aura->m_Net.m_UDPMainServerEnabled && m_Aura->m_Net.m_Config.m_UDPBroadcastStrictMode)) {
-        SendGameDiscoveryInfo();
-      } else {
-        SendGameDiscoveryRefresh();
-      }
-      m_GameDiscoveryActive = true;
-    }
-
-    if (m_GameDiscoveryInfoChanged & GAME_DISCOVERY_CHANGED_SLOTS) {
-      SendGameDiscoveryInfoMDNS();
-      m_GameDiscoveryInfoChanged &= ~GAME_DISCOVERY_CHANGED_SLOTS;
-    }
-
-    m_LastPingTicks = Ticks;
+  // ping every 5 seconds, see RunPingTimer
+  // the timer is disarmed while the lobby is loading, and armed again here once it's done
+  if (m_PingTimer == 0 && !m_LobbyLoading) {
+    RunPingTimer();
   }
 
   if (m_GameLoaded && (m_EffectiveTicks >= m_LastCheckActionsTicks + 5000)) {
@@ -1770,11 +1627,15 @@ bool CGame::Update(fd_set* fd, fd_set* send_fd)
     }
   }
 
+  if (m_ReplayWriter && m_GameLoaded) {
+    FlushReplayFrames();
+  }
+
   // update users
 
   for (auto i = begin(m_Users); i != end(m_Users);) {
-    if ((*i)->Update(fd, (*i)->GetGProxyAny() ? GAME_USER_TIMEOUT_RECONNECTABLE : GAME_USER_TIMEOUT_VANILLA)) {
-      EventUserDeleted(*i, fd, send_fd);
+    if ((*i)->Update((*i)->GetGProxyAny() ? GAME_USER_TIMEOUT_RECONNECTABLE : GAME_USER_TIMEOUT_VANILLA)) {
+      EventUserDeleted(*i);
       m_Aura->m_Net.OnUserKicked(*i);
       delete *i;
       i = m_Users.erase(i);
@@ -1889,7 +1750,392 @@ bool CGame::Update(fd_set* fd, fd_set* send_fd)
   return m_Exiting;
 }
 
-void CGame::UpdatePost(fd_set* send_fd) const
+void CGame::RunPingTimer()
+{
+  // ping every 5 seconds
+  // changed this to ping during game loading as well to hopefully fix some problems with people disconnecting during loading
+  // changed this to ping during the game as well
+
+  if (m_LobbyLoading) {
+    // CGame::Update arms the timer again once the lobby is ready
+    m_PingTimer = 0;
+    return;
+  }
+
+  const int64_t Ticks = GetTicks();
+
+  // we must send pings to users who are downloading the map because
+  // Warcraft III disconnects from the lobby if it doesn't receive a ping every ~90 seconds
+  // so if the user takes longer than 90 seconds to download the map they would be disconnected unless we keep sending pings
+
+  vector<uint8_t> pingPacket = GameProtocol::SEND_W3GS_PING_FROM_HOST(m_Aura->GetLoopTicks());
+  for (auto& user : m_Users) {
+    // Avoid ping-spamming GProxy-reconnected players
+    if (!user->GetDisconnected()) {
+      user->Send(pingPacket);
+    }
+  }
+
+  // we also broadcast the game to the local network every 5 seconds so we hijack this timer for our nefarious purposes
+  if (GetUDPEnabled() && GetIsStageAcceptingJoins()) {
+    if (!(m_Aura->m_Net.m_UDPMainServerEnabled && m_Aura->m_Net.m_Config.m_UDPBroadcastStrictMode)) {
+      SendGameDiscoveryInfo();
+    } else {
+      SendGameDiscoveryRefresh();
+    }
+    m_GameDiscoveryActive = true;
+  }
+
+  if (m_GameDiscoveryInfoChanged & GAME_DISCOVERY_CHANGED_SLOTS) {
+    SendGameDiscoveryInfoMDNS();
+    m_GameDiscoveryInfoChanged &= ~GAME_DISCOVERY_CHANGED_SLOTS;
+  }
+
+  m_LastPingTicks = Ticks;
+  SchedulePingTimer(Ticks + 5000);
+}
+
+void CGame::SchedulePingTimer(const int64_t dueTicks)
+{
+  if (!m_Aura->m_Timers.Reschedule(m_PingTimer, dueTicks)) {
+    m_PingTimer = m_Aura->m_Timers.Schedule(dueTicks, [this]() {
+      RunPingTimer();
+    });
+  }
+}
+
+void CGame::UpdateActionTimer()
+{
+  // wake up the main loop when the next action frame is due
+  // no action frames are sent while the lag screen is up, so the timer is armed again once it's lifted
+  if (!m_GameLoaded || m_IsLagging) {
+    m_Aura->m_Timers.Cancel(m_ActionTimer);
+    return;
+  }
+  const int64_t dueTicks = m_LastActionSentTicks + m_LatencyTicks - m_LastActionLateBy;
+  if (!m_Aura->m_Timers.Reschedule(m_ActionTimer, dueTicks)) {
+    m_ActionTimer = m_Aura->m_Timers.Schedule(dueTicks, nullptr);
+  }
+}
+
+void CGame::RunCountDownTimer()
+{
+  // countdown every m_LobbyCountDownInterval ms (default 500 ms)
+  if (!m_CountDownStarted || !GetIsLobbyStrict()) {
+    return;
+  }
+
+  const int64_t Ticks = GetTicks();
+  if (m_CountDownCounter > 0) {
+    // we use a countdown counter rather than a "finish countdown time" here because it might alternately round up or down the count
+    // this sometimes resulted in a countdown of e.g. "6 5 3 2 1" during my testing which looks pretty dumb
+    // doing it this way ensures it's always "5 4 3 2 1" but each interval might not be *exactly* the same length
+
+    SendAllChat(to_string(m_CountDownCounter--) + ". . .");
+  } else if (GetNumJoinedUsers() >= 1) { // allow observing AI vs AI matches
+    // CGame::UpdateLobby starts loading the game, so that CAura moves it to the started games
+    m_CountDownFinished = true;
+  } else {
+    // Some operations may remove fake users during countdown.
+    // Ensure that the game doesn't start if there are neither real nor fake users.
+    // (If a user leaves or joins, the countdown is stopped elsewhere.)
+    LOG_APP_IF(LogLevel::kDebug, "countdown stopped - lobby is empty.")
+    StopCountDown();
+  }
+
+  m_LastCountDownTicks = Ticks;
+  if (m_CountDownStarted && !m_CountDownFinished) {
+    ScheduleCountDownTimer(Ticks + m_Config.m_LobbyCountDownInterval);
+  }
+}
+
+void CGame::ScheduleCountDownTimer(const int64_t dueTicks)
+{
+  if (!m_Aura->m_Timers.Reschedule(m_CountDownTimer, dueTicks)) {
+    m_CountDownTimer = m_Aura->m_Timers.Schedule(dueTicks, [this]() {
+      RunCountDownTimer();
+    });
+  }
+}
+
+void CGame::RunAutoStartTimer()
+{
+  if (!GetIsLobbyStrict()) {
+    return;
+  }
+
+  if (GetIsAutoStartDue()) {
+    SendAllChat("Game automatically starting in. . .");
+    StartCountDown(false, true);
+  }
+
+  // the countdown may still be refused, e.g. while someone downloads the map
+  ScheduleAutoStartTimer(GetTicks() + AUTO_START_RETRY_PERIOD);
+}
+
+void CGame::ScheduleAutoStartTimer(const int64_t notBeforeTicks)
+{
+  if (m_AutoStartRequirements.empty() || m_CountDownStarted || !GetIsLobbyStrict()) {
+    m_Aura->m_Timers.Cancel(m_AutoStartTimer);
+    return;
+  }
+
+  // requirements are measured in GetTime, check back as soon as the earliest one may be met
+  const int64_t Time = GetTime(), Ticks = GetTicks();
+  int64_t dueTicks = APP_MAX_TICKS;
+  for (const auto& requirement : m_AutoStartRequirements) {
+    dueTicks = min(dueTicks, Ticks + (requirement.second - Time) * 1000);
+  }
+  dueTicks = max(dueTicks, notBeforeTicks);
+
+  if (!m_Aura->m_Timers.Reschedule(m_AutoStartTimer, dueTicks)) {
+    m_AutoStartTimer = m_Aura->m_Timers.Schedule(dueTicks, [this]() {
+      RunAutoStartTimer();
+    });
+  }
+}
+
+void CGame::RunLobbyTimeoutTimer()
+{
+  if (!GetIsLobbyStrict()) {
+    return;
+  }
+
+  // release abandoned lobbies, so other users can take ownership
+  CheckLobbyTimeouts();
+  if (!m_Exiting) {
+    ScheduleLobbyTimeoutTimer();
+  }
+}
+
+void CGame::ScheduleLobbyTimeoutTimer()
+{
+  if (!GetIsLobbyStrict()) {
+    m_Aura->m_Timers.Cancel(m_LobbyTimeoutTimer);
+    return;
+  }
+
+  // m_LastUserSeen and m_LastOwnerSeen keep moving forward while users are in the lobby,
+  // so the timer may fire early, and then it's scheduled again at the new deadline
+  const int64_t Ticks = GetTicks();
+  const int64_t ownerTimeout = static_cast<int64_t>(m_Config.m_LobbyOwnerTimeout);
+  const int64_t lobbyTimeout = static_cast<int64_t>(m_Config.m_LobbyTimeout);
+  int64_t dueTicks = APP_MAX_TICKS;
+  if (HasOwnerSet()) {
+    switch (m_Config.m_LobbyOwnerTimeoutMode) {
+      case LobbyOwnerTimeoutMode::kNever:
+        break;
+      case LobbyOwnerTimeoutMode::kAbsent:
+        dueTicks = min(dueTicks, m_LastOwnerSeen + ownerTimeout + 1);
+        break;
+      case LobbyOwnerTimeoutMode::kStrict:
+        dueTicks = min(dueTicks, m_LastOwnerAssigned + ownerTimeout + 1);
+        break;
+      IGNORE_ENUM_LAST(LobbyOwnerTimeoutMode)
+    }
+  }
+  if (!m_IsMirror || m_Config.m_LobbyTimeoutMode == LobbyTimeoutMode::kStrict) {
+    switch (m_Config.m_LobbyTimeoutMode) {
+      case LobbyTimeoutMode::kNever:
+        break;
+      case LobbyTimeoutMode::kEmpty:
+        dueTicks = min(dueTicks, m_LastUserSeen + lobbyTimeout + 1);
+        break;
+      case LobbyTimeoutMode::kOwnerMissing:
+        dueTicks = min(dueTicks, m_LastOwnerSeen + lobbyTimeout + 1);
+        break;
+      case LobbyTimeoutMode::kStrict:
+        // measured in GetTime
+        dueTicks = min(dueTicks, Ticks + (m_CreationTime + lobbyTimeout / 1000 + 1 - GetTime()) * 1000);
+        break;
+      IGNORE_ENUM_LAST(LobbyTimeoutMode)
+    }
+  }
+
+  if (dueTicks == APP_MAX_TICKS) {
+    // armed again when an owner is assigned
+    m_Aura->m_Timers.Cancel(m_LobbyTimeoutTimer);
+    return;
+  }
+
+  // deadlines in the past didn't time out, e.g. during a network health check
+  if (dueTicks <= Ticks) {
+    dueTicks = Ticks + LOBBY_TIMEOUT_RETRY_PERIOD;
+  }
+
+  if (!m_Aura->m_Timers.Reschedule(m_LobbyTimeoutTimer, dueTicks)) {
+    m_LobbyTimeoutTimer = m_Aura->m_Timers.Schedule(dueTicks, [this]() {
+      RunLobbyTimeoutTimer();
+    });
+  }
+}
+
+void CGame::RunLoadingTimer()
+{
+  if (!m_GameLoading) {
+    return;
+  }
+
+  const int64_t Time = GetTime(), Ticks = GetTicks();
+  if (m_Config.m_LoadingTimeoutMode == GameLoadingTimeoutMode::kStrict) {
+    if (Ticks - m_StartedLoadingTicks > static_cast<int64_t>(m_Config.m_LoadingTimeout)) {
+      StopLoadPending("was automatically dropped after " + to_string(m_Config.m_LoadingTimeout / 1000) + " seconds");
+    }
+  }
+
+  // Warcraft III disconnects if it doesn't receive an action packet for more than ~65 seconds
+  if (m_Config.m_LoadInGame && Time - m_LastLagScreenResetTime >= 60) {
+    bool anyLoaded = false;
+    for (const auto& user : m_Users) {
+      if (user->GetFinishedLoading()) {
+        anyLoaded = true;
+        break;
+      }
+    }
+    if (anyLoaded) {
+      ResetLagScreen();
+    }
+  }
+
+  ScheduleLoadingTimer();
+}
+
+void CGame::ScheduleLoadingTimer()
+{
+  if (!m_GameLoading) {
+    m_Aura->m_Timers.Cancel(m_LoadingTimer);
+    return;
+  }
+
+  const int64_t Time = GetTime(), Ticks = GetTicks();
+  int64_t dueTicks = APP_MAX_TICKS;
+  if (m_Config.m_LoadingTimeoutMode == GameLoadingTimeoutMode::kStrict) {
+    const int64_t timeoutTicks = m_StartedLoadingTicks + static_cast<int64_t>(m_Config.m_LoadingTimeout) + 1;
+    if (Ticks < timeoutTicks) {
+      dueTicks = timeoutTicks;
+    }
+  }
+  if (m_Config.m_LoadInGame) {
+    // measured in GetTime, retried every second until someone has loaded
+    dueTicks = min(dueTicks, Ticks + max(m_LastLagScreenResetTime + 60 - Time, static_cast<int64_t>(1)) * 1000);
+  }
+
+  if (dueTicks == APP_MAX_TICKS) {
+    m_Aura->m_Timers.Cancel(m_LoadingTimer);
+    return;
+  }
+
+  if (!m_Aura->m_Timers.Reschedule(m_LoadingTimer, dueTicks)) {
+    m_LoadingTimer = m_Aura->m_Timers.Schedule(dueTicks, [this]() {
+      RunLoadingTimer();
+    });
+  }
+}
+
+void CGame::RunLagScreenTimer()
+{
+  if (!m_GameLoaded || !m_IsLagging || m_Users.empty()) {
+    return;
+  }
+
+  const int64_t Time = GetTime(), Ticks = GetTicks();
+  pair<int64_t, int64_t> waitTicks = GetReconnectWaitTicks();
+  UserList droppedUsers;
+  for (auto& user : m_Users) {
+    if (!user->GetIsLagging()) {
+      continue;
+    }
+    if (Ticks - user->GetStartedLaggingTicks() > GetLaggerWaitTicks(user, waitTicks)) {
+      if (user->GetDisconnected()) {
+        StopLagger(user, "failed to reconnect within " + to_string((Ticks - user->GetStartedLaggingTicks()) / 1000) + " seconds");
+      } else {
+        StopLagger(user, "was automatically dropped after " + to_string((Ticks - user->GetStartedLaggingTicks()) / 1000) + " seconds");
+      }
+      droppedUsers.push_back(user);
+    }
+  }
+  if (!droppedUsers.empty()) {
+    bool saved = false;
+    for (const auto& user : droppedUsers) {
+      TryShareUnitsOnDisconnect(user, false);
+      if (!saved) saved = TrySaveOnDisconnect(user, false);
+    }
+    ResetDropVotes();
+  }
+
+  // Warcraft III disconnects if it doesn't receive an action packet for more than ~65 seconds
+  if (Time - m_LastLagScreenResetTime >= 60) {
+    ResetLagScreen();
+  }
+
+  // every 17 seconds, report most recent lag data
+  if (Time - m_StartedLaggingTime >= m_PingReportedSinceLagTimes * 17) {
+    ReportAllPings();
+    ++m_PingReportedSinceLagTimes;
+    if (m_Config.m_SyncNormalize) {
+      if (m_PingReportedSinceLagTimes == 2 && Ticks - m_FinishedLoadingTicks < 60000) {
+        NormalizeSyncCounters();
+      } else if (m_PingReportedSinceLagTimes == 3 && Ticks - m_FinishedLoadingTicks < 180000) {
+        NormalizeSyncCounters();
+      }
+    }
+  }
+
+  // CGame::UpdateLoaded stops the lag screen once dropped users are gone
+  ScheduleLagScreenTimer();
+}
+
+void CGame::ScheduleLagScreenTimer()
+{
+  if (!m_GameLoaded || !m_IsLagging) {
+    m_Aura->m_Timers.Cancel(m_LagScreenTimer);
+    return;
+  }
+
+  // lag screen resets and ping reports are measured in GetTime
+  const int64_t Time = GetTime(), Ticks = GetTicks();
+  int64_t dueTicks = Ticks + max(m_LastLagScreenResetTime + 60 - Time, static_cast<int64_t>(1)) * 1000;
+  dueTicks = min(dueTicks, Ticks + max(m_StartedLaggingTime + m_PingReportedSinceLagTimes * 17 - Time, static_cast<int64_t>(0)) * 1000);
+
+  pair<int64_t, int64_t> waitTicks = GetReconnectWaitTicks();
+  for (const auto& user : m_Users) {
+    if (user->GetIsLagging()) {
+      dueTicks = min(dueTicks, user->GetStartedLaggingTicks() + GetLaggerWaitTicks(user, waitTicks) + 1);
+    }
+  }
+  dueTicks = max(dueTicks, Ticks + 1);
+
+  if (!m_Aura->m_Timers.Reschedule(m_LagScreenTimer, dueTicks)) {
+    m_LagScreenTimer = m_Aura->m_Timers.Schedule(dueTicks, [this]() {
+      RunLagScreenTimer();
+    });
+  }
+}
+
+int64_t CGame::GetLaggerWaitTicks(const GameUser::CGameUser* user, const pair<int64_t, int64_t>& waitTicks) const
+{
+  if (user->GetDisconnected() && user->GetGProxyExtended()) {
+    return waitTicks.second;
+  } else if (user->GetDisconnected() && user->GetGProxyAny()) {
+    return waitTicks.first;
+  } else {
+    return 60000;
+  }
+}
+
+void CGame::CancelTimers()
+{
+  m_Aura->m_Timers.Cancel(m_PingTimer);
+  m_Aura->m_Timers.Cancel(m_ActionTimer);
+  m_Aura->m_Timers.Cancel(m_CountDownTimer);
+  m_Aura->m_Timers.Cancel(m_AutoStartTimer);
+  m_Aura->m_Timers.Cancel(m_LobbyTimeoutTimer);
+  m_Aura->m_Timers.Cancel(m_LoadingTimer);
+  m_Aura->m_Timers.Cancel(m_LagScreenTimer);
+  m_Aura->m_Timers.Cancel(m_ObserverTimer);
+}
+
+void CGame::UpdatePost() const
 {
   // we need to manually call DoSend on each user now because GameUser::CGameUser::Update doesn't do it
   // this is in case user 2 generates a packet for user 1 during the update but it doesn't get sent because user 1 already finished updating
@@ -1897,7 +2143,7 @@ void CGame::UpdatePost(fd_set* send_fd) const
 
   for (const auto& user : m_Users) {
     if (user->GetDisconnected()) continue;
-    user->GetSocket()->DoSend(send_fd);
+    user->GetSocket()->DoSend();
   }
 }
 
@@ -1953,7 +2199,7 @@ void CGame::RunActionsScheduler()
     m_LatencyTicks = newLatency;
     if (m_BufferingEnabled & BUFFERING_ENABLED_PLAYING) {
       vector<uint8_t> storedLatency = CreateByteArray(static_cast<uint16_t>(newLatency), false);
-      m_GameHistory->m_PlayingBuffer.emplace_back(GAME_FRAME_TYPE_LATENCY, storedLatency);
+      m_GameHistory->m_PlayingBuffer.Append(GAME_FRAME_TYPE_LATENCY, storedLatency);
     }
   }
 
@@ -1986,6 +2232,9 @@ void CGame::RunActionsSchedulerInner(const int64_t newLatency, const uint8_t max
   for (auto& user : m_Users) {
     user->AdvanceActiveGameFrame();
   }
+
+  // m_LastActionSentTicks and m_LatencyTicks only change here, so that's when the next frame is due
+  UpdateActionTimer();
 }
 
 void CGame::LogApp(const string& logText, const uint8_t logTargets) const
@@ -2098,8 +2347,7 @@ void CGame::SendMulti(const std::vector<uint8_t>& UIDs, const std::vector<uint8_
   for (auto& UID : UIDs) {
     if (m_JoinInProgressVirtualUser.has_value() && UID == m_JoinInProgressVirtualUser->GetUID()) {
       if (m_GameLoaded && (m_BufferingEnabled & BUFFERING_ENABLED_PLAYING)) {
-        GameFrame& frame = m_GameHistory->m_PlayingBuffer.emplace_back(GAME_FRAME_TYPE_CHAT);
-        frame.m_Bytes = vector<uint8_t>(begin(data), begin(data) + data.size());
+        m_GameHistory->m_PlayingBuffer.Append(GAME_FRAME_TYPE_CHAT, data);
       }
     } else {
       Send(UID, data);
@@ -2114,6 +2362,13 @@ void CGame::SendAll(const std::vector<uint8_t>& data) const
   }
 }
 
+void CGame::SendAll(const SharedPacket& packet) const
+{
+  for (auto& user : m_Users) {
+    user->Send(packet);
+  }
+}
+
 void CGame::SendAsChat(CConnection* user, const std::vector<uint8_t>& data) const
 {
   if (user->GetType() == INCON_TYPE_PLAYER && static_cast<const GameUser::CGameUser*>(user)->GetIsInLoadingScreen()) {
@@ -2124,19 +2379,19 @@ void CGame::SendAsChat(CConnection* user, const std::vector<uint8_t>& data) cons
 
 bool CGame::SendAllAsChat(const std::vector<uint8_t>& data) const
 {
+  const SharedPacket packet = MakeSharedPacket(data);
   bool success = false;
   for (auto& user : m_Users) {
     if (user->GetIsInLoadingScreen()) {
       continue;
     }
-    user->Send(data);
+    user->Send(packet);
     success = true;
   }
   if (!success) return success;
 
   if (m_GameLoaded && (m_BufferingEnabled & BUFFERING_ENABLED_PLAYING)) {
-    GameFrame& frame = m_GameHistory->m_PlayingBuffer.emplace_back(GAME_FRAME_TYPE_CHAT);
-    frame.m_Bytes = vector<uint8_t>(begin(data), begin(data) + data.size());
+    m_GameHistory->m_PlayingBuffer.Append(GAME_FRAME_TYPE_CHAT, *packet);
   }
 
   return success;
@@ -2145,19 +2400,19 @@ bool CGame::SendAllAsChat(const std::vector<uint8_t>& data) const
 bool CGame::SendObserversAsChat(const std::vector<uint8_t>& data) const
 {
   if (!m_GameLoaded) return false;
+  const SharedPacket packet = MakeSharedPacket(data);
   bool success = false;
   for (auto& user : m_Users) {
     if (!user->GetIsObserver()) {
       continue;
     }
-    user->Send(data);
+    user->Send(packet);
     success = true;
   }
   if (!success) return success;
 
   if (m_BufferingEnabled & BUFFERING_ENABLED_PLAYING) {
-    GameFrame& frame = m_GameHistory->m_PlayingBuffer.emplace_back(GAME_FRAME_TYPE_CHAT);
-    frame.m_Bytes = vector<uint8_t>(begin(data), begin(data) + data.size());
+    m_GameHistory->m_PlayingBuffer.Append(GAME_FRAME_TYPE_CHAT, *packet);
   }
 
   return success;
@@ -3362,56 +3617,48 @@ void CGame::SendIncomingPlayerInfo(GameUser::CGameUser* user) const
   }
 }
 
-uint8_t CGame::NextSendMap(CConnection* user, const uint8_t UID, MapTransfer& mapTransfer)
+uint8_t CGame::NextSendMap(CConnection* user, const uint8_t UID, MapTransfer& mapTransfer, const uint32_t maxBytes)
 {
   if (!mapTransfer.GetIsInProgress()) {
     return MAP_TRANSFER_NONE;
   }
 
-  // send up to 100 pieces of the map at once so that the download goes faster
-  // if we wait for each MAPPART packet to be acknowledged by the client it'll take a long time to download
-  // this is because we would have to wait the round trip time (the ping time) between sending every 1442 bytes of map data
-  // doing it this way allows us to send at least 1.4 MB in each round trip interval which is much more reasonable
-  // the theoretical throughput is [1.4 MB * 1000 / ping] in KB/sec so someone with 100 ping (round trip ping, not LC ping) could download at 1400 KB/sec
-  // note: this creates a queue of map data which clogs up the connection when the client is on a slower connection (e.g. dialup)
-  // in this case any changes to the lobby are delayed by the amount of time it takes to send the queued data (i.e. 140 KB, which could be 30 seconds or more)
-  // for example, users joining and leaving, slot changes, chat messages would all appear to happen much later for the low bandwidth user
-  // note: the throughput is also limited by the number of times this code is executed each second
-  // e.g. if we send the maximum amount (1.4 MB) 10 times per second the theoretical throughput is 1400 KB/sec
-  // therefore the maximum throughput is 14 MB/sec, and this value slowly diminishes as the user's ping increases
-  // in addition to this, the throughput is limited by the configuration value bot_maxdownloadspeed
-  // in summary: the actual throughput is MIN( 1.4 * 1000 / ping, 1400, bot_maxdownloadspeed ) in KB/sec assuming only one user is downloading the map
+  // map parts are sent back to back, without waiting for each one to be acknowledged,
+  // or a download would take one round trip for every 1442 bytes
+  //
+  // maxBytes is granted by CMapUploadScheduler for the current update cycle. The grant is already bounded by
+  // - the bytes this user may have in flight, given their acknowledgement rate and round trip time, so that
+  //   a slow connection isn't flooded with map data, which would delay lobby updates and chat for them
+  // - the bytes already waiting in their send buffer
+  // - their fair share of <hosting.map_transfers.max_speed>, weighted in favor of players over observers
+  //
+  // only whole parts that fit in the grant are sent. Whatever is left is returned as credit,
+  // so that small grants add up over the next cycles, rather than being exceeded.
 
   const uint32_t mapSize = m_Map->GetMapSize();
 
-  if (mapTransfer.GetLastSentOffsetEnd() == 0 && (
-      mapTransfer.GetLastSentOffsetEnd() < mapTransfer.GetLastAck() + 1442 * m_Aura->m_Net.m_Config.m_MaxParallelMapPackets &&
-      mapTransfer.GetLastSentOffsetEnd() < mapSize &&
-      !(m_Aura->m_Net.m_Config.m_MaxUploadSpeed > 0 && m_Aura->m_Net.m_TransferredMapBytesThisUpdate > m_Aura->m_Net.m_Config.m_MaxUploadSpeed * 100)
-    )
-  ) {
+  if (mapTransfer.GetLastSentOffsetEnd() == 0 && maxBytes > 0 && mapSize > 0) {
     // overwrite the "started download ticks" since this is the first time we've sent any map data to the user
     // prior to this we've only determined if the user needs to download the map but it's possible we could have delayed sending any data due to download limits
 
     mapTransfer.Start();
   }
 
-  while (
-    mapTransfer.GetLastSentOffsetEnd() < mapTransfer.GetLastAck() + 1442 * m_Aura->m_Net.m_Config.m_MaxParallelMapPackets &&
-    mapTransfer.GetLastSentOffsetEnd() < mapSize &&
-
-    // limit the download speed if we're sending too much data
-    // the download counter is the # of map bytes downloaded in the last second (it's reset once per second)
-    !(m_Aura->m_Net.m_Config.m_MaxUploadSpeed > 0 && m_Aura->m_Net.m_TransferredMapBytesThisUpdate > m_Aura->m_Net.m_Config.m_MaxUploadSpeed * 100)
-  ) {
+  uint32_t sentBytes = 0;
+  while (sentBytes < maxBytes && mapTransfer.GetLastSentOffsetEnd() < mapSize) {
     uint32_t lastOffsetEnd = mapTransfer.GetLastSentOffsetEnd();
     const FileChunkTransient cachedChunk = GetMapChunk(lastOffsetEnd);
-    if (!cachedChunk.bytes) {
+    if (!cachedChunk.bytes || cachedChunk.start > lastOffsetEnd || cachedChunk.GetSizeFromCursor(lastOffsetEnd) == 0) {
       return MAP_TRANSFER_MISSING;
     }
 
-    const vector<uint8_t> packet = GameProtocol::SEND_W3GS_MAPPART(GetHostUID(), UID, lastOffsetEnd, cachedChunk);
-    uint32_t chunkSendSize = static_cast<uint32_t>(packet.size() - 18);
+    // don't send more than 1442 map bytes in one packet
+    // map data is queued straight from the cached chunk, and only the header is copied into the send buffer
+    uint32_t chunkSendSize = static_cast<uint32_t>(min(static_cast<size_t>(MAP_PART_SIZE), cachedChunk.GetSizeFromCursor(lastOffsetEnd)));
+    if (sentBytes + chunkSendSize > maxBytes) {
+      break;
+    }
+    const vector<uint8_t> header = GameProtocol::SEND_W3GS_MAPPART_HEADER(GetHostUID(), UID, lastOffsetEnd, cachedChunk.GetDataAtCursor(lastOffsetEnd), chunkSendSize);
     mapTransfer.SetLastSentOffsetEnd(lastOffsetEnd + chunkSendSize);
 
     // Update CRC32 for map parts sent to this user
@@ -3423,7 +3670,8 @@ uint8_t CGame::NextSendMap(CConnection* user, const uint8_t UID, MapTransfer& ma
 
     bool fullySent = mapTransfer.GetLastSentOffsetEnd() == mapSize;
     m_Aura->m_Net.m_TransferredMapBytesThisUpdate += chunkSendSize;
-    Send(user, packet);
+    sentBytes += chunkSendSize;
+    user->SendWithPayload(header, cachedChunk.bytes, lastOffsetEnd - cachedChunk.start, chunkSendSize);
 
     if (fullySent) {
       mapTransfer.SetFinished();
@@ -3435,6 +3683,7 @@ uint8_t CGame::NextSendMap(CConnection* user, const uint8_t UID, MapTransfer& ma
     }
   }
 
+  mapTransfer.SetUploadCredit(mapTransfer.GetUploadCredit() + (maxBytes - sentBytes));
   return MAP_TRANSFER_IN_PROGRESS;
 }
 
@@ -3822,7 +4071,7 @@ void CGame::SendGProxyEmptyActions()
   }
 
   if (m_BufferingEnabled & BUFFERING_ENABLED_PLAYING) {
-    m_GameHistory->m_PlayingBuffer.emplace_back(GAME_FRAME_TYPE_GPROXY);
+    m_GameHistory->m_PlayingBuffer.Append(GAME_FRAME_TYPE_GPROXY);
   }
 }
 
@@ -3838,12 +4087,20 @@ void CGame::SendAllActions()
   ++m_SyncCounter;
 
   SendGProxyEmptyActions();
-  vector<uint8_t> actions = GetFirstActionFrame().GetBytes((uint16_t)activeLatency);
+
+  // encoded once, then shared by every user's GProxy buffer - the frame is Reset() by SendAllActionsCallback()
+  const SharedPacket actions = MakeSharedPacket(GetFirstActionFrame().TakeBytes((uint16_t)activeLatency));
   SendAll(actions);
 
   if (m_BufferingEnabled & BUFFERING_ENABLED_PLAYING) {
-    m_GameHistory->m_PlayingBuffer.emplace_back(m_IsPaused ? GAME_FRAME_TYPE_PAUSED : GAME_FRAME_TYPE_ACTIONS, actions);
+    m_GameHistory->m_PlayingBuffer.Append(m_IsPaused ? GAME_FRAME_TYPE_PAUSED : GAME_FRAME_TYPE_ACTIONS, *actions);
     m_GameHistory->AddActionFrameCounter();
+    if (m_GameHistory->m_PlayingBuffer.GetHasCursors()) {
+      // observers schedule their next frame at CNet::UpdateBeforeGames
+      if (!m_Aura->m_Timers.Reschedule(m_ObserverTimer, GetTicks())) {
+        m_ObserverTimer = m_Aura->m_Timers.Schedule(GetTicks(), nullptr);
+      }
+    }
   }
 
   SendAllActionsCallback();
@@ -4109,9 +4366,8 @@ void CGame::MergeFrameNodes(vector<QueuedActionsFrameNode*>& frameNodes)
   while (i < frameCount) {
     CQueuedActionsFrame& obsoleteFrame = frameNodes[i]->data;
     targetFrame.MergeFrame(obsoleteFrame);
-    m_Actions.remove(frameNodes[i]);
-    // When the node is deleted, data is deleted as well.
-    delete frameNodes[i];
+    // MergeFrame() leaves the obsolete frame reset, so that its node can be recycled as is.
+    m_Actions.release(frameNodes[i]);
     ++i;
   }
 }
@@ -4443,7 +4699,7 @@ void CGame::SendGameDiscoveryInfo()
  * - StopPlayers
  * - EventUserAfterDisconnect (only in the game lobby)
  */
-void CGame::EventUserDeleted(GameUser::CGameUser* user, fd_set* /*fd*/, fd_set* send_fd)
+void CGame::EventUserDeleted(GameUser::CGameUser* user)
 {
   if (!user->GetMapChecked()) {
     user->AddLeftReason("map not validated");
@@ -4516,6 +4772,9 @@ void CGame::EventUserDeleted(GameUser::CGameUser* user, fd_set* /*fd*/, fd_set*
       // Intentionally reveal the name of the lobby leaver (may be trolling.)
       SendAllChat("Countdown stopped because [" + user->GetName() + "] left!");
       m_CountDownStarted = false;
+      m_CountDownFinished = false;
+      m_Aura->m_Timers.Cancel(m_CountDownTimer);
+      ScheduleAutoStartTimer(GetTicks());
     } else {
       // Observers that leave during countdown are replaced by fake observers.
       // This ensures the integrity of many things related to game slots.
@@ -4582,7 +4841,7 @@ void CGame::EventUserDeleted(GameUser::CGameUser* user, fd_set* /*fd*/, fd_set*
 
   // Flush queued data before the socket is destroyed.
   if (!user->GetDisconnected()) {
-    user->GetSocket()->DoSend(send_fd);
+    user->GetSocket()->DoSend();
   }
 }
 
@@ -4691,6 +4950,10 @@ void CGame::SetLaggingPlayerAndUpdate(GameUser::CGameUser* user)
     DLOG_APP_IF(LogLevel::kTrace, "global lagger update (+" + ToNameListSentence(laggingPlayers) + ")")
     SendAll(GameProtocol::SEND_W3GS_START_LAG(laggingPlayers, m_Aura->GetLoopTicks()));
   }
+
+  // the user may have a shorter deadline now that it's disconnected
+  UpdateActionTimer();
+  ScheduleLagScreenTimer();
 }
 
 void CGame::SetEveryoneLagging()
@@ -5017,7 +5280,7 @@ void CGame::SendLeftMessage(GameUser::CGameUser* user, const bool sendChat) cons
     case OnPlayerLeaveHandler::kNative: {
       SendAll(packet);
       if (m_GameLoaded && (m_BufferingEnabled & BUFFERING_ENABLED_PLAYING)) {
-        m_GameHistory->m_PlayingBuffer.emplace_back(GAME_FRAME_TYPE_LEAVER, packet);
+        m_GameHistory->m_PlayingBuffer.Append(GAME_FRAME_TYPE_LEAVER, packet);
       }
       break;
     }
@@ -5065,7 +5328,7 @@ bool CGame::SendEveryoneElseLeftAndDisconnect(const string& reason) const
     }
     if (m_GameLoaded && (m_BufferingEnabled & BUFFERING_ENABLED_PLAYING)) {
       vector<uint8_t> packet = GameProtocol::SEND_W3GS_PLAYERLEAVE_OTHERS(p1->GetUID(), PLAYERLEAVE_DISCONNECT);
-      m_GameHistory->m_PlayingBuffer.emplace_back(GAME_FRAME_TYPE_LEAVER, packet);
+      m_GameHistory->m_PlayingBuffer.Append(GAME_FRAME_TYPE_LEAVER, packet);
     }
     p1->CloseConnection();
     p1->SetStatus(USERSTATUS_ENDED);
@@ -5813,6 +6076,7 @@ void CGame::EventUserLoaded(GameUser::CGameUser* user)
     UserList laggingPlayers = GetLaggingUsers();
     if (laggingPlayers.empty()) {
       m_IsLagging = false;
+      UpdateActionTimer();
     }
     if (m_IsLagging) {
       DLOG_APP_IF(LogLevel::kTrace, "@[" + user->GetName() + "] lagger update (+" + ToNameListSentence(laggingPlayers) + ")")
@@ -6553,31 +6817,6 @@ void CGame::EventUserPongToHost(GameUser::CGameUser* user)
     user->SetLatencySent(true);
   }
 
-  if ((!user->GetIsReady() && user->GetMapReady() && !user->GetIsObserver()) &&
-    (!m_CountDownStarted && !m_ChatOnly && m_Aura->m_StartedGames.size() < m_Aura->m_Config.m_MaxStartedGames) &&
-    (user->GetReadyReminderIsDue() && user->GetIsRTTMeasuredConsistent())) {
-    if (!m_AutoStartRequirements.empty()) {
-      switch (GetPlayersReadyMode()) {
-        case PlayersReadyMode::kExpectRace: {
-          SendChat(user, "Choose your race for the match to automatically start (or type " + GetCmdToken() + "ready)");
-          break;
-        }
-        case PlayersReadyMode::kExplicit: {
-          SendChat(user, "Type " + GetCmdToken() + "ready for the match to automatically start.");
-          break;
-        }
-        case PlayersReadyMode::kFast: {
-          // This is an "always-ready" mode. Even !afk cannot be used.
-          // GameUser::CGameUser::UpdateReady() takes care of updating user readiness as soon as they are map-ready.
-          UNREACHABLE();
-          break;
-        }
-        IGNORE_ENUM_LAST(PlayersReadyMode)
-      }
-      user->SetReadyReminded();
-    }
-  }
-
   // autokick users with excessive pings but only if they're not reserved and we've received at least 3 pings from them
   // see the Update function for where we send pings
 
@@ -6617,6 +6856,39 @@ void CGame::EventUserPongToHost(GameUser::CGameUser* user)
   }
 }
 
+bool CGame::EventUserReadyReminderDue(GameUser::CGameUser* user)
+{
+  // see GameUser::CGameUser::RunReadyReminderTimer
+  if (user->GetIsReady() || !user->GetMapReady() || user->GetIsObserver()) {
+    return false;
+  }
+  if (m_CountDownStarted || m_ChatOnly || m_Aura->m_StartedGames.size() >= m_Aura->m_Config.m_MaxStartedGames) {
+    return false;
+  }
+  if (!user->GetIsRTTMeasuredConsistent() || m_AutoStartRequirements.empty()) {
+    return false;
+  }
+
+  switch (GetPlayersReadyMode()) {
+    case PlayersReadyMode::kExpectRace: {
+      SendChat(user, "Choose your race for the match to automatically start (or type " + GetCmdToken() + "ready)");
+      break;
+    }
+    case PlayersReadyMode::kExplicit: {
+      SendChat(user, "Type " + GetCmdToken() + "ready for the match to automatically start.");
+      break;
+    }
+    case PlayersReadyMode::kFast: {
+      // This is an "always-ready" mode. Even !afk cannot be used.
+      // GameUser::CGameUser::UpdateReady() takes care of updating user readiness as soon as they are map-ready.
+      UNREACHABLE();
+      break;
+    }
+    IGNORE_ENUM_LAST(PlayersReadyMode)
+  }
+  return true;
+}
+
 void CGame::EventUserMapReady(GameUser::CGameUser* user)
 {
   if (user->GetMapReady()) {
@@ -6624,6 +6896,9 @@ void CGame::EventUserMapReady(GameUser::CGameUser* user)
   }
   user->SetMapReady(true);
   UpdateReadyCounters();
+
+  // the RTT is usually measured by then
+  user->ScheduleReadyReminderTimer(GetTicks() + READY_REMINDER_RETRY_PERIOD);
 }
 
 // keyword: EventGameLoading
@@ -6710,6 +6985,10 @@ void CGame::EventGameStartedLoading()
   m_ChatEnabled = m_Config.m_EnableInGameChat;
   m_APMTrainerPaused = m_Map->GetMapType() == "microtraining";
   m_GameLoading = true;
+  m_Aura->m_Timers.Cancel(m_CountDownTimer);
+  m_Aura->m_Timers.Cancel(m_AutoStartTimer);
+  m_Aura->m_Timers.Cancel(m_LobbyTimeoutTimer);
+  ScheduleLoadingTimer();
 
   // since we use a fake countdown to deal with leavers during countdown the COUNTDOWN_START and COUNTDOWN_END packets are sent in quick succession
   // send a start countdown packet
@@ -6736,6 +7015,10 @@ void CGame::EventGameStartedLoading()
     AppendByteArrayFast(m_GameHistory->m_PlayersBuffer, GetJoinedPlayersInfo());
   }
 
+  if (m_Config.m_SaveReplays) {
+    StartReplay();
+  }
+
   // When load-in-game is disabled, m_LoadingVirtualBuffer also includes
   // load messages for disconnected real players, but we let automatic resizing handle that.
 
@@ -6755,6 +7038,8 @@ void CGame::EventGameStartedLoading()
     ++m_BeforePlayingEmptyActions;
   }
 
+  // preallocate every frame the latency equalizer may use, so that the action loop doesn't allocate them later
+  m_Actions.reserve(m_Config.m_LatencyEqualizerEnabled ? m_Config.m_LatencyEqualizerFrames : 1);
   m_Actions.emplaceBack();
   m_CurrentActionsFrame = m_Actions.head;
   ResetUserPingEqualizerDelays();
@@ -7027,6 +7312,9 @@ void CGame::EventGameLoaded()
   m_MapGameStartTime = CGameInteractiveHost::GetMapTime();
   m_GameLoading = false;
   m_GameLoaded = true;
+  m_Aura->m_Timers.Cancel(m_LoadingTimer);
+  UpdateActionTimer();
+  ScheduleLagScreenTimer();
 
   RunPlayerObfuscation();
 
@@ -7175,14 +7463,7 @@ void CGame::HandleGameLoadedStats()
     }
   }
 
-  int64_t Ticks = GetTicks();
-  if (!m_Aura->m_DB->Begin()) {
-    LOG_APP_IF(LogLevel::kWarning, "[STATS] failed to begin transaction for game loaded data")
-    return;
-  }
-  m_Aura->m_DB->UpdateLatestHistoryGameId(m_PersistentId);
-
-  m_Aura->m_DB->GameAdd(
+  m_Aura->m_DB->SubmitGameLoaded(
     m_PersistentId,
     m_CreatorText,
     m_Map->GetClientPath(),
@@ -7191,17 +7472,9 @@ void CGame::HandleGameLoadedStats()
     exportPlayerNames,
     exportPlayerIDs,
     exportSlotIDs,
-    exportColorIDs
+    exportColorIDs,
+    m_GameControllers
   );
-
-  for (auto& controllerData : m_GameControllers) {
-    m_Aura->m_DB->UpdateGamePlayerOnStart(m_PersistentId, controllerData);
-  }
-  if (!m_Aura->m_DB->Commit()) {
-    LOG_APP_IF(LogLevel::kWarning, "[STATS] failed to commit transaction for game loaded data")
-  } else {
-    LOG_APP_IF(LogLevel::kDebug, "[STATS] commited game loaded data in " + to_string(GetTicks() - Ticks) + " ms")
-  }
 }
 
 bool CGame::GetIsRemakeable()
@@ -7218,6 +7491,7 @@ void CGame::RemakeStart()
   m_Remaking = true;
   m_Remade = false;
   m_LobbyLoading = true;
+  CancelTimers();
 }
 
 void CGame::Remake()
@@ -7282,11 +7556,13 @@ void CGame::Remake()
   //m_PublicStart = false;
   m_Locked = false;
   m_CountDownStarted = false;
+  m_CountDownFinished = false;
   m_CountDownFast = false;
   m_CountDownUserInitiated = false;
   m_GameLoading = false;
   m_GameLoaded = false;
   m_IsLagging = false;
+  CancelTimers();
   m_IsDraftMode = false;
   m_IsHiddenPlayerNames = false;
   m_HadLeaver = false;
@@ -7314,6 +7590,8 @@ void CGame::Remake()
   m_KickVotePlayer.clear();
 
   m_LobbyLoading = false;
+  SchedulePingTimer(Ticks + 5000);
+  ScheduleLobbyTimeoutTimer();
   LOG_APP_IF(LogLevel::kInfo, "finished loading after remake")
   CreateVirtualHost();
 }
@@ -7898,6 +8176,87 @@ void CGame::ResolveBuffering()
   if (m_Config.m_EnableJoinObserversInProgress || m_Config.m_EnableJoinPlayersInProgress) {
     m_BufferingEnabled |= BUFFERING_ENABLED_ALL;
   }
+  if (m_Config.m_SaveReplays) {
+    m_BufferingEnabled |= BUFFERING_ENABLED_PLAYING;
+  }
+  if (m_BufferingEnabled & BUFFERING_ENABLED_PLAYING) {
+    // frames read by every cursor are only kept (on disk) if observers may still join
+    m_GameHistory->m_PlayingBuffer.SetKeepHistory(m_Config.m_EnableJoinObserversInProgress || m_Config.m_EnableJoinPlayersInProgress);
+    m_GameHistory->m_PlayingBuffer.SetMaxResidentBytes(static_cast<size_t>(m_Config.m_JoinInProgressMaxMemory) * 1024);
+    error_code ec;
+    const filesystem::path tempDirectory = filesystem::temp_directory_path(ec);
+    if (ec) {
+      LOG_APP_IF(LogLevel::kWarning, "no temporary directory available, game frames will be kept in memory")
+    } else {
+      m_GameHistory->m_PlayingBuffer.SetSpillPath(tempDirectory / filesystem::path("aura-frames-" + to_string(m_PersistentId) + "-" + to_string(GetRandomUInt32()) + ".bin"));
+    }
+  }
+}
+
+bool CGame::StartReplay()
+{
+  ReplayHeaderInfo headerInfo;
+  headerInfo.m_IsExpansion = GetIsExpansion();
+  headerInfo.m_War3Version = GetVersion();
+  headerInfo.m_BuildNumber = m_Config.m_ReplayBuildNumber;
+  headerInfo.m_GameType = GetGameType();
+  headerInfo.m_GameName = m_GameName;
+  headerInfo.m_StatString = GameStat(
+    GetGameFlags(),
+    ByteArrayToUInt16(GetAnnounceWidth(), false),
+    ByteArrayToUInt16(GetAnnounceHeight(), false),
+    GetSourceFilePath(),
+    GetIndexHostName(),
+    GetSourceFileHashBlizz(GetVersion()),
+    nullopt
+  ).Encode();
+  headerInfo.m_SlotInfo = GameProtocol::EncodeSlotInfo(m_Slots, m_RandomSeed, GetLayout(), m_Map->GetMapNumControllers());
+
+  // the first player is recorded as the replay host
+  for (const auto& user : m_Users) {
+    if (user->GetDeleteMe()) continue;
+    headerInfo.m_Players.emplace_back(user->GetUID(), user->GetDisplayName());
+  }
+  for (const CGameVirtualUser& fakeUser : m_FakeUsers) {
+    if (m_JoinInProgressVirtualUser.has_value() && fakeUser.GetUID() == m_JoinInProgressVirtualUser->GetUID()) {
+      continue;
+    }
+    headerInfo.m_Players.emplace_back(fakeUser.GetUID(), fakeUser.GetName());
+  }
+
+  error_code ec;
+  filesystem::create_directories(m_Aura->m_Config.m_ReplayPath, ec);
+  const filesystem::path filePath = m_Aura->m_Config.m_ReplayPath / filesystem::path("game-" + to_string(m_PersistentId) + ".w3g");
+  m_ReplayWriter = make_unique<CReplayWriter>(filePath, std::move(headerInfo));
+  if (!m_ReplayWriter->Start()) {
+    LOG_APP_IF(LogLevel::kWarning, "failed to start replay [" + PathToString(filePath) + "]")
+    m_ReplayWriter.reset();
+    return false;
+  }
+  m_ReplayFrameCursor.Open(&m_GameHistory->m_PlayingBuffer);
+  LOG_APP_IF(LogLevel::kDebug, "recording replay to [" + PathToString(filePath) + "]")
+  return true;
+}
+
+void CGame::FlushReplayFrames()
+{
+  while (m_ReplayFrameCursor.GetHasNext()) {
+    m_ReplayWriter->AddFrame(m_ReplayFrameCursor.Peek());
+    m_ReplayFrameCursor.Advance();
+  }
+}
+
+void CGame::CloseReplay()
+{
+  if (!m_ReplayWriter) return;
+  if (m_ReplayFrameCursor.GetIsOpen()) {
+    FlushReplayFrames();
+    m_ReplayFrameCursor.Close();
+  }
+  if (m_ReplayWriter->Finish()) {
+    LOG_APP_IF(LogLevel::kInfo, "saved replay [" + PathToString(m_ReplayWriter->GetFilePath()) + "] (" + ToFormattedTimeStamp(m_ReplayWriter->GetReplayLength() / 1000) + ")")
+  }
+  m_ReplayWriter.reset();
 }
 
 bool CGame::GetHasAnyActiveTeam() const
@@ -9479,6 +9838,7 @@ void CGame::SetOwner(const string& name, const string& realm)
   m_OwnerName = name;
   m_OwnerRealm = realm;
   m_LastOwnerAssigned = GetTicks();
+  ScheduleLobbyTimeoutTimer();
 
   UncacheOwner();
 
@@ -9797,8 +10157,11 @@ void CGame::StartCountDown(bool fromUser, bool force)
 
   m_Replaceable = false;
   m_CountDownStarted = true;
+  m_CountDownFinished = false;
   m_CountDownUserInitiated = fromUser;
   m_CountDownCounter = m_Config.m_LobbyCountDownStartValue;
+  m_Aura->m_Timers.Cancel(m_AutoStartTimer);
+  ScheduleCountDownTimer(m_LastCountDownTicks + m_Config.m_LobbyCountDownInterval);
 
   if (!m_KickVotePlayer.empty()) {
     m_KickVotePlayer.clear();
@@ -9842,9 +10205,12 @@ void CGame::StartCountDownFast(bool fromUser)
 void CGame::StopCountDown()
 {
   m_CountDownStarted = false;
+  m_CountDownFinished = false;
   m_CountDownFast = false;
   m_CountDownUserInitiated = false;
   m_CountDownCounter = 0;
+  m_Aura->m_Timers.Cancel(m_CountDownTimer);
+  ScheduleAutoStartTimer(GetTicks());
 }
 
 bool CGame::StopPlayers(const string& reason)
@@ -59,6 +59,7 @@
 #include "game_virtual_user.h"
 #include "save_game.h"
 #include "socket.h"
+#include "timer_queue.h"
 #include "config/config_game.h"
 
 //
@@ -125,6 +126,14 @@ protected:
   std::string                                            m_MapSiteURL;
   int64_t                                                m_CreationTime;                  // GetTime when the game was created
   int64_t                                                m_LastPingTicks;                 // GetTicks when the last ping was sent
+  TimerId                                                m_PingTimer;                     // sends the next ping
+  TimerId                                                m_ActionTimer;                   // wakes up the main loop when the next action frame is due
+  TimerId                                                m_CountDownTimer;                // sends the next countdown message
+  TimerId                                                m_AutoStartTimer;                // starts the countdown once the autostart requirements are met
+  TimerId                                                m_LobbyTimeoutTimer;             // releases absent owners, and closes abandoned lobbies
+  TimerId                                                m_LoadingTimer;                  // drops users that take too long to load, and refreshes the load-in-game lag screen
+  TimerId                                                m_LagScreenTimer;                // drops lagging users, refreshes the lag screen, and reports pings while it's up
+  TimerId                                                m_ObserverTimer;                 // wakes up the main loop, so that observers get new frames
   int64_t                                                m_LastCheckActionsTicks;
   int64_t                                                m_LastRefreshTime;               // GetTime when the last game refresh was sent
   int64_t                                                m_LastDownloadCounterResetTicks; // GetTicks when the download counter was last reset
@@ -195,6 +204,7 @@ protected:
   bool                                                   m_CountDownStarted;              // if the game start countdown has started or not
   bool                                                   m_CountDownFast;
   bool                                                   m_CountDownUserInitiated;
+  bool                                                   m_CountDownFinished;             // the countdown reached zero, the game starts loading at the next CGame::UpdateLobby
   bool                                                   m_GameLoading;                   // if the game is currently loading or not
   bool                                                   m_GameLoaded;                    // if the game has loaded or not
   bool                                                   m_LobbyLoading;                  // if the lobby is being setup asynchronously
@@ -222,6 +232,8 @@ protected:
 
   SharedByteArray                                        m_LoadedMapChunk;
   std::shared_ptr<GameHistory>                           m_GameHistory;
+  std::unique_ptr<CReplayWriter>                         m_ReplayWriter;                  // streams the replay to disk while the game is played
+  CGameFrameCursor                                       m_ReplayFrameCursor;             // next frame of m_GameHistory->m_PlayingBuffer to be written to the replay
   std::optional<GameResults>                             m_GameResults;
   GameResultSource                                       m_GameResultsSource;
 
@@ -344,7 +356,6 @@ public:
   uint8_t                                                GetLayout() const;
   uint8_t                                                GetCustomLayout() const { return m_CustomLayout; }
   bool                                                   GetIsCustomForces() const;
-  void                                                   UpdateSelectBlockTime(int64_t& usecBlockTime) const;
   uint32_t                                               GetSlotsOccupied() const;
   uint32_t                                               GetSlotsOpen() const;
   bool                                                   HasSlotsOpen() const;
@@ -443,13 +454,27 @@ public:
 
   // processing functions
 
-  uint32_t                                               SetFD(fd_set* fd, fd_set* send_fd, int32_t* nfds) const;
   void                                                   UpdateJoinable();
   bool                                                   UpdateLobby();
   void                                                   UpdateLoading();
   void                                                   UpdateLoaded();
-  bool                                                   Update(fd_set* fd, fd_set* send_fd);
-  void                                                   UpdatePost(fd_set* send_fd) const;
+  bool                                                   Update();
+  void                                                   UpdatePost() const;
+  void                                                   RunPingTimer();
+  void                                                   SchedulePingTimer(const int64_t dueTicks);
+  void                                                   UpdateActionTimer();
+  void                                                   RunCountDownTimer();
+  void                                                   ScheduleCountDownTimer(const int64_t dueTicks);
+  void                                                   RunAutoStartTimer();
+  void                                                   ScheduleAutoStartTimer(const int64_t notBeforeTicks);
+  void                                                   RunLobbyTimeoutTimer();
+  void                                                   ScheduleLobbyTimeoutTimer();
+  void                                                   RunLoadingTimer();
+  void                                                   ScheduleLoadingTimer();
+  void                                                   RunLagScreenTimer();
+  void                                                   ScheduleLagScreenTimer();
+  [[nodiscard]] int64_t                                  GetLaggerWaitTicks(const GameUser::CGameUser* user, const std::pair<int64_t, int64_t>& waitTicks) const;
+  void                                                   CancelTimers();
   void                                                   CheckLobbyTimeouts();
   void                                                   RunActionsScheduler();
   void                                                   RunActionsSchedulerInner(const int64_t newLatency, const uint8_t maxNewEqualizerOffset, const int64_t oldLatency, const uint8_t maxOldEqualizerOffset, const int64_t actionLateBy);
@@ -471,6 +496,7 @@ public:
   void                                                   SendMulti(const std::vector<uint8_t>& UIDs, const std::vector<uint8_t>& data) const;
   void                                                   SendAsChat(CConnection* player, const std::vector<uint8_t>& data) const;
   void                                                   SendAll(const std::vector<uint8_t>& data) const;
+  void                                                   SendAll(const SharedPacket& packet) const;
   bool                                                   SendAllAsChat(const std::vector<uint8_t>& data) const;
   bool                                                   SendObserversAsChat(const std::vector<uint8_t>& data) const;
  
@@ -539,7 +565,7 @@ public:
   // note: these are only called while iterating through the m_Potentials or m_Users std::vectors
   // therefore you can't modify those std::vectors and must use the player's m_DeleteMe member to flag for deletion
 
-  void                      EventUserDeleted(GameUser::CGameUser* user, fd_set* fd, fd_set* send_fd);
+  void                      EventUserDeleted(GameUser::CGameUser* user);
   void                      EventLobbyLastPlayerLeaves();
   void                      ReportAllPings() const;
   void                      SetLaggingPlayerAndUpdate(GameUser::CGameUser* user);
@@ -575,6 +601,7 @@ public:
   void                      EventUserDropRequest(GameUser::CGameUser* user);
   void                      EventUserMapSize(GameUser::CGameUser* user, const CIncomingMapFileSize& mapSize);
   void                      EventUserPongToHost(GameUser::CGameUser* user);
+  [[nodiscard]] bool        EventUserReadyReminderDue(GameUser::CGameUser* user);
   void                      EventUserMapReady(GameUser::CGameUser* user);
 
   // these events are called outside of any iterations
@@ -625,6 +652,9 @@ public:
   uint8_t                   SimulateActionUID(const uint8_t actionType, GameUser::CGameUser* user, const bool isDisconnect, const uint8_t actorMask);
   void                      ResolveVirtualUsers();
   void                      ResolveBuffering();
+  bool                      StartReplay();
+  void                      FlushReplayFrames();
+  void                      CloseReplay();
   bool                      GetHasAnyActiveTeam() const;
   bool                      GetHasAnyUser() const;
   bool                      GetIsRealPlayerSlot(const uint8_t SID) const;
@@ -646,7 +676,7 @@ public:
   uint8_t                   GetPassiveVirtualUserTeamSID(const uint8_t team) const;
   inline bool               GetHMCEnabled() const { return m_HMCEnabled; }
   void                      SendIncomingPlayerInfo(GameUser::CGameUser* user) const;
-  uint8_t                   NextSendMap(CConnection* connection, const uint8_t UID, MapTransfer& mapTransfer);
+  uint8_t                   NextSendMap(CConnection* connection, const uint8_t UID, MapTransfer& mapTransfer, const uint32_t maxBytes);
   GameUser::CGameUser*                JoinPlayer(CConnection* connection, const CIncomingJoinRequest& joinRequest, const uint8_t SID, const uint8_t UID, const uint8_t HostCounterID, const std::string JoinedRealm, const bool IsReserved, const bool IsUnverifiedAdmin);  
   bool                      CreateVirtualHost();
   bool                      DeleteVirtualHost();
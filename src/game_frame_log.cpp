@@ -0,0 +1,486 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#include "game_frame_log.h"
+#include "file_util.h"
+#include "util.h"
+
+using namespace std;
+
+//
+// CGameFrameLog::Segment
+//
+
+CGameFrameLog::Segment::Segment(const size_t nFirstFrame)
+ : m_FirstFrame(nFirstFrame),
+   m_Size(0),
+   m_SpillPending(false),
+   m_LoadPending(false),
+   m_LoadFailed(false)
+{
+}
+
+CGameFrameLog::Segment::~Segment() = default;
+
+//
+// CGameFrameLog
+//
+
+CGameFrameLog::CGameFrameLog()
+ : m_NumFrames(0),
+   m_NumActionFrames(0),
+   m_NumBytes(0),
+   m_GameTicks(0),
+   m_Latency(0),
+   m_FirstAvailableFrame(0),
+   m_ResidentBytes(0),
+   m_SpillingBytes(0),
+   m_MaxResidentBytes(GAME_FRAME_MAX_RESIDENT_BYTES),
+   m_KeepHistory(true),
+   m_SpillSize(0),
+   m_SpillFailed(false),
+   m_Busy(false),
+   m_Exiting(false)
+{
+}
+
+CGameFrameLog::~CGameFrameLog()
+{
+  for (auto& cursor : m_Cursors) {
+    cursor->m_Log = nullptr;
+  }
+  if (m_Worker.joinable()) {
+    {
+      lock_guard<mutex> lock(m_Mutex);
+      m_Exiting = true;
+      m_Tasks.clear();
+    }
+    m_WakeUp.notify_one();
+    m_Worker.join();
+  }
+  if (m_SpillFile.is_open()) {
+    m_SpillFile.close();
+    FileDelete(m_SpillPath);
+  }
+}
+
+void CGameFrameLog::Append(const uint8_t type)
+{
+  Append(type, nullptr, 0);
+}
+
+void CGameFrameLog::Append(const uint8_t type, const vector<uint8_t>& bytes)
+{
+  Append(type, bytes.data(), bytes.size());
+}
+
+void CGameFrameLog::Append(const uint8_t type, const uint8_t* data, const size_t size)
+{
+  if (m_SpillingBytes > 0) {
+    // release the segments that have been written meanwhile
+    Trim();
+  }
+
+  if (m_Segments.empty() || m_Segments.back().m_Data->capacity() - m_Segments.back().m_Data->size() < size) {
+    m_Segments.emplace_back(m_NumFrames);
+    Segment& segment = m_Segments.back();
+    segment.m_Data = make_shared<vector<uint8_t>>();
+    segment.m_Data->reserve(max(GAME_FRAME_SEGMENT_SIZE, size));
+    m_ResidentSegments.push_back(m_Segments.size() - 1);
+    // the previous segment is complete now, and may already have been read by everyone
+    Trim();
+  }
+
+  Segment& segment = m_Segments.back();
+  segment.m_Frames.push_back(FrameRecord{type, segment.m_Size, static_cast<uint32_t>(size)});
+  if (size > 0) {
+    segment.m_Data->insert(segment.m_Data->end(), data, data + size);
+    segment.m_Size += static_cast<uint32_t>(size);
+    m_ResidentBytes += size;
+  }
+  ++m_NumFrames;
+  m_NumBytes += size;
+
+  switch (type) {
+    case GAME_FRAME_TYPE_ACTIONS:
+      m_GameTicks += m_Latency;
+      // falls through
+    case GAME_FRAME_TYPE_PAUSED:
+      if (++m_NumActionFrames % GAME_FRAME_CHECKPOINT_INTERVAL == 0) {
+        AddCheckpoint();
+      }
+      break;
+    case GAME_FRAME_TYPE_LATENCY:
+      if (size >= 2) {
+        SetLatency(ByteArrayToUInt16(data, false));
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void CGameFrameLog::SetLatency(const uint16_t latency)
+{
+  if (latency == m_Latency) return;
+  m_Latency = latency;
+  AddCheckpoint();
+}
+
+void CGameFrameLog::AddCheckpoint()
+{
+  if (!m_Checkpoints.empty() && m_Checkpoints.back().m_Frame == m_NumFrames) {
+    m_Checkpoints.back().m_Latency = m_Latency;
+    return;
+  }
+  m_Checkpoints.push_back(Checkpoint{m_NumFrames, m_GameTicks, m_NumActionFrames, m_NumBytes, m_Latency});
+}
+
+const CGameFrameLog::Checkpoint* CGameFrameLog::GetCheckpoint(const int64_t gameTicks) const
+{
+  auto it = upper_bound(m_Checkpoints.begin(), m_Checkpoints.end(), gameTicks, [](const int64_t ticks, const Checkpoint& checkpoint) {
+    return ticks < checkpoint.m_GameTicks;
+  });
+  if (it == m_Checkpoints.begin()) return nullptr;
+  return &*(it - 1);
+}
+
+size_t CGameFrameLog::GetFrameAtGameTicks(const int64_t gameTicks) const
+{
+  // the latency is constant between checkpoints, so frame types are enough to keep track of the game time
+  const Checkpoint* checkpoint = GetCheckpoint(gameTicks);
+  if (!checkpoint) return 0;
+  if (checkpoint->m_Frame < m_FirstAvailableFrame) {
+    // the frames between the checkpoint and the target were discarded, see SetKeepHistory()
+    return m_FirstAvailableFrame;
+  }
+  size_t frameIndex = checkpoint->m_Frame;
+  int64_t ticks = checkpoint->m_GameTicks;
+  while (ticks < gameTicks && frameIndex < m_NumFrames) {
+    const Segment& segment = m_Segments[FindSegment(frameIndex)];
+    for (auto it = segment.m_Frames.begin() + (frameIndex - segment.m_FirstFrame); it != segment.m_Frames.end() && ticks < gameTicks; ++it) {
+      if (it->m_Type == GAME_FRAME_TYPE_ACTIONS) {
+        ticks += checkpoint->m_Latency;
+      }
+      ++frameIndex;
+    }
+  }
+  return frameIndex;
+}
+
+size_t CGameFrameLog::FindSegment(const size_t frameIndex) const
+{
+  auto it = upper_bound(m_Segments.begin(), m_Segments.end(), frameIndex, [](const size_t index, const Segment& segment) {
+    return index < segment.m_FirstFrame;
+  });
+  return static_cast<size_t>(it - m_Segments.begin()) - 1;
+}
+
+GameFrame CGameFrameLog::GetFrame(const size_t frameIndex, size_t& segmentEnd)
+{
+  if (frameIndex < m_FirstAvailableFrame || frameIndex >= m_NumFrames) {
+    segmentEnd = frameIndex + 1;
+    return GameFrame(GAME_FRAME_TYPE_MISSING);
+  }
+
+  const size_t segmentIndex = FindSegment(frameIndex);
+  Segment& segment = m_Segments[segmentIndex];
+  segmentEnd = segment.m_FirstFrame + segment.m_Frames.size();
+  if (!segment.m_Data) {
+    // it may have been read back already
+    CollectSpills();
+  }
+  if (!segment.m_Data) {
+    if (segment.m_LoadFailed || !segment.m_SpillOffset.has_value()) {
+      return GameFrame(GAME_FRAME_TYPE_MISSING);
+    }
+    Load(segmentIndex);
+    return GameFrame(GAME_FRAME_TYPE_PENDING);
+  }
+  const FrameRecord& record = segment.m_Frames[frameIndex - segment.m_FirstFrame];
+  return GameFrame(record.m_Type, segment.m_Data, record.m_Offset, record.m_Size);
+}
+
+void CGameFrameLog::Trim()
+{
+  CollectSpills();
+
+  size_t minPosition = m_NumFrames;
+  for (const auto& cursor : m_Cursors) {
+    if (cursor->GetPosition() < minPosition) minPosition = cursor->GetPosition();
+  }
+
+  // oldest first, the last segment is still being appended to
+  sort(m_ResidentSegments.begin(), m_ResidentSegments.end());
+  const size_t lastSegment = m_Segments.size() - 1;
+  for (size_t i = 0; i < m_ResidentSegments.size();) {
+    const size_t segmentIndex = m_ResidentSegments[i];
+    const Segment& segment = m_Segments[segmentIndex];
+    if (segmentIndex == lastSegment || minPosition < segment.m_FirstFrame + segment.m_Frames.size()) {
+      // still needed
+      ++i;
+      continue;
+    }
+    if (!m_KeepHistory) {
+      // nobody will ever read it again
+      Discard(segmentIndex);
+      continue;
+    }
+    if (m_ResidentBytes - m_SpillingBytes <= m_MaxResidentBytes) {
+      break;
+    }
+    if (segment.m_SpillPending) {
+      ++i;
+    } else if (segment.m_SpillOffset.has_value()) {
+      Evict(segmentIndex);
+    } else if (Spill(segmentIndex)) {
+      // released once written, see CollectSpills()
+      ++i;
+    } else {
+      // keep it in memory if it cannot be spilled
+      break;
+    }
+  }
+}
+
+void CGameFrameLog::Drain()
+{
+  if (!m_Worker.joinable()) return;
+  {
+    unique_lock<mutex> lock(m_Mutex);
+    m_Drained.wait(lock, [this] { return m_Tasks.empty() && !m_Busy; });
+  }
+  Trim();
+}
+
+void CGameFrameLog::Evict(const size_t segmentIndex)
+{
+  Segment& segment = m_Segments[segmentIndex];
+  m_ResidentBytes -= segment.m_Size;
+  segment.m_Data.reset();
+  m_ResidentSegments.erase(find(m_ResidentSegments.begin(), m_ResidentSegments.end(), segmentIndex));
+}
+
+void CGameFrameLog::Discard(const size_t segmentIndex)
+{
+  Segment& segment = m_Segments[segmentIndex];
+  m_FirstAvailableFrame = max(m_FirstAvailableFrame, segment.m_FirstFrame + segment.m_Frames.size());
+  segment.m_Frames = vector<FrameRecord>();
+  Evict(segmentIndex);
+}
+
+bool CGameFrameLog::Spill(const size_t segmentIndex)
+{
+  if (m_SpillFailed || m_SpillPath.empty()) return false;
+
+  Segment& segment = m_Segments[segmentIndex];
+  segment.m_SpillPending = true;
+  m_SpillingBytes += segment.m_Size;
+  PushTask(SpillTask{segmentIndex, m_SpillSize, segment.m_Size, segment.m_Data, false, false});
+  m_SpillSize += segment.m_Size;
+  return true;
+}
+
+void CGameFrameLog::Load(const size_t segmentIndex)
+{
+  Segment& segment = m_Segments[segmentIndex];
+  if (segment.m_LoadPending) return;
+  segment.m_LoadPending = true;
+  PushTask(SpillTask{segmentIndex, segment.m_SpillOffset.value(), segment.m_Size, nullptr, true, false});
+}
+
+void CGameFrameLog::CollectSpills()
+{
+  vector<SpillTask> results;
+  {
+    lock_guard<mutex> lock(m_Mutex);
+    if (m_Results.empty()) return;
+    results.swap(m_Results);
+  }
+
+  for (auto& result : results) {
+    Segment& segment = m_Segments[result.m_Segment];
+    if (result.m_IsLoad) {
+      segment.m_LoadPending = false;
+      if (!result.m_Success) {
+        Print("[GAME] failed to read spill file [" + PathToString(m_SpillPath) + "]");
+        segment.m_LoadFailed = true;
+        continue;
+      }
+      segment.m_Data = std::move(result.m_Data);
+      m_ResidentBytes += segment.m_Size;
+      m_ResidentSegments.push_back(result.m_Segment);
+      continue;
+    }
+
+    segment.m_SpillPending = false;
+    m_SpillingBytes -= segment.m_Size;
+    if (!result.m_Success) {
+      if (!m_SpillFailed) {
+        Print("[GAME] failed to write spill file [" + PathToString(m_SpillPath) + "], game frames will be kept in memory");
+        m_SpillFailed = true;
+      }
+      continue;
+    }
+    // Trim() releases it if it's still over the limit
+    segment.m_SpillOffset = result.m_Offset;
+  }
+}
+
+void CGameFrameLog::PushTask(SpillTask&& task)
+{
+  if (!m_Worker.joinable()) {
+    m_Worker = thread(&CGameFrameLog::RunWorker, this);
+  }
+  {
+    lock_guard<mutex> lock(m_Mutex);
+    m_Tasks.push_back(std::move(task));
+  }
+  m_WakeUp.notify_one();
+}
+
+void CGameFrameLog::RunWorker()
+{
+  while (true) {
+    SpillTask task;
+    {
+      unique_lock<mutex> lock(m_Mutex);
+      m_WakeUp.wait(lock, [this] { return m_Exiting || !m_Tasks.empty(); });
+      if (m_Tasks.empty()) break;
+      task = std::move(m_Tasks.front());
+      m_Tasks.pop_front();
+      m_Busy = true;
+    }
+    task.m_Success = task.m_IsLoad ? ReadSegment(task) : WriteSegment(task);
+    {
+      lock_guard<mutex> lock(m_Mutex);
+      m_Results.push_back(std::move(task));
+      m_Busy = false;
+    }
+    m_Drained.notify_all();
+  }
+}
+
+bool CGameFrameLog::WriteSegment(SpillTask& task)
+{
+  if (!m_SpillFile.is_open()) {
+    m_SpillFile.open(m_SpillPath, ios::in | ios::out | ios::binary | ios::trunc);
+    if (!m_SpillFile.is_open()) {
+      return false;
+    }
+  }
+
+  m_SpillFile.seekp(static_cast<streamoff>(task.m_Offset));
+  m_SpillFile.write(reinterpret_cast<const char*>(task.m_Data->data()), task.m_Size);
+  m_SpillFile.flush();
+  // the segment is released by the main thread
+  task.m_Data.reset();
+  if (m_SpillFile.fail()) {
+    m_SpillFile.clear();
+    return false;
+  }
+  return true;
+}
+
+bool CGameFrameLog::ReadSegment(SpillTask& task)
+{
+  if (!m_SpillFile.is_open()) {
+    return false;
+  }
+
+  task.m_Data = make_shared<vector<uint8_t>>(task.m_Size);
+  m_SpillFile.seekg(static_cast<streamoff>(task.m_Offset));
+  m_SpillFile.read(reinterpret_cast<char*>(task.m_Data->data()), task.m_Size);
+  if (m_SpillFile.fail()) {
+    m_SpillFile.clear();
+    task.m_Data.reset();
+    return false;
+  }
+  return true;
+}
+
+void CGameFrameLog::AddCursor(CGameFrameCursor* cursor)
+{
+  m_Cursors.push_back(cursor);
+}
+
+void CGameFrameLog::RemoveCursor(CGameFrameCursor* cursor)
+{
+  m_Cursors.erase(remove(m_Cursors.begin(), m_Cursors.end(), cursor), m_Cursors.end());
+  if (!m_Segments.empty()) {
+    Trim();
+  }
+}
+
+//
+// CGameFrameCursor
+//
+
+CGameFrameCursor::CGameFrameCursor()
+ : m_Log(nullptr),
+   m_Position(0),
+   m_SegmentEnd(0),
+   m_Waiting(false)
+{
+}
+
+CGameFrameCursor::~CGameFrameCursor()
+{
+  Close();
+}
+
+void CGameFrameCursor::Open(CGameFrameLog* log)
+{
+  Close();
+  m_Log = log;
+  m_Position = log->GetFirstAvailableFrame();
+  m_SegmentEnd = m_Position;
+  m_Waiting = false;
+  m_Log->AddCursor(this);
+}
+
+void CGameFrameCursor::Close()
+{
+  if (!m_Log) return;
+  CGameFrameLog* log = m_Log;
+  m_Log = nullptr;
+  log->RemoveCursor(this);
+}
+
+GameFrame CGameFrameCursor::Peek()
+{
+  GameFrame frame = m_Log->GetFrame(m_Position, m_SegmentEnd);
+  m_Waiting = frame.GetType() == GAME_FRAME_TYPE_PENDING;
+  return frame;
+}
+
+void CGameFrameCursor::Advance()
+{
+  ++m_Position;
+  if (m_Position >= m_SegmentEnd && m_Log) {
+    // just left a segment behind
+    m_Log->Trim();
+  }
+}
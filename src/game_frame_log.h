@@ -0,0 +1,259 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#ifndef AURA_GAME_FRAME_LOG_H_
+#define AURA_GAME_FRAME_LOG_H_
+
+#include "includes.h"
+#include "protocol/packet_view.h"
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+//
+// GameFrame
+//
+// A view of a single recorded frame. The segment it lives in is kept alive for as long as the view is.
+//
+
+struct GameFrame
+{
+  uint8_t                                                m_Type;
+  SharedPacket                                           m_Segment;
+  uint32_t                                               m_Offset;
+  uint32_t                                               m_Size;
+
+  GameFrame(const uint8_t nType)
+   : m_Type(nType),
+     m_Offset(0),
+     m_Size(0)
+  {};
+
+  GameFrame(const uint8_t nType, const SharedPacket& nBytes)
+   : m_Type(nType),
+     m_Segment(nBytes),
+     m_Offset(0),
+     m_Size(nBytes ? static_cast<uint32_t>(nBytes->size()) : 0)
+  {}
+
+  GameFrame(const uint8_t nType, const SharedPacket& nSegment, const uint32_t nOffset, const uint32_t nSize)
+   : m_Type(nType),
+     m_Segment(nSegment),
+     m_Offset(nOffset),
+     m_Size(nSize)
+  {}
+
+  ~GameFrame() = default;
+
+  inline uint8_t                     GetType() const { return m_Type; }
+  inline const SharedPacket&         GetSegment() const { return m_Segment; }
+  inline uint32_t                    GetOffset() const { return m_Offset; }
+  inline uint32_t                    GetSize() const { return m_Size; }
+  inline bool                        GetIsEmpty() const { return m_Size == 0; }
+  inline const uint8_t*              GetData() const { return m_Segment ? m_Segment->data() + m_Offset : nullptr; }
+  inline std::string GetTypeName() const {
+    switch (m_Type) {
+      case GAME_FRAME_TYPE_ACTIONS: return "actions";
+      case GAME_FRAME_TYPE_PAUSED: return "paused";
+      case GAME_FRAME_TYPE_LEAVER: return "leaver";
+      case GAME_FRAME_TYPE_CHAT: return "chat";
+      case GAME_FRAME_TYPE_LATENCY: return "latency";
+      case GAME_FRAME_TYPE_GPROXY: return "gproxy";
+      case GAME_FRAME_TYPE_PENDING: return "pending";
+      case GAME_FRAME_TYPE_MISSING: return "missing";
+      default: return "unknown";
+    }
+  };
+};
+
+//
+// CGameFrameLog
+//
+// Append-only record of the frames of a started game, for async observers and replays.
+//
+// Frames are packed back to back into fixed-capacity segments, with a small index per segment.
+// Once every open cursor has gone past a segment, and the log holds more than m_MaxResidentBytes,
+// the oldest segments are written to a spill file by a background thread, and released once written.
+// They are read back by the same thread only if a cursor (e.g. a newly joined observer) gets to them again,
+// and meanwhile the cursor gets GAME_FRAME_TYPE_PENDING frames.
+// Memory use is therefore bounded by the configured limit, or by how far the slowest reader lags behind.
+//
+// Segments never grow past their reserved capacity, so frames already handed to sockets stay valid.
+//
+// The log also keeps checkpoints of the game time every few action frames, and wherever the latency changes,
+// so that a game time can be mapped to a frame without reading any frame data.
+//
+
+class CGameFrameLog
+{
+public:
+  struct FrameRecord
+  {
+    uint8_t                                              m_Type;
+    uint32_t                                             m_Offset;
+    uint32_t                                             m_Size;
+  };
+
+  struct Checkpoint
+  {
+    size_t                                               m_Frame;          // first frame after the checkpoint
+    int64_t                                              m_GameTicks;
+    size_t                                               m_ActionFrames;
+    uint64_t                                             m_Bytes;
+    uint16_t                                             m_Latency;        // in effect until the next checkpoint
+  };
+
+  struct Segment
+  {
+    size_t                                               m_FirstFrame;
+    std::vector<FrameRecord>                             m_Frames;
+    std::shared_ptr<std::vector<uint8_t>>                m_Data;           // nullptr while only available from the spill file
+    uint32_t                                             m_Size;
+    std::optional<uint64_t>                              m_SpillOffset;
+    bool                                                 m_SpillPending;   // queued for writing, still in memory meanwhile
+    bool                                                 m_LoadPending;    // queued for reading
+    bool                                                 m_LoadFailed;
+
+    Segment(const size_t nFirstFrame);
+    ~Segment();
+  };
+
+  struct SpillTask
+  {
+    size_t                                               m_Segment;
+    uint64_t                                             m_Offset;
+    uint32_t                                             m_Size;
+    std::shared_ptr<std::vector<uint8_t>>                m_Data;
+    bool                                                 m_IsLoad;
+    bool                                                 m_Success;
+  };
+
+  std::vector<Segment>                                   m_Segments;
+  std::vector<size_t>                                    m_ResidentSegments;
+  std::vector<CGameFrameCursor*>                         m_Cursors;
+  std::vector<Checkpoint>                                m_Checkpoints;
+  size_t                                                 m_NumFrames;
+  size_t                                                 m_NumActionFrames;
+  uint64_t                                               m_NumBytes;
+  int64_t                                                m_GameTicks;
+  uint16_t                                               m_Latency;
+  size_t                                                 m_FirstAvailableFrame;  // frames before this one were discarded
+  size_t                                                 m_ResidentBytes;
+  size_t                                                 m_SpillingBytes;        // resident bytes queued for writing
+  size_t                                                 m_MaxResidentBytes;
+  bool                                                   m_KeepHistory;
+  std::filesystem::path                                  m_SpillPath;
+  uint64_t                                               m_SpillSize;
+  bool                                                   m_SpillFailed;
+
+  std::mutex                                             m_Mutex;
+  std::condition_variable                                m_WakeUp;
+  std::condition_variable                                m_Drained;
+  std::deque<SpillTask>                                  m_Tasks;
+  std::vector<SpillTask>                                 m_Results;
+  bool                                                   m_Busy;
+  bool                                                   m_Exiting;
+  std::thread                                            m_Worker;
+
+  // only touched by the worker while it runs
+  std::fstream                                           m_SpillFile;
+
+  CGameFrameLog();
+  ~CGameFrameLog();
+  CGameFrameLog(CGameFrameLog&) = delete;
+
+  [[nodiscard]] inline size_t                            GetNumFrames() const { return m_NumFrames; }
+  [[nodiscard]] inline size_t                            GetFirstAvailableFrame() const { return m_FirstAvailableFrame; }
+  [[nodiscard]] inline size_t                            GetNumSegments() const { return m_Segments.size(); }
+  [[nodiscard]] inline size_t                            GetResidentBytes() const { return m_ResidentBytes; }
+  [[nodiscard]] inline bool                              GetHasCursors() const { return !m_Cursors.empty(); }
+  [[nodiscard]] inline int64_t                           GetGameTicks() const { return m_GameTicks; }
+  [[nodiscard]] inline uint64_t                          GetNumBytes() const { return m_NumBytes; }
+
+  inline void                                            SetKeepHistory(const bool nKeepHistory) { m_KeepHistory = nKeepHistory; }
+  inline void                                            SetMaxResidentBytes(const size_t nMaxResidentBytes) { m_MaxResidentBytes = nMaxResidentBytes; }
+  inline void                                            SetSpillPath(const std::filesystem::path& nSpillPath) { m_SpillPath = nSpillPath; }
+  void                                                   SetLatency(const uint16_t latency);
+
+  void                                                   Append(const uint8_t type);
+  void                                                   Append(const uint8_t type, const std::vector<uint8_t>& bytes);
+  void                                                   Append(const uint8_t type, const uint8_t* data, const size_t size);
+  [[nodiscard]] GameFrame                                GetFrame(const size_t frameIndex, size_t& segmentEnd);
+  [[nodiscard]] const Checkpoint*                        GetCheckpoint(const int64_t gameTicks) const;
+  [[nodiscard]] size_t                                   GetFrameAtGameTicks(const int64_t gameTicks) const;
+  void                                                   Trim();
+  void                                                   Drain();
+
+  void                                                   AddCursor(CGameFrameCursor* cursor);
+  void                                                   RemoveCursor(CGameFrameCursor* cursor);
+
+private:
+  [[nodiscard]] size_t                                   FindSegment(const size_t frameIndex) const;
+  void                                                   AddCheckpoint();
+  [[nodiscard]] bool                                     Spill(const size_t segmentIndex);
+  void                                                   Load(const size_t segmentIndex);
+  void                                                   Evict(const size_t segmentIndex);
+  void                                                   Discard(const size_t segmentIndex);
+  void                                                   CollectSpills();
+  void                                                   PushTask(SpillTask&& task);
+  void                                                   RunWorker();
+  [[nodiscard]] bool                                     WriteSegment(SpillTask& task);
+  [[nodiscard]] bool                                     ReadSegment(SpillTask& task);
+};
+
+//
+// CGameFrameCursor
+//
+// Reading position of a CGameFrameLog consumer. Cursors must be closed before the log is destroyed.
+//
+
+class CGameFrameCursor
+{
+public:
+  CGameFrameLog*                                         m_Log;
+  size_t                                                 m_Position;
+  size_t                                                 m_SegmentEnd;
+  bool                                                   m_Waiting;        // the next frame is being read back from the spill file
+
+  CGameFrameCursor();
+  ~CGameFrameCursor();
+  CGameFrameCursor(CGameFrameCursor&) = delete;
+
+  [[nodiscard]] inline bool                              GetIsOpen() const { return m_Log != nullptr; }
+  [[nodiscard]] inline size_t                            GetPosition() const { return m_Position; }
+  [[nodiscard]] inline bool                              GetHasNext() const { return m_Log && m_Position < m_Log->GetNumFrames(); }
+  [[nodiscard]] inline bool                              GetIsWaiting() const { return m_Waiting; }
+
+  void                                                   Open(CGameFrameLog* log);
+  void                                                   Close();
+  [[nodiscard]] GameFrame                                Peek();
+  void                                                   Advance();
+};
+
+#endif // AURA_GAME_FRAME_LOG_H_
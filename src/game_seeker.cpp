@@ -88,7 +88,7 @@ void CGameSeeker::Init()
   }
 }
 
-GameSeekerStatus CGameSeeker::Update(fd_set* fd, fd_set* send_fd, int64_t timeout)
+GameSeekerStatus CGameSeeker::Update(int64_t timeout)
 {
   if (m_DeleteMe || !m_Socket || m_Socket->HasError()) {
     return GameSeekerStatus::kDestroy;
@@ -103,32 +103,23 @@ GameSeekerStatus CGameSeeker::Update(fd_set* fd, fd_set* send_fd, int64_t timeou
   GameSeekerStatus result = GameSeekerStatus::kOk;
   bool Abort = false;
   if (m_Type == INCON_TYPE_KICKED_PLAYER) {
-    m_Socket->Discard(fd);
-  } else if (m_Socket->DoRecv(fd)) {
+    m_Socket->Discard();
+  } else if (m_Socket->DoRecv()) {
     // extract as many packets as possible from the socket's receive buffer and process them
-    string*              RecvBuffer         = m_Socket->GetBytes();
-    std::vector<uint8_t> Bytes              = CreateByteArray((uint8_t*)RecvBuffer->c_str(), RecvBuffer->size());
-    uint32_t             LengthProcessed    = 0;
+    CStreamBuffer*       RecvBuffer         = m_Socket->GetBytes();
+    CPacketFramer        Framer(*RecvBuffer);
+    PacketView           Data;
 
-    // a packet is at least 4 bytes so loop as long as the buffer contains 4 bytes
+    while (Framer.Next(Data)) {
+      const uint16_t Length = static_cast<uint16_t>(Data.size());
 
-    while (Bytes.size() >= 4) {
-      // bytes 2 and 3 contain the length of the packet
-      const uint16_t Length = ByteArrayToUInt16(Bytes, false, 2);
-      if (Length < 4) {
-        Abort = true;
-        break;
-      }
-      if (Bytes.size() < Length) break;
-      const std::vector<uint8_t> Data = std::vector<uint8_t>(begin(Bytes), begin(Bytes) + Length);
-
-      switch (Bytes[0]) {
+      switch (Data.GetHeader()) {
         case GameProtocol::Magic::W3GS_HEADER:
           if (m_Type != INCON_TYPE_UDP_TUNNEL || !m_Aura->m_Net.m_Config.m_EnableTCPWrapUDP) {
             Abort = true;
             break;
           }
-          if (Bytes[1] == GameProtocol::Magic::REQJOIN) {
+          if (Data.GetID() == GameProtocol::Magic::REQJOIN) {
             CIncomingJoinRequest joinRequest = GameProtocol::RECEIVE_W3GS_REQJOIN(Data);
             if (!joinRequest.GetIsValid()) {
               Abort = true;
@@ -144,7 +135,7 @@ GameSeekerStatus CGameSeeker::Update(fd_set* fd, fd_set* send_fd, int64_t timeou
               m_Type = INCON_TYPE_PLAYER;
               m_Socket = nullptr;
             }
-          } else if (GameProtocol::Magic::SEARCHGAME <= Bytes[1] && Bytes[1] <= GameProtocol::Magic::DECREATEGAME) {
+          } else if (GameProtocol::Magic::SEARCHGAME <= Data.GetID() && Data.GetID() <= GameProtocol::Magic::DECREATEGAME) {
             if (Length > 1024) {
               Abort = true;
               break;
@@ -152,7 +143,7 @@ GameSeekerStatus CGameSeeker::Update(fd_set* fd, fd_set* send_fd, int64_t timeou
             struct UDPPkt pkt;
             pkt.socket = m_Socket;
             pkt.sender = &(m_Socket->m_RemoteHost);
-            memcpy(pkt.buf, Bytes.data(), Length);
+            memcpy(pkt.buf, Data.data(), Length);
             pkt.length = Length;
             m_Aura->m_Net.HandleUDP(&pkt);
           } else {
@@ -166,8 +157,8 @@ GameSeekerStatus CGameSeeker::Update(fd_set* fd, fd_set* send_fd, int64_t timeou
             Abort = true;
             break;
           }
-          if (Bytes[1] == VLANProtocol::Magic::SEARCHGAME) {
-            CIncomingVLanSearchGame vlanSearch = VLANProtocol::RECEIVE_VLAN_SEARCHGAME(Data);
+          if (Data.GetID() == VLANProtocol::Magic::SEARCHGAME) {
+            CIncomingVLanSearchGame vlanSearch = VLANProtocol::RECEIVE_VLAN_SEARCHGAME(Data.ToVector());
             if (vlanSearch.isValid) {
               m_GameVersion = GAMEVER(1, vlanSearch.gameVersion);
               for (const auto& game : m_Aura->GetJoinableGames()) {
@@ -184,21 +175,21 @@ GameSeekerStatus CGameSeeker::Update(fd_set* fd, fd_set* send_fd, int64_t timeou
           Abort = true;
       }
 
-      LengthProcessed += Length;
-
       if (Abort) {
         // Process no more packets
         break;
       }
+    }
 
-      Bytes = std::vector<uint8_t>(begin(Bytes) + Length, end(Bytes));
+    if (Framer.GetIsMalformed()) {
+      Abort = true;
     }
 
     if (Abort && result != GameSeekerStatus::kPromoted) {
       result = GameSeekerStatus::kDestroy;
-      RecvBuffer->clear();
-    } else if (LengthProcessed > 0) {
-      *RecvBuffer = RecvBuffer->substr(LengthProcessed);
+      RecvBuffer->Clear();
+    } else {
+      RecvBuffer->Consume(Framer.GetProcessed());
     }
   } else if (Ticks - m_Socket->GetLastRecv() >= timeout) {
     PRINT_IF(LogLevel::kDebug, "Game seeker timed out after " + to_string(timeout) + " ms")
@@ -210,7 +201,7 @@ GameSeekerStatus CGameSeeker::Update(fd_set* fd, fd_set* send_fd, int64_t timeou
     return GameSeekerStatus::kDestroy;
   }
 
-  m_Socket->DoSend(send_fd);
+  m_Socket->DoSend();
 
   return result;
 }
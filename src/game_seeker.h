@@ -58,7 +58,7 @@ public:
   void SetTimeout(const int64_t nTicks);
   bool CloseConnection();
   void Init();
-  [[nodiscard]] GameSeekerStatus Update(fd_set* fd, fd_set* send_fd, int64_t timeout);
+  [[nodiscard]] GameSeekerStatus Update(int64_t timeout);
 
   // other functions
 
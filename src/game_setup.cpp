@@ -198,8 +198,9 @@ CGameSetup::CGameSetup(CAura* nAura, shared_ptr<CCommandContext> nCtx, CConfig*
     m_IsDownloadable(false),
     m_IsStepDownloading(false),
     m_IsStepDownloaded(false),
+    m_IsStepLoadingMap(false),
     m_MapDownloadSize(0),
-    m_DownloadFileStream(nullptr),
+    m_Download(nullptr),
     m_DownloadTimeout(m_Aura->m_Net.m_Config.m_DownloadTimeout),
     m_SuggestionsTimeout(SUGGESTIONS_TIMEOUT),
     m_AsyncStep(GAMESETUP_STEP_MAIN),
@@ -248,8 +249,9 @@ CGameSetup::CGameSetup(CAura* nAura, shared_ptr<CCommandContext> nCtx, const str
     m_IsDownloadable(false),
     m_IsStepDownloading(false),
     m_IsStepDownloaded(false),
+    m_IsStepLoadingMap(false),
     m_MapDownloadSize(0),
-    m_DownloadFileStream(nullptr),
+    m_Download(nullptr),
     m_DownloadTimeout(m_Aura->m_Net.m_Config.m_DownloadTimeout),
     m_SuggestionsTimeout(SUGGESTIONS_TIMEOUT),
     m_AsyncStep(GAMESETUP_STEP_MAIN),
@@ -485,14 +487,16 @@ pair<uint8_t, filesystem::path> CGameSetup::SearchInputLocalFuzzy(vector<string>
 {
   vector<pair<string, int>> allResults;
   if (m_SearchType == SEARCH_TYPE_ONLY_MAP || m_SearchType == SEARCH_TYPE_ONLY_FILE || m_SearchType == SEARCH_TYPE_ANY) {
-    vector<pair<string, int>> mapResults = FuzzySearchFiles(m_Aura->m_Config.m_MapPath, FILE_EXTENSIONS_MAP, m_SearchTarget.second);
+    m_Aura->m_MapFilesIndex.Refresh(m_Aura->m_Config.m_MapPath);
+    vector<pair<string, int>> mapResults = m_Aura->m_MapFilesIndex.Search(m_SearchTarget.second);
     for (const auto& result : mapResults) {
       // Whether 0x80 is set flags the type of result: If it is there, it's a map
       allResults.push_back(make_pair(result.first, result.second | 0x80));
     }
   }
   if (m_SearchType == SEARCH_TYPE_ONLY_CONFIG || m_SearchType == SEARCH_TYPE_ONLY_FILE || m_SearchType == SEARCH_TYPE_ANY) {
-    vector<pair<string, int>> cfgResults = FuzzySearchFiles(m_Aura->m_Config.m_MapCFGPath, FILE_EXTENSIONS_CONFIG, m_SearchTarget.second);
+    m_Aura->m_MapConfigFilesIndex.Refresh(m_Aura->m_Config.m_MapCFGPath);
+    vector<pair<string, int>> cfgResults = m_Aura->m_MapConfigFilesIndex.Search(m_SearchTarget.second);
     allResults.insert(allResults.end(), cfgResults.begin(), cfgResults.end());
   }
   if (allResults.empty()) {
@@ -630,7 +634,7 @@ shared_ptr<CMap> CGameSetup::GetBaseMapFromConfig(CConfig* mapCFG, const bool si
 
   shared_ptr<CMap> map = nullptr;
   try {
-    map = make_shared<CMap>(m_Aura, mapCFG);
+    map = make_shared<CMap>(m_Aura, mapCFG, MapLoaderConfig(m_Aura));
   } catch (const exception& e) {
     Print("[MAP] Failed to load map : " + string(e.what()));
     return map;
@@ -652,7 +656,11 @@ shared_ptr<CMap> CGameSetup::GetBaseMapFromConfig(CConfig* mapCFG, const bool si
 shared_ptr<CMap> CGameSetup::GetBaseMapFromConfigFile(const filesystem::path& filePath, const bool isCache, const bool silent)
 {
   CConfig MapCFG;
-  if (!MapCFG.Read(filePath)) {
+  // cached configs skip the ini parser, as long as the map catalog is up to date
+  const MapCatalogEntry* catalogEntry = isCache ? m_Aura->m_MapCatalog.Get(filePath.parent_path(), filePath.filename()) : nullptr;
+  if (catalogEntry) {
+    MapCFG.Load(filePath, catalogEntry->config);
+  } else if (!MapCFG.Read(filePath)) {
     if (!silent) m_Ctx->ErrorReply("Map config file [" + PathToString(filePath.filename()) + "] not found.", CHAT_SEND_SOURCE_ALL);
     return nullptr;
   }
@@ -664,11 +672,15 @@ shared_ptr<CMap> CGameSetup::GetBaseMapFromConfigFile(const filesystem::path& fi
       FileWrite(filePath, bytes.data(), bytes.size());
       Print("[AURA] Updated map cache for [" + PathToString(filePath.filename()) + "] as [" + PathToString(filePath) + "]");
     }
+    if (MapCFG.GetIsModified() || !catalogEntry) {
+      m_Aura->m_MapCatalog.Update(filePath.parent_path(), filePath.filename(), MapCFG.GetEntries());
+      m_Aura->ScheduleMapCatalogSave();
+    }
   }
   return map;
 }
 
-shared_ptr<CMap> CGameSetup::GetBaseMapFromMapFile(const filesystem::path& filePath, const bool silent)
+shared_ptr<CConfig> CGameSetup::CreateMapConfigFromMapFile(const filesystem::path& filePath)
 {
   bool isInMapsFolder = filePath.parent_path() == m_Aura->m_Config.m_MapPath.parent_path();
   string fileName = PathToString(filePath.filename());
@@ -680,43 +692,71 @@ shared_ptr<CMap> CGameSetup::GetBaseMapFromMapFile(const filesystem::path& fileP
     baseFileName = fileName;
   }
 
-  CConfig MapCFG;
-  MapCFG.SetBool("map.cfg.partial", true); // temporary
-  MapCFG.SetUint8("map.cfg.schema_number", MAP_CONFIG_SCHEMA_NUMBER);
-  ExportTemporaryToMap(&MapCFG);
-  if (m_StandardPaths) MapCFG.SetBool("map.standard_path", true);
+  shared_ptr<CConfig> MapCFG = make_shared<CConfig>();
+  MapCFG->SetBool("map.cfg.partial", true); // temporary
+  MapCFG->SetUint8("map.cfg.schema_number", MAP_CONFIG_SCHEMA_NUMBER);
+  ExportTemporaryToMap(MapCFG.get());
+  if (m_StandardPaths) MapCFG->SetBool("map.standard_path", true);
 
   {
     W3ModLocale gameLocaleMod = m_GameLocaleMod.value_or(m_Aura->m_Config.m_GameLocaleModDefault);
     array<string, 12> localeStrings = {"enUS", "deDE", "esES", "esMX", "frFR", "itIT", "koKR", "plPL", "ptBR", "ruRU", "zhCN", "zhTW"};
     assert((uint8_t)W3ModLocale::LAST == localeStrings.size());
-    MapCFG.SetString("map.locale.mod", localeStrings[(uint8_t)gameLocaleMod]);
+    MapCFG->SetString("map.locale.mod", localeStrings[(uint8_t)gameLocaleMod]);
   }
   {
     uint16_t gameLocaleLangID = m_GameLocaleLangID.value_or(m_Aura->m_Config.m_GameLocaleLangID);
-    MapCFG.SetUint16("map.locale.lang_id", gameLocaleLangID);
+    MapCFG->SetUint16("map.locale.lang_id", gameLocaleLangID);
   }
-  MapCFG.Set("map.path", R"(Maps\Download\)" + baseFileName);
+  MapCFG->Set("map.path", R"(Maps\Download\)" + baseFileName);
   string localPath = isInMapsFolder && !m_StandardPaths ? fileName : PathToString(filePath);
-  MapCFG.Set("map.local_path", localPath);
+  MapCFG->Set("map.local_path", localPath);
 
   if (m_IsMapDownloaded) {
-    MapCFG.Set("map.meta.site", m_MapSiteUri);
-    MapCFG.Set("map.meta.url", m_MapDownloadUri);
-    MapCFG.Set("map.downloaded.by", m_Attribution);
+    MapCFG->Set("map.meta.site", m_MapSiteUri);
+    MapCFG->Set("map.meta.url", m_MapDownloadUri);
+    MapCFG->Set("map.downloaded.by", m_Attribution);
+    if (m_DownloadDigest.has_value() && filePath == m_DownloadFilePath) {
+      optional<array<uint8_t, 4>> crc32Bytes;
+      EnsureFixedByteArray(crc32Bytes, m_DownloadDigest->crc32, true); // big-endian, matching SHA1
+      MapCFG->SetUint32("map.size", static_cast<uint32_t>(m_DownloadDigest->size));
+      MapCFG->SetUint8Array("map.file_hash.crc32", crc32Bytes->data(), 4);
+      MapCFG->SetUint8Array("map.file_hash.sha1", m_DownloadDigest->sha1.data(), 20);
+      MapCFG->SetBool("map.cfg.hashed", true); // temporary
+    }
   }
 
-  shared_ptr<CMap> baseMap = nullptr;
+  return MapCFG;
+}
+
+MapLoadResult CGameSetup::LoadMapFromConfigTask(shared_ptr<CConfig> mapCFG, MapLoaderConfig loaderConfig)
+{
+  // may run in a worker thread - must not touch CAura, nor the game setup, nor send any replies
+  // the map is attached to CAura by OnBaseMapFromMapFileLoaded(), back in the main thread
+  MapLoadResult result;
   try {
-    baseMap = make_shared<CMap>(m_Aura, &MapCFG);
+    result.map = make_shared<CMap>(nullptr, mapCFG.get(), move(loaderConfig));
   } catch (const exception& e) {
+    result.exceptionMessage = e.what();
+  }
+  return result;
+}
+
+shared_ptr<CMap> CGameSetup::OnBaseMapFromMapFileLoaded(const filesystem::path& filePath, CConfig& MapCFG, MapLoadResult& result, const bool silent)
+{
+  bool isInMapsFolder = filePath.parent_path() == m_Aura->m_Config.m_MapPath.parent_path();
+  string fileName = PathToString(filePath.filename());
+
+  shared_ptr<CMap> baseMap = result.map;
+  if (!baseMap) {
     if (!silent) m_Ctx->ErrorReply("Failed to load map.", CHAT_SEND_SOURCE_ALL);
-    Print("[MAP] Failed to load map : " + string(e.what()));
+    Print("[MAP] Failed to load map : " + result.exceptionMessage);
     vector<uint8_t> bytes = MapCFG.Export();
     m_Aura->LogPersistent("[MAP] Failed to load [" + PathToString(filePath) + "] - config was:");
     m_Aura->LogPersistent(string(begin(bytes), end(bytes)));
     return baseMap;
   }
+  baseMap->m_Aura = m_Aura;
   string errorMessage = baseMap->CheckProblems();
   if (!errorMessage.empty()) {
     if (!silent) m_Ctx->ErrorReply("Failed to load map: " + errorMessage, CHAT_SEND_SOURCE_ALL);
@@ -738,6 +778,8 @@ shared_ptr<CMap> CGameSetup::GetBaseMapFromMapFile(const filesystem::path& fileP
     vector<uint8_t> bytes = MapCFG.Export();
     FileWrite(resolvedCFGPath, bytes.data(), bytes.size());
     m_Aura->m_CFGCacheNamesByMapNames[fileName] = resolvedCFGName;
+    m_Aura->m_MapCatalog.Update(resolvedCFGPath.parent_path(), resolvedCFGPath.filename(), MapCFG.GetEntries());
+    m_Aura->ScheduleMapCatalogSave();
     Print("[AURA] Cached map config for [" + fileName + "] as [" + PathToString(resolvedCFGPath) + "]");
   }
 
@@ -745,7 +787,54 @@ shared_ptr<CMap> CGameSetup::GetBaseMapFromMapFile(const filesystem::path& fileP
   return baseMap;
 }
 
-shared_ptr<CMap> CGameSetup::GetBaseMapFromMapFileOrCache(const filesystem::path& mapPath, const bool silent)
+shared_ptr<CMap> CGameSetup::GetBaseMapFromMapFile(const filesystem::path& filePath, const bool silent)
+{
+  shared_ptr<CConfig> MapCFG = CreateMapConfigFromMapFile(filePath);
+  if (!MapCFG) return nullptr;
+  MapLoadResult result = LoadMapFromConfigTask(MapCFG, MapLoaderConfig(m_Aura));
+  return OnBaseMapFromMapFileLoaded(filePath, *MapCFG, result, silent);
+}
+
+void CGameSetup::RunLoadMapFromMapFile(const filesystem::path& filePath)
+{
+  m_MapLoadConfig = CreateMapConfigFromMapFile(filePath);
+  if (!m_MapLoadConfig) {
+    OnLoadMapError();
+    return;
+  }
+  m_MapLoadPath = filePath;
+  m_IsStepLoadingMap = true;
+
+  // bot settings are copied here, so that the worker thread never reads CAura
+  // the thread is detached, so that releasing this game setup does not wait for the map to finish loading
+  promise<MapLoadResult> loadPromise;
+  m_MapLoadFuture = loadPromise.get_future();
+  thread([mapCFG = m_MapLoadConfig, loaderConfig = MapLoaderConfig(m_Aura), loadPromise = move(loadPromise)]() mutable {
+    loadPromise.set_value(LoadMapFromConfigTask(mapCFG, move(loaderConfig)));
+  }).detach();
+}
+
+void CGameSetup::OnLoadMapFromMapFileEnd()
+{
+  MapLoadResult result = m_MapLoadFuture.get();
+  m_IsStepLoadingMap = false;
+  if (m_ExitingSoon || m_Ctx->GetPartiallyDestroyed()) {
+    m_MapLoadConfig.reset();
+    m_DeleteMe = true;
+    return;
+  }
+  m_Map = OnBaseMapFromMapFileLoaded(m_MapLoadPath, *m_MapLoadConfig, result, false);
+  m_MapLoadConfig.reset();
+  if (m_Map) {
+    DPRINT_IF(LogLevel::kTrace, "[GAMESETUP] Map loaded successfully.")
+    OnLoadMapSuccess();
+  } else {
+    PRINT_IF(LogLevel::kDebug, "[GAMESETUP] Map failed to load")
+    OnLoadMapError();
+  }
+}
+
+shared_ptr<CMap> CGameSetup::GetBaseMapFromMapCache(const filesystem::path& mapPath, const bool silent)
 {
   filesystem::path fileName = mapPath.filename();
   if (fileName.empty()) return nullptr;
@@ -785,6 +874,14 @@ shared_ptr<CMap> CGameSetup::GetBaseMapFromMapFileOrCache(const filesystem::path
       Print("[AURA] Map cache miss");
     }
   }
+  return nullptr;
+}
+
+shared_ptr<CMap> CGameSetup::GetBaseMapFromMapFileOrCache(const filesystem::path& mapPath, const bool silent)
+{
+  if (mapPath.filename().empty()) return nullptr;
+  shared_ptr<CMap> cachedMap = GetBaseMapFromMapCache(mapPath, silent);
+  if (cachedMap) return cachedMap;
   return GetBaseMapFromMapFile(mapPath, silent);
 }
 
@@ -1019,12 +1116,29 @@ bool CGameSetup::PrepareDownloadMap()
   string fileNameFragmentPre = m_BaseDownloadFileName.substr(0, m_BaseDownloadFileName.length() - fileNameFragmentPost.length());
   bool nameSuccess = false;
   string mapSuffix;
+  vector<filesystem::path> candidatePaths;
   for (uint8_t i = 0; i < 10; ++i) {
     if (i != 0) {
       mapSuffix = "~" + to_string(i);
     }
     string testFileName = fileNameFragmentPre + mapSuffix + fileNameFragmentPost;
-    filesystem::path testFilePath = m_Aura->m_Config.m_MapPath / filesystem::path(testFileName);
+    candidatePaths.push_back(m_Aura->m_Config.m_MapPath / filesystem::path(testFileName));
+  }
+  for (const auto& testFilePath : candidatePaths) {
+    if (!FileExists(testFilePath) && CMapDownload::GetCanResume(testFilePath, m_MapDownloadUri)) {
+      // An earlier attempt to download this map was interrupted.
+      SetDownloadFilePath(filesystem::path(testFilePath));
+      nameSuccess = true;
+      break;
+    }
+  }
+  for (auto& testFilePath : candidatePaths) {
+    if (nameSuccess) break;
+    string testFileName = PathToString(testFilePath.filename());
+    if (CMapDownload::GetHasPartial(testFilePath)) {
+      // Partially downloaded from somewhere else.
+      continue;
+    }
     if (FileExists(testFilePath)) {
       // Map already exists.
       // I'd rather directly open the file with wx flags to avoid racing conditions,
@@ -1043,62 +1157,125 @@ bool CGameSetup::PrepareDownloadMap()
     m_Ctx->ErrorReply("Download failed - duplicate map name [" + m_BaseDownloadFileName + "].", CHAT_SEND_SOURCE_ALL);
     return false;
   }
-  Print("[NET] GET <" + m_MapDownloadUri + "> as [" + PathToString(m_DownloadFilePath.filename()) + "]...");
-  m_DownloadFileStream = new ofstream(m_DownloadFilePath.native().c_str(), std::ios_base::out | std::ios_base::binary);
+  m_Download = new CMapDownload(m_DownloadFilePath, m_MapDownloadUri);
+  if (!m_Download->Open()) {
+    delete m_Download;
+    m_Download = nullptr;
+    m_Ctx->ErrorReply("Download failed - unable to write to disk.", CHAT_SEND_SOURCE_ALL);
+    return false;
+  }
+  if (m_Download->GetIsResumed()) {
+    Print("[NET] GET <" + m_MapDownloadUri + "> as [" + PathToString(m_DownloadFilePath.filename()) + "] (resuming at " + to_string(m_Download->GetReceivedSize()) + " bytes)...");
+  } else {
+    Print("[NET] GET <" + m_MapDownloadUri + "> as [" + PathToString(m_DownloadFilePath.filename()) + "]...");
+  }
   return true;
 }
 
 uint32_t CGameSetup::DownloadMapTask()
 {
-  if (!m_DownloadFileStream) return 0;
-  if (!m_DownloadFileStream->is_open()) {
-    m_DownloadFileStream->close();
-    delete m_DownloadFileStream;
-    m_DownloadFileStream = nullptr;
-    m_ErrorMessage = "Download failed - unable to write to disk.";
-    return 0;
-  }
-  cpr::Response response = cpr::Download(
-    *m_DownloadFileStream,
-    cpr::Url{m_MapDownloadUri},
-    cpr::Header{{"user-agent", "Mozilla/5.0 (Windows NT 6.1; Win64; x64; rv:109.0) Gecko/20100101 Firefox/115.0"}},
-    cpr::Timeout{m_DownloadTimeout},
-    cpr::ProgressCallback(
-      [this](cpr::cpr_off_t /* downloadTotal*/, cpr::cpr_off_t /* downloadNow*/, cpr::cpr_off_t /* uploadTotal*/, cpr::cpr_off_t /* uploadNow*/, intptr_t /* userdata*/) -> bool
-      {
-        return !this->m_ExitingSoon;
-      }
-    )
-  );
-  m_DownloadFileStream->close();
-  delete m_DownloadFileStream;
-  m_DownloadFileStream = nullptr;
+  if (!m_Download) return 0;
+  m_DownloadDigest.reset();
+
+  // bytes are hashed as they arrive, so the digest is ready as soon as the transfer ends
+  // interrupted transfers are resumed with a Range request, rather than restarted
+  cpr::Response response;
+  float elapsedSeconds = 0.f;
+  uint8_t attempt = 0;
+  do {
+    if (attempt > 0) {
+      Print("[NET] Download interrupted at " + to_string(m_Download->GetReceivedSize()) + " bytes - resuming (attempt " + to_string(attempt + 1) + ")...");
+    }
+    m_Download->BeginAttempt();
+    cpr::Header header{{"user-agent", "Mozilla/5.0 (Windows NT 6.1; Win64; x64; rv:109.0) Gecko/20100101 Firefox/115.0"}};
+    string range = m_Download->GetRangeHeader();
+    if (!range.empty()) {
+      header["range"] = range;
+    }
+    response = cpr::Download(
+      cpr::WriteCallback(
+        [this](string data, intptr_t /* userdata*/) -> bool
+        {
+          return this->m_Download->OnData(reinterpret_cast<const uint8_t*>(data.data()), data.size()) && !this->m_ExitingSoon;
+        }
+      ),
+      cpr::HeaderCallback(
+        [this](string line, intptr_t /* userdata*/) -> bool
+        {
+          return this->m_Download->OnHeader(line);
+        }
+      ),
+      cpr::Url{m_MapDownloadUri},
+      header,
+      cpr::Timeout{m_DownloadTimeout},
+      cpr::LimitRate(static_cast<int64_t>(m_Aura->m_Net.m_Config.m_DownloadMaxSpeed) * 1024, 0),
+      cpr::ProgressCallback(
+        [this](cpr::cpr_off_t /* downloadTotal*/, cpr::cpr_off_t /* downloadNow*/, cpr::cpr_off_t /* uploadTotal*/, cpr::cpr_off_t /* uploadNow*/, intptr_t /* userdata*/) -> bool
+        {
+          return !this->m_ExitingSoon;
+        }
+      )
+    );
+    elapsedSeconds += static_cast<float>(response.elapsed);
+    m_Download->SaveProgress();
+    if (m_ExitingSoon) {
+      break;
+    }
+    if (m_Download->EndAttempt(static_cast<uint16_t>(response.status_code), response.error.code == cpr::ErrorCode::OK) != MapDownloadStep::kRetry) {
+      break;
+    }
+  } while (++attempt < MAP_DOWNLOAD_MAX_ATTEMPTS);
+
   if (m_ExitingSoon) {
+    // partial file is kept, so that the download may be resumed next time
+    delete m_Download;
+    m_Download = nullptr;
     m_ErrorMessage = "Shutting down.";
-    FileDelete(m_DownloadFilePath);
     return RESOLUTION_ERR;
   }
-  if (response.status_code == 0) {
-    m_ErrorMessage = "Failed to access " + m_SearchTarget.first + " repository (connectivity error).";
-    FileDelete(m_DownloadFilePath);
+  if (m_Download->GetHasWriteError()) {
+    if (m_Download->m_Oversized) {
+      m_ErrorMessage = "Download failed - map is larger than expected.";
+    } else {
+      m_ErrorMessage = "Download failed - unable to write to disk.";
+    }
+    m_Download->Discard();
+    delete m_Download;
+    m_Download = nullptr;
     return 0;
   }
-  if (response.status_code != 200) {
-    m_ErrorMessage = "Map not found in " + m_SearchTarget.first + " repository (code " + to_string(response.status_code) + ").";
-    FileDelete(m_DownloadFilePath);
-    return 0;
+
+  const bool isSuccess = (response.status_code == 200 || response.status_code == 206) && response.error.code == cpr::ErrorCode::OK;
+  if (isSuccess) {
+    m_DownloadDigest = m_Download->Commit();
   }
-  const bool timedOut = cpr::ErrorCode::OPERATION_TIMEDOUT == response.error.code;
-  if (timedOut) {
-    m_ErrorMessage = "Map download took too long.";
-    FileDelete(m_DownloadFilePath);
+  if (!m_DownloadDigest.has_value()) {
+    if (response.status_code == 0) {
+      m_ErrorMessage = "Failed to access " + m_SearchTarget.first + " repository (connectivity error).";
+    } else if (cpr::ErrorCode::OPERATION_TIMEDOUT == response.error.code) {
+      m_ErrorMessage = "Map download took too long.";
+    } else if (response.status_code != 200 && response.status_code != 206) {
+      m_ErrorMessage = "Map not found in " + m_SearchTarget.first + " repository (code " + to_string(response.status_code) + ").";
+    } else {
+      m_ErrorMessage = "Download failed - map size does not match the one advertised by " + m_SearchTarget.first + ".";
+    }
+    if (m_Download->GetReceivedSize() == 0 || (response.status_code != 0 && response.status_code != 200 && response.status_code != 206)) {
+      m_Download->Discard();
+    } else {
+      m_ErrorMessage += " Try again to resume it.";
+    }
+    delete m_Download;
+    m_Download = nullptr;
     return 0;
   }
-  Print("[AURA] download finished in " + ToFormattedString(static_cast<float>(response.elapsed)) + " seconds");
+  delete m_Download;
+  m_Download = nullptr;
+
+  Print("[AURA] download finished in " + ToFormattedString(elapsedSeconds) + " seconds");
   // Signals completion.
   m_IsStepDownloaded = true;
 
-  return static_cast<uint32_t>(response.downloaded_bytes);
+  return static_cast<uint32_t>(m_DownloadDigest->size);
 }
 
 void CGameSetup::RunDownloadMap()
@@ -1202,7 +1379,12 @@ void CGameSetup::LoadMap()
     m_Map = GetBaseMapFromConfigFile(searchResult.second, false, false);
   } else {
     DPRINT_IF(LogLevel::kTrace, "[GAMESETUP] Loading from map or cache...")
-    m_Map = GetBaseMapFromMapFileOrCache(searchResult.second, false);
+    m_Map = GetBaseMapFromMapCache(searchResult.second, false);
+    if (!m_Map) {
+      // parsing the MPQ and hashing the file takes a while for large maps, so keep it off the main thread
+      RunLoadMapFromMapFile(searchResult.second);
+      return;
+    }
   }
   if (m_Map) {
     DPRINT_IF(LogLevel::kTrace, "[GAMESETUP] Map loaded successfully.")
@@ -1293,13 +1475,12 @@ void CGameSetup::OnDownloadMapSuccess()
     return;
   }
   m_IsMapDownloaded = true;
-  m_Map = GetBaseMapFromMapFileOrCache(m_DownloadFilePath, false);
+  m_Map = GetBaseMapFromMapCache(m_DownloadFilePath, false);
   if (m_Map) {
     DPRINT_IF(LogLevel::kTrace, "[GAMESETUP] Downloaded map loaded successfully.")
     OnLoadMapSuccess();
   } else {
-    DPRINT_IF(LogLevel::kTrace, "[GAMESETUP] Downloaded map failed to load.")
-    OnLoadMapError();
+    RunLoadMapFromMapFile(m_DownloadFilePath);
   }
 }
 
@@ -1536,6 +1717,13 @@ void CGameSetup::OnGameCreate()
 
 bool CGameSetup::Update()
 {
+  if (m_IsStepLoadingMap) {
+    if (m_MapLoadFuture.wait_for(chrono::seconds(0)) == future_status::ready) {
+      OnLoadMapFromMapFileEnd();
+    }
+    return m_DeleteMe;
+  }
+
 #ifndef DISABLE_CPR
   if (!m_IsStepDownloading) return m_DeleteMe;
   auto status = m_DownloadFuture.wait_for(chrono::seconds(0));
@@ -1573,6 +1761,9 @@ bool CGameSetup::Update()
 
 void CGameSetup::AwaitSettled()
 {
+  if (m_IsStepLoadingMap) {
+    m_MapLoadFuture.wait();
+  }
 #ifndef DISABLE_DPP
   if (m_IsStepDownloading) {
     m_DownloadFuture.wait();
@@ -1810,6 +2001,12 @@ CGameSetup::~CGameSetup()
   m_Aura = nullptr;
 
   m_Map.reset();
+
+  if (m_Download && !m_IsStepDownloading) {
+    // prepared, but never started
+    delete m_Download;
+    m_Download = nullptr;
+  }
 }
 
 #undef SEARCH_RESULT
@@ -27,14 +27,18 @@
 #define AURA_GAMESETUP_H_
 
 #include "includes.h"
+#include "file_hash.h"
 #include "game_host.h"
+#include "map_download.h"
 #include "locations.h"
 #include "realm.h"
 #include "socket.h"
 
 #include <atomic>
 #include <filesystem>
+#include <future>
 #include <regex>
+#include <thread>
 
 #ifndef DISABLE_CPR
 #include <cpr/cpr.h>
@@ -58,6 +62,19 @@ inline std::vector<std::pair<std::string, int>> ExtractEpicWarMaps(const std::st
   return output;
 }
 
+//
+// MapLoadResult
+//
+// Outcome of parsing a map file off the main thread.
+// The map is not validated yet, and no replies have been sent to the requester.
+//
+
+struct MapLoadResult
+{
+  std::shared_ptr<CMap>                  map;
+  std::string                            exceptionMessage;
+};
+
 //
 // CGameExtraOptions
 //
@@ -142,12 +159,17 @@ public:
   bool                                            m_IsDownloadable;
   bool                                            m_IsStepDownloading;
   bool                                            m_IsStepDownloaded;
+  bool                                            m_IsStepLoadingMap;
+  std::filesystem::path                           m_MapLoadPath;
+  std::shared_ptr<CConfig>                        m_MapLoadConfig;
+  std::future<MapLoadResult>                      m_MapLoadFuture;
   std::string                                     m_BaseDownloadFileName;
   std::string                                     m_MapDownloadUri;
   uint32_t                                        m_MapDownloadSize;
   std::string                                     m_MapSiteUri;
   std::filesystem::path                           m_DownloadFilePath;
-  std::ofstream*                                  m_DownloadFileStream;
+  CMapDownload*                                   m_Download;
+  std::optional<FileHashDigest>                   m_DownloadDigest;   // hashed while streaming, so that CMap needn't read the file again
 #ifndef DISABLE_CPR
   std::future<uint32_t>                           m_DownloadFuture;
 #endif
@@ -274,8 +296,14 @@ public:
   inline std::shared_ptr<CMap> GetMap() const { return m_Map; }
   [[nodiscard]] std::shared_ptr<CMap> GetBaseMapFromConfig(CConfig* mapCFG, const bool silent);
   [[nodiscard]] std::shared_ptr<CMap> GetBaseMapFromConfigFile(const std::filesystem::path& filePath, const bool isCache, const bool silent);
+  [[nodiscard]] std::shared_ptr<CConfig> CreateMapConfigFromMapFile(const std::filesystem::path& filePath);
+  [[nodiscard]] static MapLoadResult LoadMapFromConfigTask(std::shared_ptr<CConfig> mapCFG, MapLoaderConfig loaderConfig);
+  [[nodiscard]] std::shared_ptr<CMap> OnBaseMapFromMapFileLoaded(const std::filesystem::path& filePath, CConfig& MapCFG, MapLoadResult& result, const bool silent);
   [[nodiscard]] std::shared_ptr<CMap> GetBaseMapFromMapFile(const std::filesystem::path& filePath, const bool silent);
+  [[nodiscard]] std::shared_ptr<CMap> GetBaseMapFromMapCache(const std::filesystem::path& mapPath, const bool silent);
   [[nodiscard]] std::shared_ptr<CMap> GetBaseMapFromMapFileOrCache(const std::filesystem::path& mapPath, const bool silent);
+  void RunLoadMapFromMapFile(const std::filesystem::path& filePath);
+  void OnLoadMapFromMapFileEnd();
   bool ApplyMapModifiers(CGameExtraOptions* extraOptions);
 #ifndef DISABLE_CPR
   [[nodiscard]] uint32_t ResolveMapRepositoryTask();
@@ -311,6 +339,7 @@ public:
   [[nodiscard]] inline GameMirrorSetup& GetMirror() { return m_Mirror; }
   [[nodiscard]] inline const GameMirrorSetup& InspectMirror() const { return m_Mirror; }
   [[nodiscard]] inline bool GetIsDownloading() const { return m_IsStepDownloading; }
+  [[nodiscard]] inline bool GetIsLoadingMap() const { return m_IsStepLoadingMap; }
   [[nodiscard]] inline bool GetHasBeenHosted() const { return m_CreationCounter > 0; }
   [[nodiscard]] inline bool GetHasGameVersion() const { return m_GameVersion.has_value(); }
 
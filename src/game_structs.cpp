@@ -28,6 +28,7 @@
 #include "game_controller_data.h"
 #include "game_user.h"
 
+#include <crc32/crc32.h>
 
 using namespace std;
 
@@ -68,15 +69,48 @@ CQueuedActionsFrame::CQueuedActionsFrame()
  : callback(ON_SEND_ACTIONS_NONE),
    pauseUID(0xFF),
    bufferSize(0),
-   activeQueue(nullptr)
+   activeQueue(nullptr),
+   encodedFinal(false)
  {
    activeQueue = &actions.emplace_back();
+   activeQueue->reserve(DEFAULT_ACTIONS_PER_FRAME);
+   encoded.reserve(DEFAULT_ACTION_FRAME_ENCODED_SIZE);
+   BeginEncodedQueue();
  }
 
 CQueuedActionsFrame::~CQueuedActionsFrame() = default;
 
+void CQueuedActionsFrame::BeginEncodedQueue()
+{
+  // header, length, send interval, CRC-16
+  encodedOffsets.push_back(encoded.size());
+  encoded.resize(encoded.size() + 8, 0);
+}
+
+ActionQueue* CQueuedActionsFrame::AddQueue()
+{
+  BeginEncodedQueue();
+  if (spareQueues.empty()) {
+    ActionQueue* queue = &actions.emplace_back();
+    queue->reserve(DEFAULT_ACTIONS_PER_FRAME);
+    return queue;
+  }
+  actions.push_back(std::move(spareQueues.back()));
+  spareQueues.pop_back();
+  return &actions.back();
+}
+
 void CQueuedActionsFrame::AddAction(CIncomingAction&& action)
 {
+  if (encodedFinal) {
+    // GetBytes() will finalize the headers again, but an empty last packet has dropped its CRC,
+    // and actions are only ever appended to the last packet
+    if (encoded.size() - encodedOffsets.back() == 6) {
+      encoded.resize(encoded.size() + 2, 0);
+    }
+    encodedFinal = false;
+  }
+
   const uint16_t actionSize = static_cast<uint16_t>(action.GetOutgoingLength());
 
   // we aren't allowed to send more than 1460 bytes in a single packet but it's possible we might have more than that many bytes waiting in the queue
@@ -90,12 +124,17 @@ void CQueuedActionsFrame::AddAction(CIncomingAction&& action)
     }
     bufferSize = actionSize;
   } else */if (bufferSize + actionSize > 1452) {
-    activeQueue = &actions.emplace_back();
-    activeQueue->reserve(DEFAULT_ACTIONS_PER_FRAME);
+    activeQueue = AddQueue();
     bufferSize = actionSize;
   } else {
     bufferSize += actionSize;
   }
+
+  const vector<uint8_t>& actionBytes = action.GetImmutableAction();
+  encoded.push_back(action.GetUID());
+  AppendByteArray(encoded, static_cast<uint16_t>(actionBytes.size()), false);
+  AppendByteArrayFast(encoded, actionBytes);
+
   activeQueue->push_back(std::move(action));
 }
 
@@ -121,39 +160,95 @@ size_t CQueuedActionsFrame::AddQueuedActionsCount(queue<CIncomingAction>& extern
   return maxCount - count;
 }
 
-vector<uint8_t> CQueuedActionsFrame::GetBytes(const uint16_t sendInterval) const
+const vector<uint8_t>& CQueuedActionsFrame::GetBytes(const uint16_t sendInterval)
 {
-  vector<uint8_t> packet;
-
-  // the W3GS_INCOMING_ACTION2 packet handles the overflow but it must be sent *before*
-  // the corresponding W3GS_INCOMING_ACTION packet
-
-  auto it = actions.begin();
-  auto back = actions.end() - 1;
-  while (it != back) {
-    const vector<uint8_t> subPacket = GameProtocol::SEND_W3GS_INCOMING_ACTION2(*it);
-    AppendByteArrayFast(packet, subPacket);
-    ++it;
+  if (encodedFinal) {
+    // headers and CRCs are already final, only the send interval of the last packet may differ
+    uint8_t* header = encoded.data() + encodedOffsets.back();
+    header[4] = static_cast<uint8_t>(sendInterval);
+    header[5] = static_cast<uint8_t>(sendInterval >> 8);
+    return encoded;
   }
 
-  {
-    const vector<uint8_t> subPacket = GameProtocol::SEND_W3GS_INCOMING_ACTION(*it, sendInterval);
-    AppendByteArrayFast(packet, subPacket);
+  // the W3GS_INCOMING_ACTION2 packets handle the overflow but they must be sent *before*
+  // the corresponding W3GS_INCOMING_ACTION packet, which is always the last one
+
+  // go backwards, since packets without actions drop their CRC, and shift whatever follows
+  size_t end = encoded.size();
+  size_t i = encodedOffsets.size();
+  while (i--) {
+    const size_t start = encodedOffsets[i];
+    const bool isLast = i + 1 == encodedOffsets.size();
+    uint16_t length = static_cast<uint16_t>(end - start);
+    uint8_t* header = encoded.data() + start;
+    header[0] = GameProtocol::Magic::W3GS_HEADER;
+    header[1] = isLast ? GameProtocol::Magic::INCOMING_ACTION : GameProtocol::Magic::INCOMING_ACTION2;
+    header[4] = isLast ? static_cast<uint8_t>(sendInterval) : 0;
+    header[5] = isLast ? static_cast<uint8_t>(sendInterval >> 8) : 0;
+    if (length <= 8) {
+      // packets without actions have no CRC, it may already be gone if the frame was reopened by AddAction()
+      if (length == 8) {
+        encoded.erase(encoded.begin() + start + 6, encoded.begin() + start + 8);
+        length = 6;
+        // packets that follow moved back, keep their offsets valid for repeated calls
+        for (size_t j = i + 1; j < encodedOffsets.size(); ++j) {
+          encodedOffsets[j] -= 2;
+        }
+      }
+    } else {
+      // we only care about the lower 2 bytes of the CRC
+      const uint32_t crc32 = CRC32::CalculateCRC(header + 8, length - 8);
+      header[6] = static_cast<uint8_t>(crc32);
+      header[7] = static_cast<uint8_t>(crc32 >> 8);
+    }
+    header[2] = static_cast<uint8_t>(length);
+    header[3] = static_cast<uint8_t>(length >> 8);
+    end = start;
   }
 
-  // Note: Must ensure Reset() is called afterwards
-  return packet;
+  encodedFinal = true;
+  return encoded;
+}
+
+vector<uint8_t> CQueuedActionsFrame::TakeBytes(const uint16_t sendInterval)
+{
+  GetBytes(sendInterval);
+
+  // the frame must be Reset() before it's reused
+  vector<uint8_t> bytes = std::move(encoded);
+  encoded.clear();
+  encodedOffsets.clear();
+  encodedFinal = false;
+  return bytes;
 }
 
 void CQueuedActionsFrame::Reset()
 {
-  actions.clear();
+  // queues keep their capacity, so that frames are recycled without allocating
+  while (actions.size() > 1) {
+    actions.back().clear();
+    spareQueues.push_back(std::move(actions.back()));
+    actions.pop_back();
+  }
+  if (actions.empty()) {
+    // 10 players x 150 APM x (1 min / 60000 ms) x (100 ms latency) = 2.5 (rounded to 3)
+    actions.emplace_back().reserve(DEFAULT_ACTIONS_PER_FRAME);
+  } else {
+    actions.front().clear();
+  }
   callback = ON_SEND_ACTIONS_NONE;
   bufferSize = 0;
-  activeQueue = &actions.emplace_back();
-  // 10 players x 150 APM x (1 min / 60000 ms) x (100 ms latency) = 2.5 (rounded to 3)
-  activeQueue->reserve(DEFAULT_ACTIONS_PER_FRAME);
+  activeQueue = &actions.front();
   leavers.clear();
+
+  encoded.clear();
+  if (encoded.capacity() == 0) {
+    // handed over by TakeBytes()
+    encoded.reserve(DEFAULT_ACTION_FRAME_ENCODED_SIZE);
+  }
+  encodedOffsets.clear();
+  encodedFinal = false;
+  BeginEncodedQueue();
 }
 
 bool CQueuedActionsFrame::GetIsEmpty() const
@@ -177,7 +272,10 @@ size_t CQueuedActionsFrame::GetActionCount() const
 
 void CQueuedActionsFrame::MergeFrame(CQueuedActionsFrame& frame)
 {
-  if (frame.bufferSize == 0) return;
+  if (frame.bufferSize == 0) {
+    frame.Reset();
+    return;
+  }
 
   callback = frame.callback;
 
@@ -185,6 +283,18 @@ void CQueuedActionsFrame::MergeFrame(CQueuedActionsFrame& frame)
     leavers.push_back(user);
   }
 
+  if (bufferSize == 0 && actions.size() == 1 && actions.front().empty()) {
+    // nothing queued here yet, so adopt the other frame's queues as they are
+    actions.swap(frame.actions);
+    encoded.swap(frame.encoded);
+    encodedOffsets.swap(frame.encodedOffsets);
+    std::swap(encodedFinal, frame.encodedFinal);
+    bufferSize = frame.bufferSize;
+    activeQueue = &actions.back();
+    frame.Reset();
+    return;
+  }
+
   auto it = frame.actions.begin();
   while (it != frame.actions.end()) {
     ActionQueue& subActions = (*it);
@@ -29,6 +29,7 @@
 #include "includes.h"
 #include "list.h"
 #include "protocol/game_protocol.h"
+#include "game_frame_log.h"
 
 struct CGameLogRecord
 {
@@ -62,6 +63,16 @@ struct CQueuedActionsFrame
   // last queue is sent with SEND_W3GS_INCOMING_ACTION, together with the expected delay til next action (latency)
   std::vector<ActionQueue> actions;
 
+  // overflow queues detached by Reset(), kept to be reused by busy frames without reallocating
+  std::vector<ActionQueue> spareQueues;
+
+  // W3GS_INCOMING_ACTION2 and W3GS_INCOMING_ACTION packets, encoded as actions are added
+  // encodedOffsets[i] is the offset of the packet header for actions[i]
+  // headers are left as placeholders until GetBytes() finalizes them, and reopened by AddAction()
+  std::vector<uint8_t> encoded;
+  std::vector<size_t> encodedOffsets;
+  bool encodedFinal;
+
   // when a player leaves, the SEND_W3GS_PLAYERLEAVE_OTHERS is delayed until we are sure all their pending actions have been sent
   // so, if they leave during the game, we must append it to the last CQueuedActionsFrame
   // but if they leave while loading, we may append it to the first CQueuedActionsFrame
@@ -70,10 +81,13 @@ struct CQueuedActionsFrame
   CQueuedActionsFrame();
   ~CQueuedActionsFrame();
 
+  ActionQueue* AddQueue();
   void AddAction(CIncomingAction&& action);
   void AddQueuedActionsAll(std::queue<CIncomingAction>& actions);
   size_t AddQueuedActionsCount(std::queue<CIncomingAction>& actions, size_t count);
-  std::vector<uint8_t> GetBytes(const uint16_t sendInterval) const;
+  void BeginEncodedQueue();
+  const std::vector<uint8_t>& GetBytes(const uint16_t sendInterval);
+  std::vector<uint8_t> TakeBytes(const uint16_t sendInterval);
   void MergeFrame(CQueuedActionsFrame& frame);
   bool GetHasActionsBy(const uint8_t fromUID) const;
   bool GetIsEmpty() const;
@@ -81,38 +95,6 @@ struct CQueuedActionsFrame
   void Reset();
 };
 
-struct GameFrame
-{
-  uint8_t                                                m_Type;
-  std::vector<uint8_t>                                   m_Bytes;  
-
-  GameFrame(const uint8_t nType)
-   : m_Type(nType),
-     m_Bytes(std::vector<uint8_t>())
-  {};
-
-  GameFrame(const uint8_t nType, std::vector<uint8_t>& nBytes)
-   : m_Type(nType),
-     m_Bytes(std::move(nBytes))
-  {}
-
-  ~GameFrame() = default;
-
-  inline uint8_t                     GetType() const { return m_Type; }
-  inline const std::vector<uint8_t>& GetBytes() const { return m_Bytes; }
-  inline std::string GetTypeName() {
-    switch (m_Type) {
-      case GAME_FRAME_TYPE_ACTIONS: return "actions";
-      case GAME_FRAME_TYPE_PAUSED: return "paused";
-      case GAME_FRAME_TYPE_LEAVER: return "leaver";
-      case GAME_FRAME_TYPE_CHAT: return "chat";
-      case GAME_FRAME_TYPE_LATENCY: return "latency";
-      case GAME_FRAME_TYPE_GPROXY: return "gproxy";
-      default: return "unknown";
-    }
-  };
-};
-
 struct GameHistory
 {
   bool                                                   m_Desynchronized;
@@ -127,7 +109,7 @@ struct GameHistory
   std::vector<uint8_t>                                   m_SlotsBuffer;
   std::vector<uint8_t>                                   m_LoadingRealBuffer;             // real W3GS_GAMELOADED messages for real players. In standard load, this buffer is filled in real-time. When load-in-game is enabled, this buffer is prefilled.
   std::vector<uint8_t>                                   m_LoadingVirtualBuffer;          // fake W3GS_GAMELOADED messages for fake players, but also for disconnected real players - for consistent game load, m_LoadingVirtualBuffer is sent after m_LoadingRealBuffer
-  std::vector<GameFrame>                                 m_PlayingBuffer;
+  CGameFrameLog                                          m_PlayingBuffer;
 
   GameHistory()
    : m_Desynchronized(false),
@@ -146,7 +128,7 @@ struct GameHistory
   inline bool GetDesynchronized() { return m_Desynchronized; }
   inline void SetSoftDesynchronized(const bool nSoftDesynchronized = true) { m_SoftDesynchronized = nSoftDesynchronized; }
   inline bool GetSoftDesynchronized() { return m_SoftDesynchronized; }
-  inline void SetDefaultLatency(const uint16_t nLatency) { m_DefaultLatency = nLatency; }
+  inline void SetDefaultLatency(const uint16_t nLatency) { m_DefaultLatency = nLatency; m_PlayingBuffer.SetLatency(nLatency); }
   inline uint16_t GetDefaultLatency() { return m_DefaultLatency; }
   inline void SetGProxyEmptyActions(const uint8_t nCount) { m_GProxyEmptyActions = nCount; }
   inline uint32_t GetGProxyEmptyActions() { return m_GProxyEmptyActions; }
@@ -122,6 +122,7 @@ CGameUser::CGameUser(shared_ptr<CGame> nGame, CConnection* connection, uint8_t n
     m_StartedLaggingTicks(0),
     m_LastGProxyWaitNoticeSentTime(0),
     m_GProxyReconnectKey(rand()),
+    m_KickTimer(0),
     m_SID(0xFF),
     m_UID(nUID),
     m_OldUID(0xFF),
@@ -139,6 +140,7 @@ CGameUser::CGameUser(shared_ptr<CGame> nGame, CConnection* connection, uint8_t n
     m_MapReady(false),
     m_InGameReady(false),
     m_Ready(false),
+    m_ReadyReminderTimer(0),
     m_KickReason(KickReason::NONE),
     m_HasHighPing(false),
     m_DownloadAllowed(false),
@@ -177,6 +179,9 @@ CGameUser::CGameUser(shared_ptr<CGame> nGame, CConnection* connection, uint8_t n
 
 CGameUser::~CGameUser()
 {
+  m_Game.get().m_Aura->m_Timers.Cancel(m_KickTimer);
+  m_Game.get().m_Aura->m_Timers.Cancel(m_ReadyReminderTimer);
+
   if (m_Socket) {
     if (!m_LeftMessageSent) {
       Send(GameProtocol::SEND_W3GS_PLAYERLEAVE_OTHERS(GetUID(), m_Game.get().GetIsLobbyStrict() ? PLAYERLEAVE_LOBBY : GetLeftCode()));
@@ -474,7 +479,7 @@ void CGameUser::RefreshUID()
   m_UID = m_Game.get().GetNewUID();
 }
 
-bool CGameUser::Update(fd_set* fd, int64_t timeout)
+bool CGameUser::Update(int64_t timeout)
 {
   if (m_Disconnected) {
     if (m_GProxyExtended && GetTotalDisconnectTicks() > m_Game.get().m_Aura->m_Net.m_Config.m_ReconnectWaitTicks) {
@@ -490,45 +495,37 @@ bool CGameUser::Update(fd_set* fd, int64_t timeout)
 
   if (m_DeleteMe) {
     m_Socket->ClearRecvBuffer(); // in case there are pending bytes from a previous recv
-    m_Socket->Discard(fd);
+    m_Socket->Discard();
     return m_DeleteMe;
   }
 
   const int64_t Ticks = GetTicks();
 
   bool Abort = false;
-  if (m_Socket->DoRecv(fd)) {
+  if (m_Socket->DoRecv()) {
     // extract as many packets as possible from the socket's receive buffer and process them
 
-    string*              RecvBuffer         = m_Socket->GetBytes();
-    std::vector<uint8_t> Bytes              = CreateByteArray((uint8_t*)RecvBuffer->c_str(), RecvBuffer->size());
-    uint32_t             LengthProcessed    = 0;
+    // packets are parsed in place, the views are only valid until the buffer is consumed
 
-    // a packet is at least 4 bytes so loop as long as the buffer contains 4 bytes
+    CStreamBuffer*       RecvBuffer         = m_Socket->GetBytes();
+    CPacketFramer        Framer(*RecvBuffer);
+    PacketView           Data;
 
-    while (Bytes.size() >= 4)
+    while (Framer.Next(Data))
     {
-      // bytes 2 and 3 contain the length of the packet
-      const uint16_t Length = ByteArrayToUInt16(Bytes, false, 2);
-      if (Length < 4) {
-        m_Game.get().EventUserDisconnectGameProtocolError(this, true);
-        Abort = true;
-        break;
-      }
-      if (Bytes.size() < Length) break;
-      const std::vector<uint8_t> Data = std::vector<uint8_t>(begin(Bytes), begin(Bytes) + Length);
+      const uint16_t Length = static_cast<uint16_t>(Data.size());
 
-      if (Bytes[0] == GameProtocol::Magic::W3GS_HEADER)
+      if (Data.GetHeader() == GameProtocol::Magic::W3GS_HEADER)
       {
         ++m_TotalPacketsReceived;
 
         // byte 1 contains the packet ID
 
-        switch (Bytes[1])
+        switch (Data.GetID())
         {
           case GameProtocol::Magic::LEAVEGAME: {
-            if (ValidateLength(Data) && Data.size() >= 8) {
-              const uint32_t reason = ByteArrayToUInt32(Data, false, 4);
+            if (Data.size() >= 8) {
+              const uint32_t reason = Data.GetUInt32(4);
               m_Game.get().EventUserLeft(this, reason);
               m_Socket->SetLogErrors(false);
             } else {
@@ -550,7 +547,7 @@ bool CGameUser::Update(fd_set* fd, int64_t timeout)
             break;
 
           case GameProtocol::Magic::OUTGOING_ACTION: {
-            if (ValidateLength(Data) && Data.size() >= 8) {
+            if (Data.size() >= 8) {
               CIncomingAction action = GameProtocol::RECEIVE_W3GS_OUTGOING_ACTION(Data, m_UID);
               if (!m_Game.get().EventUserIncomingAction(this, action)) {
                 m_Game.get().EventUserDisconnectGameProtocolError(this, false);
@@ -692,10 +689,11 @@ bool CGameUser::Update(fd_set* fd, int64_t timeout)
           case GameProtocol::Magic::PROTO_BUF: {
             // Serialized protocol buffers
             // TODO: Not sure how to handle PROTO_BUF in the most compatible way yet.
+            const std::vector<uint8_t> protoBuf = Data.ToVector();
             if (m_Game.get().GetIsSupportedGameVersion(GAMEVER(1u, 31u))) {
-              m_Game.get().SendAll(Data);
+              m_Game.get().SendAll(protoBuf);
             } else {
-              Send(Data);
+              Send(protoBuf);
             }
             break;
           }
@@ -706,17 +704,17 @@ bool CGameUser::Update(fd_set* fd, int64_t timeout)
           }
         }
       }
-      else if (Bytes[0] == GPSProtocol::Magic::GPS_HEADER && m_Game.get().GetIsProxyReconnectable()) {
-        if (Bytes[1] == GPSProtocol::Magic::ACK && Length == 8) {
-          EventGProxyAck(ByteArrayToUInt32(Data, false, 4));
-        } else if (Bytes[1] == GPSProtocol::Magic::INIT) {
-          InitGProxy(Length >= 8 ? ByteArrayToUInt32(Bytes, false, 4) : 0);
-        } else if (Bytes[1] == GPSProtocol::Magic::SUPPORT_EXTENDED && Length >= 8) {
+      else if (Data.GetHeader() == GPSProtocol::Magic::GPS_HEADER && m_Game.get().GetIsProxyReconnectable()) {
+        if (Data.GetID() == GPSProtocol::Magic::ACK && Length == 8) {
+          EventGProxyAck(Data.GetUInt32(4));
+        } else if (Data.GetID() == GPSProtocol::Magic::INIT) {
+          InitGProxy(Length >= 8 ? Data.GetUInt32(4) : 0);
+        } else if (Data.GetID() == GPSProtocol::Magic::SUPPORT_EXTENDED && Length >= 8) {
           if (m_GProxy && m_Game.get().GetIsProxyReconnectableLong()) {
             ConfirmGProxyExtended(Data);
           }
-        } else if (Bytes[1] == GPSProtocol::Magic::CHANGEKEY && Length >= 8) {
-          m_GProxyReconnectKey = ByteArrayToUInt32(Bytes, false, 4);
+        } else if (Data.GetID() == GPSProtocol::Magic::CHANGEKEY && Length >= 8) {
+          m_GProxyReconnectKey = Data.GetUInt32(4);
           Print(m_Game.get().GetLogPrefix() + "player [" + m_Name + "] updated their reconnect key");
         }
       }
@@ -725,15 +723,17 @@ bool CGameUser::Update(fd_set* fd, int64_t timeout)
         // Process no more packets
         break;
       }
+    }
 
-      LengthProcessed += Length;
-      Bytes = std::vector<uint8_t>(begin(Bytes) + Length, end(Bytes));
+    if (!Abort && Framer.GetIsMalformed()) {
+      m_Game.get().EventUserDisconnectGameProtocolError(this, true);
+      Abort = true;
     }
 
     if (Abort) {
-      RecvBuffer->clear();
-    } else if (LengthProcessed > 0) {
-      *RecvBuffer = RecvBuffer->substr(LengthProcessed);
+      RecvBuffer->Clear();
+    } else {
+      RecvBuffer->Consume(Framer.GetProcessed());
     }
   } else if (Ticks - m_Socket->GetLastRecv() >= timeout) {
     // check for socket timeouts
@@ -743,7 +743,7 @@ bool CGameUser::Update(fd_set* fd, int64_t timeout)
     m_Game.get().EventUserDisconnectTimedOut(this);
     if (m_Disconnected) {
       if (m_DeleteMe) {
-        m_Socket->Discard(fd);
+        m_Socket->Discard();
       }
       return m_DeleteMe;
     }
@@ -759,8 +759,6 @@ bool CGameUser::Update(fd_set* fd, int64_t timeout)
       m_Game.get().EventUserDisconnectSocketError(this);
     } else if (m_Socket->HasFin() || !m_Socket->GetConnected()) {
       m_Game.get().EventUserDisconnectConnectionClosed(this);
-    } else if (m_KickByTicks.has_value() && m_KickByTicks.value() < Ticks) {
-      m_Game.get().EventUserKickHandleQueued(this);
     } else if (!m_Verified && m_RealmInternalId >= 0x10 && Ticks - m_JoinTicks >= GAME_USER_UNVERIFIED_KICK_TICKS && m_Game.get().GetIsLobbyStrict()) {
       shared_ptr<CRealm> Realm = GetRealm(false);
       if (Realm && Realm->GetUnverifiedAutoKickedFromLobby()) {
@@ -816,28 +814,66 @@ bool CGameUser::Update(fd_set* fd, int64_t timeout)
   return false;
 }
 
-uint8_t CGameUser::NextSendMap()
+uint8_t CGameUser::NextSendMap(const uint32_t maxBytes)
+{
+  return m_Game.get().NextSendMap(this, GetUID(), GetMapTransfer(), maxBytes);
+}
+
+bool CGameUser::GetIsGProxyBuffering() const
 {
-  return m_Game.get().NextSendMap(this, GetUID(), GetMapTransfer());
+  return m_GProxy && m_Game.get().GetGameLoaded();
 }
 
 void CGameUser::Send(const std::vector<uint8_t>& data)
 {
+  if (GetIsGProxyBuffering()) {
+    // the GProxy buffer must own the bytes anyway
+    Send(MakeSharedPacket(data));
+    return;
+  }
+
   // must start counting packet total from beginning of connection
   // accepting fragmented packets should not make an observable difference,
   // but it's the safest behavior, just in case something weird is going on in the caller side.
-  size_t count = GameProtocol::GetPacketCount<GameProtocol::FragmentPolicy::kAccept>(data);
+  m_TotalPacketsSent += GameProtocol::GetPacketCount<GameProtocol::FragmentPolicy::kAccept>(data);
+
+  if (!m_Disconnected && !m_Socket->HasError()) {
+    m_Socket->PutBytes(data);
+  }
+}
+
+void CGameUser::Send(const SharedPacket& packet)
+{
+  size_t count = GameProtocol::GetPacketCount<GameProtocol::FragmentPolicy::kAccept>(*packet);
   m_TotalPacketsSent += count;
 
-  if (m_GProxy && m_Game.get().GetGameLoaded()) {
+  if (GetIsGProxyBuffering()) {
     // we can avoid buffering packets until we know the client is using GProxy++ since that'll be determined before the game starts
     // this prevents us from buffering packets for non-reconnectable clients
-    m_GProxyBuffer.push(GameProtocol::PacketWrapper(data, count));
+    m_GProxyBuffer.push(GameProtocol::PacketWrapper(packet, count));
     m_GProxyBufferSize += count;
   }
 
   if (!m_Disconnected && !m_Socket->HasError()) {
-    m_Socket->PutBytes(data);
+    m_Socket->PutPacket(packet);
+  }
+}
+
+void CGameUser::SendWithPayload(const std::vector<uint8_t>& header, const SharedPacket& payload, const size_t offset, const size_t size)
+{
+  if (GetIsGProxyBuffering()) {
+    vector<uint8_t> packet = header;
+    packet.insert(packet.end(), payload->begin() + offset, payload->begin() + offset + size);
+    Send(MakeSharedPacket(move(packet)));
+    return;
+  }
+
+  // the header carries the length of the whole packet
+  ++m_TotalPacketsSent;
+
+  if (!m_Disconnected && !m_Socket->HasError()) {
+    m_Socket->PutBytes(header);
+    m_Socket->PutSlice(payload, offset, size);
   }
 }
 
@@ -865,7 +901,7 @@ void CGameUser::InitGProxy(const uint32_t version)
   Print(m_Game.get().GetLogPrefix() + "player [" + m_Name + "] will reconnect at port " + to_string(m_GProxyPort) + " if disconnected");
 }
 
-void CGameUser::ConfirmGProxyExtended(const vector<uint8_t>& data)
+void CGameUser::ConfirmGProxyExtended(const PacketView& data)
 {
   m_GProxyExtended = true;
   if (data.size() >= 12) {
@@ -956,7 +992,7 @@ void CGameUser::EventGProxyReconnect(CConnection* connection, const uint32_t las
     // but preserve buffer in case the client disconnects again
     queue<GameProtocol::PacketWrapper> tempBuffer;
     while (!m_GProxyBuffer.empty()) {
-      m_Socket->PutBytes(m_GProxyBuffer.front().data);
+      m_Socket->PutBytes(m_GProxyBuffer.front().GetData(), m_GProxyBuffer.front().GetSize());
       tempBuffer.push(move(m_GProxyBuffer.front()));
       m_GProxyBuffer.pop();
     }
@@ -1173,12 +1209,55 @@ void CGameUser::DisableReconnect()
   */
 }
 
-bool CGameUser::GetReadyReminderIsDue() const
+void CGameUser::SetKickByTicks(int64_t nKickByTicks)
+{
+  m_KickByTicks = nKickByTicks;
+  const int64_t dueTicks = nKickByTicks + 1;
+  if (!m_Game.get().m_Aura->m_Timers.Reschedule(m_KickTimer, dueTicks)) {
+    m_KickTimer = m_Game.get().m_Aura->m_Timers.Schedule(dueTicks, [this]() {
+      RunKickTimer();
+    });
+  }
+}
+
+void CGameUser::ClearKickByTicks()
+{
+  m_KickByTicks = nullopt;
+  m_Game.get().m_Aura->m_Timers.Cancel(m_KickTimer);
+}
+
+void CGameUser::KickAtLatest(int64_t nKickByTicks)
+{
+  if (!m_KickByTicks.has_value() || nKickByTicks < m_KickByTicks.value()) {
+    SetKickByTicks(nKickByTicks);
+  }
+}
+
+void CGameUser::RunKickTimer()
 {
-  return !m_ReadyReminderLastTicks.has_value() || m_ReadyReminderLastTicks.value() + READY_REMINDER_PERIOD < GetTicks();
+  if (m_Disconnected || m_DeleteMe) {
+    return;
+  }
+  m_Game.get().EventUserKickHandleQueued(this);
 }
 
-void CGameUser::SetReadyReminded()
+void CGameUser::RunReadyReminderTimer()
 {
-  m_ReadyReminderLastTicks = GetTicks();
+  if (m_Disconnected || m_DeleteMe || !m_Game.get().GetIsLobbyStrict()) {
+    return;
+  }
+  if (m_Game.get().EventUserReadyReminderDue(this)) {
+    ScheduleReadyReminderTimer(GetTicks() + READY_REMINDER_PERIOD);
+  } else {
+    ScheduleReadyReminderTimer(GetTicks() + READY_REMINDER_RETRY_PERIOD);
+  }
+}
+
+void CGameUser::ScheduleReadyReminderTimer(const int64_t dueTicks)
+{
+  if (!m_Game.get().m_Aura->m_Timers.Reschedule(m_ReadyReminderTimer, dueTicks)) {
+    m_ReadyReminderTimer = m_Game.get().m_Aura->m_Timers.Schedule(dueTicks, [this]() {
+      RunReadyReminderTimer();
+    });
+  }
 }
\ No newline at end of file
@@ -53,6 +53,7 @@
 #include "game_structs.h"
 #include "rate_limiter.h"
 #include "map.h"
+#include "timer_queue.h"
 
 //
 // GameUser::CGameUser
@@ -107,6 +108,7 @@ namespace GameUser
     int64_t                          m_LastGProxyWaitNoticeSentTime; // GetTime when the last disconnection notice has been sent when using GProxy++
     uint32_t                         m_GProxyReconnectKey;           // the GProxy++ reconnect key
     std::optional<int64_t>           m_KickByTicks;
+    TimerId                          m_KickTimer;                    // kicks the user at m_KickByTicks
     std::optional<int64_t>           m_LastGProxyAckTicks;           // GetTime when we last acknowledged GProxy++ packet
     uint8_t                          m_SID;                          // the player's SID - this is well defined only after the game starts loading
     uint8_t                          m_UID;                          // the player's UID
@@ -126,7 +128,7 @@ namespace GameUser
     bool                             m_InGameReady;
     std::optional<bool>              m_UserReady;
     bool                             m_Ready;
-    std::optional<int64_t>           m_ReadyReminderLastTicks;
+    TimerId                          m_ReadyReminderTimer;           // reminds the user to get ready while in the lobby
     uint8_t                          m_KickReason;                   // bitmask for all the reasons why this user is going to be kicked
     bool                             m_HasHighPing;                  // if last time we checked, the player had high ping
     bool                             m_DownloadAllowed;              // if we're allowed to download the map or not (used with permission based map downloads)
@@ -372,16 +374,13 @@ namespace GameUser
     inline void SetGProxyDisconnectNoticeSent(bool nGProxyDisconnectNoticeSent) { m_GProxyDisconnectNoticeSent = nGProxyDisconnectNoticeSent; }
     inline void SetLastGProxyWaitNoticeSentTime(uint64_t nLastGProxyWaitNoticeSentTime) { m_LastGProxyWaitNoticeSentTime = nLastGProxyWaitNoticeSentTime; }
     void DisableReconnect();
-    inline void SetKickByTicks(int64_t nKickByTicks) { m_KickByTicks = nKickByTicks; }
-    inline void ClearKickByTicks() { m_KickByTicks = std::nullopt; }
+    void SetKickByTicks(int64_t nKickByTicks);
+    void ClearKickByTicks();
     inline void AddKickReason(const uint8_t nKickReason) { m_KickReason |= nKickReason; }
     inline void RemoveKickReason(const uint8_t nKickReason) { m_KickReason &= ~nKickReason; }
     inline void ResetKickReason() { m_KickReason = GameUser::KickReason::NONE; }
-    inline void KickAtLatest(int64_t nKickByTicks) {
-      if (!m_KickByTicks.has_value() || nKickByTicks < m_KickByTicks.value()) {
-        m_KickByTicks = nKickByTicks;
-      }
-    }
+    void KickAtLatest(int64_t nKickByTicks);
+    void RunKickTimer();
     inline void CheckStillKicked() {
       if (!GetAnyKicked() && GetKickQueued()) {
         ClearKickByTicks();
@@ -391,8 +390,8 @@ namespace GameUser
     inline void SetUserReady(bool nReady) { m_UserReady = nReady; }
     inline void ClearUserReady() { m_UserReady = std::nullopt; }
 
-    [[nodiscard]] bool GetReadyReminderIsDue() const;
-    void SetReadyReminded();
+    void RunReadyReminderTimer();
+    void ScheduleReadyReminderTimer(const int64_t dueTicks);
 
     inline void SetDraftCaptain(const uint8_t nTeamNumber) { m_TeamCaptain = nTeamNumber; }
     inline void DropRemainingSaves() { --m_RemainingSaves; }
@@ -426,12 +425,15 @@ namespace GameUser
 
     // processing functions
 
-    [[nodiscard]] bool Update(fd_set* fd, int64_t timeout);
-    [[nodiscard]] uint8_t NextSendMap();
+    [[nodiscard]] bool Update(int64_t timeout);
+    [[nodiscard]] uint8_t NextSendMap(const uint32_t maxBytes);
 
     // other functions
 
     void Send(const std::vector<uint8_t>& data) final;
+    void Send(const SharedPacket& packet) final;
+    void SendWithPayload(const std::vector<uint8_t>& header, const SharedPacket& payload, const size_t offset, const size_t size) final;
+    [[nodiscard]] bool GetIsGProxyBuffering() const;
 
     void EventGProxyAck(const size_t lastPacket);
     void EventGProxyReconnect(CConnection* connection, const uint32_t LastPacket);
@@ -441,7 +443,7 @@ namespace GameUser
     void UnrefConnection(bool deferred = false);
 
     void InitGProxy(const uint32_t version);
-    void ConfirmGProxyExtended(const std::vector<uint8_t>& data);
+    void ConfirmGProxyExtended(const PacketView& data);
     void UpdateGProxyEmptyActions() const;
     void CheckGProxyExtendedStartHandShake() const;
   };
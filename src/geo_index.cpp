@@ -0,0 +1,229 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#include "geo_index.h"
+#include "file_util.h"
+#include "util.h"
+
+#include <csvparser/csvparser.h>
+
+using namespace std;
+
+//
+// CGeoIndex
+//
+
+CGeoIndex::CGeoIndex()
+{
+}
+
+CGeoIndex::~CGeoIndex()
+{
+}
+
+uint16_t CGeoIndex::GetCountryCode(const uint32_t ip) const
+{
+  // find the last range starting at or before ip
+  auto it = upper_bound(m_RangeStarts.begin(), m_RangeStarts.end(), ip);
+  if (it == m_RangeStarts.begin()) {
+    return GEO_INDEX_COUNTRY_UNKNOWN;
+  }
+  const size_t index = static_cast<size_t>(distance(m_RangeStarts.begin(), it)) - 1;
+  if (ip > m_RangeEnds[index]) {
+    return GEO_INDEX_COUNTRY_UNKNOWN;
+  }
+  return m_Countries[index];
+}
+
+string CGeoIndex::GetCountry(const uint32_t ip) const
+{
+  return UnpackCountry(GetCountryCode(ip));
+}
+
+void CGeoIndex::Clear()
+{
+  m_RangeStarts.clear();
+  m_RangeEnds.clear();
+  m_Countries.clear();
+}
+
+void CGeoIndex::AddRange(const uint32_t ip1, const uint32_t ip2, const string& country)
+{
+  if (ip2 < ip1) return;
+  m_RangeStarts.push_back(ip1);
+  m_RangeEnds.push_back(ip2);
+  m_Countries.push_back(PackCountry(country));
+}
+
+void CGeoIndex::Seal()
+{
+  const size_t count = m_RangeStarts.size();
+  vector<uint32_t> order(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    order[i] = i;
+  }
+  stable_sort(order.begin(), order.end(), [this](const uint32_t a, const uint32_t b) {
+    return m_RangeStarts[a] < m_RangeStarts[b];
+  });
+
+  vector<uint32_t> rangeStarts, rangeEnds;
+  vector<uint16_t> countries;
+  rangeStarts.reserve(count);
+  rangeEnds.reserve(count);
+  countries.reserve(count);
+
+  for (const uint32_t index : order) {
+    // ranges must not overlap, or binary search may miss them - earlier entries win
+    if (!rangeEnds.empty() && m_RangeStarts[index] <= rangeEnds.back()) {
+      continue;
+    }
+    rangeStarts.push_back(m_RangeStarts[index]);
+    rangeEnds.push_back(m_RangeEnds[index]);
+    countries.push_back(m_Countries[index]);
+  }
+
+  m_RangeStarts = move(rangeStarts);
+  m_RangeEnds = move(rangeEnds);
+  m_Countries = move(countries);
+}
+
+bool CGeoIndex::LoadCSV(const filesystem::path& filePath)
+{
+  string contents;
+  if (!FileRead(filePath, contents, GEO_INDEX_MAX_SOURCE_SIZE) || contents.empty()) {
+    return false;
+  }
+
+  Clear();
+
+  string    Line, Skip, IP1, IP2, Country;
+  CSVParser parser;
+
+  string::size_type lineStart = 0;
+  while (lineStart < contents.size()) {
+    string::size_type lineEnd = contents.find('\n', lineStart);
+    if (lineEnd == string::npos) lineEnd = contents.size();
+    Line = contents.substr(lineStart, lineEnd - lineStart);
+    lineStart = lineEnd + 1;
+
+    if (!Line.empty() && Line.back() == '\r') Line.pop_back();
+    if (Line.empty())
+      continue;
+
+    parser << Line;
+    parser >> Skip;
+    parser >> Skip;
+    parser >> IP1;
+    parser >> IP2;
+    parser >> Country;
+
+    optional<uint32_t> ip1 = ToUint32(IP1);
+    optional<uint32_t> ip2 = ToUint32(IP2);
+    if (!ip1.has_value() || !ip2.has_value()) {
+      continue;
+    }
+    AddRange(ip1.value(), ip2.value(), Country);
+  }
+
+  Seal();
+  return !GetIsEmpty();
+}
+
+bool CGeoIndex::LoadSnapshot(const filesystem::path& filePath, const size_t sourceSize, const int64_t sourceModified)
+{
+  vector<uint8_t> bytes;
+  if (!FileRead(filePath, bytes, GEO_INDEX_MAX_SOURCE_SIZE) || bytes.size() < GEO_INDEX_SNAPSHOT_HEADER_SIZE) {
+    return false;
+  }
+
+  // header: "AGEO", version, source size, source modified time, range count - native byte order
+  const uint8_t* cursor = bytes.data();
+  uint32_t version = 0, count = 0;
+  uint64_t snapshotSourceSize = 0;
+  int64_t snapshotSourceModified = 0;
+  if (memcmp(cursor, "AGEO", 4) != 0) return false;
+  memcpy(&version, cursor + 4, 4);
+  memcpy(&snapshotSourceSize, cursor + 8, 8);
+  memcpy(&snapshotSourceModified, cursor + 16, 8);
+  memcpy(&count, cursor + 24, 4);
+  if (version != GEO_INDEX_SNAPSHOT_VERSION || snapshotSourceSize != sourceSize || snapshotSourceModified != sourceModified) {
+    return false;
+  }
+  if (bytes.size() != GEO_INDEX_SNAPSHOT_HEADER_SIZE + static_cast<size_t>(count) * 10) {
+    return false;
+  }
+
+  cursor += GEO_INDEX_SNAPSHOT_HEADER_SIZE;
+  m_RangeStarts.resize(count);
+  m_RangeEnds.resize(count);
+  m_Countries.resize(count);
+  memcpy(m_RangeStarts.data(), cursor, count * 4);
+  cursor += count * 4;
+  memcpy(m_RangeEnds.data(), cursor, count * 4);
+  cursor += count * 4;
+  memcpy(m_Countries.data(), cursor, count * 2);
+
+  // a tampered snapshot must not break lookups
+  if (!is_sorted(m_RangeStarts.begin(), m_RangeStarts.end())) {
+    Seal();
+  }
+  return !GetIsEmpty();
+}
+
+bool CGeoIndex::SaveSnapshot(const filesystem::path& filePath, const size_t sourceSize, const int64_t sourceModified) const
+{
+  const uint32_t count = static_cast<uint32_t>(m_RangeStarts.size());
+  const uint64_t snapshotSourceSize = sourceSize;
+  vector<uint8_t> bytes(GEO_INDEX_SNAPSHOT_HEADER_SIZE + static_cast<size_t>(count) * 10);
+  uint8_t* cursor = bytes.data();
+  memcpy(cursor, "AGEO", 4);
+  memcpy(cursor + 4, &GEO_INDEX_SNAPSHOT_VERSION, 4);
+  memcpy(cursor + 8, &snapshotSourceSize, 8);
+  memcpy(cursor + 16, &sourceModified, 8);
+  memcpy(cursor + 24, &count, 4);
+  cursor += GEO_INDEX_SNAPSHOT_HEADER_SIZE;
+  memcpy(cursor, m_RangeStarts.data(), count * 4);
+  cursor += count * 4;
+  memcpy(cursor, m_RangeEnds.data(), count * 4);
+  cursor += count * 4;
+  memcpy(cursor, m_Countries.data(), count * 2);
+  return FileWrite(filePath, bytes.data(), bytes.size());
+}
+
+uint16_t CGeoIndex::PackCountry(const string& country)
+{
+  if (country.size() != 2) {
+    return GEO_INDEX_COUNTRY_UNKNOWN;
+  }
+  return static_cast<uint16_t>(static_cast<uint8_t>(country[0])) << 8 | static_cast<uint8_t>(country[1]);
+}
+
+string CGeoIndex::UnpackCountry(const uint16_t countryCode)
+{
+  string country(2, '?');
+  country[0] = static_cast<char>(countryCode >> 8);
+  country[1] = static_cast<char>(countryCode & 0xFF);
+  return country;
+}
@@ -0,0 +1,72 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#ifndef AURA_GEO_INDEX_H_
+#define AURA_GEO_INDEX_H_
+
+#include "includes.h"
+
+#include <filesystem>
+
+//
+// CGeoIndex
+//
+// IPv4 to country lookups, served from memory.
+// Ranges are kept sorted by their first address, as parallel arrays, and looked up by binary search.
+// Country codes are packed into 2 bytes each, so the whole table stays within a few MB.
+//
+// Parsing ip-to-country.csv is only needed once. Afterwards, a binary snapshot is loaded with a single read.
+// The snapshot records the size and modification time of its source CSV, and is rebuilt whenever they change.
+//
+
+class CGeoIndex
+{
+public:
+  std::vector<uint32_t>     m_RangeStarts;
+  std::vector<uint32_t>     m_RangeEnds;
+  std::vector<uint16_t>     m_Countries;
+
+  CGeoIndex();
+  ~CGeoIndex();
+  CGeoIndex(CGeoIndex&) = delete;
+
+  [[nodiscard]] inline size_t       GetSize() const { return m_RangeStarts.size(); }
+  [[nodiscard]] inline bool         GetIsEmpty() const { return m_RangeStarts.empty(); }
+  [[nodiscard]] uint16_t            GetCountryCode(const uint32_t ip) const;
+  [[nodiscard]] std::string         GetCountry(const uint32_t ip) const;
+
+  void                              Clear();
+  void                              AddRange(const uint32_t ip1, const uint32_t ip2, const std::string& country);
+  void                              Seal();
+
+  [[nodiscard]] bool                LoadCSV(const std::filesystem::path& filePath);
+  [[nodiscard]] bool                LoadSnapshot(const std::filesystem::path& filePath, const size_t sourceSize, const int64_t sourceModified);
+  bool                              SaveSnapshot(const std::filesystem::path& filePath, const size_t sourceSize, const int64_t sourceModified) const;
+
+  [[nodiscard]] static uint16_t     PackCountry(const std::string& country);
+  [[nodiscard]] static std::string  UnpackCountry(const uint16_t countryCode);
+};
+
+#endif // AURA_GEO_INDEX_H_
@@ -143,6 +143,24 @@ std::string::size_type constexpr GetStringLength(const char* str)
 #define DPRINT_IF(T, U)
 #endif
 
+// Same as PRINT_IF, DPRINT_IF, but matching the log level of C instead of m_Aura
+#define CFG_PRINT_IF(C, T, U) \
+    static_assert(T < LogLevel::LAST, "Use CFG_DPRINT_IF for tracing log levels");\
+    if ((C).MatchLogLevel(T)) {\
+        Print(U); \
+    }
+
+#ifdef DEBUG
+#define CFG_DPRINT_IF(C, T, U) \
+    static_assert(T < LogLevel::LAST, "Invalid tracing log level");\
+    static_assert(T >= LogLevel::kTrace, "Use CFG_PRINT_IF for regular log levels");\
+    if ((C).MatchLogLevel(T)) {\
+        Print(U); \
+    }
+#else
+#define CFG_DPRINT_IF(C, T, U)
+#endif
+
 #define GAMEVER(T, U) Version((uint8_t)(T), (uint8_t)(U))
 
 #define APP_MAX_TICKS std::numeric_limits<int64_t>::max()
@@ -162,38 +180,43 @@ inline int64_t GetTicks()
   return std::chrono::duration_cast<std::chrono::milliseconds>(time_now.time_since_epoch()).count();
 }
 
-inline void LogStream(std::ostream& outStream, const std::string& message, bool details = false)
+// formatted timestamps are cached, since localtime() is only worth calling once per second
+inline const std::string& GetLogTimestamp(const int64_t unixTime, bool details)
 {
-  auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-  struct tm timeinfo;
+  thread_local int64_t cachedTime = -1;
+  thread_local std::string cachedShort, cachedLong;
+
+  if (unixTime != cachedTime) {
+    const time_t now = static_cast<time_t>(unixTime);
+    struct tm timeinfo;
 #ifdef _WIN32
-  localtime_s(&timeinfo, &now);
+    localtime_s(&timeinfo, &now);
 #else
-  localtime_r(&now, &timeinfo);
+    localtime_r(&now, &timeinfo);
 #endif
-  if (details) {
-    outStream << "[" << std::put_time(&timeinfo, "%Y-%m-%d %H:%M:%S") << "] " << message << std::endl;
-  } else {
-    outStream << "[" << std::put_time(&timeinfo, "%H:%M:%S") << "] " << message << std::endl;
+    char buffer[32];
+    strftime(buffer, sizeof(buffer), "[%H:%M:%S] ", &timeinfo);
+    cachedShort = buffer;
+    strftime(buffer, sizeof(buffer), "[%Y-%m-%d %H:%M:%S] ", &timeinfo);
+    cachedLong = buffer;
+    cachedTime = unixTime;
   }
-  outStream << std::flush;
+  return details ? cachedLong : cachedShort;
+}
+
+inline const std::string& GetLogTimestamp(bool details)
+{
+  return GetLogTimestamp(static_cast<int64_t>(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now())), details);
+}
+
+inline void LogStream(std::ostream& outStream, const std::string& message, bool details = false)
+{
+  outStream << GetLogTimestamp(details) << message << '\n' << std::flush;
 }
 
 inline void LogStream(std::ostream& outStream, const char* message, bool details = false)
 {
-  auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-  struct tm timeinfo;
-#ifdef _WIN32
-  localtime_s(&timeinfo, &now);
-#else
-  localtime_r(&now, &timeinfo);
-#endif
-  if (details) {
-    outStream << "[" << std::put_time(&timeinfo, "%Y-%m-%d %H:%M:%S") << "] " << message << std::endl;
-  } else {
-    outStream << "[" << std::put_time(&timeinfo, "%H:%M:%S") << "] " << message << std::endl;
-  }
-  outStream << std::flush;
+  outStream << GetLogTimestamp(details) << message << '\n' << std::flush;
 }
 
 inline void Print(const std::string& message) // outputs to console
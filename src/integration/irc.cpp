@@ -97,19 +97,6 @@ bool CIRC::MatchHostName(const string& hostName) const
   return false;
 }
 
-uint32_t CIRC::SetFD(fd_set* fd, fd_set* send_fd, int32_t* nfds) const
-{
-  // irc socket
-
-  if (!m_Socket->HasError() && !m_Socket->HasFin() && m_Socket->GetConnected())
-  {
-    m_Socket->SetFD(fd, send_fd, nfds);
-    return 0;
-  }
-
-  return 1;
-}
-
 void CIRC::ResetConnection()
 {
   m_Socket->Reset();
@@ -118,7 +105,7 @@ void CIRC::ResetConnection()
   m_LoggedIn = false;
 }
 
-void CIRC::Update(fd_set* fd, fd_set* send_fd)
+void CIRC::Update()
 {
   if (!m_Config.m_Enabled) {
     if (m_Socket && m_Socket->GetConnected()) {
@@ -163,13 +150,13 @@ void CIRC::Update(fd_set* fd, fd_set* send_fd)
       m_LastAntiIdleTime = Time;
     }
 
-    if (m_Socket->DoRecv(fd)) {
+    if (m_Socket->DoRecv()) {
       ExtractPackets();
     }
     if (m_Socket->HasError() || m_Socket->HasFin()) {
       return;
     }
-    m_Socket->DoSend(send_fd);
+    m_Socket->DoSend();
     return;
   }
 
@@ -200,7 +187,7 @@ void CIRC::Update(fd_set* fd, fd_set* send_fd)
       Send("NICK " + m_Config.m_NickName);
       Send("USER " + m_Config.m_UserName + " " + m_Config.m_NickName + " " + m_Config.m_UserName + " :aura-bot");
 
-      m_Socket->DoSend(send_fd);
+      m_Socket->DoSend();
 
       m_LoggedIn = true;
       Print("[IRC: " + m_Config.m_HostName + "] connected");
@@ -223,10 +210,16 @@ void CIRC::Update(fd_set* fd, fd_set* send_fd)
   if (!m_Socket->GetConnecting() && !m_Socket->GetConnected() && (Time - m_LastConnectionAttemptTime > 60)) {
     // attempt to connect to irc
 
+    sockaddr_storage resolvedAddress;
+    const DNSStatus resolution = m_Aura->m_Net.ResolveHostName(resolvedAddress, ACCEPT_ANY, m_Config.m_HostName, m_Config.m_Port);
+    if (resolution == DNSStatus::kPending) {
+      // check back next update
+      return;
+    }
+
     Print("[IRC: " + m_Config.m_HostName + "] connecting to server [" + m_Config.m_HostName + "] on port " + to_string(m_Config.m_Port));
     optional<sockaddr_storage> emptyBindAddress;
-    sockaddr_storage resolvedAddress;
-    if (m_Aura->m_Net.ResolveHostName(resolvedAddress, ACCEPT_ANY, m_Config.m_HostName, m_Config.m_Port)) {
+    if (resolution == DNSStatus::kResolved) {
       m_Socket->Connect(emptyBindAddress, resolvedAddress);
     } else {
       m_Socket->m_HasError = true;
@@ -240,12 +233,25 @@ void CIRC::Update(fd_set* fd, fd_set* send_fd)
 
 void CIRC::ExtractPackets()
 {
-  const int64_t Time = GetTime();
-  string*       Recv = m_Socket->GetBytes();
+  const int64_t  Time = GetTime();
+  CStreamBuffer* Recv = m_Socket->GetBytes();
+
+  // only complete lines are processed, a trailing partial line stays in the buffer until the rest arrives
+
+  const string_view pending = Recv->GetView();
+  const string_view::size_type lastLF = pending.rfind('\n');
+  if (lastLF == string_view::npos) {
+    if (pending.size() > 4096) {
+      // lines are at most 512 bytes long, the server isn't speaking IRC
+      Recv->Clear();
+    }
+    return;
+  }
 
   // separate packets using the CRLF delimiter
 
-  vector<string> Packets = SplitTokens(*Recv, '\n');
+  vector<string> Packets = SplitTokens(pending.substr(0, lastLF), '\n');
+  Recv->Consume(lastLF + 1);
 
   for (auto& Packets_Packet : Packets)
   {
@@ -396,9 +402,6 @@ void CIRC::ExtractPackets()
       continue;
     }
   }
-
-  // clear the whole buffer
-  m_Socket->ClearRecvBuffer();
 }
 
 void CIRC::Send(const string& message)
@@ -44,15 +44,26 @@ struct DoubleLinkedListNode {
   }
 };
 
+//
+// CircleDoubleLinkedList
+//
+// Nodes removed with release() are not deleted, but kept in a free list, and reused by the emplace methods.
+// Callers must leave the released node's data in a reusable state.
+//
+
 template <typename T>
 struct CircleDoubleLinkedList
 {
   DoubleLinkedListNode<T>* head;
   DoubleLinkedListNode<T>* tail;
+  DoubleLinkedListNode<T>* freeHead;
+  size_t freeCount;
 
   CircleDoubleLinkedList()
    : head(nullptr),
-     tail(nullptr)
+     tail(nullptr),
+     freeHead(nullptr),
+     freeCount(0)
   {}
 
   ~CircleDoubleLinkedList()
@@ -87,14 +98,45 @@ struct CircleDoubleLinkedList
     }
   }
 
+  DoubleLinkedListNode<T>* acquire()
+  {
+    if (freeHead == nullptr) {
+      return new DoubleLinkedListNode<T>();
+    }
+    DoubleLinkedListNode<T>* node = freeHead;
+    freeHead = node->next;
+    --freeCount;
+    node->next = nullptr;
+    return node;
+  }
+
+  void release(DoubleLinkedListNode<T>* node)
+  {
+    remove(node);
+    node->prev = nullptr;
+    node->next = freeHead;
+    freeHead = node;
+    ++freeCount;
+  }
+
+  void reserve(const size_t count)
+  {
+    while (freeCount < count) {
+      DoubleLinkedListNode<T>* node = new DoubleLinkedListNode<T>();
+      node->next = freeHead;
+      freeHead = node;
+      ++freeCount;
+    }
+  }
+
   void emplaceBefore(DoubleLinkedListNode<T>* next)
   {
-    insertBefore(next, new DoubleLinkedListNode<T>());
+    insertBefore(next, acquire());
   }
 
   void emplaceAfter(DoubleLinkedListNode<T>* prev)
   {
-    insertAfter(prev, new DoubleLinkedListNode<T>());
+    insertAfter(prev, acquire());
   }
 
   void insertBack(DoubleLinkedListNode<T>* node)
@@ -115,7 +157,7 @@ struct CircleDoubleLinkedList
 
   void emplaceBack()
   {
-    insertBack(new DoubleLinkedListNode<T>());
+    insertBack(acquire());
   }
 
   void remove(DoubleLinkedListNode<T>* node)
@@ -145,6 +187,12 @@ struct CircleDoubleLinkedList
       remove(tmpTail);
       delete tmpTail;
     }
+    while (freeHead != nullptr) {
+      DoubleLinkedListNode<T>* tmpHead = freeHead;
+      freeHead = tmpHead->next;
+      delete tmpHead;
+    }
+    freeCount = 0;
   }
 };
 
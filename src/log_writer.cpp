@@ -0,0 +1,237 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#include "log_writer.h"
+
+using namespace std;
+
+//
+// CLogWriter
+//
+
+CLogWriter::CLogWriter()
+ : m_Started(false),
+   m_Stopping(false),
+   m_Format(LOG_FORMAT_TEXT),
+   m_RotateSize(0),
+   m_RotateInterval(0)
+{
+}
+
+CLogWriter::~CLogWriter()
+{
+  Stop();
+}
+
+void CLogWriter::SetOptions(const uint8_t format, const uint64_t rotateSize, const int64_t rotateInterval)
+{
+  lock_guard<mutex> lock(m_Mutex);
+  m_Format = format;
+  m_RotateSize = rotateSize;
+  m_RotateInterval = rotateInterval;
+}
+
+void CLogWriter::Push(const filesystem::path& path, string text)
+{
+  const int64_t time = static_cast<int64_t>(chrono::system_clock::to_time_t(chrono::system_clock::now()));
+  bool wake = false;
+  {
+    lock_guard<mutex> lock(m_Mutex);
+    if (m_Stopping) {
+      return;
+    }
+    if (!m_Started) {
+      m_Thread = thread(&CLogWriter::Run, this);
+      m_Started = true;
+    }
+    m_Queue.push_back(LogRecord{path, time, move(text)});
+    wake = m_Queue.size() >= LOG_WRITER_WAKE_THRESHOLD;
+  }
+  if (wake) {
+    m_Ready.notify_one();
+  }
+}
+
+void CLogWriter::Stop()
+{
+  {
+    lock_guard<mutex> lock(m_Mutex);
+    if (m_Stopping) {
+      return;
+    }
+    m_Stopping = true;
+  }
+  m_Ready.notify_one();
+  if (m_Thread.joinable()) {
+    m_Thread.join();
+  }
+}
+
+void CLogWriter::Run()
+{
+  vector<LogRecord> batch;
+  unique_lock<mutex> lock(m_Mutex);
+  while (true) {
+    m_Ready.wait_for(lock, chrono::milliseconds(LOG_WRITER_FLUSH_INTERVAL_MS), [this]() {
+      return m_Stopping || m_Queue.size() >= LOG_WRITER_WAKE_THRESHOLD;
+    });
+    const bool stopping = m_Stopping;
+    const uint8_t format = m_Format;
+    const uint64_t rotateSize = m_RotateSize;
+    const int64_t rotateInterval = m_RotateInterval;
+    batch.swap(m_Queue);
+    lock.unlock();
+
+    WriteBatch(batch, format, rotateSize, rotateInterval);
+    batch.clear();
+
+    if (stopping) {
+      break;
+    }
+    lock.lock();
+  }
+
+  for (auto& entry : m_Targets) {
+    entry.second.stream.close();
+  }
+  m_Targets.clear();
+}
+
+void CLogWriter::WriteBatch(vector<LogRecord>& batch, const uint8_t format, const uint64_t rotateSize, const int64_t rotateInterval)
+{
+  if (batch.empty()) {
+    return;
+  }
+
+  vector<LogFileTarget*> touched;
+  for (auto& record : batch) {
+    LogFileTarget* target = GetTarget(record.path, record.time);
+    if (!target) {
+      continue;
+    }
+
+    const bool dueSize = rotateSize > 0 && target->size + target->pending.size() >= rotateSize;
+    const bool dueTime = rotateInterval > 0 && record.time - target->openedTime >= rotateInterval;
+    if ((dueSize || dueTime) && (target->size + target->pending.size()) > 0) {
+      RotateTarget(record.path, *target, record.time);
+      if (!target->stream.is_open()) {
+        target->failed = true;
+        continue;
+      }
+    }
+
+    if (!target->batched) {
+      target->batched = true;
+      touched.push_back(target);
+    }
+    if (format == LOG_FORMAT_BINARY) {
+      const uint32_t length = static_cast<uint32_t>(record.text.size());
+      target->pending.append(reinterpret_cast<const char*>(&record.time), sizeof(record.time));
+      target->pending.append(reinterpret_cast<const char*>(&length), sizeof(length));
+      target->pending.append(record.text);
+    } else {
+      target->pending.append(GetLogTimestamp(record.time, true));
+      target->pending.append(record.text);
+      target->pending.push_back('\n');
+    }
+  }
+
+  // targets are only dropped here, so that pointers in touched stay valid during the batch
+  for (auto& target : touched) {
+    target->batched = false;
+    if (target->failed) {
+      continue;
+    }
+    target->stream.write(target->pending.data(), target->pending.size());
+    target->stream.flush();
+    target->size += target->pending.size();
+    target->pending.clear();
+  }
+
+  for (auto it = m_Targets.begin(); it != m_Targets.end();) {
+    if (it->second.failed) {
+      it = m_Targets.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+LogFileTarget* CLogWriter::GetTarget(const filesystem::path& path, const int64_t time)
+{
+  auto it = m_Targets.find(path);
+  if (it == m_Targets.end()) {
+    it = m_Targets.emplace(piecewise_construct, forward_as_tuple(path), forward_as_tuple()).first;
+  }
+  LogFileTarget& target = it->second;
+  if (target.failed) {
+    return nullptr;
+  }
+  if (!target.stream.is_open()) {
+    target.stream.open(path.native().c_str(), ios::binary | ios::app);
+    if (target.stream.fail()) {
+      target.failed = true;
+      return nullptr;
+    }
+    error_code ec;
+    uintmax_t size = filesystem::file_size(path, ec);
+    target.size = ec ? 0 : static_cast<uint64_t>(size);
+    target.openedTime = time;
+  }
+  return &target;
+}
+
+void CLogWriter::RotateTarget(const filesystem::path& path, LogFileTarget& target, const int64_t time)
+{
+  // pending lines belong to the rotated file
+  if (!target.pending.empty()) {
+    target.stream.write(target.pending.data(), target.pending.size());
+    target.pending.clear();
+  }
+  target.stream.close();
+
+  const time_t rotateTime = static_cast<time_t>(time);
+  struct tm timeinfo;
+#ifdef _WIN32
+  localtime_s(&timeinfo, &rotateTime);
+#else
+  localtime_r(&rotateTime, &timeinfo);
+#endif
+  char suffix[32];
+  strftime(suffix, sizeof(suffix), "-%Y%m%d-%H%M%S", &timeinfo);
+
+  filesystem::path rotatedPath = path;
+  rotatedPath.replace_filename(path.stem().native() + filesystem::path(suffix).native() + path.extension().native());
+  error_code ec;
+  for (uint8_t i = 1; filesystem::exists(rotatedPath, ec) && i < 100; ++i) {
+    // rotated more than once in the same second
+    rotatedPath.replace_filename(path.stem().native() + filesystem::path(string(suffix) + "-" + to_string(i)).native() + path.extension().native());
+  }
+  filesystem::rename(path, rotatedPath, ec);
+
+  target.stream.open(path.native().c_str(), ios::binary | ios::app);
+  target.size = 0;
+  target.openedTime = time;
+}
@@ -0,0 +1,100 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#ifndef AURA_LOG_WRITER_H_
+#define AURA_LOG_WRITER_H_
+
+#include "includes.h"
+
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+//
+// CLogWriter
+//
+// Appends log lines to files from a background thread, so that the main loop never waits on disk.
+// Producers only move their line into a queue. The writer thread drains it in batches,
+// keeps files open between batches, and flushes once per batch.
+//
+// Files may be rotated once they exceed a size, or once they have been open for some time.
+// Rotated files are renamed with the time of rotation appended to their stem.
+//
+// In binary format, each record is written as <int64 unix time> <uint32 length> <bytes>, in native byte order.
+//
+
+struct LogRecord
+{
+  std::filesystem::path   path;
+  int64_t                 time;
+  std::string             text;
+};
+
+struct LogFileTarget
+{
+  std::ofstream           stream;
+  uint64_t                size;
+  int64_t                 openedTime;
+  std::string             pending;
+  bool                    batched;  // already listed for the flush of the current batch
+  bool                    failed;   // cannot be written to, dropped once the current batch is flushed
+};
+
+class CLogWriter
+{
+public:
+  std::mutex                                      m_Mutex;
+  std::condition_variable                         m_Ready;
+  std::vector<LogRecord>                          m_Queue;
+  std::thread                                     m_Thread;
+  bool                                            m_Started;
+  bool                                            m_Stopping;
+
+  // options, guarded by m_Mutex
+  uint8_t                                         m_Format;
+  uint64_t                                        m_RotateSize;
+  int64_t                                         m_RotateInterval;
+
+  // writer thread only
+  std::map<std::filesystem::path, LogFileTarget>  m_Targets;
+
+  CLogWriter();
+  ~CLogWriter();
+  CLogWriter(CLogWriter&) = delete;
+
+  void                      SetOptions(const uint8_t format, const uint64_t rotateSize, const int64_t rotateInterval);
+  void                      Push(const std::filesystem::path& path, std::string text);
+  void                      Stop();
+
+private:
+  void                      Run();
+  void                      WriteBatch(std::vector<LogRecord>& batch, const uint8_t format, const uint64_t rotateSize, const int64_t rotateInterval);
+  [[nodiscard]] LogFileTarget* GetTarget(const std::filesystem::path& path, const int64_t time);
+  void                      RotateTarget(const std::filesystem::path& path, LogFileTarget& target, const int64_t time);
+};
+
+#endif // AURA_LOG_WRITER_H_
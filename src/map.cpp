@@ -47,6 +47,7 @@
 #include "aura.h"
 #include "util.h"
 #include "file_util.h"
+#include "file_hash.h"
 #include "game_setup.h"
 #include "game_slot.h"
 #include "pjass.h"
@@ -64,12 +65,41 @@
 
 using namespace std;
 
+//
+// MapLoaderConfig
+//
+
+MapLoaderConfig::MapLoaderConfig(const CAura* nAura)
+  : mapPath(nAura->m_Config.m_MapPath),
+    jassPath(nAura->m_Config.m_JASSPath),
+    targetCommunity(nAura->m_Config.m_TargetCommunity),
+    allowJASS(nAura->m_Config.m_AllowJASS),
+    validateJASS(nAura->m_Config.m_ValidateJASS),
+    validateJASSFlags(nAura->m_Config.m_ValidateJASSFlags),
+    allowLua(nAura->m_Config.m_AllowLua),
+    allowTransfers(nAura->m_Net.m_Config.m_AllowTransfers),
+    cfgCacheRevalidateAlgorithm(nAura->m_Config.m_CFGCacheRevalidateAlgorithm),
+    gameIsExpansion(nAura->m_GameDefaultConfig->m_GameIsExpansion),
+    gameVersion(nAura->m_GameDefaultConfig->m_GameVersion),
+    supportedGameVersions(nAura->m_Config.m_SupportedGameVersions),
+    supportedVersionHeads(nAura->GetSupportedVersionsCrossPlayRangeHeads()),
+    supportsModernSlots(nAura->m_SupportsModernSlots),
+    logLevel(nAura->m_LogLevel)
+{
+}
+
+bool MapLoaderConfig::GetIsSupportedGameVersion(const Version& version) const
+{
+  return find(supportedGameVersions.begin(), supportedGameVersions.end(), version) != supportedGameVersions.end();
+}
+
 //
 // CMap
 //
 
-CMap::CMap(CAura* nAura, CConfig* CFG)
+CMap::CMap(CAura* nAura, CConfig* CFG, MapLoaderConfig nLoaderConfig)
   : m_Aura(nAura),
+    m_LoaderConfig(move(nLoaderConfig)),
     m_MapSize(0),
     m_MapServerPath(CFG->GetPath("map.local_path", filesystem::path())),
     m_MapFileIsValid(false),
@@ -117,13 +147,13 @@ CMap::CMap(CAura* nAura, CConfig* CFG)
       m_GameLocaleMod = CFG->GetEnumSensitive<W3ModLocale>("map.locale.mod", TO_ARRAY("enUS", "deDE", "esES", "esMX", "frFR", "itIT", "koKR", "plPL", "ptBR", "ruRU", "zhCN", "zhTW"), W3ModLocale::kENUS);
       deductedLangId = CMap::GetLocaleInt(m_GameLocaleMod.value());
     } else {
-      PRINT_IF(LogLevel::kDebug, "[MAP] " + CFG->GetKeyValue("map.locale.mod") + " not supported - game version >= v1.30 is required");
+      CFG_PRINT_IF(m_LoaderConfig, LogLevel::kDebug, "[MAP] " + CFG->GetKeyValue("map.locale.mod") + " not supported - game version >= v1.30 is required");
     }
   }
 
   m_GameLocaleLangID = CFG->GetUint16("map.locale.lang_id", deductedLangId.value_or(m_GameLocaleLangID));
   if (m_GameLocaleLangID != 0 && deductedLangId.has_value() && m_GameLocaleLangID != deductedLangId.value()) {
-    PRINT_IF(LogLevel::kWarning, "[MAP] warning - " + CFG->GetKeyValue("map.locale.lang_id") + " does not match " + CFG->GetKeyValue("map.locale.mod")); 
+    CFG_PRINT_IF(m_LoaderConfig, LogLevel::kWarning, "[MAP] warning - " + CFG->GetKeyValue("map.locale.lang_id") + " does not match " + CFG->GetKeyValue("map.locale.mod")); 
   }
 
   Load(CFG);
@@ -383,7 +413,7 @@ string CMap::GetClientFileName() const
 {
   filesystem::path resolvedFilePath(m_MapServerPath);
   if (resolvedFilePath.filename() == resolvedFilePath && !m_UseStandardPaths) {
-    resolvedFilePath = m_Aura->m_Config.m_MapPath / resolvedFilePath;
+    resolvedFilePath = m_LoaderConfig.mapPath / resolvedFilePath;
   }    
   return resolvedFilePath;
 }
@@ -724,14 +754,14 @@ void CMap::OnLoadMPQSubFile(optional<MapEssentials>& /*mapEssentials*/, map<Vers
       string* commonJ = &mapCommonJ;
       string* blizzardJ = &mapBlizzardJ;
       if (mapCommonJ.empty()) {
-        filesystem::path commonPath = m_Aura->m_Config.m_JASSPath / filesystem::path("common-" + ToVersionString(version) +".j");
+        filesystem::path commonPath = m_LoaderConfig.jassPath / filesystem::path("common-" + ToVersionString(version) +".j");
         if (FileRead(commonPath, baseCommonJ, MAX_READ_FILE_SIZE) && !baseCommonJ.empty()) {
           commonJ = &baseCommonJ;
         }
       }
 
       if (mapBlizzardJ.empty()) {
-        filesystem::path blizzardPath = m_Aura->m_Config.m_JASSPath / filesystem::path("blizzard-" + ToVersionString(version) +".j");
+        filesystem::path blizzardPath = m_LoaderConfig.jassPath / filesystem::path("blizzard-" + ToVersionString(version) +".j");
         if (FileRead(blizzardPath, baseBlizzardJ, MAX_READ_FILE_SIZE) && !baseBlizzardJ.empty()) {
           blizzardJ = &baseBlizzardJ;
         }
@@ -739,11 +769,11 @@ void CMap::OnLoadMPQSubFile(optional<MapEssentials>& /*mapEssentials*/, map<Vers
 
       UpdateCryptoScripts(cryptos, version, *commonJ, *blizzardJ, fileContents);
 
-      if (!m_Aura->m_Config.m_ValidateJASS) {
+      if (!m_LoaderConfig.validateJASS) {
         m_JASSValid = true;
 #ifndef DISABLE_PJASS
       } else if (!m_JASSValid) {
-        pair<bool, string> result = ParseJASS(*commonJ, *blizzardJ, fileContents, m_Aura->m_Config.m_ValidateJASSFlags, version);
+        pair<bool, string> result = ParseJASS(*commonJ, *blizzardJ, fileContents, m_LoaderConfig.validateJASSFlags, version);
         if (!result.first) {
           m_JASSErrorMessage = ExtractFirstJASSError(result.second);
         } else {
@@ -775,7 +805,7 @@ void CMap::ReadFileFromArchive(vector<uint8_t>& container, const string& fileSub
     string localizedPath = CMap::GetLocalizedInMPQPath(m_GameLocaleMod.value(), fileSubPath);
     ReadFileFromArchiveExact(container, localizedPath);
     if (!container.empty()) {
-      PRINT_IF(LogLevel::kInfo, "[MAP] found [" + localizedPath + "]")
+      CFG_PRINT_IF(m_LoaderConfig, LogLevel::kInfo, "[MAP] found [" + localizedPath + "]")
       return;
     }
   }
@@ -788,7 +818,7 @@ void CMap::ReadFileFromArchive(string& container, const string& fileSubPath) con
     string localizedPath = CMap::GetLocalizedInMPQPath(m_GameLocaleMod.value(), fileSubPath);
     ReadFileFromArchiveExact(container, localizedPath);
     if (!container.empty()) {
-      PRINT_IF(LogLevel::kInfo, "[MAP] found [" + localizedPath + "]")
+      CFG_PRINT_IF(m_LoaderConfig, LogLevel::kInfo, "[MAP] found [" + localizedPath + "]")
       return;
     }
   }
@@ -848,7 +878,7 @@ optional<MapEssentials> CMap::ParseMPQ()
   // calculate <map.scripts_hash.blizz.vN>, and <map.scripts_hash.sha1.vN>
   // a big thank you to Strilanc for figuring the <map.scripts_hash.blizz.vN> algorithm out
 
-  vector<Version> supportedVersionHeads = m_Aura->GetSupportedVersionsCrossPlayRangeHeads();
+  const vector<Version>& supportedVersionHeads = m_LoaderConfig.supportedVersionHeads;
   map<Version, MapCrypto> cryptos;
   for (const auto& version : supportedVersionHeads) {
     //cryptos[version].emplace(version, MapCrypto());
@@ -1032,7 +1062,7 @@ optional<MapEssentials> CMap::ParseMPQ()
           mapEssentials->options = RawMapFlags & (MAPOPT_MELEE | MAPOPT_FIXEDPLAYERSETTINGS | MAPOPT_CUSTOMFORCES);
           if (mapEssentials->options & MAPOPT_FIXEDPLAYERSETTINGS) mapEssentials->options |= MAPOPT_CUSTOMFORCES;
 
-          DPRINT_IF(LogLevel::kTrace, "[MAP] calculated <map.options = " + to_string(mapEssentials->options) + ">")
+          CFG_DPRINT_IF(m_LoaderConfig, LogLevel::kTrace, "[MAP] calculated <map.options = " + to_string(mapEssentials->options) + ">")
 
           if (!(mapEssentials->options & MAPOPT_CUSTOMFORCES)) {
             mapEssentials->numTeams = static_cast<uint8_t>(RawMapNumPlayers);
@@ -1049,7 +1079,7 @@ optional<MapEssentials> CMap::ParseMPQ()
             if (!(mapEssentials->options & MAPOPT_CUSTOMFORCES)) {
               PlayerMask = 1 << i;
             }
-            DPRINT_IF(LogLevel::kTrace, "[MAP] calculated team " + to_string(i) + " mask = " + ToHexString(PlayerMask))
+            CFG_DPRINT_IF(m_LoaderConfig, LogLevel::kTrace, "[MAP] calculated team " + to_string(i) + " mask = " + ToHexString(PlayerMask))
 
             for (auto& Slot : mapEssentials->slots) {
               if (0 != (PlayerMask & (1 << static_cast<uint32_t>((Slot).GetColor())))) {
@@ -1077,7 +1107,7 @@ optional<MapEssentials> CMap::ParseMPQ()
 
 #ifdef DEBUG
           uint32_t SlotNum = 1;
-          if (m_Aura->GetIsLoggingTrace()) {
+          if (m_LoaderConfig.GetIsLoggingTrace()) {
             Print("[MAP] calculated <map.width = " + ByteArrayToDecString(mapEssentials->width.value()) + ">");
             Print("[MAP] calculated <map.height = " + ByteArrayToDecString(mapEssentials->height.value()) + ">");
             Print("[MAP] calculated <map.num_players = " + ToDecString(mapEssentials->numPlayers) + ">");
@@ -1086,7 +1116,7 @@ optional<MapEssentials> CMap::ParseMPQ()
           }
 
           for (const auto& slot : mapEssentials->slots) {
-            DPRINT_IF(LogLevel::kTrace, "[MAP] calculated <map.slot_" + to_string(SlotNum) + " = " + ByteArrayToDecString(slot.GetProtocolArray()) + ">")
+            CFG_DPRINT_IF(m_LoaderConfig, LogLevel::kTrace, "[MAP] calculated <map.slot_" + to_string(SlotNum) + " = " + ByteArrayToDecString(slot.GetProtocolArray()) + ">")
             ++SlotNum;
           }
 #endif
@@ -1099,7 +1129,7 @@ optional<MapEssentials> CMap::ParseMPQ()
       }
 
       if (FileFormat > 25) {
-        mapEssentials->minCompatibleGameVersion = m_Aura->m_Config.m_TargetCommunity ? GAMEVER(1u, 29u) : GAMEVER(1u, 31u);
+        mapEssentials->minCompatibleGameVersion = m_LoaderConfig.targetCommunity ? GAMEVER(1u, 29u) : GAMEVER(1u, 31u);
       } else if (FileFormat > 18) {
         mapEssentials->minCompatibleGameVersion = GAMEVER(1u, 7u);
       }
@@ -1134,18 +1164,18 @@ optional<MapEssentials> CMap::ParseMPQ()
       mapEssentials->previewImgSize = previewImgSize.value();
     }
   } else { // end m_MapLoaderIsPartial
-    DPRINT_IF(LogLevel::kTrace, "[MAP] using mapcfg for <map.options>, <map.width>, <map.height>, <map.slot_N>, <map.num_players>, <map.num_teams>")
+    CFG_DPRINT_IF(m_LoaderConfig, LogLevel::kTrace, "[MAP] using mapcfg for <map.options>, <map.width>, <map.height>, <map.slot_N>, <map.num_players>, <map.num_teams>")
   }
 
   if (m_MapIsLua) {
-    switch (m_Aura->m_Config.m_AllowLua) {
+    switch (m_LoaderConfig.allowLua) {
       case MAP_ALLOW_LUA_NEVER: {
         m_Valid = false;
         m_ErrorMessage = "map script uses Lua, which is not allowed";
         break;
       }
       case MAP_ALLOW_LUA_AUTO: {
-        Version minVersion = m_Aura->m_Config.m_TargetCommunity ? GAMEVER(1u, 29u) : GAMEVER(1u, 31u);
+        Version minVersion = m_LoaderConfig.targetCommunity ? GAMEVER(1u, 29u) : GAMEVER(1u, 31u);
         if (m_MapTargetGameVersion.has_value() && m_MapTargetGameVersion.value() < minVersion) {
           m_Valid = false;
           m_ErrorMessage = "map script uses Lua, which is not allowed";
@@ -1153,7 +1183,7 @@ optional<MapEssentials> CMap::ParseMPQ()
         }
       }
     }
-  } else if (!m_Aura->m_Config.m_AllowJASS) {
+  } else if (!m_LoaderConfig.allowJASS) {
     m_Valid = false;
     m_ErrorMessage = "only Lua maps are allowed";
   }
@@ -1206,18 +1236,18 @@ optional<MapEssentials> CMap::ParseMPQ()
       // make sure to instantiate MapFragmentHashes anyway, so that mapEssentials is in a valid state
       // (note: contents are wrapped in std::optional)
       if (mapCryptoProcessor->second.errored) {
-        PRINT_IF(LogLevel::kWarning, "[MAP] unable to calculate <map.scripts_hash.blizz.v" + ToVersionString(version) + ">, and <map.scripts_hash.sha1.v" + ToVersionString(version) + ">")
+        CFG_PRINT_IF(m_LoaderConfig, LogLevel::kWarning, "[MAP] unable to calculate <map.scripts_hash.blizz.v" + ToVersionString(version) + ">, and <map.scripts_hash.sha1.v" + ToVersionString(version) + ">")
         continue;
       }
       auto mapCryptoResults = mapEssentials->fragmentHashes.find(version);
       EnsureFixedByteArray(mapCryptoResults->second.blizz, mapCryptoProcessor->second.blizz, false);
-      DPRINT_IF(LogLevel::kTrace, "[MAP] calculated <map.scripts_hash.blizz.v" + ToVersionString(version) + " = " + ByteArrayToDecString(mapCryptoResults->second.blizz.value()) + ">")
+      CFG_DPRINT_IF(m_LoaderConfig, LogLevel::kTrace, "[MAP] calculated <map.scripts_hash.blizz.v" + ToVersionString(version) + " = " + ByteArrayToDecString(mapCryptoResults->second.blizz.value()) + ">")
 
       mapCryptoProcessor->second.sha1.Final();
       mapCryptoResults->second.sha1.emplace();
       mapCryptoResults->second.sha1->fill(0);
       mapCryptoProcessor->second.sha1.GetHash(mapCryptoResults->second.sha1->data());
-      DPRINT_IF(LogLevel::kTrace, "[MAP] calculated <map.scripts_hash.sha1.v" + ToVersionString(version) + " = " + ByteArrayToDecString(mapCryptoResults->second.sha1.value()) + ">")
+      CFG_DPRINT_IF(m_LoaderConfig, LogLevel::kTrace, "[MAP] calculated <map.scripts_hash.sha1.v" + ToVersionString(version) + " = " + ByteArrayToDecString(mapCryptoResults->second.sha1.value()) + ">")
     }
 
     if (!m_JASSValid && m_ErrorMessage.empty()) {
@@ -1274,7 +1304,18 @@ void CMap::Load(CConfig* CFG)
   optional<uint32_t> mapFileSize;
   optional<uint32_t> mapFileCRC32;
   optional<array<uint8_t, 20>> mapFileSHA1;
-  if (m_MapLoaderIsPartial || m_Aura->m_Net.m_Config.m_AllowTransfers != MAP_TRANSFERS_NEVER || !isLatestSchema) {
+  if (CFG->GetBool("map.cfg.hashed", false)) {
+    // file was hashed by CGameSetup while it was being downloaded - no need to read it again
+    CFG->Delete("map.cfg.hashed");
+    mapFileSize = CFG->GetMaybeUint32("map.size");
+    vector<uint8_t> cfgCRC32 = CFG->GetUint8Vector("map.file_hash.crc32", 4);
+    vector<uint8_t> cfgSHA1 = CFG->GetUint8Vector("map.file_hash.sha1", 20);
+    if (!cfgCRC32.empty()) mapFileCRC32 = ByteArrayToUInt32(cfgCRC32, 0, true);
+    if (!cfgSHA1.empty()) {
+      mapFileSHA1.emplace();
+      copy_n(cfgSHA1.begin(), 20, mapFileSHA1->begin());
+    }
+  } else if (m_MapLoaderIsPartial || m_LoaderConfig.allowTransfers != MAP_TRANSFERS_NEVER || !isLatestSchema) {
     if (!TryLoadMapFileChunked(mapFileSize, mapFileCRC32, mapFileSHA1)) {
       // Map file does not exist or failed to read
       if (m_MapLoaderIsPartial) {
@@ -1290,7 +1331,7 @@ void CMap::Load(CConfig* CFG)
   if (!ignoreMPQ) {
     ignoreMPQ = (
       (!m_MapLoaderIsPartial && isLatestSchema) &&
-      m_Aura->m_Config.m_CFGCacheRevalidateAlgorithm == CacheRevalidationMethod::kNever
+      m_LoaderConfig.cfgCacheRevalidateAlgorithm == CacheRevalidationMethod::kNever
     );
   }
 
@@ -1304,7 +1345,7 @@ void CMap::Load(CConfig* CFG)
       fileModifiedTime = GetMaybeModifiedTime(resolvedFilePath);
       ignoreMPQ = (
         (!m_MapLoaderIsPartial && isLatestSchema) && (
-          m_Aura->m_Config.m_CFGCacheRevalidateAlgorithm == CacheRevalidationMethod::kModified && (
+          m_LoaderConfig.cfgCacheRevalidateAlgorithm == CacheRevalidationMethod::kModified && (
             !fileModifiedTime.has_value() || (
               cachedModifiedTime.has_value() && fileModifiedTime.has_value() &&
               fileModifiedTime.value() <= cachedModifiedTime.value()
@@ -1345,7 +1386,7 @@ void CMap::Load(CConfig* CFG)
       Print("[MAP] failed to parse map, using config file for <map.scripts_hash.blizz.vN>, <map.scripts_hash.sha1.vN>");
     }
   } else {
-    DPRINT_IF(LogLevel::kTrace2, "[MAP] MPQ archive ignored");
+    CFG_DPRINT_IF(m_LoaderConfig, LogLevel::kTrace2, "[MAP] MPQ archive ignored");
   }
 
   if (mapEssentials.has_value()) {
@@ -1386,7 +1427,7 @@ void CMap::Load(CConfig* CFG)
 
     m_Slots = mapEssentials->slots;
   } else {
-    DPRINT_IF(LogLevel::kTrace2, "[MAP] MPQ archive ignored/missing/errored");
+    CFG_DPRINT_IF(m_LoaderConfig, LogLevel::kTrace2, "[MAP] MPQ archive ignored/missing/errored");
   }
 
   array<uint8_t, 5> mapContentMismatch = {0, 0, 0, 0, 0};
@@ -1462,7 +1503,7 @@ void CMap::Load(CConfig* CFG)
   if (m_MapTargetGameVersion.has_value()) {
     targetGameVersionRangeHead = GetScriptsVersionRangeHead(m_MapTargetGameVersion.value());
   }
-  for (const auto& version : m_Aura->GetSupportedVersionsCrossPlayRangeHeads()) {
+  for (const auto& version : m_LoaderConfig.supportedVersionHeads) {
     array<uint8_t, 4> scriptsHashBlizz;
     scriptsHashBlizz.fill(0);
     vector<uint8_t> cfgScriptsWeakHash = CFG->GetUint8Vector("map.scripts_hash.blizz.v" + ToVersionString(version), 4);
@@ -1522,7 +1563,7 @@ void CMap::Load(CConfig* CFG)
 
   if (HasMismatch()) {
     m_MapContentMismatch.swap(mapContentMismatch);
-    PRINT_IF(LogLevel::kWarning, "[CACHE] error - map content mismatch");
+    CFG_PRINT_IF(m_LoaderConfig, LogLevel::kWarning, "[CACHE] error - map content mismatch");
   } else if (crc32.has_value() && sha1.has_value()) {
     m_MapFileIsValid = true;
   }
@@ -1847,7 +1888,7 @@ bool CMap::AcquireGameIsExpansion(CConfig* CFG)
     // Guaranteed to have a value,
     // because we don't error anywhere just because the bot owner forgot to specify TFT,
     // and just default to TFT.
-    m_MapTargetGameIsExpansion = m_Aura->m_GameDefaultConfig->m_GameIsExpansion;
+    m_MapTargetGameIsExpansion = m_LoaderConfig.gameIsExpansion;
   }
 
   return true;
@@ -1869,8 +1910,8 @@ bool CMap::AcquireGameVersion(CConfig* CFG)
     }
   }
 
-  if (!m_MapTargetGameVersion.has_value() && m_Aura->m_GameDefaultConfig->m_GameVersion.has_value()) { // from config.ini
-    m_MapTargetGameVersion = m_Aura->m_GameDefaultConfig->m_GameVersion.value();
+  if (!m_MapTargetGameVersion.has_value() && m_LoaderConfig.gameVersion.has_value()) { // from config.ini
+    m_MapTargetGameVersion = m_LoaderConfig.gameVersion.value();
   }
 
   return m_MapTargetGameVersion.has_value();
@@ -1885,7 +1926,7 @@ bool CMap::TryLoadMapFilePersistent(optional<uint32_t>& fileSize, optional<uint3
   }
   filesystem::path resolvedPath(m_MapServerPath);
   if (m_MapServerPath.filename() == m_MapServerPath && !m_UseStandardPaths) {
-    resolvedPath = m_Aura->m_Config.m_MapPath / m_MapServerPath;
+    resolvedPath = m_LoaderConfig.mapPath / m_MapServerPath;
   }
   m_MapFileContents = m_Aura->ReadFile(resolvedPath, MAX_READ_FILE_SIZE);
   if (!HasMapFileContents()) {
@@ -1911,45 +1952,40 @@ bool CMap::TryLoadMapFilePersistent(optional<uint32_t>& fileSize, optional<uint3
 bool CMap::TryLoadMapFileChunked(optional<uint32_t>& fileSize, optional<uint32_t>& crc32, optional<array<uint8_t, 20>>& sha1)
 {
   if (m_MapServerPath.empty()) {
-    DPRINT_IF(LogLevel::kTrace2, "m_MapServerPath missing - map data not loaded")
+    CFG_DPRINT_IF(m_LoaderConfig, LogLevel::kTrace2, "m_MapServerPath missing - map data not loaded")
     return false;
   }
   filesystem::path resolvedPath(m_MapServerPath);
   if (m_MapServerPath.filename() == m_MapServerPath && !m_UseStandardPaths) {
-    resolvedPath = m_Aura->m_Config.m_MapPath / m_MapServerPath;
+    resolvedPath = m_LoaderConfig.mapPath / m_MapServerPath;
   }
 
-  m_Aura->m_SHA.Reset();
-  uint32_t rollingCRC32 = 0;
-  pair<bool, uint32_t> result = ProcessMapChunked(resolvedPath, [this, &rollingCRC32](FileChunkTransient cachedChunk, size_t cursor, size_t size) {
-    rollingCRC32 = CRC32::CalculateCRC(cachedChunk.GetDataAtCursor(cursor), size, rollingCRC32);
-    m_Aura->m_SHA.Update(cachedChunk.GetDataAtCursor(cursor), size);
-  });
-  m_Aura->m_SHA.Final();
+  optional<FileHashDigest> digest;
+  if (HasMapFileContents()) {
+    digest = HashBufferParallel(GetMapFileContents()->data(), GetMapFileContents()->size());
+  } else {
+    digest = HashFileParallel(resolvedPath, MAP_FILE_PROCESSING_CHUNK_SIZE, 0xFFFFFFFF);
+  }
 
-  if (!result.first || result.second == 0) {
-    PRINT_IF(LogLevel::kInfo, "[MAP] Failed to read [" + PathToString(resolvedPath) + "]")
-    m_Aura->m_SHA.Reset();
+  if (!digest.has_value() || digest->size == 0) {
+    CFG_PRINT_IF(m_LoaderConfig, LogLevel::kInfo, "[MAP] Failed to read [" + PathToString(resolvedPath) + "]")
     return false;
   }
 
-  fileSize = result.second;
+  fileSize = static_cast<uint32_t>(digest->size);
 #ifdef DEBUG
   array<uint8_t, 4> mapFileSizeBytes = CreateFixedByteArray(fileSize.value(), false);
-  DPRINT_IF(LogLevel::kTrace, "[MAP] calculated <map.size = " + ByteArrayToDecString(mapFileSizeBytes) + ">")
+  CFG_DPRINT_IF(m_LoaderConfig, LogLevel::kTrace, "[MAP] calculated <map.size = " + ByteArrayToDecString(mapFileSizeBytes) + ">")
 #endif
 
-  crc32 = rollingCRC32;
+  crc32 = digest->crc32;
   optional<array<uint8_t, 4>> crc32Bytes;
-  EnsureFixedByteArray(crc32Bytes, rollingCRC32, true); // Big endian, matching SHA1
-  DPRINT_IF(LogLevel::kTrace, "[MAP] calculated <map.file_hash.crc32 = " + ByteArrayToDecString(crc32Bytes.value()) + ">")
+  EnsureFixedByteArray(crc32Bytes, digest->crc32, true); // Big endian, matching SHA1
+  CFG_DPRINT_IF(m_LoaderConfig, LogLevel::kTrace, "[MAP] calculated <map.file_hash.crc32 = " + ByteArrayToDecString(crc32Bytes.value()) + ">")
 
-  sha1.emplace();
-  sha1->fill(0);
-  m_Aura->m_SHA.GetHash(sha1->data());
-  DPRINT_IF(LogLevel::kTrace, "[MAP] calculated <map.file_hash.sha1 = " + ByteArrayToDecString(sha1.value()) + ">")
+  sha1 = digest->sha1;
+  CFG_DPRINT_IF(m_LoaderConfig, LogLevel::kTrace, "[MAP] calculated <map.file_hash.sha1 = " + ByteArrayToDecString(sha1.value()) + ">")
 
-  m_Aura->m_SHA.Reset();
   return true;
 }
 
@@ -1995,34 +2031,13 @@ FileChunkTransient CMap::GetMapFileChunk(size_t start)
   } else {
     filesystem::path resolvedPath(m_MapServerPath);
     if (m_MapServerPath.filename() == m_MapServerPath && !m_UseStandardPaths) {
-      resolvedPath = m_Aura->m_Config.m_MapPath / m_MapServerPath;
+      resolvedPath = m_LoaderConfig.mapPath / m_MapServerPath;
     }
     // Load up to 8 MB at a time
     return m_Aura->ReadFileChunkCacheable(resolvedPath, start, start + MAP_FILE_MAX_CHUNK_SIZE);
   }
 }
 
-pair<bool, uint32_t> CMap::ProcessMapChunked(const filesystem::path& filePath, function<void(FileChunkTransient, size_t, size_t)> processChunk)
-{
-  uintmax_t fileSize = FileSize(filePath);
-  size_t cursor = 0;
-  if (fileSize == 0 || fileSize > 0xFFFFFFFF) return make_pair(false, (uint32_t)cursor);
-  while (cursor < fileSize) {
-    FileChunkTransient cachedChunk = GetMapFileChunk(cursor);
-    if (!cachedChunk.bytes) {
-      return make_pair(false, (uint32_t)cursor);
-    }
-    size_t availableBytes = cachedChunk.GetSizeFromCursor(cursor);
-    size_t stepBytes = MAP_FILE_PROCESSING_CHUNK_SIZE;
-    if (stepBytes > availableBytes) {
-      stepBytes = availableBytes;
-    }
-    processChunk(cachedChunk, cursor, stepBytes);
-    cursor += stepBytes;
-  }
-  return make_pair(fileSize == cursor, (uint32_t)cursor);
-}
-
 bool CMap::UnlinkFile()
 {
   if (m_MapServerPath.empty()) return false;
@@ -2031,7 +2046,7 @@ bool CMap::UnlinkFile()
   if (mapLocalPath.is_absolute()) {
     result = FileDelete(mapLocalPath);
   } else {
-    filesystem::path resolvedPath =  m_Aura->m_Config.m_MapPath / mapLocalPath;
+    filesystem::path resolvedPath =  m_LoaderConfig.mapPath / mapLocalPath;
     result = FileDelete(resolvedPath.lexically_normal());
   }
   if (result) {
@@ -2058,7 +2073,7 @@ string CMap::CheckProblems()
     return m_ErrorMessage;
   }
 
-  if (m_MapTargetGameVersion.has_value() && !m_Aura->GetIsSupportedGameVersion(m_MapTargetGameVersion.value())) {
+  if (m_MapTargetGameVersion.has_value() && !m_LoaderConfig.GetIsSupportedGameVersion(m_MapTargetGameVersion.value())) {
     m_Valid = false;
     m_ErrorMessage = "hosting in v" + ToVersionString(m_MapTargetGameVersion.value()) + " is not supported";
     return m_ErrorMessage;
@@ -2112,7 +2127,7 @@ string CMap::CheckProblems()
     return m_ErrorMessage;
   }
 
-  if (!m_Aura->m_SupportsModernSlots) {
+  if (!m_LoaderConfig.supportsModernSlots) {
     if (
       m_MapNumControllers + m_MapNumDisabled > MAX_SLOTS_LEGACY ||
       m_MapNumTeams > MAX_SLOTS_LEGACY ||
@@ -2132,7 +2147,7 @@ string CMap::CheckProblems()
       m_ErrorMessage = "map uses an invalid amount of players";
       return m_ErrorMessage;
     }
-    if (!m_Aura->m_SupportsModernSlots && (slot.GetTeam() > MAX_SLOTS_LEGACY || slot.GetColor() > MAX_SLOTS_LEGACY)) {
+    if (!m_LoaderConfig.supportsModernSlots && (slot.GetTeam() > MAX_SLOTS_LEGACY || slot.GetColor() > MAX_SLOTS_LEGACY)) {
       m_Valid = false;
       m_ErrorMessage = "map uses too many players - v1.29+ required";
       return m_ErrorMessage;
@@ -231,6 +231,12 @@ struct MapTransfer
   uint32_t lastAck;
   uint32_t crc32;
 
+  // CMapUploadScheduler state
+  uint32_t uploadCredit;
+  uint32_t ackRate;
+  uint32_t ackRateSample;
+  int64_t ackRateSampleTicks;
+
   MapTransfer()
    : started(false),
      finished(false),
@@ -239,7 +245,11 @@ struct MapTransfer
      finishedTicks(0),
      lastSentOffsetEnd(0),
      lastAck(0),
-     crc32(0)
+     crc32(0),
+     uploadCredit(0),
+     ackRate(0),
+     ackRateSample(0),
+     ackRateSampleTicks(0)
   {
   }
   ~MapTransfer() = default;
@@ -266,6 +276,12 @@ struct MapTransfer
   inline uint32_t GetLastCRC32() const { return crc32; }
   inline void SetLastCRC32(const uint32_t nCRC32) { crc32 = nCRC32; }
 
+  inline uint32_t GetUploadCredit() const { return uploadCredit; }
+  inline void SetUploadCredit(const uint32_t nCredit) { uploadCredit = nCredit; }
+
+  inline uint32_t GetAckRate() const { return ackRate; }
+  inline uint32_t GetInFlight() const { return lastSentOffsetEnd > lastAck ? lastSentOffsetEnd - lastAck : 0; }
+
   inline void Start() {
     SetStarted();
     SetStartedTicks(GetTicks());
@@ -277,6 +293,43 @@ struct MapTransfer
   inline bool GetIsInProgress() const { return GetStarted() && !GetFinished(); }
 };
 
+//
+// MapLoaderConfig
+//
+// Bot settings used while loading a map.
+// Copied from CAura on the main thread, so that maps can be loaded in a worker thread.
+//
+
+struct MapLoaderConfig
+{
+  std::filesystem::path mapPath;
+  std::filesystem::path jassPath;
+  bool targetCommunity;
+  bool allowJASS;
+  bool validateJASS;
+  std::bitset<11> validateJASSFlags;
+  uint8_t allowLua;
+  uint8_t allowTransfers;
+  CacheRevalidationMethod cfgCacheRevalidateAlgorithm;
+  bool gameIsExpansion;
+  std::optional<Version> gameVersion;
+  std::vector<Version> supportedGameVersions;
+  std::vector<Version> supportedVersionHeads;
+  bool supportsModernSlots;
+  LogLevel logLevel;
+
+  explicit MapLoaderConfig(const CAura* nAura);
+  ~MapLoaderConfig() = default;
+
+  [[nodiscard]] bool GetIsSupportedGameVersion(const Version& version) const;
+  inline bool MatchLogLevel(LogLevel nLogLevel) const { return nLogLevel <= logLevel; }
+#ifdef DEBUG
+  inline bool GetIsLoggingTrace() const { return MatchLogLevel(LogLevel::kTrace); }
+#else
+  inline bool GetIsLoggingTrace() const { return false; }
+#endif
+};
+
 //
 // CMap
 //
@@ -284,7 +337,8 @@ struct MapTransfer
 class CMap
 {
 public:
-  CAura* m_Aura;
+  CAura* m_Aura; // nullptr while the map is being loaded
+  MapLoaderConfig m_LoaderConfig;
 
   std::optional<bool>                             m_MapTargetGameIsExpansion;
   std::optional<Version>                          m_MapTargetGameVersion;
@@ -421,7 +475,7 @@ private:
   std::string                     m_JASSErrorMessage;
 
 public:
-  CMap(CAura* nAura, CConfig* CFG);
+  CMap(CAura* nAura, CConfig* CFG, MapLoaderConfig nLoaderConfig);
   ~CMap();
 
   [[nodiscard]] inline bool                              GetValid() const { return m_Valid; }
@@ -544,7 +598,6 @@ public:
   [[nodiscard]] bool                              CheckMapFileIntegrity();
   void                                            InvalidateMapFile() { m_MapFileIsValid = false; }
   [[nodiscard]] FileChunkTransient                GetMapFileChunk(size_t start);
-  [[nodiscard]] std::pair<bool, uint32_t>         ProcessMapChunked(const std::filesystem::path& filePath, std::function<void(FileChunkTransient, size_t, size_t)> processChunk);
   bool                                            UnlinkFile();
   [[nodiscard]] std::string                       CheckProblems();
 
@@ -0,0 +1,248 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#include "map_catalog.h"
+#include "file_util.h"
+#include "util.h"
+
+#include <fstream>
+
+using namespace std;
+
+namespace
+{
+  void AppendCatalogString(vector<uint8_t>& bytes, const string& value)
+  {
+    AppendByteArray(bytes, static_cast<uint32_t>(value.size()), false);
+    AppendByteArrayString(bytes, value, false);
+  }
+
+  void AppendCatalogUint64(vector<uint8_t>& bytes, const uint64_t value)
+  {
+    AppendByteArray(bytes, static_cast<uint32_t>(value & 0xFFFFFFFF), false);
+    AppendByteArray(bytes, static_cast<uint32_t>(value >> 32), false);
+  }
+
+  bool ReadCatalogUint32(const vector<uint8_t>& bytes, size_t& cursor, uint32_t& value)
+  {
+    if (bytes.size() - cursor < 4) return false;
+    value = ByteArrayToUInt32(bytes, false, cursor);
+    cursor += 4;
+    return true;
+  }
+
+  bool ReadCatalogUint64(const vector<uint8_t>& bytes, size_t& cursor, uint64_t& value)
+  {
+    uint32_t low = 0, high = 0;
+    if (!ReadCatalogUint32(bytes, cursor, low) || !ReadCatalogUint32(bytes, cursor, high)) return false;
+    value = static_cast<uint64_t>(high) << 32 | low;
+    return true;
+  }
+
+  bool ReadCatalogString(const vector<uint8_t>& bytes, size_t& cursor, string& value)
+  {
+    uint32_t size = 0;
+    if (!ReadCatalogUint32(bytes, cursor, size) || bytes.size() - cursor < size) return false;
+    value.assign(reinterpret_cast<const char*>(bytes.data() + cursor), size);
+    cursor += size;
+    return true;
+  }
+
+  bool GetCatalogFileStats(const filesystem::path& filePath, uint64_t& size, int64_t& modified)
+  {
+    optional<int64_t> maybeModified = GetMaybeModifiedTime(filePath);
+    if (!maybeModified.has_value()) return false;
+    size = static_cast<uint64_t>(FileSize(filePath));
+    modified = maybeModified.value();
+    return true;
+  }
+}
+
+//
+// MapCatalogEntry
+//
+
+MapCatalogEntry::MapCatalogEntry()
+ : cfgSize(0),
+   cfgModified(0)
+{
+}
+
+MapCatalogEntry::~MapCatalogEntry() = default;
+
+//
+// CMapCatalog
+//
+
+CMapCatalog::CMapCatalog()
+ : m_IsModified(false)
+{
+}
+
+CMapCatalog::~CMapCatalog() = default;
+
+bool CMapCatalog::Load(const filesystem::path& filePath)
+{
+  m_FilePath = filePath;
+  m_Entries.clear();
+  m_IsModified = false;
+
+  vector<uint8_t> bytes;
+  if (!FileRead(filePath, bytes, MAP_CATALOG_MAX_SIZE) || bytes.size() < 12) {
+    return false;
+  }
+  if (memcmp(bytes.data(), "AMCT", 4) != 0) {
+    return false;
+  }
+  size_t cursor = 4;
+  uint32_t version = 0, count = 0;
+  if (!ReadCatalogUint32(bytes, cursor, version) || version != MAP_CATALOG_VERSION) {
+    return false;
+  }
+  if (!ReadCatalogUint32(bytes, cursor, count)) {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < count; ++i) {
+    string cfgName;
+    MapCatalogEntry entry;
+    uint64_t cfgModified = 0;
+    uint32_t configSize = 0;
+    if (
+      !ReadCatalogString(bytes, cursor, cfgName) ||
+      !ReadCatalogUint64(bytes, cursor, entry.cfgSize) ||
+      !ReadCatalogUint64(bytes, cursor, cfgModified) ||
+      !ReadCatalogUint32(bytes, cursor, configSize)
+    ) {
+      m_Entries.clear();
+      return false;
+    }
+    entry.cfgModified = static_cast<int64_t>(cfgModified);
+    for (uint32_t j = 0; j < configSize; ++j) {
+      string key, value;
+      if (!ReadCatalogString(bytes, cursor, key) || !ReadCatalogString(bytes, cursor, value)) {
+        m_Entries.clear();
+        return false;
+      }
+      entry.config.emplace_hint(entry.config.end(), move(key), move(value));
+    }
+    m_Entries[filesystem::path(cfgName)] = move(entry);
+  }
+
+  return true;
+}
+
+bool CMapCatalog::Save()
+{
+  if (m_FilePath.empty()) {
+    return false;
+  }
+
+  vector<uint8_t> bytes;
+  AppendByteArrayString(bytes, "AMCT", false);
+  AppendByteArray(bytes, MAP_CATALOG_VERSION, false);
+  AppendByteArray(bytes, static_cast<uint32_t>(m_Entries.size()), false);
+  for (const auto& entry : m_Entries) {
+    AppendCatalogString(bytes, PathToString(entry.first));
+    AppendCatalogUint64(bytes, entry.second.cfgSize);
+    AppendCatalogUint64(bytes, static_cast<uint64_t>(entry.second.cfgModified));
+    AppendByteArray(bytes, static_cast<uint32_t>(entry.second.config.size()), false);
+    for (const auto& keyValue : entry.second.config) {
+      AppendCatalogString(bytes, keyValue.first);
+      AppendCatalogString(bytes, keyValue.second);
+    }
+  }
+
+  // write to a temporary file first, so that a crash mid-write leaves the previous catalog intact
+  filesystem::path tempPath = m_FilePath;
+  tempPath += ".tmp";
+  ofstream fileStream(tempPath, ios::out | ios::binary | ios::trunc);
+  if (!fileStream.is_open()) {
+    return false;
+  }
+  fileStream.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+  fileStream.close();
+  if (fileStream.fail()) {
+    FileDelete(tempPath);
+    return false;
+  }
+
+  error_code ec;
+  filesystem::rename(tempPath, m_FilePath, ec);
+  if (ec) {
+    FileDelete(tempPath);
+    return false;
+  }
+  m_IsModified = false;
+  return true;
+}
+
+const MapCatalogEntry* CMapCatalog::Get(const filesystem::path& cfgDirectory, const filesystem::path& cfgName) const
+{
+  auto it = m_Entries.find(cfgName);
+  if (it == m_Entries.end()) {
+    return nullptr;
+  }
+  uint64_t cfgSize = 0;
+  int64_t cfgModified = 0;
+  if (!GetCatalogFileStats(cfgDirectory / cfgName, cfgSize, cfgModified)) {
+    return nullptr;
+  }
+  if (cfgSize != it->second.cfgSize || cfgModified != it->second.cfgModified) {
+    return nullptr;
+  }
+  return &(it->second);
+}
+
+void CMapCatalog::Update(const filesystem::path& cfgDirectory, const filesystem::path& cfgName, const map<string, string>& config)
+{
+  MapCatalogEntry entry;
+  if (!GetCatalogFileStats(cfgDirectory / cfgName, entry.cfgSize, entry.cfgModified)) {
+    Remove(cfgName);
+    return;
+  }
+  entry.config = config;
+  m_Entries[cfgName] = move(entry);
+  m_IsModified = true;
+}
+
+void CMapCatalog::Remove(const filesystem::path& cfgName)
+{
+  if (m_Entries.erase(cfgName) > 0) {
+    m_IsModified = true;
+  }
+}
+
+void CMapCatalog::Retain(const set<filesystem::path>& cfgNames)
+{
+  for (auto it = m_Entries.begin(); it != m_Entries.end();) {
+    if (cfgNames.find(it->first) == cfgNames.end()) {
+      it = m_Entries.erase(it);
+      m_IsModified = true;
+    } else {
+      ++it;
+    }
+  }
+}
@@ -0,0 +1,78 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#ifndef AURA_MAP_CATALOG_H_
+#define AURA_MAP_CATALOG_H_
+
+#include "includes.h"
+
+#include <filesystem>
+
+//
+// CMapCatalog
+//
+// Binary index of the map config cache, stored as a single file next to the cached <.ini> files.
+// Each entry keeps the parsed contents of a cached config (including map size, hashes, and slot layout),
+// so that cached maps are resolved and loaded without running the ini parser.
+//
+// Entries are keyed by config file name, and are only trusted while the size and modification time
+// of the config file match. Stale entries are refreshed whenever their config file is parsed again.
+// Changes are kept in memory, and written out by CAura on a timer and at exit, replacing the file atomically.
+//
+
+struct MapCatalogEntry
+{
+  uint64_t                            cfgSize;
+  int64_t                             cfgModified;
+  std::map<std::string, std::string>  config;
+
+  MapCatalogEntry();
+  ~MapCatalogEntry();
+};
+
+class CMapCatalog
+{
+public:
+  std::filesystem::path                               m_FilePath;
+  std::map<std::filesystem::path, MapCatalogEntry>    m_Entries;
+  bool                                                m_IsModified;
+
+  CMapCatalog();
+  ~CMapCatalog();
+  CMapCatalog(CMapCatalog&) = delete;
+
+  [[nodiscard]] inline size_t     GetSize() const { return m_Entries.size(); }
+  [[nodiscard]] inline bool       GetIsModified() const { return m_IsModified; }
+
+  bool                            Load(const std::filesystem::path& filePath);
+  bool                            Save();
+
+  [[nodiscard]] const MapCatalogEntry* Get(const std::filesystem::path& cfgDirectory, const std::filesystem::path& cfgName) const;
+  void                            Update(const std::filesystem::path& cfgDirectory, const std::filesystem::path& cfgName, const std::map<std::string, std::string>& config);
+  void                            Remove(const std::filesystem::path& cfgName);
+  void                            Retain(const std::set<std::filesystem::path>& cfgNames);
+};
+
+#endif // AURA_MAP_CATALOG_H_
@@ -0,0 +1,355 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+#include "map_download.h"
+#include "config/config.h"
+#include "file_util.h"
+#include "util.h"
+
+using namespace std;
+
+namespace
+{
+  // strict decimal parsing - HTTP headers must not be trusted to be well-formed
+  optional<size_t> ParseDecimal(const string& input)
+  {
+    optional<size_t> result;
+    if (input.empty() || input.size() > 18) return result;
+    size_t value = 0;
+    for (const char c : input) {
+      if (c < '0' || '9' < c) return result;
+      value = value * 10 + static_cast<size_t>(c - '0');
+    }
+    result = value;
+    return result;
+  }
+};
+
+//
+// HTTPContentRange
+//
+
+HTTPContentRange::HTTPContentRange()
+ : m_Start(0),
+   m_End(0)
+{
+}
+
+optional<HTTPContentRange> ParseHTTPContentRange(const string& value)
+{
+  // bytes <start>-<end>/<total>, where <total> may be "*" if unknown
+  optional<HTTPContentRange> range;
+  string input = TrimStringExtended(value);
+  if (input.substr(0, 6) != "bytes ") return range;
+  size_t dash = input.find('-', 6);
+  size_t slash = input.find('/', 6);
+  if (dash == string::npos || slash == string::npos || slash < dash) return range;
+
+  optional<size_t> start = ParseDecimal(input.substr(6, dash - 6));
+  optional<size_t> end = ParseDecimal(input.substr(dash + 1, slash - dash - 1));
+  if (!start.has_value() || !end.has_value() || end.value() < start.value()) return range;
+
+  string totalString = input.substr(slash + 1);
+  optional<size_t> total;
+  if (totalString != "*") {
+    total = ParseDecimal(totalString);
+    if (!total.has_value() || total.value() <= end.value()) return range;
+  }
+
+  range.emplace();
+  range->m_Start = start.value();
+  range->m_End = end.value();
+  range->m_Total = total;
+  return range;
+}
+
+optional<uint16_t> ParseHTTPStatusLine(const string& line)
+{
+  // HTTP/1.1 206 Partial Content
+  optional<uint16_t> statusCode;
+  if (line.substr(0, 5) != "HTTP/") return statusCode;
+  size_t space = line.find(' ');
+  if (space == string::npos || line.size() < space + 4) return statusCode;
+  optional<size_t> code = ParseDecimal(line.substr(space + 1, 3));
+  if (code.has_value() && 100 <= code.value() && code.value() <= 999) {
+    statusCode = static_cast<uint16_t>(code.value());
+  }
+  return statusCode;
+}
+
+//
+// CMapDownload
+//
+
+CMapDownload::CMapDownload(filesystem::path nFilePath, string nUri)
+ : m_FilePath(move(nFilePath)),
+   m_PartPath(GetPartPath(m_FilePath)),
+   m_SidecarPath(GetSidecarPath(m_FilePath)),
+   m_Uri(move(nUri)),
+   m_ResumedSize(0),
+   m_StatusCode(0),
+   m_AcceptBody(false),
+   m_WriteError(false),
+   m_Oversized(false),
+   m_Restarted(false)
+{
+}
+
+CMapDownload::~CMapDownload()
+{
+  if (m_FileStream.is_open()) {
+    m_FileStream.close();
+  }
+}
+
+filesystem::path CMapDownload::GetPartPath(const filesystem::path& filePath)
+{
+  return filesystem::path(filePath.native() + PLATFORM_STRING(".part"));
+}
+
+filesystem::path CMapDownload::GetSidecarPath(const filesystem::path& filePath)
+{
+  return filesystem::path(filePath.native() + PLATFORM_STRING(".part.ini"));
+}
+
+bool CMapDownload::GetHasPartial(const filesystem::path& filePath)
+{
+  return FileExists(GetPartPath(filePath)) || FileExists(GetSidecarPath(filePath));
+}
+
+bool CMapDownload::GetCanResume(const filesystem::path& filePath, const string& uri)
+{
+  if (!FileExists(GetPartPath(filePath)) || !FileExists(GetSidecarPath(filePath))) return false;
+  CConfig sidecar;
+  if (!sidecar.Read(GetSidecarPath(filePath))) return false;
+  return sidecar.GetString("download.uri", string()) == uri;
+}
+
+bool CMapDownload::Open()
+{
+  if (GetCanResume(m_FilePath, m_Uri)) {
+    CConfig sidecar;
+    if (sidecar.Read(m_SidecarPath)) {
+      optional<uint32_t> totalSize = sidecar.GetMaybeUint32("download.size");
+      if (totalSize.has_value()) m_TotalSize = totalSize.value();
+    }
+
+    // rehash what we already have, so that the digest still covers the whole file when done
+    ifstream partStream(m_PartPath, ios::in | ios::binary);
+    vector<uint8_t> block(MAP_FILE_PROCESSING_CHUNK_SIZE);
+    while (partStream.is_open() && !GetHasWriteError()) {
+      partStream.read(reinterpret_cast<char*>(block.data()), block.size());
+      const size_t readSize = static_cast<size_t>(partStream.gcount());
+      if (readSize == 0) break;
+      if (GetReceivedSize() + readSize > MAX_MAP_SIZE_RF) {
+        m_Oversized = true;
+        break;
+      }
+      m_Hash.Update(block.data(), readSize);
+    }
+    const bool partOK = partStream.is_open() && !partStream.bad() && !m_Oversized;
+    partStream.close();
+    m_Oversized = false;
+
+    if (partOK && (!m_TotalSize.has_value() || GetReceivedSize() <= m_TotalSize.value())) {
+      m_ResumedSize = GetReceivedSize();
+      m_FileStream.open(m_PartPath, ios::out | ios::binary | ios::app);
+    } else if (!Restart()) {
+      return false;
+    }
+  } else if (!Restart()) {
+    return false;
+  }
+  return m_FileStream.is_open() && SaveProgress();
+}
+
+bool CMapDownload::Restart()
+{
+  if (m_FileStream.is_open()) {
+    m_FileStream.close();
+  }
+  m_Hash.Reset();
+  m_TotalSize.reset();
+  m_ResumedSize = 0;
+  m_FileStream.open(m_PartPath, ios::out | ios::binary | ios::trunc);
+  return m_FileStream.is_open();
+}
+
+void CMapDownload::BeginAttempt()
+{
+  m_StatusCode = 0;
+  m_ContentRange.reset();
+  m_ContentLength.reset();
+  m_AcceptBody = false;
+  m_Restarted = false;
+}
+
+string CMapDownload::GetRangeHeader() const
+{
+  if (GetReceivedSize() == 0) return string();
+  return "bytes=" + to_string(GetReceivedSize()) + "-";
+}
+
+bool CMapDownload::OnHeader(const string& line)
+{
+  string header = TrimStringExtended(line);
+  optional<uint16_t> statusCode = ParseHTTPStatusLine(header);
+  if (statusCode.has_value()) {
+    // redirects send several responses - only the headers of the last one are relevant
+    BeginAttempt();
+    m_StatusCode = statusCode.value();
+    return true;
+  }
+
+  if (!header.empty()) {
+    size_t colon = header.find(':');
+    if (colon == string::npos) return true;
+    string name = ToLowerCase(TrimString(header.substr(0, colon)));
+    string value = TrimString(header.substr(colon + 1));
+    if (name == "content-range") {
+      m_ContentRange = ParseHTTPContentRange(value);
+    } else if (name == "content-length") {
+      m_ContentLength = ParseDecimal(value);
+    }
+    return true;
+  }
+
+  // end of headers
+  if (m_StatusCode == 206) {
+    const bool isContiguous = m_ContentRange.has_value() && m_ContentRange->m_Start == GetReceivedSize();
+    const bool isSameFile = !m_TotalSize.has_value() || !m_ContentRange.has_value() || m_ContentRange->m_Total == m_TotalSize;
+    if (!isContiguous || !isSameFile) {
+      // cannot be spliced onto what we have - the next attempt starts over
+      if (!Restart()) {
+        m_WriteError = true;
+        return false;
+      }
+      m_Restarted = true;
+      return true;
+    }
+    if (m_ContentRange->m_Total.has_value()) {
+      m_TotalSize = m_ContentRange->m_Total;
+    }
+    m_AcceptBody = true;
+  } else if (m_StatusCode == 200) {
+    // Range header ignored - full body follows
+    if (GetReceivedSize() > 0 && !Restart()) {
+      m_WriteError = true;
+      return false;
+    }
+    m_TotalSize = m_ContentLength;
+    m_AcceptBody = true;
+  } else if (m_StatusCode == 416) {
+    // partial file is longer than the current remote one
+    if (!Restart()) {
+      m_WriteError = true;
+      return false;
+    }
+    m_Restarted = true;
+  }
+  return true;
+}
+
+bool CMapDownload::OnData(const uint8_t* data, const size_t size)
+{
+  if (!m_AcceptBody) {
+    // error pages, redirect bodies
+    return true;
+  }
+  const size_t maxSize = m_TotalSize.value_or(MAX_MAP_SIZE_RF);
+  if (GetReceivedSize() + size > maxSize || GetReceivedSize() + size > MAX_MAP_SIZE_RF) {
+    m_Oversized = true;
+    return false;
+  }
+  m_FileStream.write(reinterpret_cast<const char*>(data), size);
+  if (m_FileStream.fail()) {
+    m_WriteError = true;
+    return false;
+  }
+  m_Hash.Update(data, size);
+  return true;
+}
+
+MapDownloadStep CMapDownload::EndAttempt(const uint16_t statusCode, const bool isTransferOK) const
+{
+  if (GetHasWriteError()) {
+    return MapDownloadStep::kFail;
+  }
+  if (m_Restarted) {
+    // the remote file changed, or our partial file is unusable - request all of it
+    return MapDownloadStep::kRetry;
+  }
+  const bool isSuccess = (statusCode == 200 || statusCode == 206) && isTransferOK;
+  if (isSuccess && (!m_TotalSize.has_value() || GetIsComplete())) {
+    return MapDownloadStep::kDone;
+  }
+  // only connectivity errors, timeouts, and truncated or mismatched bodies are worth a retry
+  if (statusCode != 0 && statusCode != 200 && statusCode != 206 && statusCode != 416) {
+    return MapDownloadStep::kFail;
+  }
+  return MapDownloadStep::kRetry;
+}
+
+bool CMapDownload::SaveProgress()
+{
+  if (m_FileStream.is_open()) {
+    m_FileStream.flush();
+  }
+  CConfig sidecar;
+  sidecar.Set("download.uri", m_Uri);
+  sidecar.SetUint32("download.received", static_cast<uint32_t>(GetReceivedSize()));
+  if (m_TotalSize.has_value()) {
+    sidecar.SetUint32("download.size", static_cast<uint32_t>(m_TotalSize.value()));
+  }
+  vector<uint8_t> bytes = sidecar.Export();
+  return FileWrite(m_SidecarPath, bytes.data(), bytes.size());
+}
+
+optional<FileHashDigest> CMapDownload::Commit()
+{
+  optional<FileHashDigest> digest;
+  if (m_FileStream.is_open()) {
+    m_FileStream.close();
+  }
+  if (GetReceivedSize() == 0 || (m_TotalSize.has_value() && GetReceivedSize() != m_TotalSize.value())) {
+    return digest;
+  }
+  error_code ec;
+  filesystem::rename(m_PartPath, m_FilePath, ec);
+  if (ec) {
+    return digest;
+  }
+  FileDelete(m_SidecarPath);
+  digest = m_Hash.Final();
+  return digest;
+}
+
+void CMapDownload::Discard()
+{
+  if (m_FileStream.is_open()) {
+    m_FileStream.close();
+  }
+  FileDelete(m_PartPath);
+  FileDelete(m_SidecarPath);
+}
@@ -0,0 +1,120 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+#ifndef AURA_MAP_DOWNLOAD_H_
+#define AURA_MAP_DOWNLOAD_H_
+
+#include "includes.h"
+#include "file_hash.h"
+
+#include <filesystem>
+#include <fstream>
+
+//
+// HTTPContentRange
+//
+// Value of a "Content-Range: bytes <start>-<end>/<total>" response header.
+//
+
+struct HTTPContentRange
+{
+  size_t                                        m_Start;
+  size_t                                        m_End;
+  std::optional<size_t>                         m_Total;
+
+  HTTPContentRange();
+  ~HTTPContentRange() = default;
+};
+
+enum class MapDownloadStep : uint8_t
+{
+  kDone = 0,
+  kRetry = 1,
+  kFail = 2,
+};
+
+[[nodiscard]] std::optional<HTTPContentRange> ParseHTTPContentRange(const std::string& value);
+[[nodiscard]] std::optional<uint16_t> ParseHTTPStatusLine(const std::string& line);
+
+//
+// CMapDownload
+//
+// Map file being downloaded from a repository.
+//
+// Bytes are written to <map>.part, and hashed as they arrive. Whenever a transfer is interrupted,
+// progress is recorded in the <map>.part.ini sidecar, so that the next attempt - in this process
+// or a later one - requests only the missing tail through an HTTP Range request.
+// Servers that ignore the Range header just restart the file from scratch.
+//
+// Fed from cpr header and write callbacks, but holds no network state of its own.
+//
+
+class CMapDownload
+{
+public:
+  std::filesystem::path                         m_FilePath;
+  std::filesystem::path                         m_PartPath;
+  std::filesystem::path                         m_SidecarPath;
+  std::string                                   m_Uri;
+  std::ofstream                                 m_FileStream;
+  CFileHashStream                               m_Hash;
+  std::optional<size_t>                         m_TotalSize;            // as advertised by the repository
+  size_t                                        m_ResumedSize;          // bytes already on disk when opened
+  uint16_t                                      m_StatusCode;           // of the response being received
+  std::optional<HTTPContentRange>               m_ContentRange;
+  std::optional<size_t>                         m_ContentLength;
+  bool                                          m_AcceptBody;
+  bool                                          m_WriteError;
+  bool                                          m_Oversized;
+  bool                                          m_Restarted;            // response didn't fit what we had, so the next attempt starts over
+
+  CMapDownload(std::filesystem::path nFilePath, std::string nUri);
+  ~CMapDownload();
+  CMapDownload(CMapDownload&) = delete;
+
+  [[nodiscard]] static std::filesystem::path GetPartPath(const std::filesystem::path& filePath);
+  [[nodiscard]] static std::filesystem::path GetSidecarPath(const std::filesystem::path& filePath);
+  [[nodiscard]] static bool GetHasPartial(const std::filesystem::path& filePath);
+  [[nodiscard]] static bool GetCanResume(const std::filesystem::path& filePath, const std::string& uri);
+
+  [[nodiscard]] bool Open();
+  void BeginAttempt();
+  [[nodiscard]] std::string GetRangeHeader() const;
+  bool OnHeader(const std::string& line);
+  bool OnData(const uint8_t* data, const size_t size);
+  [[nodiscard]] MapDownloadStep EndAttempt(const uint16_t statusCode, const bool isTransferOK) const;
+  bool SaveProgress();
+  [[nodiscard]] std::optional<FileHashDigest> Commit();
+  void Discard();
+
+  [[nodiscard]] inline size_t GetReceivedSize() const { return m_Hash.GetSize(); }
+  [[nodiscard]] inline bool GetIsResumed() const { return m_ResumedSize > 0; }
+  [[nodiscard]] inline bool GetIsComplete() const { return m_TotalSize.has_value() && GetReceivedSize() == m_TotalSize.value(); }
+  [[nodiscard]] inline bool GetHasWriteError() const { return m_WriteError || m_Oversized; }
+
+private:
+  bool Restart();
+};
+
+#endif // AURA_MAP_DOWNLOAD_H_
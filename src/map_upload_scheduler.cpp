@@ -0,0 +1,165 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+#include "map_upload_scheduler.h"
+#include "map.h"
+
+#include <limits>
+
+using namespace std;
+
+//
+// CMapUploadScheduler::Flow
+//
+
+CMapUploadScheduler::Flow::Flow(MapTransfer* nTransfer, const uint8_t nWeight, const uint32_t nMapSize, const size_t nSendQueueSize, optional<uint32_t> nRTT)
+ : m_Transfer(nTransfer),
+   m_Weight(nWeight),
+   m_MapSize(nMapSize),
+   m_SendQueueSize(nSendQueueSize),
+   m_RTT(nRTT),
+   m_Limit(0),
+   m_Grant(0)
+{
+}
+
+//
+// CMapUploadScheduler
+//
+
+CMapUploadScheduler::CMapUploadScheduler()
+ : m_MaxInFlight(MAP_PART_SIZE * 1000),
+   m_Cycle(0)
+{
+}
+
+CMapUploadScheduler::~CMapUploadScheduler() = default;
+
+void CMapUploadScheduler::Clear()
+{
+  m_Flows.clear();
+}
+
+void CMapUploadScheduler::Add(MapTransfer* transfer, const uint8_t weight, const uint32_t mapSize, const size_t sendQueueSize, optional<uint32_t> rtt)
+{
+  m_Flows.emplace_back(transfer, weight, mapSize, sendQueueSize, rtt);
+}
+
+void CMapUploadScheduler::UpdateAckRate(MapTransfer& transfer, const int64_t ticks)
+{
+  if (transfer.ackRateSampleTicks == 0 || transfer.lastAck < transfer.ackRateSample) {
+    transfer.ackRateSample = transfer.lastAck;
+    transfer.ackRateSampleTicks = ticks;
+    return;
+  }
+  const int64_t elapsed = ticks - transfer.ackRateSampleTicks;
+  if (elapsed < MAP_UPLOAD_ACK_RATE_INTERVAL) {
+    return;
+  }
+  const uint64_t sampleRate = static_cast<uint64_t>(transfer.lastAck - transfer.ackRateSample) * 1000 / static_cast<uint64_t>(elapsed);
+  // follow increases right away, so that fast links ramp up quickly, but decreases only gradually
+  const uint64_t smoothedRate = sampleRate >= transfer.ackRate ? sampleRate : (static_cast<uint64_t>(transfer.ackRate) * 3 + sampleRate) / 4;
+  transfer.ackRate = static_cast<uint32_t>(min<uint64_t>(smoothedRate, numeric_limits<uint32_t>::max()));
+  transfer.ackRateSample = transfer.lastAck;
+  transfer.ackRateSampleTicks = ticks;
+}
+
+uint32_t CMapUploadScheduler::GetLimit(const MapTransfer& transfer, const uint32_t mapSize, const size_t sendQueueSize, optional<uint32_t> rtt, const uint32_t maxInFlight)
+{
+  if (transfer.GetLastSentOffsetEnd() >= mapSize) {
+    return 0;
+  }
+
+  // until acknowledgements arrive, throughput is unknown
+  uint64_t window = MAP_UPLOAD_INITIAL_WINDOW;
+  uint64_t queueLimit = MAP_UPLOAD_INITIAL_WINDOW;
+  if (transfer.GetAckRate() > 0) {
+    const uint64_t roundTrip = rtt.value_or(MAP_UPLOAD_DEFAULT_RTT);
+    // the window is a bit larger than the measured rate needs, or the estimate could never grow back to the link speed
+    window = max<uint64_t>(MAP_UPLOAD_MIN_WINDOW, static_cast<uint64_t>(transfer.GetAckRate()) * (roundTrip + MAP_UPLOAD_TARGET_QUEUE_DELAY) * MAP_UPLOAD_WINDOW_GAIN_PERCENT / 100000);
+    queueLimit = max<uint64_t>(MAP_UPLOAD_MIN_WINDOW, static_cast<uint64_t>(transfer.GetAckRate()) * MAP_UPLOAD_TARGET_QUEUE_DELAY / 1000);
+  }
+  window = min<uint64_t>(window, maxInFlight);
+
+  const uint64_t inFlight = transfer.GetInFlight();
+  if (inFlight >= window || sendQueueSize >= queueLimit) {
+    return 0;
+  }
+  return static_cast<uint32_t>(min<uint64_t>({window - inFlight, queueLimit - sendQueueSize, mapSize - transfer.GetLastSentOffsetEnd()}));
+}
+
+void CMapUploadScheduler::Schedule(const int64_t ticks, const uint64_t budget)
+{
+  ++m_Cycle;
+  if (m_Flows.empty()) return;
+
+  for (auto& flow : m_Flows) {
+    UpdateAckRate(*flow.m_Transfer, ticks);
+    flow.m_Limit = GetLimit(*flow.m_Transfer, flow.m_MapSize, flow.m_SendQueueSize, flow.m_RTT, m_MaxInFlight);
+    flow.m_Grant = 0;
+  }
+
+  if (budget == 0) {
+    // unlimited - pacing is the only constraint
+    for (auto& flow : m_Flows) {
+      flow.m_Grant = flow.m_Limit;
+      flow.m_Transfer->SetUploadCredit(0);
+    }
+    return;
+  }
+
+  // a round must fit in the budget, or whoever comes first would take it all
+  uint64_t totalWeight = 0;
+  for (const auto& flow : m_Flows) {
+    if (flow.m_Limit > 0) totalWeight += flow.m_Weight;
+  }
+  const uint64_t quantum = totalWeight == 0 ? MAP_UPLOAD_QUANTUM : max<uint64_t>(1, min<uint64_t>(MAP_UPLOAD_QUANTUM, budget / totalWeight));
+
+  // rounds start at a different downloader every cycle, so that ties don't always favor the same one
+  const size_t numFlows = m_Flows.size();
+  const size_t firstIndex = static_cast<size_t>(m_Cycle % numFlows);
+  uint64_t remainingBudget = budget;
+  bool anyBacklogged = true;
+  while (anyBacklogged && remainingBudget > 0) {
+    anyBacklogged = false;
+    for (size_t i = 0; i < numFlows && remainingBudget > 0; ++i) {
+      Flow& flow = m_Flows[(firstIndex + i) % numFlows];
+      if (flow.m_Grant >= flow.m_Limit) continue;
+      anyBacklogged = true;
+      uint64_t credit = static_cast<uint64_t>(flow.m_Transfer->GetUploadCredit()) + quantum * flow.m_Weight;
+      const uint64_t amount = min<uint64_t>({credit, flow.m_Limit - flow.m_Grant, remainingBudget});
+      flow.m_Grant += static_cast<uint32_t>(amount);
+      credit -= amount;
+      remainingBudget -= amount;
+      flow.m_Transfer->SetUploadCredit(static_cast<uint32_t>(credit));
+    }
+  }
+
+  for (auto& flow : m_Flows) {
+    if (flow.m_Grant >= flow.m_Limit) {
+      // not backlogged - must not hoard credit for later cycles
+      flow.m_Transfer->SetUploadCredit(0);
+    }
+  }
+}
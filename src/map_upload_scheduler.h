@@ -0,0 +1,80 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+#ifndef AURA_MAP_UPLOAD_SCHEDULER_H_
+#define AURA_MAP_UPLOAD_SCHEDULER_H_
+
+#include "includes.h"
+
+//
+// CMapUploadScheduler
+//
+// Splits the map upload budget of each transfer cycle among downloaders, both lobby users and async observers.
+//
+// Deficit round-robin: every round, each downloader earns MAP_UPLOAD_QUANTUM bytes of credit times its weight
+// (less if a whole round wouldn't fit in the budget), and spends it on map parts. Users holding a player slot outweigh observers, since the lobby can't start without them.
+// Credit left over when the budget runs out carries over to the next cycle, so that no downloader is starved.
+//
+// Pacing: each downloader may only have as many map bytes in flight as its acknowledged throughput covers
+// within its round-trip time plus MAP_UPLOAD_TARGET_QUEUE_DELAY, and only as many bytes waiting in its
+// send queue as drain within MAP_UPLOAD_TARGET_QUEUE_DELAY. Lobby chat and slot updates are queued behind
+// map parts, so this bounds how late they reach slow users.
+//
+
+class CMapUploadScheduler
+{
+public:
+  struct Flow
+  {
+    MapTransfer*                                m_Transfer;
+    uint8_t                                     m_Weight;
+    uint32_t                                    m_MapSize;
+    size_t                                      m_SendQueueSize;        // bytes of any kind waiting to be sent
+    std::optional<uint32_t>                     m_RTT;                  // milliseconds, as reported by TCP
+    uint32_t                                    m_Limit;                // most bytes the connection can take now
+    uint32_t                                    m_Grant;                // bytes to send this cycle
+
+    Flow(MapTransfer* nTransfer, const uint8_t nWeight, const uint32_t nMapSize, const size_t nSendQueueSize, std::optional<uint32_t> nRTT);
+    ~Flow() = default;
+  };
+
+  std::vector<Flow>                             m_Flows;
+  uint32_t                                      m_MaxInFlight;          // <hosting.map_transfers.max_parallel_packets>, in bytes
+  uint64_t                                      m_Cycle;
+
+  CMapUploadScheduler();
+  ~CMapUploadScheduler();
+
+  void Clear();
+  void Add(MapTransfer* transfer, const uint8_t weight, const uint32_t mapSize, const size_t sendQueueSize, std::optional<uint32_t> rtt);
+  void Schedule(const int64_t ticks, const uint64_t budget);
+
+  [[nodiscard]] inline uint32_t GetGrant(const size_t index) const { return m_Flows[index].m_Grant; }
+  [[nodiscard]] inline size_t GetNumFlows() const { return m_Flows.size(); }
+
+  static void UpdateAckRate(MapTransfer& transfer, const int64_t ticks);
+  [[nodiscard]] static uint32_t GetLimit(const MapTransfer& transfer, const uint32_t mapSize, const size_t sendQueueSize, std::optional<uint32_t> rtt, const uint32_t maxInFlight);
+};
+
+#endif // AURA_MAP_UPLOAD_SCHEDULER_H_
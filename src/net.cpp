@@ -45,6 +45,7 @@
 #include "game_user.h"
 #include "realm.h"
 #include "socket.h"
+#include "socket_poller.h"
 #include "aura.h"
 
 using namespace std;
@@ -72,17 +73,6 @@ CGameTestConnection::~CGameTestConnection()
   delete m_Socket;
 }
 
-uint32_t CGameTestConnection::SetFD(fd_set* fd, fd_set* send_fd, int32_t* nfds) const
-{
-  if (!m_Socket->HasError() && m_Socket->GetConnected())
-  {
-    m_Socket->SetFD(fd, send_fd, nfds);
-    return 1;
-  }
-
-  return 0;
-}
-
 bool CGameTestConnection::GetIsRealmOnline() const
 {
   if (m_RealmInternalId < 0x10) return true;
@@ -152,7 +142,7 @@ bool CGameTestConnection::QueryGameInfo()
   return true;
 }
 
-bool CGameTestConnection::Update(fd_set* fd, fd_set* send_fd)
+bool CGameTestConnection::Update()
 {
   static optional<sockaddr_storage> emptyBindAddress;
 
@@ -167,15 +157,15 @@ bool CGameTestConnection::Update(fd_set* fd, fd_set* send_fd)
     m_Socket->Reset();
   } else if (m_Socket->GetConnected() && Ticks < m_Timeout) {
     bool gotJoinedMessage = false;
-    if (m_Socket->DoRecv(fd)) {
-      string* RecvBuffer = m_Socket->GetBytes();
-      std::vector<uint8_t> Bytes = CreateByteArray((uint8_t*)RecvBuffer->c_str(), RecvBuffer->size());
+    if (m_Socket->DoRecv()) {
+      CStreamBuffer* RecvBuffer = m_Socket->GetBytes();
+      std::vector<uint8_t> Bytes = CreateByteArray(RecvBuffer->GetData(), RecvBuffer->GetSize());
       gotJoinedMessage = Bytes.size() >= 2 && Bytes[0] == GameProtocol::Magic::W3GS_HEADER && Bytes[1] == GameProtocol::Magic::SLOTINFOJOIN;
       m_Passed = true;
     }
     if (!m_SentJoinRequest) {
       if (QueryGameInfo()) {
-        m_Socket->DoSend(send_fd);
+        m_Socket->DoSend();
       }
     } else if (gotJoinedMessage) {
       m_Socket->Reset();
@@ -218,17 +208,6 @@ CIPAddressAPIConnection::~CIPAddressAPIConnection()
   delete m_Socket;
 }
 
-uint32_t CIPAddressAPIConnection::SetFD(fd_set* fd, fd_set* send_fd, int32_t* nfds)
-{
-  if (!m_Socket->HasError() && m_Socket->GetConnected())
-  {
-    m_Socket->SetFD(fd, send_fd, nfds);
-    return 1;
-  }
-
-  return 0;
-}
-
 int64_t CNet::GetThrottleTime(const NetworkHost& host, int64_t minTime) const
 {
   const auto it = m_OutgoingThrottles.find(host);
@@ -316,7 +295,7 @@ bool CIPAddressAPIConnection::QueryIPAddress()
   return true;
 }
 
-bool CIPAddressAPIConnection::Update(fd_set* fd, fd_set* send_fd)
+bool CIPAddressAPIConnection::Update()
 {
   static optional<sockaddr_storage> emptyBindAddress;
 
@@ -331,9 +310,9 @@ bool CIPAddressAPIConnection::Update(fd_set* fd, fd_set* send_fd)
     m_Socket->Reset();
   } else if (m_Socket->GetConnected() && Ticks < m_Timeout) {
     bool gotAddress = false;
-    if (m_Socket->DoRecv(fd)) {
-      string* RecvBuffer = m_Socket->GetBytes();
-      std::vector<uint8_t> Bytes = CreateByteArray((uint8_t*)RecvBuffer->c_str(), RecvBuffer->size());
+    if (m_Socket->DoRecv()) {
+      CStreamBuffer* RecvBuffer = m_Socket->GetBytes();
+      std::vector<uint8_t> Bytes = CreateByteArray(RecvBuffer->GetData(), RecvBuffer->GetSize());
       uint16_t size = static_cast<uint16_t>(Bytes.size());
       const bool is200 = size >= 15 && Bytes[9] == 0x32 && Bytes[10] == 0x30 && Bytes[11] == 0x30;
       if (is200) {
@@ -359,7 +338,7 @@ bool CIPAddressAPIConnection::Update(fd_set* fd, fd_set* send_fd)
     }
     if (!m_SentQuery) {
       if (QueryIPAddress()) {
-        m_Socket->DoSend(send_fd);
+        m_Socket->DoSend();
       }
     } else if (gotAddress) {
       m_Socket->Reset();
@@ -403,6 +382,8 @@ CNet::CNet(CConfig& nCFG)
     m_MainBroadcastTarget(new sockaddr_storage()),
     m_ProxyBroadcastTarget(new sockaddr_storage()),
 
+    m_DNSPollTimer(0),
+    m_PollResumeTimer(0),
     m_IPv4SelfCacheV(make_pair(string(), nullptr)),
     m_IPv4SelfCacheT(NET_PUBLIC_IP_ADDRESS_ALGORITHM_INVALID),
     m_IPv6SelfCacheV(make_pair(string(), nullptr)),
@@ -413,6 +394,7 @@ CNet::CNet(CConfig& nCFG)
     m_HealthCheckContext(nullptr),
 
     m_IPAddressFetchInProgress(false),
+    m_IPAddressFetchResolving(0),
 
     m_LastHostPort(0),
     m_LastDownloadTicks(APP_MIN_TICKS),
@@ -518,79 +500,31 @@ bool CNet::Init()
   return true;
 }
 
-uint32_t CNet::SetFD(fd_set* fd, fd_set* send_fd, int32_t* nfds)
+void CNet::UpdateBeforeGames()
 {
-  uint32_t NumFDs = 0;
-
-  for (auto& connection : m_HealthCheckClients)
-    NumFDs += connection->SetFD(fd, send_fd, nfds);
-
-  for (auto& connection : m_IPAddressFetchClients)
-    NumFDs += connection->SetFD(fd, send_fd, nfds);
-
-  if (m_UDPMainServerEnabled) {
-    m_UDPMainServer->SetFD(fd, send_fd, nfds);
-    ++NumFDs;
-  } else if (m_UDPDeafSocket) {
-    m_UDPDeafSocket->SetFD(fd, send_fd, nfds);
-    ++NumFDs;
-  }
-
-  for (const auto& entry : m_GameServers) {
-    if (auto server = entry.second) {
-      server->SetFD(fd, send_fd, nfds);
-      ++NumFDs;
-    }
-  }
-
-  for (const auto& serverConnections : m_IncomingConnections) {
-    // std::pair<uint16_t, vector<CConnection*>>
-    for (const auto& connection : serverConnections.second) {
-      NumFDs += connection->SetFD(fd, send_fd, nfds);;
-    }
-  }
-
-  for (const auto& serverConnections : m_GameProxies) {
-    // std::pair<uint16_t, vector<CTCPProxy*>>
-    for (const auto& connection : serverConnections.second) {
-      NumFDs += connection->SetFD(fd, send_fd, nfds);;
-    }
-  }
-
-  for (const auto& serverConnections : m_GameSeekers) {
-    // std::pair<uint16_t, vector<CGameSeeker*>>
-    for (const auto& connection : serverConnections.second) {
-      NumFDs += connection->SetFD(fd, send_fd, nfds);;
-    }
-  }
-
-  for (const auto& serverConnections : m_GameObservers) {
-    // std::pair<uint16_t, vector<CAsyncObserver*>>
-    for (const auto& connection : serverConnections.second) {
-      NumFDs += connection->SetFD(fd, send_fd, nfds);;
-    }
-  }  
+  // deliver host name resolutions completed by worker threads
+  m_DNSResolver.Update();
+  ScheduleDNSPollTimer();
 
-  return NumFDs;
-}
-
-void CNet::UpdateBeforeGames(fd_set* fd, fd_set* send_fd)
-{
   // if hosting a lobby, accept new connections to its game server
 
   for (const auto& entry : m_GameServers) {
     if (auto server = entry.second) {
       if (m_Aura->m_ExitingSoon) {
-        server->Discard(fd);
+        server->Discard();
         continue;
       }
       uint16_t localPort = entry.first;
-      if (m_IncomingConnections[localPort].size() >= MAX_INCOMING_CONNECTIONS) {
-        server->Discard(fd);
-        continue;
-      }
-      CStreamIOSocket* socket = server->Accept(fd);
-      if (socket) {
+      // pending connections must be drained, since the poller may not notify about them again
+      for (uint16_t acceptCount = 0; acceptCount < SOCKET_ACCEPT_MAX_PER_UPDATE; ++acceptCount) {
+        if (m_IncomingConnections[localPort].size() >= MAX_INCOMING_CONNECTIONS) {
+          server->Discard();
+          break;
+        }
+        CStreamIOSocket* socket = server->Accept();
+        if (!socket) {
+          break;
+        }
         if (m_Config.m_ProxyReconnect > 0) {
           CConnection* incomingConnection = new CConnection(m_Aura, localPort, socket);
           DPRINT_IF(LogLevel::kTrace2, "[AURA] incoming connection from " + incomingConnection->GetIPString())
@@ -607,6 +541,9 @@ void CNet::UpdateBeforeGames(fd_set* fd, fd_set* send_fd)
           PRINT_IF(LogLevel::kWarning, "[AURA] " + to_string(m_IncomingConnections[localPort].size()) + " connections at port " + to_string(localPort) + " - rejecting further connections")
         }
       }
+      if (server->GetIsReadable()) {
+        CSocketPoller::GetThreadPoller()->SetBacklogged();
+      }
 
       if (server->HasError()) {
         m_Aura->m_Exiting = true;
@@ -618,13 +555,13 @@ void CNet::UpdateBeforeGames(fd_set* fd, fd_set* send_fd)
     int64_t timeout = (int64_t)LinearInterpolation((float)serverConnections.second.size(), (float)1., (float)MAX_INCOMING_CONNECTIONS, (float)GAME_USER_CONNECTION_MAX_TIMEOUT, (float)GAME_USER_CONNECTION_MIN_TIMEOUT);
     for (auto i = begin(serverConnections.second); i != end(serverConnections.second);) {
       // *i is a pointer to a CConnection
-      uint8_t result = (*i)->Update(fd, send_fd, timeout);
+      uint8_t result = (*i)->Update(timeout);
       if (result == INCON_UPDATE_OK) {
         ++i;
         continue;
       }
       if ((*i)->GetSocket()) {
-        (*i)->GetSocket()->DoSend(send_fd); // flush the socket
+        (*i)->GetSocket()->DoSend(); // flush the socket
       }
       delete *i;
       i = serverConnections.second.erase(i);
@@ -634,16 +571,16 @@ void CNet::UpdateBeforeGames(fd_set* fd, fd_set* send_fd)
   for (auto& serverConnections : m_GameProxies) {
     for (auto i = begin(serverConnections.second); i != end(serverConnections.second);) {
       // *i is a pointer to a CTCPProxy
-      TCPProxyStatus result = (*i)->Update(fd, send_fd, GAME_USER_TIMEOUT_VANILLA);
+      TCPProxyStatus result = (*i)->Update(GAME_USER_TIMEOUT_VANILLA);
       if (result == TCPProxyStatus::kOk) {
         ++i;
         continue;
       }
       if ((*i)->GetIncomingSocket()) {
-        (*i)->GetIncomingSocket()->DoSend(send_fd); // flush the socket
+        (*i)->GetIncomingSocket()->DoSend(); // flush the socket
       }
       if ((*i)->GetOutgoingSocket()) {
-        (*i)->GetOutgoingSocket()->DoSend(send_fd); // flush the socket
+        (*i)->GetOutgoingSocket()->DoSend(); // flush the socket
       }
       delete *i;
       i = serverConnections.second.erase(i);
@@ -654,13 +591,13 @@ void CNet::UpdateBeforeGames(fd_set* fd, fd_set* send_fd)
     int64_t timeout = (int64_t)LinearInterpolation((float)serverConnections.second.size(), (float)1., (float)MAX_INCOMING_CONNECTIONS, (float)GAME_SEEKER_CONNECTION_MAX_TIMEOUT, (float)GAME_SEEKER_CONNECTION_MIN_TIMEOUT);
     for (auto i = begin(serverConnections.second); i != end(serverConnections.second);) {
       // *i is a pointer to a CGameSeeker
-      GameSeekerStatus result = (*i)->Update(fd, send_fd, timeout);
+      GameSeekerStatus result = (*i)->Update(timeout);
       if (result == GameSeekerStatus::kOk) {
         ++i;
         continue;
       }
       if ((*i)->GetSocket()) {
-        (*i)->GetSocket()->DoSend(send_fd); // flush the socket
+        (*i)->GetSocket()->DoSend(); // flush the socket
       }
       delete *i;
       i = serverConnections.second.erase(i);
@@ -670,13 +607,14 @@ void CNet::UpdateBeforeGames(fd_set* fd, fd_set* send_fd)
   for (auto& serverConnections : m_GameObservers) {
     for (auto i = begin(serverConnections.second); i != end(serverConnections.second);) {
       // *i is a pointer to a CAsyncObserver
-      uint8_t result = (*i)->Update(fd, send_fd, GAME_USER_TIMEOUT_VANILLA);
+      uint8_t result = (*i)->Update(GAME_USER_TIMEOUT_VANILLA);
       if (result == ASYNC_OBSERVER_OK) {
+        (*i)->ScheduleFrameTimer();
         ++i;
         continue;
       }
       if ((*i)->GetSocket()) {
-        (*i)->GetSocket()->DoSend(send_fd); // flush the socket
+        (*i)->GetSocket()->DoSend(); // flush the socket
       }
       delete *i;
       i = serverConnections.second.erase(i);
@@ -684,12 +622,12 @@ void CNet::UpdateBeforeGames(fd_set* fd, fd_set* send_fd)
   }
 }
 
-void CNet::UpdateAfterGames(fd_set* fd, fd_set* send_fd)
+void CNet::UpdateAfterGames()
 {
   if (m_HealthCheckInProgress) {
     bool anyPending = false;
     for (auto& testConnection : m_HealthCheckClients) {
-      if (testConnection->Update(fd, send_fd)) {
+      if (testConnection->Update()) {
         anyPending = true;
       }
     }
@@ -698,9 +636,9 @@ void CNet::UpdateAfterGames(fd_set* fd, fd_set* send_fd)
     }
   }
   if (m_IPAddressFetchInProgress) {
-    bool anyPending = false;
+    bool anyPending = m_IPAddressFetchResolving > 0;
     for (auto& apiConnection : m_IPAddressFetchClients) {
-      if (apiConnection->Update(fd, send_fd)) {
+      if (apiConnection->Update()) {
         anyPending = true;
       }
     }
@@ -711,19 +649,26 @@ void CNet::UpdateAfterGames(fd_set* fd, fd_set* send_fd)
 
   if (m_UDPMainServerEnabled) {
     if (m_Aura->m_ExitingSoon) {
-      m_UDPMainServer->Discard(fd);
+      m_UDPMainServer->Discard();
     } else {
-      UDPPkt* pkt = m_UDPMainServer->Accept(fd);
-      if (pkt != nullptr) {
+      for (uint16_t packetCount = 0; packetCount < SOCKET_ACCEPT_MAX_PER_UPDATE; ++packetCount) {
+        UDPPkt* pkt = m_UDPMainServer->Accept();
+        if (pkt == nullptr) {
+          break;
+        }
         HandleUDP(pkt);
         delete pkt->sender;
         delete pkt;
       }
+      if (m_UDPMainServer->GetIsReadable()) {
+        CSocketPoller::GetThreadPoller()->SetBacklogged();
+      }
     }
   } else if (m_UDPDeafSocket) {
-    m_UDPDeafSocket->Discard(fd);
+    m_UDPDeafSocket->Discard();
   }
 
+  SchedulePollResumeTimer();
   UpdateMapTransfers();
 }
 
@@ -745,9 +690,7 @@ void CNet::UpdateMapTransfers()
     for (auto& user : game->GetUsers()) {
       if (!user->GetMapTransfer().GetIsInProgress()) continue;
       if (downloadersCount >= m_Config.m_MaxDownloaders) continue;
-      // Sort to avoid cache deoptimization
-      auto pos = lower_bound(downloaderPlayers.begin(), downloaderPlayers.end(), user, &GameUser::SortUsersByDownloadProgressAscending);
-      downloaderPlayers.insert(pos, user);
+      downloaderPlayers.push_back(user);
       downloadersCountByGame.insert(game);
       ++downloadersCount;
     }
@@ -761,15 +704,45 @@ void CNet::UpdateMapTransfers()
         continue;
       }
       if (downloadersCount >= m_Config.m_MaxDownloaders) continue;
-      // Sort to avoid cache deoptimization
-      auto pos = lower_bound(downloaderObservers.begin(), downloaderObservers.end(), observer, &CAsyncObserver::SortObserversByDownloadProgressAscending);
-      downloaderObservers.insert(pos, observer);
+      downloaderObservers.push_back(observer);
       downloadersCountByGame.insert(observer->GetGame());
       ++downloadersCount;
     }
   }
 
+  // Sort to avoid cache deoptimization
+  sort(downloaderPlayers.begin(), downloaderPlayers.end(), &GameUser::SortUsersByDownloadProgressAscending);
+  sort(downloaderObservers.begin(), downloaderObservers.end(), &CAsyncObserver::SortObserversByDownloadProgressAscending);
+
+  // Players are added first, then observers, so that flow indices follow both lists.
+  m_MapUploadScheduler.Clear();
+  m_MapUploadScheduler.m_MaxInFlight = MAP_PART_SIZE * m_Config.m_MaxParallelMapPackets;
+  for (const auto& user : downloaderPlayers) {
+    CStreamIOSocket* socket = user->GetSocket();
+    m_MapUploadScheduler.Add(
+      &user->GetMapTransfer(),
+      user->GetIsObserver() ? MAP_UPLOAD_WEIGHT_OBSERVER : MAP_UPLOAD_WEIGHT_PLAYER,
+      user->GetGame()->GetMap()->GetMapSize(),
+      socket ? socket->GetSendBufferSize() : 0,
+      socket ? socket->GetRTT() : nullopt
+    );
+  }
+  for (const auto& observer : downloaderObservers) {
+    CStreamIOSocket* socket = observer->GetSocket();
+    m_MapUploadScheduler.Add(
+      &observer->GetMapTransfer(),
+      MAP_UPLOAD_WEIGHT_OBSERVER,
+      observer->GetGame()->GetMap()->GetMapSize(),
+      socket ? socket->GetSendBufferSize() : 0,
+      socket ? socket->GetRTT() : nullopt
+    );
+  }
+  // <hosting.map_transfers.max_speed> is a budget per 100 ms cycle
+  m_MapUploadScheduler.Schedule(Ticks, static_cast<uint64_t>(m_Config.m_MaxUploadSpeed) * 100);
+
+  size_t flowIndex = 0;
   for (const auto& user : downloaderPlayers) {
+    const uint32_t grant = m_MapUploadScheduler.GetGrant(flowIndex++);
     shared_ptr<CGame> game = user->GetGame();
     if (!game->GetMap()->GetMapFileIsValid()) {
       user->AddKickReason(GameUser::KickReason::MAP_MISSING);
@@ -781,7 +754,7 @@ void CNet::UpdateMapTransfers()
     }
 
     bool mapIsInvalid = false;
-    const uint8_t sendResult = user->NextSendMap();
+    const uint8_t sendResult = user->NextSendMap(grant);
     switch (sendResult) {
       case MAP_TRANSFER_IN_PROGRESS:
       case MAP_TRANSFER_DONE:
@@ -805,6 +778,7 @@ void CNet::UpdateMapTransfers()
   }
 
   for (const auto& user : downloaderObservers) {
+    const uint32_t grant = m_MapUploadScheduler.GetGrant(flowIndex++);
     shared_ptr<CGame> game = user->GetGame();
     if (!game->GetMap()->GetMapFileIsValid()) {
       if (!user->HasLeftReason()) {
@@ -815,7 +789,7 @@ void CNet::UpdateMapTransfers()
     }
 
     bool mapIsInvalid = false;
-    const uint8_t sendResult = user->NextSendMap();
+    const uint8_t sendResult = user->NextSendMap(grant);
     switch (sendResult) {
       case MAP_TRANSFER_IN_PROGRESS:
       case MAP_TRANSFER_DONE:
@@ -1550,12 +1524,14 @@ bool CNet::QueryIPAddress()
         string hostName = get<1>(parsedURL.value());
         uint16_t port = get<2>(parsedURL.value());
         string path = get<3>(parsedURL.value());
-        sockaddr_storage resolvedAddress;
-        if (ResolveHostName(resolvedAddress, ACCEPT_IPV4, hostName, port)) {
-          CIPAddressAPIConnection* client = new CIPAddressAPIConnection(m_Aura, resolvedAddress, path, hostName);
+        ++m_IPAddressFetchResolving;
+        m_IPAddressFetchInProgress = true;
+        ResolveHostNameAsync(AF_INET, hostName, port, [this, path, hostName](const optional<sockaddr_storage>& resolvedAddress) {
+          if (m_IPAddressFetchResolving > 0) --m_IPAddressFetchResolving;
+          if (!resolvedAddress.has_value() || !m_IPAddressFetchInProgress) return;
+          CIPAddressAPIConnection* client = new CIPAddressAPIConnection(m_Aura, resolvedAddress.value(), path, hostName);
           m_IPAddressFetchClients.push_back(client);
-          m_IPAddressFetchInProgress = true;
-        }
+        });
       }
     }
   }
@@ -1570,12 +1546,14 @@ bool CNet::QueryIPAddress()
         string hostName = get<1>(parsedURL.value());
         uint16_t port = get<2>(parsedURL.value());
         string path = get<3>(parsedURL.value());
-        sockaddr_storage resolvedAddress;
-        if (ResolveHostName(resolvedAddress, ACCEPT_IPV6, hostName, port)) {
-          CIPAddressAPIConnection* client = new CIPAddressAPIConnection(m_Aura, resolvedAddress, path, hostName);
+        ++m_IPAddressFetchResolving;
+        m_IPAddressFetchInProgress = true;
+        ResolveHostNameAsync(AF_INET6, hostName, port, [this, path, hostName](const optional<sockaddr_storage>& resolvedAddress) {
+          if (m_IPAddressFetchResolving > 0) --m_IPAddressFetchResolving;
+          if (!resolvedAddress.has_value() || !m_IPAddressFetchInProgress) return;
+          CIPAddressAPIConnection* client = new CIPAddressAPIConnection(m_Aura, resolvedAddress.value(), path, hostName);
           m_IPAddressFetchClients.push_back(client);
-          m_IPAddressFetchInProgress = true;
-        }
+        });
       }
     }
   }
@@ -1597,6 +1575,7 @@ void CNet::ResetIPAddressFetch()
   }
   m_IPAddressFetchClients.clear();
   m_IPAddressFetchInProgress = false;
+  m_IPAddressFetchResolving = 0;
 }
 
 void CNet::HandleIPAddressFetchDone()
@@ -1683,32 +1662,41 @@ void CNet::MergeDownGradedConnections()
   }
 }
 
-void CNet::UpdateSelectBlockTime(int64_t& usecBlockTime) const
+void CNet::ScheduleDNSPollTimer()
 {
-  if (usecBlockTime == 0) {
+  if (!m_DNSResolver.GetHasPending()) {
+    m_Aura->m_Timers.Cancel(m_DNSPollTimer);
     return;
   }
+  if (!m_Aura->m_Timers.GetIsScheduled(m_DNSPollTimer)) {
+    m_DNSPollTimer = m_Aura->m_Timers.Schedule(GetTicks() + DNS_RESOLVER_POLL_TICKS, nullptr);
+  }
+}
 
-  const int64_t ticks = GetTicks();
-  int64_t byTicks = APP_MAX_TICKS;
-  for (const auto& serverConnections : m_GameObservers) {
-    for (const auto& connection : serverConnections.second) {
-      const int64_t thisByTicks = connection->GetNextTimedActionByTicks();
-      if (thisByTicks <= ticks) {
-        usecBlockTime = 0;
-        return;
-      }
-      if (thisByTicks < byTicks) {
-        byTicks = thisByTicks;
-      }
-    }
+void CNet::RunPollResumeTimer()
+{
+  for (const auto& entry : m_GameServers) {
+    if (entry.second) entry.second->ResumePolling();
   }
-  if (byTicks != APP_MAX_TICKS) { // avoid overflow
-    int64_t maybeBlockTime = (byTicks - ticks) * 1000;
-    if (maybeBlockTime < usecBlockTime) {
-      usecBlockTime = maybeBlockTime;
+  if (m_UDPMainServer) m_UDPMainServer->ResumePolling();
+  if (m_UDPDeafSocket) m_UDPDeafSocket->ResumePolling();
+}
+
+void CNet::SchedulePollResumeTimer()
+{
+  if (m_Aura->m_Timers.GetIsScheduled(m_PollResumeTimer)) {
+    return;
+  }
+  bool anyPaused = (m_UDPMainServer && m_UDPMainServer->GetIsPollPaused()) || (m_UDPDeafSocket && m_UDPDeafSocket->GetIsPollPaused());
+  for (const auto& entry : m_GameServers) {
+    if (entry.second && entry.second->GetIsPollPaused()) {
+      anyPaused = true;
+      break;
     }
   }
+  if (anyPaused) {
+    m_PollResumeTimer = m_Aura->m_Timers.Schedule(GetTicks() + SOCKET_POLL_RESUME_TICKS, [this]() { RunPollResumeTimer(); });
+  }
 }
 
 vector<uint16_t> CNet::GetPotentialGamePorts() const
@@ -1787,70 +1775,48 @@ optional<sockaddr_storage> CNet::ParseAddress(const string& address, const uint8
   return result;
 }
 
-bool CNet::ResolveHostNameInner(sockaddr_storage& address, const string& hostName, const uint16_t port, const uint8_t family, map<string, sockaddr_storage*>& cache)
+DNSStatus CNet::ResolveHostName(sockaddr_storage& address, const uint8_t acceptFamily, const string& hostName, const uint16_t port)
 {
-  auto it = cache.find(hostName);
-  if (it != end(cache)) {
-    // Output to address argument
-    memset(&address, 0, sizeof(sockaddr_storage));
-    memcpy(&address, it->second, sizeof(sockaddr_storage));
+  optional<sockaddr_storage> parseResult = ParseAddress(hostName, acceptFamily);
+  if (parseResult.has_value()) {
+    memcpy(&address, &(parseResult.value()), sizeof(sockaddr_storage));
     SetAddressPort(&address, port);
-    return true;
+    return DNSStatus::kResolved;
   }
 
-  struct addrinfo hints, *p;
-  int status;
-
-  memset(&hints, 0, sizeof hints);
-  hints.ai_family = family;
-  hints.ai_socktype = SOCK_STREAM;
-
-  if ((status = getaddrinfo(hostName.c_str(), nullptr, &hints, &p)) != 0) {
-#ifdef _WIN32
-    Print("[DNS] cannot resolve address for " + hostName + " - error " + to_string(status));
-#else
-    Print("[DNS] cannot resolve address for " + hostName + gai_strerror(status));
-#endif
-    Print("[DNS] warning - check your Internet connection");
-    return false;
+  // IPv6 is only queried once IPv4 is known to fail
+  DNSStatus status = DNSStatus::kFailed;
+  if (0 != (acceptFamily & ACCEPT_IPV4)) {
+    status = m_DNSResolver.Lookup(hostName, AF_INET, address);
   }
-  
-  if (p == nullptr) {
-    return false;
+  if (status == DNSStatus::kFailed && 0 != (acceptFamily & ACCEPT_IPV6)) {
+    status = m_DNSResolver.Lookup(hostName, AF_INET6, address);
   }
-
-  // Save to cache
-  sockaddr_storage* cacheAddress = new sockaddr_storage();
-  memcpy(cacheAddress, reinterpret_cast<sockaddr_storage*>(p->ai_addr), sizeof(sockaddr_storage));
-  SetAddressPort(cacheAddress, port);
-  cache[hostName] = cacheAddress;
-
-  // Output to address argument
-  memcpy(&address, cacheAddress, sizeof(sockaddr_storage));
-
-  freeaddrinfo(p);
-  return true;
+  if (status == DNSStatus::kResolved) {
+    SetAddressPort(&address, port);
+  }
+  ScheduleDNSPollTimer();
+  return status;
 }
 
-bool CNet::ResolveHostName(sockaddr_storage& address, const uint8_t acceptFamily, const string& hostName, const uint16_t port)
+void CNet::ResolveHostNameAsync(const int family, const string& hostName, const uint16_t port, DNSCallback callback)
 {
-  optional<sockaddr_storage> parseResult = ParseAddress(hostName, acceptFamily);
+  optional<sockaddr_storage> parseResult = ParseAddress(hostName, family == AF_INET6 ? ACCEPT_IPV6 : ACCEPT_IPV4);
   if (parseResult.has_value()) {
-    memcpy(&address, &(parseResult.value()), sizeof(sockaddr_storage));
-    SetAddressPort(&address, port);
-    return true;
-  }
-  if (0 != (acceptFamily & ACCEPT_IPV4)) {
-    if (ResolveHostNameInner(address, hostName, port, AF_INET, m_IPv4DNSCache)) {
-      return true;
-    }
+    SetAddressPort(&(parseResult.value()), port);
+    callback(parseResult);
+    return;
   }
-  if (0 != (acceptFamily & ACCEPT_IPV6)) {
-    if (ResolveHostNameInner(address, hostName, port, AF_INET6, m_IPv6DNSCache)) {
-      return true;
+  m_DNSResolver.Query(hostName, family, [port, callback = move(callback)](const optional<sockaddr_storage>& address) {
+    if (!address.has_value()) {
+      callback(address);
+      return;
     }
-  }
-  return false;
+    sockaddr_storage portAddress = address.value();
+    SetAddressPort(&portAddress, port);
+    callback(portAddress);
+  });
+  ScheduleDNSPollTimer();
 }
 
 shared_ptr<CTCPServer> CNet::GetOrCreateTCPServer(uint16_t inputPort, const string& name)
@@ -1886,20 +1852,7 @@ void CNet::FlushDNSCache()
   if (m_Aura->MatchLogLevel(LogLevel::kDebug)) {
     Print("[NET] Flushing DNS cache");
   }
-  for (auto& entry : m_IPv4DNSCache) {
-    if (entry.second != nullptr) {
-      delete entry.second;
-      entry.second = nullptr;
-    }
-  }
-  for (auto& entry : m_IPv6DNSCache) {
-    if (entry.second != nullptr) {
-      delete entry.second;
-      entry.second = nullptr;
-    }
-  }
-  m_IPv4DNSCache.clear();
-  m_IPv6DNSCache.clear();
+  m_DNSResolver.Flush();
 }
 
 void CNet::FlushSelfIPCache()
@@ -2111,6 +2064,8 @@ CNet::~CNet()
     Print("[NET] shutting down");
   }
 
+  m_Aura->m_Timers.Cancel(m_PollResumeTimer);
+
   delete m_UDPMainServer;
   delete m_UDPDeafSocket;
   delete m_UDPIPv6Server;
@@ -28,7 +28,10 @@
 
 #include "includes.h"
 #include "socket.h"
+#include "dns_resolver.h"
+#include "timer_queue.h"
 #include "mdns.h"
+#include "map_upload_scheduler.h"
 #include "config/config_net.h"
 
 #pragma once
@@ -43,8 +46,7 @@ public:
   CGameTestConnection(CAura* nAura, std::shared_ptr<CRealm> nRealm, sockaddr_storage nTargetHost, const uint32_t nBaseHostCounter, const uint8_t nType, const std::string& nName);
   ~CGameTestConnection();
 
-  [[nodiscard]] uint32_t  SetFD(fd_set* fd, fd_set* send_fd, int32_t* nfds) const;
-  [[nodiscard]] bool      Update(fd_set* fd, fd_set* send_fd);
+  [[nodiscard]] bool      Update();
   [[nodiscard]] bool      QueryGameInfo();
   [[nodiscard]] bool      GetIsRealmOnline() const;
   [[nodiscard]] bool      GetIsRealmListed() const;
@@ -71,8 +73,7 @@ public:
   CIPAddressAPIConnection(CAura* nAura, const sockaddr_storage& nTargetHost, const std::string& nEndPoint, const std::string& nHostName);
   ~CIPAddressAPIConnection();
 
-  [[nodiscard]] uint32_t  SetFD(fd_set* fd, fd_set* send_fd, int32_t* nfds);
-  [[nodiscard]] bool      Update(fd_set* fd, fd_set* send_fd);
+  [[nodiscard]] bool      Update();
   bool                    QueryIPAddress();
 
   sockaddr_storage                  m_TargetHost;
@@ -131,8 +132,9 @@ public:
   std::queue<std::pair<uint16_t, CConnection*>>               m_DownGradedConnections;      // connections that are waiting for insertion into m_IncomingConnections, built from a stale CStreamIOSocket
   std::map<std::pair<uint16_t, uint16_t>, TimedUint8>         m_UPnPTCPCache;
   std::map<std::pair<uint16_t, uint16_t>, TimedUint8>         m_UPnPUDPCache;
-  std::map<std::string, sockaddr_storage*>                    m_IPv4DNSCache;
-  std::map<std::string, sockaddr_storage*>                    m_IPv6DNSCache;
+  CDNSResolver                                                m_DNSResolver;
+  TimerId                                                     m_DNSPollTimer;               // resolver threads can't wake up the poller, so check back on them soon
+  TimerId                                                     m_PollResumeTimer;            // listening sockets that ran out of descriptors or buffers are retried later
   std::pair<std::string, sockaddr_storage*>                   m_IPv4SelfCacheV;
   uint8_t                                                     m_IPv4SelfCacheT;
   std::pair<std::string, sockaddr_storage*>                   m_IPv6SelfCacheV;
@@ -146,17 +148,18 @@ public:
   bool                                                        m_HealthCheckInProgress;
   std::shared_ptr<CCommandContext>                            m_HealthCheckContext;
   bool                                                        m_IPAddressFetchInProgress;
+  uint8_t                                                     m_IPAddressFetchResolving;
   uint16_t                                                    m_LastHostPort;               // the port of the last hosted game
 
   int64_t                                                     m_LastDownloadTicks;             // GetTicks when the last map download cycle was performed
   uint64_t                                                    m_TransferredMapBytesThisUpdate;
+  CMapUploadScheduler                                         m_MapUploadScheduler;
 
   void InitPersistentConfig();
   bool Init();
-  [[nodiscard]] uint32_t SetFD(fd_set* fd, fd_set* send_fd, int32_t* nfds);
 
-  void UpdateBeforeGames(fd_set* fd, fd_set* send_fd);
-  void UpdateAfterGames(fd_set* fd, fd_set* send_fd);
+  void UpdateBeforeGames();
+  void UpdateAfterGames();
   void UpdateMapTransfers();
 
   bool SendBroadcast(const std::vector<uint8_t>& packet);
@@ -175,8 +178,8 @@ public:
   [[nodiscard]] std::vector<uint16_t>           GetPotentialGamePorts() const;
   [[nodiscard]] uint16_t                        GetUDPPort(const uint8_t protocol) const;
 
-  bool                                          ResolveHostName(sockaddr_storage& address, const uint8_t nAcceptFamily, const std::string& hostName, const uint16_t port);
-  bool                                          ResolveHostNameInner(sockaddr_storage& address, const std::string& hostName, const uint16_t port, const uint8_t nFamily, std::map<std::string, sockaddr_storage*>&);
+  [[nodiscard]] DNSStatus                       ResolveHostName(sockaddr_storage& address, const uint8_t nAcceptFamily, const std::string& hostName, const uint16_t port);
+  void                                          ResolveHostNameAsync(const int family, const std::string& hostName, const uint16_t port, DNSCallback callback);
   [[nodiscard]] std::shared_ptr<CTCPServer>     GetOrCreateTCPServer(uint16_t, const std::string& name);
   void                                          FlushDNSCache();
   void                                          FlushSelfIPCache();
@@ -204,7 +207,9 @@ public:
   uint16_t NextHostPort();
   void     MergeDownGradedConnections();
 
-  void UpdateSelectBlockTime(int64_t& usecBlockTime) const;
+  void ScheduleDNSPollTimer();
+  void RunPollResumeTimer();
+  void SchedulePollResumeTimer();
 
   [[nodiscard]] static std::optional<std::tuple<std::string, std::string, uint16_t, std::string>> ParseURL(const std::string& address);
   [[nodiscard]] static std::optional<sockaddr_storage> ParseAddress(const std::string& address, const uint8_t inputMode = ACCEPT_ANY);
@@ -25,9 +25,15 @@
 
 #include "pjass.h"
 
+#include <mutex>
+
 using namespace std;
 
 #ifndef DISABLE_PJASS
+
+// pjass keeps its parser state and symbol tables in globals, and maps may be loaded from several threads
+static mutex pjassMutex;
+
 pair<bool, string> ParseJASSFiles(const vector<filesystem::path>& filePaths, const bitset<11> flags)
 {
   const static vector<string> pjassAvailableFlags = {
@@ -67,7 +73,10 @@ pair<bool, string> ParseJASSFiles(const vector<filesystem::path>& filePaths, con
     filePtrs.push_back(filePathsInner.back().c_str());
   }
 
-  result = parse_jass_custom_r(buffer, maxOutSize, &outSize, fileCount, filePtrs.data()) == 0;
+  {
+    lock_guard<mutex> lock(pjassMutex);
+    result = parse_jass_custom_r(buffer, maxOutSize, &outSize, fileCount, filePtrs.data()) == 0;
+  }
   if (result) {
     return make_pair(result, details);
   }
@@ -161,7 +170,10 @@ pair<bool, string> ParseJASS(string commonJ, string blizzardJ, string war3mapJ,
   char* targets[] = {commonJ.data(), blizzardJ.data(), war3mapJ.data()};
   char* fixedFlags[] = {flagString.data(), flagString.data(), flagString.data()};
 
-  result = parse_jass_custom(buffer, maxOutSize, &outSize, 3, bufferSizes, targets, fixedFlags) == 0;
+  {
+    lock_guard<mutex> lock(pjassMutex);
+    result = parse_jass_custom(buffer, maxOutSize, &outSize, 3, bufferSizes, targets, fixedFlags) == 0;
+  }
   //result = parse_jass_custom(buffer, maxOutSize, &outSize, 1, bufferSizes + 2, targets + 2, fixedFlags + 2) == 0;
   //result = parse_jass_triad(buffer, maxOutSize, &outSize, commonJ.data(), commonJ.size(), blizzardJ.data(), blizzardJ.size(), war3mapJ.data(), war3mapJ.size()) == 0;
   //result = parse_jass(buffer, maxOutSize, &outSize, war3mapJ.data(), war3mapJ.size()) == 0;
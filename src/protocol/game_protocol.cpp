@@ -210,8 +210,9 @@ namespace GameProtocol
   template size_t GetPacketCount<GameProtocol::FragmentPolicy::kIgnore>(const std::vector<uint8_t>& data);
   template size_t GetPacketCount<GameProtocol::FragmentPolicy::kAccept>(const std::vector<uint8_t>& data);
 
-  PacketWrapper::PacketWrapper(const std::vector<uint8_t>& nData, const size_t nCount)
+  PacketWrapper::PacketWrapper(const SharedPacket& nData, const size_t nCount)
   : count(nCount),
+    offset(0),
     data(nData)
   {
   };
@@ -222,23 +223,24 @@ namespace GameProtocol
 
   void PacketWrapper::Remove(size_t removeCount)
   {
-    size_t cursor = 0;
+    // the bytes are shared with other buffers, so just skip past the removed packets
+    const std::vector<uint8_t>& bytes = *data;
     removeCount = min(removeCount, count);
-    while (0 < removeCount && cursor + 4 <= data.size()) {
-      assert((data[cursor] == GameProtocol::Magic::W3GS_HEADER) && "PacketWrapper should only contain W3GS packets.");
-      size_t thisSize = ByteArrayToUInt16(data, false, cursor + 2);
+    count -= removeCount;
+    while (0 < removeCount && offset + 4 <= bytes.size()) {
+      assert((bytes[offset] == GameProtocol::Magic::W3GS_HEADER) && "PacketWrapper should only contain W3GS packets.");
+      size_t thisSize = ByteArrayToUInt16(bytes, false, offset + 2);
       assert(thisSize >= 4 && "PacketWrapper should only contain valid-sized W3GS packets.");
-      cursor += thisSize;
+      offset += thisSize;
       --removeCount;
     }
-    data.erase(data.begin(), data.begin() + cursor);
   }
 
   ///////////////////////
   // RECEIVE FUNCTIONS //
   ///////////////////////
 
-  CIncomingJoinRequest RECEIVE_W3GS_REQJOIN(const std::vector<uint8_t>& data)
+  CIncomingJoinRequest RECEIVE_W3GS_REQJOIN(const PacketView& data)
   {
     // DEBUG_Print( "RECEIVED W3GS_REQJOIN" );
     // DEBUG_Print( data );
@@ -255,22 +257,22 @@ namespace GameProtocol
     // 2 bytes                    -> InternalPort (???)
     // 4 bytes                    -> InternalIP
 
-    if (ValidateLength(data) && data.size() >= 20) {
-      const uint32_t             HostCounter = ByteArrayToUInt32(data, false, 4);
-      const uint32_t             EntryKey    = ByteArrayToUInt32(data, false, 8);
-      const std::vector<uint8_t> RawName     = ExtractCString(data, 19);
+    if (data.GetIsValidLength() && data.size() >= 20) {
+      const uint32_t             HostCounter = data.GetUInt32(4);
+      const uint32_t             EntryKey    = data.GetUInt32(8);
+      string                     Name        = data.GetCString(19);
 
-      if (!RawName.empty() && data.size() >= RawName.size() + 30) {
+      if (!Name.empty() && data.size() >= Name.size() + 30) {
         std::array<uint8_t, 4> InternalIP = {0, 0, 0, 0};
-        copy_n(data.begin() + RawName.size() + 26, 4, InternalIP.begin());
-        return CIncomingJoinRequest(HostCounter, EntryKey, string(begin(RawName), end(RawName)), InternalIP);
+        copy_n(data.begin() + Name.size() + 26, 4, InternalIP.begin());
+        return CIncomingJoinRequest(HostCounter, EntryKey, move(Name), InternalIP);
       }
     }
 
     return CIncomingJoinRequest();
   }
 
-  uint32_t RECEIVE_W3GS_LEAVEGAME(const std::vector<uint8_t>& data)
+  uint32_t RECEIVE_W3GS_LEAVEGAME(const PacketView& data)
   {
     // DEBUG_Print( "RECEIVED W3GS_LEAVEGAME" );
     // DEBUG_Print( data );
@@ -279,13 +281,13 @@ namespace GameProtocol
     // 2 bytes					-> Length
     // 4 bytes					-> Reason
 
-    if (ValidateLength(data) && data.size() >= 8)
-      return ByteArrayToUInt32(data, false, 4);                     
+    if (data.GetIsValidLength() && data.size() >= 8)
+      return data.GetUInt32(4);
 
     return 0;
   }
 
-  bool RECEIVE_W3GS_GAMELOADED_SELF(const std::vector<uint8_t>& data)
+  bool RECEIVE_W3GS_GAMELOADED_SELF(const PacketView& data)
   {
     // DEBUG_Print( "RECEIVED W3GS_GAMELOADED_SELF" );
     // DEBUG_Print( data );
@@ -293,13 +295,10 @@ namespace GameProtocol
     // 2 bytes					-> Header
     // 2 bytes					-> Length
 
-    if (ValidateLength(data))
-      return true;
-
-    return false;
+    return data.GetIsValidLength();
   }
 
-  CIncomingAction RECEIVE_W3GS_OUTGOING_ACTION(const std::vector<uint8_t>& data, uint8_t UID)
+  CIncomingAction RECEIVE_W3GS_OUTGOING_ACTION(const PacketView& data, uint8_t UID)
   {
     // DEBUG_Print( "RECEIVED W3GS_OUTGOING_ACTION" );
     // DEBUG_Print( data );
@@ -311,11 +310,11 @@ namespace GameProtocol
 
     /*const std::array<uint8_t, 4> CRC;
     copy_n(data.begin() + 4, 4, CRC.begin());*/
-    std::vector<uint8_t> action = std::vector<uint8_t>(begin(data) + 8, end(data));
+    std::vector<uint8_t> action = std::vector<uint8_t>(data.begin() + 8, data.end());
     return CIncomingAction(UID, action);
   }
 
-  uint32_t RECEIVE_W3GS_OUTGOING_KEEPALIVE(const std::vector<uint8_t>& data)
+  uint32_t RECEIVE_W3GS_OUTGOING_KEEPALIVE(const PacketView& data)
   {
     // DEBUG_Print( "RECEIVED W3GS_OUTGOING_KEEPALIVE" );
     // DEBUG_Print( data );
@@ -325,13 +324,13 @@ namespace GameProtocol
     // 1 byte           -> ???
     // 4 bytes					-> CheckSum
 
-    if (ValidateLength(data) && data.size() == 9)
-      return ByteArrayToUInt32(data, false, 5);
+    if (data.GetIsValidLength() && data.size() == 9)
+      return data.GetUInt32(5);
 
     return 0;
   }
 
-  CIncomingChatMessage RECEIVE_W3GS_CHAT_TO_HOST(const std::vector<uint8_t>& data)
+  CIncomingChatMessage RECEIVE_W3GS_CHAT_TO_HOST(const PacketView& data)
   {
     // DEBUG_Print( "RECEIVED W3GS_CHAT_TO_HOST" );
     // DEBUG_Print( data );
@@ -357,14 +356,14 @@ namespace GameProtocol
     //		4 bytes           -> ExtraFlags
     //		null term string	-> Message
 
-    if (ValidateLength(data))
+    if (data.GetIsValidLength())
     {
       uint32_t      i     = 5;
       const uint8_t Total = data[4];
 
       if (Total > 0 && data.size() >= i + Total)
       {
-        const std::vector<uint8_t> ToUIDs = std::vector<uint8_t>(begin(data) + i, begin(data) + i + Total);
+        const std::vector<uint8_t> ToUIDs = std::vector<uint8_t>(data.begin() + i, data.begin() + i + Total);
         i += Total;
         const uint8_t FromUID = data[i];
         const uint8_t Flag    = data[i + 1];
@@ -373,8 +372,7 @@ namespace GameProtocol
         if (Flag == GameProtocol::Magic::ChatType::CHAT_LOBBY && data.size() >= i + 1) { // 16
           // chat message
 
-          const std::vector<uint8_t> Message = ExtractCString(data, i);
-          return CIncomingChatMessage(FromUID, ToUIDs, Flag, string(begin(Message), end(Message)));
+          return CIncomingChatMessage(FromUID, ToUIDs, Flag, data.GetCString(i));
         } else if ((Flag >= GameProtocol::Magic::ChatType::REQUEST_TEAM && Flag <= GameProtocol::Magic::ChatType::REQUEST_HANDICAP) && data.size() >= i + 1) { // 17-20
           // team/colour/race/handicap change request 
 
@@ -383,9 +381,8 @@ namespace GameProtocol
         } else if (Flag == GameProtocol::Magic::ChatType::CHAT_IN_GAME && data.size() >= i + 5) { // 32
           // chat message with extra flags
 
-          const uint32_t ExtraFlags = ByteArrayToUInt32(data, false, i);
-          const std::vector<uint8_t> Message = ExtractCString(data, i + 4);
-          return CIncomingChatMessage(FromUID, ToUIDs, Flag, string(begin(Message), end(Message)), ExtraFlags);
+          const uint32_t ExtraFlags = data.GetUInt32(i);
+          return CIncomingChatMessage(FromUID, ToUIDs, Flag, data.GetCString(i + 4), ExtraFlags);
         }
       }
     }
@@ -393,7 +390,7 @@ namespace GameProtocol
     return CIncomingChatMessage();
   }
 
-  CIncomingMapFileSize RECEIVE_W3GS_MAPSIZE(const std::vector<uint8_t>& data)
+  CIncomingMapFileSize RECEIVE_W3GS_MAPSIZE(const PacketView& data)
   {
     // DEBUG_Print( "RECEIVED W3GS_MAPSIZE" );
     // DEBUG_Print( data );
@@ -404,13 +401,13 @@ namespace GameProtocol
     // 1 byte           -> SizeFlag (1 = have map, 3 = continue download)
     // 4 bytes					-> MapSize
 
-    if (ValidateLength(data) && data.size() >= 13)
-      return CIncomingMapFileSize(data[8], ByteArrayToUInt32(data, false, 9));
+    if (data.GetIsValidLength() && data.size() >= 13)
+      return CIncomingMapFileSize(data[8], data.GetUInt32(9));
 
     return CIncomingMapFileSize();
   }
 
-  uint32_t RECEIVE_W3GS_PONG_TO_HOST(const std::vector<uint8_t>& data)
+  uint32_t RECEIVE_W3GS_PONG_TO_HOST(const PacketView& data)
   {
     // DEBUG_Print( "RECEIVED W3GS_PONG_TO_HOST" );
     // DEBUG_Print( data );
@@ -423,8 +420,8 @@ namespace GameProtocol
     // so as long as we trust that the client isn't trying to fake us out and mess with the pong value we can find the round trip time by simple subtraction
     // (the subtraction is done elsewhere because the very first pong value seems to be 1 and we want to discard that one)
 
-    if (ValidateLength(data) && data.size() >= 8)
-      return ByteArrayToUInt32(data, false, 4);
+    if (data.GetIsValidLength() && data.size() >= 8)
+      return data.GetUInt32(4);
 
     return 1;
   }
@@ -619,7 +616,7 @@ namespace GameProtocol
       }
 
       // calculate crc (we only care about the lower 2 bytes though)
-      uint32_t crc32 = CRC32::CalculateCRC((uint8_t*)string(begin(subpacket), end(subpacket)).c_str(), subpacket.size());
+      uint32_t crc32 = CRC32::CalculateCRC(subpacket.data(), subpacket.size());
 
       // finish subpacket
       AppendByteArray(packet, static_cast<uint16_t>(crc32 & 0xFFFF), false);      // crc
@@ -877,6 +874,20 @@ namespace GameProtocol
     return std::vector<uint8_t>{GameProtocol::Magic::W3GS_HEADER, GameProtocol::Magic::STARTDOWNLOAD, 9, 0, 1, 0, 0, 0, fromUID};
   }
 
+  std::vector<uint8_t> SEND_W3GS_MAPPART_HEADER(uint8_t fromUID, uint8_t toUID, size_t start_abs /* offset in map file */, const uint8_t* data, size_t size)
+  {
+    // the map data itself is not included, so that callers may send it straight from the map cache
+    std::vector<uint8_t> header = {GameProtocol::Magic::W3GS_HEADER, GameProtocol::Magic::MAPPART, 0, 0, toUID, fromUID, 1, 0, 0, 0}; // 10 bytes
+    header.reserve(18);
+    AppendByteArray(header, static_cast<uint32_t>(start_abs), false); // start position, 4 bytes
+    AppendByteArray(header, CRC32::CalculateCRC(data, static_cast<uint32_t>(size)), false); // crc, 4 bytes
+
+    const uint16_t length = static_cast<uint16_t>(header.size() + size);
+    header[2] = static_cast<uint8_t>(length);
+    header[3] = static_cast<uint8_t>(length >> 8);
+    return header;
+  }
+
   std::vector<uint8_t> SEND_W3GS_MAPPART(uint8_t fromUID, uint8_t toUID, size_t start_abs /* offset in map file */, const FileChunkTransient& mapFileChunk)
   {
     if (mapFileChunk.start > start_abs || !mapFileChunk.bytes) {
@@ -905,19 +916,11 @@ namespace GameProtocol
     size_t start_rel = start_abs - mapFileChunk.start;
     size_t end_rel = end_abs - mapFileChunk.start;
 
-    std::vector<uint8_t> packet = {GameProtocol::Magic::W3GS_HEADER, GameProtocol::Magic::MAPPART, 0, 0, toUID, fromUID, 1, 0, 0, 0}; // 10 bytes
-    AppendByteArray(packet, static_cast<uint32_t>(start_abs), false); // start position, 4 bytes
-
-    // calculate crc
-
-    const std::vector<uint8_t> crc32 = CreateByteArray(CRC32::CalculateCRC(mapFileChunk.bytes->data() + start_rel, (uint32_t)(end_rel - start_rel)), false);
-    AppendByteArrayFast(packet, crc32);
+    std::vector<uint8_t> packet = SEND_W3GS_MAPPART_HEADER(fromUID, toUID, start_abs, mapFileChunk.bytes->data() + start_rel, end_rel - start_rel);
 
     // map data
 
-    const std::vector<uint8_t> data = CreateByteArray(mapFileChunk.bytes->data() + start_rel, (uint32_t)(end_rel - start_rel));
-    AppendByteArrayFast(packet, data);
-    AssignLength(packet);
+    AppendByteArray(packet, mapFileChunk.bytes->data() + start_rel, end_rel - start_rel);
     return packet;
   }
 
@@ -969,7 +972,7 @@ namespace GameProtocol
       }
 
       // calculate crc (we only care about the lower 2 bytes though)
-      uint32_t crc32 = CRC32::CalculateCRC((uint8_t*)string(begin(subpacket), end(subpacket)).c_str(), subpacket.size());
+      uint32_t crc32 = CRC32::CalculateCRC(subpacket.data(), subpacket.size());
 
       // finish subpacket
       AppendByteArray(packet, static_cast<uint16_t>(crc32 & 0xFFFF), false);      // crc
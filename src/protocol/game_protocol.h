@@ -49,6 +49,7 @@
 #include "../includes.h"
 #include "../game_slot.h"
 #include "../util.h"
+#include "packet_view.h"
 
 namespace GameProtocol
 {
@@ -150,25 +151,28 @@ namespace GameProtocol
   struct PacketWrapper
   {
     size_t count;
-    std::vector<uint8_t> data;
+    size_t offset;
+    SharedPacket data;
 
-    PacketWrapper(const std::vector<uint8_t>& nData, const size_t nCount);
+    PacketWrapper(const SharedPacket& nData, const size_t nCount);
     ~PacketWrapper();
 
     void Remove(size_t count);
     [[nodiscard]] inline bool GetIsEmpty() const { return count == 0; }
+    [[nodiscard]] inline const uint8_t* GetData() const { return data->data() + offset; }
+    [[nodiscard]] inline size_t GetSize() const { return data->size() - offset; }
   };
 
   // receive functions
 
-  [[nodiscard]] CIncomingJoinRequest RECEIVE_W3GS_REQJOIN(const std::vector<uint8_t>& data);
-  [[nodiscard]] uint32_t RECEIVE_W3GS_LEAVEGAME(const std::vector<uint8_t>& data);
-  [[nodiscard]] bool RECEIVE_W3GS_GAMELOADED_SELF(const std::vector<uint8_t>& data);
-  [[nodiscard]] CIncomingAction RECEIVE_W3GS_OUTGOING_ACTION(const std::vector<uint8_t>& data, uint8_t UID);
-  [[nodiscard]] uint32_t RECEIVE_W3GS_OUTGOING_KEEPALIVE(const std::vector<uint8_t>& data);
-  [[nodiscard]] CIncomingChatMessage RECEIVE_W3GS_CHAT_TO_HOST(const std::vector<uint8_t>& data);
-  [[nodiscard]] CIncomingMapFileSize RECEIVE_W3GS_MAPSIZE(const std::vector<uint8_t>& data);
-  [[nodiscard]] uint32_t RECEIVE_W3GS_PONG_TO_HOST(const std::vector<uint8_t>& data);
+  [[nodiscard]] CIncomingJoinRequest RECEIVE_W3GS_REQJOIN(const PacketView& data);
+  [[nodiscard]] uint32_t RECEIVE_W3GS_LEAVEGAME(const PacketView& data);
+  [[nodiscard]] bool RECEIVE_W3GS_GAMELOADED_SELF(const PacketView& data);
+  [[nodiscard]] CIncomingAction RECEIVE_W3GS_OUTGOING_ACTION(const PacketView& data, uint8_t UID);
+  [[nodiscard]] uint32_t RECEIVE_W3GS_OUTGOING_KEEPALIVE(const PacketView& data);
+  [[nodiscard]] CIncomingChatMessage RECEIVE_W3GS_CHAT_TO_HOST(const PacketView& data);
+  [[nodiscard]] CIncomingMapFileSize RECEIVE_W3GS_MAPSIZE(const PacketView& data);
+  [[nodiscard]] uint32_t RECEIVE_W3GS_PONG_TO_HOST(const PacketView& data);
 
   // send functions
 
@@ -199,6 +203,7 @@ namespace GameProtocol
   [[nodiscard]] std::vector<uint8_t> SEND_W3GS_DECREATEGAME(const uint32_t hostCounter);
   [[nodiscard]] std::vector<uint8_t> SEND_W3GS_MAPCHECK(const std::string& mapPath, const uint32_t mapSize, const std::array<uint8_t, 4>& mapCRC32, const std::array<uint8_t, 4>& mapScriptsHashBlizz, const std::optional<std::array<uint8_t, 20>>& mapScriptsHashSHA1);
   [[nodiscard]] std::vector<uint8_t> SEND_W3GS_STARTDOWNLOAD(uint8_t fromUID);
+  [[nodiscard]] std::vector<uint8_t> SEND_W3GS_MAPPART_HEADER(uint8_t fromUID, uint8_t toUID, size_t start, const uint8_t* data, size_t size);
   [[nodiscard]] std::vector<uint8_t> SEND_W3GS_MAPPART(uint8_t fromUID, uint8_t toUID, size_t start, const FileChunkTransient& mapFileChunk);
   [[nodiscard]] std::vector<uint8_t> SEND_W3GS_MAPPART(uint8_t fromUID, uint8_t toUID, size_t start, const SharedByteArray& mapFileContents);
 
@@ -0,0 +1,160 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#ifndef AURA_PACKET_VIEW_H_
+#define AURA_PACKET_VIEW_H_
+
+#include "../includes.h"
+#include "../stream_buffer.h"
+
+#include <memory>
+
+//
+// SharedPacket
+//
+// Immutable packet bytes, encoded once and then referenced from as many send queues,
+// GProxy reconnect buffers and game history frames as needed, without further copies.
+//
+
+typedef std::shared_ptr<const std::vector<uint8_t>> SharedPacket;
+
+[[nodiscard]] inline SharedPacket MakeSharedPacket(std::vector<uint8_t>&& data)
+{
+  return std::make_shared<const std::vector<uint8_t>>(std::move(data));
+}
+
+[[nodiscard]] inline SharedPacket MakeSharedPacket(const std::vector<uint8_t>& data)
+{
+  return std::make_shared<const std::vector<uint8_t>>(data);
+}
+
+//
+// PacketView
+//
+// Non-owning view of a single length-prefixed packet (W3GS, GPS or BNCS):
+// 1 byte header, 1 byte packet ID, 2 bytes little-endian length, then the payload.
+// It's only valid until the buffer it points into is consumed or written to.
+//
+
+struct PacketView
+{
+  const uint8_t* m_Data;
+  size_t         m_Size;
+
+  PacketView()
+   : m_Data(nullptr),
+     m_Size(0)
+  {
+  }
+
+  PacketView(const uint8_t* nData, const size_t nSize)
+   : m_Data(nData),
+     m_Size(nSize)
+  {
+  }
+
+  explicit PacketView(const std::vector<uint8_t>& nData)
+   : m_Data(nData.data()),
+     m_Size(nData.size())
+  {
+  }
+
+  [[nodiscard]] inline const uint8_t*       data() const { return m_Data; }
+  [[nodiscard]] inline size_t               size() const { return m_Size; }
+  [[nodiscard]] inline const uint8_t*       begin() const { return m_Data; }
+  [[nodiscard]] inline const uint8_t*       end() const { return m_Data + m_Size; }
+  [[nodiscard]] inline uint8_t              operator[](const size_t index) const { return m_Data[index]; }
+
+  // Views handed out by CPacketFramer always pass this check, but views over arbitrary vectors may not.
+  [[nodiscard]] inline bool                 GetIsValidLength() const { return m_Size >= 4 && m_Size <= 0xFFFF && GetUInt16(2) == m_Size; }
+  [[nodiscard]] inline uint8_t              GetHeader() const { return m_Data[0]; }
+  [[nodiscard]] inline uint8_t              GetID() const { return m_Data[1]; }
+  [[nodiscard]] inline uint16_t             GetUInt16(const size_t offset) const { return static_cast<uint16_t>(m_Data[offset] | (m_Data[offset + 1] << 8)); }
+  [[nodiscard]] inline uint32_t             GetUInt32(const size_t offset) const {
+    return static_cast<uint32_t>(m_Data[offset]) | (static_cast<uint32_t>(m_Data[offset + 1]) << 8) | (static_cast<uint32_t>(m_Data[offset + 2]) << 16) | (static_cast<uint32_t>(m_Data[offset + 3]) << 24);
+  }
+
+  // Null-terminated string starting at offset, without the terminator. Unterminated strings run until the end of the packet.
+  [[nodiscard]] inline std::string          GetCString(const size_t offset) const {
+    if (offset >= m_Size) return std::string();
+    const uint8_t* start = m_Data + offset;
+    const uint8_t* stop = std::find(start, end(), static_cast<uint8_t>(0));
+    return std::string(reinterpret_cast<const char*>(start), stop - start);
+  }
+
+  [[nodiscard]] inline std::vector<uint8_t> ToVector() const { return std::vector<uint8_t>(begin(), end()); }
+};
+
+//
+// CPacketFramer
+//
+// Walks the unread bytes of a receive buffer in place, handing out a view for each complete packet.
+// Callers consume GetProcessed() bytes from the buffer once they are done with the views.
+// Should a packet handler clear or refill the buffer, framing stops rather than reading stale memory.
+//
+
+class CPacketFramer
+{
+public:
+  const CStreamBuffer&      m_Buffer;
+  const uint8_t*            m_Start;
+  const uint8_t*            m_Cursor;
+  const uint8_t*            m_End;
+  bool                      m_Malformed;
+
+  explicit CPacketFramer(const CStreamBuffer& buffer)
+   : m_Buffer(buffer),
+     m_Start(buffer.GetData()),
+     m_Cursor(buffer.GetData()),
+     m_End(buffer.GetData() + buffer.GetSize()),
+     m_Malformed(false)
+  {
+  }
+
+  // Returns false once the remaining bytes don't hold a complete packet, or they can't be framed at all.
+  [[nodiscard]] inline bool Next(PacketView& packet)
+  {
+    if (m_Buffer.GetData() != m_Start || m_Buffer.GetSize() != static_cast<size_t>(m_End - m_Start)) {
+      return false;
+    }
+    // a packet is at least 4 bytes, and bytes 2 and 3 contain its length
+    const size_t remaining = m_End - m_Cursor;
+    if (remaining < 4) return false;
+    const uint16_t length = static_cast<uint16_t>(m_Cursor[2] | (m_Cursor[3] << 8));
+    if (length < 4) {
+      m_Malformed = true;
+      return false;
+    }
+    if (remaining < length) return false;
+    packet = PacketView(m_Cursor, length);
+    m_Cursor += length;
+    return true;
+  }
+
+  [[nodiscard]] inline bool   GetIsMalformed() const { return m_Malformed; }
+  [[nodiscard]] inline size_t GetProcessed() const { return m_Cursor - m_Start; }
+};
+
+#endif // AURA_PACKET_VIEW_H_
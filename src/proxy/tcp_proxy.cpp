@@ -81,11 +81,11 @@ bool CTCPProxy::CloseConnection()
   return true;
 }
 
-TCPProxyStatus CTCPProxy::TransferBuffer(fd_set* fd, CStreamIOSocket* fromSocket, CStreamIOSocket* toSocket, bool* pausedRecvFlag, int64_t timeout)
+TCPProxyStatus CTCPProxy::TransferBuffer(CStreamIOSocket* fromSocket, CStreamIOSocket* toSocket, bool* pausedRecvFlag, int64_t timeout)
 {
   constexpr size_t kHighWatermark = 65536;
   constexpr size_t kLowWatermark  = 8192;
-  string::size_type pendingBytes = toSocket->GetSendBufferSize();
+  size_t pendingBytes = toSocket->GetSendBufferSize();
 
   if (pendingBytes >= kHighWatermark || (*pausedRecvFlag && pendingBytes > kLowWatermark)) {
     if (m_Aura->GetTicksIsAfterDelay(fromSocket->GetLastRecv(), timeout)) {
@@ -99,9 +99,8 @@ TCPProxyStatus CTCPProxy::TransferBuffer(fd_set* fd, CStreamIOSocket* fromSocket
 
   *pausedRecvFlag = false;
 
-  if (fromSocket->DoRecv(fd)) {
-    AppendSwapString(fromSocket->m_RecvBuffer, toSocket->m_SendBuffer); 
-    vector<uint8_t> byteArray = vector<uint8_t>(toSocket->m_SendBuffer.begin(), toSocket->m_SendBuffer.end());
+  if (fromSocket->DoRecv()) {
+    toSocket->PutBuffer(fromSocket->m_RecvBuffer);
     return TCPProxyStatus::kOk;
   }
   if (m_Aura->GetTicksIsAfterDelay(fromSocket->GetLastRecv(), timeout)) {
@@ -112,7 +111,7 @@ TCPProxyStatus CTCPProxy::TransferBuffer(fd_set* fd, CStreamIOSocket* fromSocket
   return TCPProxyStatus::kOk;
 }
 
-TCPProxyStatus CTCPProxy::Update(fd_set* fd, fd_set* send_fd, int64_t timeout)
+TCPProxyStatus CTCPProxy::Update(int64_t timeout)
 {
   if (m_DeleteMe || !m_IncomingSocket || m_IncomingSocket->HasError()) {
     return TCPProxyStatus::kDestroy;
@@ -132,8 +131,7 @@ TCPProxyStatus CTCPProxy::Update(fd_set* fd, fd_set* send_fd, int64_t timeout)
       }
       return result;
     }
-    AppendSwapString(m_IncomingSocket->m_RecvBuffer, m_OutgoingSocket->m_SendBuffer);
-    vector<uint8_t> byteArray = vector<uint8_t>(m_OutgoingSocket->m_SendBuffer.begin(), m_OutgoingSocket->m_SendBuffer.end());
+    m_OutgoingSocket->PutBuffer(m_IncomingSocket->m_RecvBuffer);
     // falls through
   } else if (!m_OutgoingSocket->GetConnected() && !m_OutgoingSocket->HasError()) {
     auto game = m_Game.lock();
@@ -144,8 +142,8 @@ TCPProxyStatus CTCPProxy::Update(fd_set* fd, fd_set* send_fd, int64_t timeout)
     return result;
   }
 
-  TransferBuffer(fd, m_IncomingSocket, m_OutgoingSocket, &m_ClientPaused, timeout);
-  TransferBuffer(fd, m_OutgoingSocket, m_IncomingSocket, &m_ServerPaused, timeout);
+  TransferBuffer(m_IncomingSocket, m_OutgoingSocket, &m_ClientPaused, timeout);
+  TransferBuffer(m_OutgoingSocket, m_IncomingSocket, &m_ServerPaused, timeout);
 
   if (m_DeleteMe) {
     return TCPProxyStatus::kDestroy;
@@ -157,26 +155,12 @@ TCPProxyStatus CTCPProxy::Update(fd_set* fd, fd_set* send_fd, int64_t timeout)
     return TCPProxyStatus::kDestroy;
   }
 
-  m_IncomingSocket->DoSend(send_fd);
-  m_OutgoingSocket->DoSend(send_fd);
+  m_IncomingSocket->DoSend();
+  m_OutgoingSocket->DoSend();
 
   return result;
 }
 
-uint32_t CTCPProxy::SetFD(fd_set* fd, fd_set* send_fd, int32_t* nfds) const
-{
-  uint32_t counter = 0;
-  if (m_IncomingSocket) {
-    m_IncomingSocket->SetFD(fd, send_fd, nfds);
-    counter++; 
-  }
-  if (m_OutgoingSocket) {
-    m_OutgoingSocket->SetFD(fd, send_fd, nfds);
-    counter++;
-  }
-  return counter;
-}
-
 void CTCPProxy::SendClient(const std::vector<uint8_t>& data)
 {
   if (m_IncomingSocket && !m_IncomingSocket->HasError()) {
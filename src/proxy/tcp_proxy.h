@@ -81,12 +81,11 @@ public:
 
   void SetTimeout(const int64_t nTicks);
   bool CloseConnection();
-  TCPProxyStatus TransferBuffer(fd_set* fd, CStreamIOSocket* fromSocket, CStreamIOSocket* toSocket, bool* pausedRecvFlag, int64_t timeout);
-  [[nodiscard]] TCPProxyStatus Update(fd_set* fd, fd_set* send_fd, int64_t timeout);
+  TCPProxyStatus TransferBuffer(CStreamIOSocket* fromSocket, CStreamIOSocket* toSocket, bool* pausedRecvFlag, int64_t timeout);
+  [[nodiscard]] TCPProxyStatus Update(int64_t timeout);
 
   // other functions
 
-  uint32_t SetFD(fd_set* fd, fd_set* send_fd, int32_t* nfds) const;
   void SendClient(const std::vector<uint8_t>& data);
   void SendServer(const std::vector<uint8_t>& data);
 };
@@ -131,17 +131,6 @@ CRealm::~CRealm()
   delete m_BNCSUtil;
 }
 
-uint32_t CRealm::SetFD(fd_set* fd, fd_set* send_fd, int32_t* nfds) const
-{
-  if (m_Socket && !m_Socket->HasError() && !m_Socket->HasFin() && m_Socket->GetConnected())
-  {
-    m_Socket->SetFD(fd, send_fd, nfds);
-    return 1;
-  }
-
-  return 0;
-}
-
 void CRealm::EventConnectionTimeOut()
 {
   // the connection attempt timed out (10 seconds)
@@ -155,7 +144,7 @@ void CRealm::EventConnectionTimeOut()
   m_WaitingToConnect     = true;
 }
 
-void CRealm::EventConnected(fd_set* /*fd*/, fd_set* send_fd)
+void CRealm::EventConnected()
 {
   // the connection attempt completed
   m_Aura->m_Net.OnThrottledConnectionSuccess(NetworkHost(m_Config.m_HostName, m_Config.m_ServerPort));
@@ -171,42 +160,33 @@ void CRealm::EventConnected(fd_set* /*fd*/, fd_set* send_fd)
   }
   SendAuth(BNETProtocol::SEND_PROTOCOL_INITIALIZE_SELECTOR());
   SendAuth(BNETProtocol::SEND_SID_AUTH_INFO(m_GameIsExpansion, m_AuthGameVersion, m_Config.m_Win32LocaleID, m_Config.m_Win32LanguageID, m_Config.m_LocaleShort, m_Config.m_CountryShort, m_Config.m_Country));
-  m_Socket->DoSend(send_fd);
+  m_Socket->DoSend();
   m_LastGameListTime = GetTime();
 }
 
-void CRealm::UpdateConnected(fd_set* fd, fd_set* send_fd)
+void CRealm::UpdateConnected()
 {
   const int64_t Time = GetTime();
 
   // the socket is connected and everything appears to be working properly
-  if (m_Socket->DoRecv(fd)) {
+  if (m_Socket->DoRecv()) {
 
     // extract as many packets as possible from the socket's receive buffer and process them
-    string*              RecvBuffer         = m_Socket->GetBytes();
-    std::vector<uint8_t> Bytes              = CreateByteArray((uint8_t*)RecvBuffer->c_str(), RecvBuffer->size());
-    uint32_t             LengthProcessed    = 0;
-    bool Abort                              = false;
-
-    // a packet is at least 4 bytes so loop as long as the buffer contains 4 bytes
-
-    while (Bytes.size() >= 4) {
-      // bytes 2 and 3 contain the length of the packet
-      const uint16_t             Length = ByteArrayToUInt16(Bytes, false, 2);
-      if (Length < 4) {
-        Abort = true;
-        break;
-      }
-      if (Bytes.size() < Length) break;
-      const vector<uint8_t> Data = vector<uint8_t>(begin(Bytes), begin(Bytes) + Length);
+    CStreamBuffer*       RecvBuffer         = m_Socket->GetBytes();
+    CPacketFramer        Framer(*RecvBuffer);
+    PacketView           Packet;
+
+    while (Framer.Next(Packet)) {
+      // the BNET protocol parsers still work on owned copies
+      const vector<uint8_t> Data = Packet.ToVector();
 
       // byte 0 is always 255
-      if (Bytes[0] == BNETProtocol::Magic::BNET_HEADER)
+      if (Packet.GetHeader() == BNETProtocol::Magic::BNET_HEADER)
       {
         // Any BNET packet is fine to reset app-level inactivity timeout.
         m_NullPacketsSent = 0;
 
-        switch (Bytes[1])
+        switch (Packet.GetID())
         {
           case BNETProtocol::Magic::ZERO:
             // warning: we do not respond to NULL packets with a NULL packet of our own
@@ -473,14 +453,12 @@ void CRealm::UpdateConnected(fd_set* fd, fd_set* send_fd)
         }
       }
 
-      LengthProcessed += Length;
-      Bytes = vector<uint8_t>(begin(Bytes) + Length, end(Bytes));
     }
 
-    if (Abort) {
-      RecvBuffer->clear();
-    } else if (LengthProcessed > 0) {
-      *RecvBuffer = RecvBuffer->substr(LengthProcessed);
+    if (Framer.GetIsMalformed()) {
+      RecvBuffer->Clear();
+    } else {
+      RecvBuffer->Consume(Framer.GetProcessed());
     }
   }
 
@@ -518,10 +496,10 @@ void CRealm::UpdateConnected(fd_set* fd, fd_set* send_fd)
     m_LastGameListTime = GetTime();
   }
 
-  m_Socket->DoSend(send_fd);
+  m_Socket->DoSend();
 }
 
-void CRealm::Update(fd_set* fd, fd_set* send_fd)
+void CRealm::Update()
 {
   // we return at the end of each if statement so we don't have to deal with errors related to the order of the if statements
   // that means it might take a few ms longer to complete a task involving multiple steps (in this case, reconnecting) due to blocking or sleeping
@@ -551,7 +529,7 @@ void CRealm::Update(fd_set* fd, fd_set* send_fd)
   }
 
   if (m_Socket->GetConnected()) {
-    UpdateConnected(fd, send_fd);
+    UpdateConnected();
     return;
   }
 
@@ -564,6 +542,13 @@ void CRealm::Update(fd_set* fd, fd_set* send_fd)
   if (!m_Socket->GetConnecting() && !m_Socket->GetConnected() && GetIsDueReconnect()) {
     // attempt to connect to battle.net
 
+    sockaddr_storage resolvedAddress;
+    const DNSStatus resolution = m_Aura->m_Net.ResolveHostName(resolvedAddress, ACCEPT_ANY, m_Config.m_HostName, m_Config.m_ServerPort);
+    if (resolution == DNSStatus::kPending) {
+      // check back next update
+      return;
+    }
+
     if (!m_FirstConnect) {
       PRINT_IF(LogLevel::kNotice, GetLogPrefix() + "reconnecting to [" + m_HostName + ":" + to_string(m_Config.m_ServerPort) + "]...")
     } else {
@@ -576,8 +561,7 @@ void CRealm::Update(fd_set* fd, fd_set* send_fd)
     m_FirstConnect = false;
     m_ReconnectNextTick = false;
 
-    sockaddr_storage resolvedAddress;
-    if (m_Aura->m_Net.ResolveHostName(resolvedAddress, ACCEPT_ANY, m_Config.m_HostName, m_Config.m_ServerPort)) {
+    if (resolution == DNSStatus::kResolved) {
       m_Aura->m_Net.OnThrottledConnectionStart(NetworkHost(m_Config.m_HostName, m_Config.m_ServerPort));
       m_Socket->Connect(m_Config.m_BindAddress, resolvedAddress);
     } else {
@@ -591,7 +575,7 @@ void CRealm::Update(fd_set* fd, fd_set* send_fd)
     // we are currently attempting to connect to battle.net
 
     if (m_Socket->CheckConnect()) {
-      EventConnected(fd, send_fd);
+      EventConnected();
     } else if (GetTime() - m_LastConnectionAttemptTime >= 10) {
       EventConnectionTimeOut();
     }
@@ -210,11 +210,10 @@ public:
 
   // processing functions
 
-  uint32_t SetFD(fd_set* fd, fd_set* send_fd, int32_t* nfds) const;
   void EventConnectionTimeOut();
-  void EventConnected(fd_set* fd, fd_set* send_fd);
-  void UpdateConnected(fd_set* fd, fd_set* send_fd);
-  void Update(fd_set* fd, fd_set* send_fd);
+  void EventConnected();
+  void UpdateConnected();
+  void Update();
   void ProcessChatEvent(const uint32_t eventType, const std::string& fromUser, const std::string& nMessage);
   uint8_t CountChatQuota();
   bool CheckWithinChatQuota(CQueuedChatMessage* message);
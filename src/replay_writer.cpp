@@ -0,0 +1,380 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#include "replay_writer.h"
+#include "game_structs.h"
+#include "file_util.h"
+#include "util.h"
+#include "protocol/game_protocol.h"
+
+#include <zlib.h>
+
+#include <crc32/crc32.h>
+
+using namespace std;
+
+namespace
+{
+  void AppendPlayerRecord(vector<uint8_t>& data, const uint8_t UID, const string& name)
+  {
+    data.push_back(UID);
+    AppendByteArrayString(data, name, true);
+    data.push_back(1); // additional data size
+    data.push_back(0); // additional data (custom game)
+  }
+}
+
+//
+// ReplayHeaderInfo
+//
+
+ReplayHeaderInfo::ReplayHeaderInfo()
+ : m_IsExpansion(true),
+   m_War3Version(GAMEVER(1u, 0u)),
+   m_BuildNumber(0),
+   m_GameType(0)
+{
+}
+
+ReplayHeaderInfo::~ReplayHeaderInfo() = default;
+
+//
+// CReplayWriter
+//
+
+CReplayWriter::CReplayWriter(const filesystem::path& filePath, ReplayHeaderInfo&& headerInfo)
+ : m_FilePath(filePath),
+   m_PartialPath(filePath.string() + ".part"),
+   m_HeaderInfo(std::move(headerInfo)),
+   m_DecompressedSize(0),
+   m_ReplayLength(0),
+   m_Started(false),
+   m_Finished(false),
+   m_Exiting(false),
+   m_NumBlocks(0),
+   m_CompressedSize(0),
+   m_Failed(false)
+{
+}
+
+CReplayWriter::~CReplayWriter()
+{
+  if (m_Started && !m_Finished) {
+    Abort();
+  }
+}
+
+bool CReplayWriter::Start()
+{
+  if (m_Started || m_HeaderInfo.m_Players.empty()) {
+    return false;
+  }
+
+  m_File.open(m_PartialPath, ios::binary | ios::trunc);
+  if (!m_File.is_open()) {
+    Print("[REPLAY] failed to open [" + PathToString(m_PartialPath) + "]");
+    return false;
+  }
+
+  // the header is patched in by Finish(), once sizes are known
+  const vector<uint8_t> placeholder(REPLAY_HEADER_SIZE, 0);
+  m_File.write(reinterpret_cast<const char*>(placeholder.data()), placeholder.size());
+
+  m_Pending.reserve(REPLAY_BLOCK_SIZE * 2);
+  AppendByteArray(m_Pending, static_cast<uint32_t>(0x110), false); // unknown
+
+  const pair<uint8_t, string>& host = m_HeaderInfo.m_Players.front();
+  m_Pending.push_back(0); // host record
+  AppendPlayerRecord(m_Pending, host.first, host.second);
+
+  AppendByteArrayString(m_Pending, m_HeaderInfo.m_GameName, true);
+  m_Pending.push_back(0);
+  AppendByteArrayFast(m_Pending, m_HeaderInfo.m_StatString);
+  m_Pending.push_back(0);
+  AppendByteArray(m_Pending, static_cast<uint32_t>(m_HeaderInfo.m_SlotInfo.empty() ? 0 : m_HeaderInfo.m_SlotInfo[0]), false);
+  AppendByteArray(m_Pending, m_HeaderInfo.m_GameType, false);
+  AppendByteArray(m_Pending, REPLAY_LANGUAGE_ID, false);
+
+  for (auto it = m_HeaderInfo.m_Players.begin() + 1; it != m_HeaderInfo.m_Players.end(); ++it) {
+    m_Pending.push_back(REPLAY_BLOCK_PLAYER_RECORD);
+    AppendPlayerRecord(m_Pending, it->first, it->second);
+    AppendByteArray(m_Pending, static_cast<uint32_t>(0), false);
+  }
+
+  m_Pending.push_back(REPLAY_BLOCK_GAME_START_RECORD);
+  AppendByteArray(m_Pending, static_cast<uint16_t>(m_HeaderInfo.m_SlotInfo.size()), false);
+  AppendByteArrayFast(m_Pending, m_HeaderInfo.m_SlotInfo);
+
+  for (const uint8_t startBlock : {REPLAY_BLOCK_FIRST_START, REPLAY_BLOCK_SECOND_START, REPLAY_BLOCK_THIRD_START}) {
+    m_Pending.push_back(startBlock);
+    AppendByteArray(m_Pending, static_cast<uint32_t>(1), false);
+  }
+
+  m_Started = true;
+  m_Worker = thread(&CReplayWriter::RunWorker, this);
+  FlushPending(false);
+  return true;
+}
+
+void CReplayWriter::AddFrame(const GameFrame& frame)
+{
+  if (!m_Started || m_Finished) return;
+
+  switch (frame.GetType()) {
+    case GAME_FRAME_TYPE_LATENCY:
+      // the send interval is already carried by each action packet
+    case GAME_FRAME_TYPE_GPROXY:
+      // GProxy empty actions are never seen by the game clients
+      return;
+    default:
+      break;
+  }
+
+  // a single frame may hold several W3GS packets (e.g. INCOMING_ACTION2 overflow, or long chat messages)
+  const uint8_t* bytes = frame.GetData();
+  const size_t size = frame.GetSize();
+  size_t offset = 0;
+  while (offset + 4 <= size) {
+    const uint8_t* packet = bytes + offset;
+    const uint16_t packetSize = ByteArrayToUInt16(packet + 2, false);
+    if (packet[0] != GameProtocol::Magic::W3GS_HEADER || packetSize < 4 || offset + packetSize > size) {
+      Print("[REPLAY] skipped malformed frame");
+      break;
+    }
+    switch (packet[1]) {
+      case GameProtocol::Magic::INCOMING_ACTION:
+      case GameProtocol::Magic::INCOMING_ACTION2:
+        AppendTimeSlot(packet, packetSize, frame.GetType() == GAME_FRAME_TYPE_PAUSED);
+        break;
+      case GameProtocol::Magic::CHAT_FROM_HOST:
+        AppendChat(packet, packetSize);
+        break;
+      case GameProtocol::Magic::PLAYERLEAVE_OTHERS:
+        AppendLeaver(packet, packetSize);
+        break;
+      default:
+        break;
+    }
+    offset += packetSize;
+  }
+
+  if (m_Pending.size() >= REPLAY_BLOCK_SIZE) {
+    FlushPending(false);
+  }
+}
+
+void CReplayWriter::AppendTimeSlot(const uint8_t* packet, const uint16_t packetSize, const bool isPaused)
+{
+  // W3GS: [header][u16 send interval][u16 crc][actions], the crc is dropped when there are no actions
+  if (packetSize < 6) return;
+  const uint16_t sendInterval = ByteArrayToUInt16(packet + 4, false);
+  const uint16_t actionsSize = packetSize >= 8 ? packetSize - 8 : 0;
+
+  m_Pending.push_back(REPLAY_BLOCK_TIME_SLOT);
+  AppendByteArray(m_Pending, static_cast<uint16_t>(2 + actionsSize), false);
+  AppendByteArray(m_Pending, sendInterval, false);
+  if (actionsSize > 0) {
+    m_Pending.insert(m_Pending.end(), packet + 8, packet + packetSize);
+  }
+
+  if (!isPaused) {
+    m_ReplayLength += sendInterval;
+  }
+}
+
+void CReplayWriter::AppendChat(const uint8_t* packet, const uint16_t packetSize)
+{
+  // W3GS: [header][u8 receiver count][receivers][sender][flag][u32 flag extra, in-game only][message]
+  // Replay: [sender][u16 size][flag][u32 flag extra, in-game only][message]
+  if (packetSize < 5) return;
+  const size_t senderOffset = 5 + packet[4];
+  if (senderOffset + 2 >= packetSize) return;
+  const uint16_t size = static_cast<uint16_t>(packetSize - senderOffset - 1);
+
+  m_Pending.push_back(REPLAY_BLOCK_CHAT);
+  m_Pending.push_back(packet[senderOffset]);
+  AppendByteArray(m_Pending, size, false);
+  m_Pending.insert(m_Pending.end(), packet + senderOffset + 1, packet + packetSize);
+}
+
+void CReplayWriter::AppendLeaver(const uint8_t* packet, const uint16_t packetSize)
+{
+  // W3GS: [header][UID][u32 left code]
+  if (packetSize < 9) return;
+
+  m_Pending.push_back(REPLAY_BLOCK_LEAVE_GAME);
+  AppendByteArray(m_Pending, static_cast<uint32_t>(1), false); // reason: connection closed by remote game
+  m_Pending.push_back(packet[4]);
+  m_Pending.insert(m_Pending.end(), packet + 5, packet + 9);   // result
+  AppendByteArray(m_Pending, static_cast<uint32_t>(1), false); // unknown
+}
+
+void CReplayWriter::FlushPending(const bool isLast)
+{
+  size_t offset = 0;
+  vector<vector<uint8_t>> chunks;
+  while (m_Pending.size() - offset >= REPLAY_BLOCK_SIZE) {
+    chunks.emplace_back(m_Pending.begin() + offset, m_Pending.begin() + offset + REPLAY_BLOCK_SIZE);
+    offset += REPLAY_BLOCK_SIZE;
+  }
+  if (isLast && offset < m_Pending.size()) {
+    // the last block is padded with zeros
+    chunks.emplace_back(m_Pending.begin() + offset, m_Pending.end());
+    chunks.back().resize(REPLAY_BLOCK_SIZE, 0);
+    offset = m_Pending.size();
+  }
+  if (chunks.empty()) return;
+
+  m_DecompressedSize += static_cast<uint32_t>(offset);
+  m_Pending.erase(m_Pending.begin(), m_Pending.begin() + offset);
+
+  {
+    lock_guard<mutex> lock(m_Mutex);
+    for (auto& chunk : chunks) {
+      m_Queue.push_back(std::move(chunk));
+    }
+  }
+  m_WakeUp.notify_one();
+}
+
+bool CReplayWriter::Finish()
+{
+  if (!m_Started || m_Finished) return false;
+  m_Finished = true;
+
+  FlushPending(true);
+  {
+    lock_guard<mutex> lock(m_Mutex);
+    m_Exiting = true;
+  }
+  m_WakeUp.notify_one();
+  m_Worker.join();
+
+  if (!m_Failed.load()) {
+    const vector<uint8_t> header = GetFileHeader();
+    m_File.seekp(0);
+    m_File.write(reinterpret_cast<const char*>(header.data()), header.size());
+  }
+  m_File.close();
+
+  if (m_Failed.load() || m_File.fail()) {
+    Print("[REPLAY] failed to write [" + PathToString(m_PartialPath) + "]");
+    FileDelete(m_PartialPath);
+    return false;
+  }
+
+  error_code ec;
+  filesystem::rename(m_PartialPath, m_FilePath, ec);
+  if (ec) {
+    Print("[REPLAY] failed to rename [" + PathToString(m_PartialPath) + "] - " + ec.message());
+    return false;
+  }
+  return true;
+}
+
+void CReplayWriter::Abort()
+{
+  m_Finished = true;
+  {
+    lock_guard<mutex> lock(m_Mutex);
+    m_Exiting = true;
+    m_Queue.clear();
+  }
+  m_WakeUp.notify_one();
+  m_Worker.join();
+  m_File.close();
+  FileDelete(m_PartialPath);
+}
+
+void CReplayWriter::RunWorker()
+{
+  vector<uint8_t> compressed(REPLAY_BLOCK_COMPRESS_BOUND);
+  while (true) {
+    vector<uint8_t> chunk;
+    {
+      unique_lock<mutex> lock(m_Mutex);
+      m_WakeUp.wait(lock, [this] { return m_Exiting || !m_Queue.empty(); });
+      if (m_Queue.empty()) break;
+      chunk = std::move(m_Queue.front());
+      m_Queue.pop_front();
+    }
+    if (!m_Failed.load() && !WriteBlock(chunk, compressed)) {
+      m_Failed = true;
+    }
+  }
+}
+
+bool CReplayWriter::WriteBlock(const vector<uint8_t>& chunk, vector<uint8_t>& compressed)
+{
+  // same block layout as CPacked::Compress()
+  uLongf compressedSize = static_cast<uLongf>(compressed.size());
+  if (compress(compressed.data(), &compressedSize, chunk.data(), static_cast<uLong>(chunk.size())) != Z_OK) {
+    return false;
+  }
+
+  vector<uint8_t> blockHeader;
+  blockHeader.reserve(8);
+  AppendByteArray(blockHeader, static_cast<uint16_t>(compressedSize), false);
+  AppendByteArray(blockHeader, static_cast<uint16_t>(REPLAY_BLOCK_SIZE), false);
+  AppendByteArray(blockHeader, static_cast<uint32_t>(0), false);
+
+  uint32_t headerCRC = CRC32::CalculateCRC(blockHeader.data(), blockHeader.size());
+  headerCRC = headerCRC ^ (headerCRC >> 16);
+  uint32_t dataCRC = CRC32::CalculateCRC(compressed.data(), compressedSize);
+  dataCRC = dataCRC ^ (dataCRC >> 16);
+  const uint32_t blockCRC = (headerCRC & 0xFFFF) | (dataCRC << 16);
+  blockHeader.resize(4);
+  AppendByteArray(blockHeader, blockCRC, false);
+
+  m_File.write(reinterpret_cast<const char*>(blockHeader.data()), blockHeader.size());
+  m_File.write(reinterpret_cast<const char*>(compressed.data()), compressedSize);
+  ++m_NumBlocks;
+  m_CompressedSize += static_cast<uint32_t>(compressedSize) + 8;
+  return !m_File.fail();
+}
+
+vector<uint8_t> CReplayWriter::GetFileHeader() const
+{
+  // same header layout as CPacked::Compress()
+  vector<uint8_t> header;
+  header.reserve(REPLAY_HEADER_SIZE);
+  AppendByteArrayString(header, "Warcraft III recorded game\x01A", true);
+  AppendByteArray(header, REPLAY_HEADER_SIZE, false);
+  AppendByteArray(header, REPLAY_HEADER_SIZE + m_CompressedSize, false);
+  AppendByteArray(header, static_cast<uint32_t>(1), false); // header version
+  AppendByteArray(header, m_DecompressedSize, false);
+  AppendByteArray(header, m_NumBlocks, false);
+  AppendByteArray(header, reinterpret_cast<const uint8_t*>(m_HeaderInfo.m_IsExpansion ? ProductID_TFT : ProductID_ROC), 4);
+  AppendByteArray(header, static_cast<uint32_t>(m_HeaderInfo.m_War3Version.second), false);
+  AppendByteArray(header, m_HeaderInfo.m_BuildNumber, false);
+  AppendByteArray(header, REPLAY_FLAGS_MULTIPLAYER, false);
+  AppendByteArray(header, m_ReplayLength, false);
+  AppendByteArray(header, static_cast<uint32_t>(0), false);
+
+  const uint32_t headerCRC = CRC32::CalculateCRC(header.data(), header.size());
+  header.resize(header.size() - 4);
+  AppendByteArray(header, headerCRC, false);
+  return header;
+}
@@ -0,0 +1,118 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#ifndef AURA_REPLAY_WRITER_H_
+#define AURA_REPLAY_WRITER_H_
+
+#include "includes.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+//
+// ReplayHeaderInfo
+//
+// Everything the w3g replay header needs, snapshotted from the game when it starts loading.
+//
+
+struct ReplayHeaderInfo
+{
+  bool                                              m_IsExpansion;
+  Version                                           m_War3Version;
+  uint16_t                                          m_BuildNumber;
+  uint32_t                                          m_GameType;
+  std::string                                       m_GameName;
+  std::vector<uint8_t>                              m_StatString;   // already encoded
+  std::vector<std::pair<uint8_t, std::string>>      m_Players;      // UID, name. The first one is recorded as the host
+  std::vector<uint8_t>                              m_SlotInfo;     // as encoded by GameProtocol::EncodeSlotInfo
+
+  ReplayHeaderInfo();
+  ~ReplayHeaderInfo();
+};
+
+//
+// CReplayWriter
+//
+// Streams a .w3g replay to disk while the game is still running.
+//
+// The main thread converts GameFrames into replay blocks (time slots, chat, leavers) as they are recorded,
+// and hands every complete 8 KB chunk to a background thread, which compresses it exactly like CPacked does,
+// and appends it to <path>.part. Finish() flushes the last chunk, patches the header, and renames the file,
+// so that the replay is ready as soon as the game ends, and at most one chunk stays in memory meanwhile.
+//
+
+class CReplayWriter
+{
+public:
+  std::filesystem::path                             m_FilePath;
+  std::filesystem::path                             m_PartialPath;
+  ReplayHeaderInfo                                  m_HeaderInfo;
+  std::vector<uint8_t>                              m_Pending;              // decompressed data not yet handed to the worker
+  uint32_t                                          m_DecompressedSize;
+  uint32_t                                          m_ReplayLength;         // in milliseconds of game time
+  bool                                              m_Started;
+  bool                                              m_Finished;
+
+  std::mutex                                        m_Mutex;
+  std::condition_variable                           m_WakeUp;
+  std::deque<std::vector<uint8_t>>                  m_Queue;                // full chunks waiting for compression
+  bool                                              m_Exiting;
+  std::thread                                       m_Worker;
+
+  // only touched by the worker while it runs
+  std::ofstream                                     m_File;
+  uint32_t                                          m_NumBlocks;
+  uint32_t                                          m_CompressedSize;
+  std::atomic<bool>                                 m_Failed;
+
+  CReplayWriter(const std::filesystem::path& filePath, ReplayHeaderInfo&& headerInfo);
+  ~CReplayWriter();
+  CReplayWriter(CReplayWriter&) = delete;
+
+  [[nodiscard]] inline bool                         GetIsStarted() const { return m_Started; }
+  [[nodiscard]] inline uint32_t                     GetReplayLength() const { return m_ReplayLength; }
+  [[nodiscard]] inline const std::filesystem::path& GetFilePath() const { return m_FilePath; }
+
+  [[nodiscard]] bool                                Start();
+  void                                              AddFrame(const GameFrame& frame);
+  [[nodiscard]] bool                                Finish();
+
+private:
+  void                                              AppendTimeSlot(const uint8_t* packet, const uint16_t packetSize, const bool isPaused);
+  void                                              AppendChat(const uint8_t* packet, const uint16_t packetSize);
+  void                                              AppendLeaver(const uint8_t* packet, const uint16_t packetSize);
+  void                                              FlushPending(const bool isLast);
+  void                                              Abort();
+  void                                              RunWorker();
+  [[nodiscard]] bool                                WriteBlock(const std::vector<uint8_t>& chunk, std::vector<uint8_t>& compressed);
+  [[nodiscard]] std::vector<uint8_t>                GetFileHeader() const;
+};
+
+#endif // AURA_REPLAY_WRITER_H_
@@ -43,6 +43,7 @@
  */
 
 #include "socket.h"
+#include "socket_poller.h"
 #include "net.h"
 #include "util.h"
 
@@ -59,7 +60,12 @@ CSocket::CSocket(const uint8_t nFamily)
     m_Port(0),
     m_HasError(false),
     m_HasFin(false),
-    m_Error(0)
+    m_PollReadable(false),
+    m_PollWritable(false),
+    m_PollPaused(false),
+    m_Error(0),
+    m_PollIndex(0),
+    m_Poller(nullptr)
 {
 }
 
@@ -70,8 +76,14 @@ CSocket::CSocket(const uint8_t nFamily, SOCKET nSocket)
     m_Port(0),
     m_HasError(false),
     m_HasFin(false),
-    m_Error(0)
+    m_PollReadable(false),
+    m_PollWritable(false),
+    m_PollPaused(false),
+    m_Error(0),
+    m_PollIndex(0),
+    m_Poller(nullptr)
 {
+  RegisterPoller();
 }
 
 CSocket::CSocket(const uint8_t nFamily, string nName)
@@ -81,7 +93,12 @@ CSocket::CSocket(const uint8_t nFamily, string nName)
     m_Port(0),
     m_HasError(false),
     m_HasFin(false),
+    m_PollReadable(false),
+    m_PollWritable(false),
+    m_PollPaused(false),
     m_Error(0),
+    m_PollIndex(0),
+    m_Poller(nullptr),
     m_Name(nName)
 {
 }
@@ -89,6 +106,7 @@ CSocket::CSocket(const uint8_t nFamily, string nName)
 CSocket::~CSocket()
 {
   if (m_Socket != INVALID_SOCKET) {
+    UnregisterPoller();
     closesocket(m_Socket);
     m_Socket = INVALID_SOCKET;
   }
@@ -183,20 +201,31 @@ string CSocket::GetErrorString() const
   return "UNKNOWN ERROR (" + to_string(m_Error) + ")";
 }
 
-void CSocket::SetFD(fd_set* fd, fd_set* send_fd, int* nfds)
+void CSocket::RegisterPoller()
 {
-  if (m_Socket == INVALID_SOCKET)
+  if (m_Socket == INVALID_SOCKET || m_Poller != nullptr)
     return;
 
-  FD_SET(m_Socket, fd);
-  FD_SET(m_Socket, send_fd);
+  CSocketPoller::GetThreadPoller()->Register(this);
+}
 
-#ifndef _WIN32
-  if (m_Socket > *nfds)
-    *nfds = m_Socket;
-#else
-  UNREFERENCED_PARAMETER(nfds);
-#endif
+void CSocket::UnregisterPoller()
+{
+  if (m_Poller == nullptr)
+    return;
+
+  m_Poller->Unregister(this);
+}
+
+void CSocket::ResumePolling()
+{
+  if (!m_PollPaused)
+    return;
+
+  // edge-triggered pollers won't report whatever got queued meanwhile, so just try again
+  m_PollPaused = false;
+  m_PollReadable = true;
+  if (m_Poller) m_Poller->SetBacklogged();
 }
 
 void CSocket::Allocate(const uint8_t family, int type)
@@ -211,11 +240,14 @@ void CSocket::Allocate(const uint8_t family, int type)
     Print("[SOCKET] error (socket) - " + GetErrorString());
     return;
   }
+
+  RegisterPoller();
 }
 
 void CSocket::Reset()
 {
   if (m_Socket != INVALID_SOCKET) {
+    UnregisterPoller();
     closesocket(m_Socket);
   }
 
@@ -223,6 +255,7 @@ void CSocket::Reset()
   m_HasError = false;
   m_Error = 0;
   m_HasFin = false;
+  m_PollPaused = false;
 }
 
 void CSocket::SendReply(const sockaddr_storage* /*address*/, const vector<uint8_t>& /*message*/)
@@ -235,6 +268,7 @@ void CSocket::SendReply(const sockaddr_storage* /*address*/, const vector<uint8_
 
 CStreamIOSocket::CStreamIOSocket(uint8_t nFamily, string nName)
   : CSocket(nFamily, nName),
+    m_SendQueueSize(0),
     m_LastRecv(GetTicks()),
     m_Connected(false),
     m_Server(nullptr),
@@ -262,6 +296,7 @@ CStreamIOSocket::CStreamIOSocket(uint8_t nFamily, string nName)
 
 CStreamIOSocket::CStreamIOSocket(SOCKET nSocket, sockaddr_storage& nAddress, CTCPServer* nServer, const uint16_t nCounter)
   : CSocket(static_cast<uint8_t>(nAddress.ss_family), nSocket),
+    m_SendQueueSize(0),
     m_LastRecv(GetTicks()),
     m_Connected(true),
     m_RemoteHost(move(nAddress)),
@@ -337,13 +372,14 @@ void CStreamIOSocket::SetKeepAlive(const bool keepAlive, const uint32_t seconds)
 void CStreamIOSocket::Close()
 {
   if (m_Socket != INVALID_SOCKET) {
+    UnregisterPoller();
     closesocket(m_Socket);
   }
 
   m_Socket = INVALID_SOCKET;
   m_Connected = false;
-  m_RecvBuffer.clear();
-  m_SendBuffer.clear();
+  m_RecvBuffer.Clear();
+  ClearSendBuffer();
 
   memset(&m_RemoteHost, 0, sizeof(sockaddr_storage));
 }
@@ -355,8 +391,8 @@ void CStreamIOSocket::Reset()
   Allocate(m_Family, SOCK_STREAM);
 
   m_Connected = false;
-  m_RecvBuffer.clear();
-  m_SendBuffer.clear();
+  m_RecvBuffer.Clear();
+  ClearSendBuffer();
   m_LastRecv = GetTicks();
 
   memset(&m_RemoteHost, 0, sizeof(sockaddr_storage));
@@ -371,53 +407,90 @@ void CStreamIOSocket::Reset()
 #endif
 }
 
-bool CStreamIOSocket::DoRecv(fd_set* fd)
+bool CStreamIOSocket::DoRecv()
 {
   if (m_Socket == INVALID_SOCKET || m_HasError || !m_Connected)
     return false;
 
-  if (!FD_ISSET(m_Socket, fd))
+  if (!m_PollReadable)
     return false;
 
-  // data is waiting, receive it
-  char buffer[1024];
-  int32_t c = recv(m_Socket, buffer, 1024, 0);
-
-  if (c > 0) {
-    // success! add the received data to the buffer
-    m_RecvBuffer += string(buffer, c);
-    m_LastRecv = GetTicks();
-    return true;
-  }
+  // data is waiting, receive it until the socket would block
+  size_t totalReceived = 0;
+
+  while (true) {
+    // receive straight into the buffer's free space
+    char* buffer = reinterpret_cast<char*>(m_RecvBuffer.PrepareWrite(SOCKET_RECV_BUFFER_SIZE));
+    int32_t c = recv(m_Socket, buffer, SOCKET_RECV_BUFFER_SIZE, 0);
+
+    if (c > 0) {
+      // success! publish the received data
+      m_RecvBuffer.CommitWrite(c);
+      totalReceived += c;
+      if (totalReceived >= SOCKET_RECV_MAX_BYTES_PER_UPDATE) {
+        // leave the rest for the next loop turn, but don't block waiting for it
+        if (m_Poller) m_Poller->SetBacklogged();
+        break;
+      }
+      continue;
+    }
 
-  if (c == SOCKET_ERROR && GetLastOSError() != EWOULDBLOCK) {
-    // receive error
-    m_HasError = true;
-    m_Error = GetLastOSError();
-    if (m_LogErrors) {
-      Print("[TCPSOCKET] (" + GetName() +") error (recv) - " + GetErrorString());
+    if (c == SOCKET_ERROR) {
+      int32_t error = GetLastOSError();
+      if (error == EINTR) {
+        continue;
+      }
+      m_PollReadable = false;
+      if (error == EWOULDBLOCK) {
+        break;
+      }
+      // receive error
+      m_HasError = true;
+      m_Error = error;
+      if (m_LogErrors) {
+        Print("[TCPSOCKET] (" + GetName() +") error (recv) - " + GetErrorString());
+      }
+      break;
     }
-  } else if (c == 0) {
+
     // the other end closed the connection
     if (m_LogErrors) {
       Print("[TCPSOCKET] (" + GetName() +") remote terminated the connection");
     }
+    m_PollReadable = false;
     m_HasFin = true;
     m_LogErrors = false;
+    break;
   }
-  return false;
+
+  if (totalReceived == 0) {
+    return false;
+  }
+
+  m_LastRecv = GetTicks();
+  return true;
 }
 
-void CStreamIOSocket::Discard(fd_set* fd)
+void CStreamIOSocket::Discard()
 {
   if (m_Socket == INVALID_SOCKET || m_HasError || !m_Connected)
     return;
 
-  if (!FD_ISSET(m_Socket, fd))
+  if (!m_PollReadable)
     return;
 
-  char buffer[1024];
-  recv(m_Socket, buffer, 1024, 0);
+  char buffer[SOCKET_RECV_BUFFER_SIZE];
+  size_t totalReceived = 0;
+  while (totalReceived < SOCKET_RECV_MAX_BYTES_PER_UPDATE) {
+    int32_t c = recv(m_Socket, buffer, SOCKET_RECV_BUFFER_SIZE, 0);
+    if (c > 0) {
+      totalReceived += c;
+    } else if (c == 0 || GetLastOSError() != EINTR) {
+      m_PollReadable = false;
+      return;
+    }
+  }
+  if (m_Poller) m_Poller->SetBacklogged();
 }
 
 optional<uint32_t> CStreamIOSocket::GetRTT() const
@@ -436,24 +509,117 @@ optional<uint32_t> CStreamIOSocket::GetRTT() const
   return rtt;
 }
 
-void CStreamIOSocket::DoSend(fd_set* send_fd)
+size_t CStreamIOSocket::PutSlice(const SharedPacket& owner, const size_t offset, const size_t size)
+{
+  if (size < SOCKET_SEND_COPY_THRESHOLD) {
+    return PutBytes(owner->data() + offset, size);
+  }
+
+  m_SendQueue.emplace_back(owner, offset, size);
+  m_SendQueueSize += size;
+  return size;
+}
+
+void CStreamIOSocket::ClearSendBuffer()
+{
+  m_SendBuffer.Clear();
+  m_SendQueue.clear();
+  m_SendQueueSize = 0;
+}
+
+void CStreamIOSocket::StageSendBytes(const size_t size)
+{
+  if (size == 0)
+    return;
+
+  // consecutive writes are coalesced, since they are contiguous in m_SendBuffer
+  if (!m_SendQueue.empty() && m_SendQueue.back().GetIsStaged()) {
+    m_SendQueue.back().m_Size += size;
+  } else {
+    m_SendQueue.emplace_back(size);
+  }
+  m_SendQueueSize += size;
+}
+
+void CStreamIOSocket::ConsumeSendQueue(size_t count)
 {
-  if (m_Socket == INVALID_SOCKET || m_HasError || m_HasFin || !m_Connected || m_SendBuffer.empty())
+  m_SendQueueSize -= count;
+  while (count > 0) {
+    SocketSendSlice& slice = m_SendQueue.front();
+    const size_t consumed = count < slice.m_Size ? count : slice.m_Size;
+    if (slice.GetIsStaged()) {
+      m_SendBuffer.Consume(consumed);
+    } else {
+      slice.m_Offset += consumed;
+    }
+    slice.m_Size -= consumed;
+    count -= consumed;
+    if (slice.m_Size == 0) {
+      m_SendQueue.pop_front();
+    }
+  }
+}
+
+void CStreamIOSocket::DoSend()
+{
+  if (m_Socket == INVALID_SOCKET || m_HasError || m_HasFin || !m_Connected || m_SendQueue.empty())
     return;
 
-  if (FD_ISSET(m_Socket, send_fd))
+#ifdef _WIN32
+  WSABUF buffers[SOCKET_SEND_MAX_SLICES];
+#else
+  iovec buffers[SOCKET_SEND_MAX_SLICES];
+#endif
+
+  while (m_PollWritable && !m_SendQueue.empty())
   {
-    // socket is ready, send it
+    // socket is ready, gather as many queued slices as possible into a single call
+
+    size_t bufferCount = 0;
+    const uint8_t* staged = m_SendBuffer.GetData();
+    for (const auto& slice : m_SendQueue) {
+      uint8_t* data;
+      if (slice.GetIsStaged()) {
+        data = const_cast<uint8_t*>(staged);
+        staged += slice.m_Size;
+      } else {
+        data = const_cast<uint8_t*>(slice.m_Owner->data() + slice.m_Offset);
+      }
+#ifdef _WIN32
+      buffers[bufferCount].buf = reinterpret_cast<CHAR*>(data);
+      buffers[bufferCount].len = static_cast<ULONG>(slice.m_Size);
+#else
+      buffers[bufferCount].iov_base = data;
+      buffers[bufferCount].iov_len = slice.m_Size;
+#endif
+      if (++bufferCount == SOCKET_SEND_MAX_SLICES) {
+        break;
+      }
+    }
 
-    int32_t s = send(m_Socket, m_SendBuffer.c_str(), static_cast<int32_t>(m_SendBuffer.size()), MSG_NOSIGNAL);
+#ifdef _WIN32
+    DWORD sentBytes = 0;
+    int64_t s = WSASend(m_Socket, buffers, static_cast<DWORD>(bufferCount), &sentBytes, 0, nullptr, nullptr) == SOCKET_ERROR ? SOCKET_ERROR : static_cast<int64_t>(sentBytes);
+#else
+    msghdr message;
+    memset(&message, 0, sizeof(msghdr));
+    message.msg_iov = buffers;
+    message.msg_iovlen = bufferCount;
+    int64_t s = sendmsg(m_Socket, &message, MSG_NOSIGNAL);
+#endif
 
     if (s > 0)
     {
-      // success! only some of the data may have been sent, remove it from the buffer
+      // success! only some of the data may have been sent, remove it from the queue
 
-      m_SendBuffer = m_SendBuffer.substr(s);
+      ConsumeSendQueue(static_cast<size_t>(s));
     }
-    else if (s == SOCKET_ERROR && GetLastOSError() != EWOULDBLOCK)
+    else if (s == SOCKET_ERROR && GetLastOSError() == EWOULDBLOCK)
+    {
+      // wait until the poller notifies there is room in the kernel buffer again
+      m_PollWritable = false;
+    }
+    else if (s == SOCKET_ERROR && GetLastOSError() != EINTR)
     {
       // send error
 
@@ -469,11 +635,13 @@ void CStreamIOSocket::DoSend(fd_set* send_fd)
 
 void CStreamIOSocket::Flush()
 {
-  if (m_Socket == INVALID_SOCKET || m_HasError || m_HasFin || !m_Connected || m_SendBuffer.empty())
+  if (m_Socket == INVALID_SOCKET || m_HasError || m_HasFin || !m_Connected || m_SendQueue.empty())
     return;
 
-  send(m_Socket, m_SendBuffer.c_str(), static_cast<int32_t>(m_SendBuffer.size()), MSG_NOSIGNAL);
-  m_SendBuffer.clear();
+  // best effort: write whatever the kernel accepts right now, and drop the rest
+  m_PollWritable = true;
+  DoSend();
+  ClearSendBuffer();
 }
 
 void CStreamIOSocket::SendReply(const sockaddr_storage* /*address*/, const vector<uint8_t>& message)
@@ -565,6 +733,9 @@ bool CTCPClient::CheckConnect()
   if (m_Socket == INVALID_SOCKET || m_HasError || !m_Connecting)
     return false;
 
+// check if the socket is connected
+
+#ifdef _WIN32
   fd_set fd;
   FD_ZERO(&fd);
   FD_SET(m_Socket, &fd);
@@ -573,12 +744,15 @@ bool CTCPClient::CheckConnect()
   tv.tv_sec  = 0;
   tv.tv_usec = 0;
 
-// check if the socket is connected
-
-#ifdef _WIN32
   if (select(1, nullptr, &fd, nullptr, &tv) == SOCKET_ERROR)
 #else
-  if (select(m_Socket + 1, nullptr, &fd, nullptr, &tv) == SOCKET_ERROR)
+  // poll() rather than select(), since descriptors may exceed FD_SETSIZE
+  pollfd pfd;
+  pfd.fd = m_Socket;
+  pfd.events = POLLOUT;
+  pfd.revents = 0;
+
+  if (poll(&pfd, 1, 0) == SOCKET_ERROR)
 #endif
   {
     m_HasError = true;
@@ -587,7 +761,11 @@ bool CTCPClient::CheckConnect()
     return false;
   }
 
+#ifdef _WIN32
   if (FD_ISSET(m_Socket, &fd))
+#else
+  if (pfd.revents & (POLLOUT | POLLERR | POLLHUP))
+#endif
   {
     m_Connecting = false;
     m_Connected  = true;
@@ -717,46 +895,81 @@ bool CTCPServer::Listen(sockaddr_storage& address, const uint16_t port, bool ret
   return true;
 }
 
-CStreamIOSocket* CTCPServer::Accept(fd_set* fd)
+bool CTCPServer::HandleAcceptError(const int32_t error)
+{
+  switch (error) {
+    case EINTR:
+    case ECONNABORTED:
+      // only the interrupted call, or a single aborted connection - the rest of the backlog is still there
+      return true;
+    case EWOULDBLOCK:
+      // drained - wait for the poller to report the socket again
+      m_PollReadable = false;
+      return false;
+    default:
+      // out of descriptors (EMFILE, ENFILE) or buffers - connections are still queued, but retrying
+      // right away would just spin, so stop polling until the owner resumes it (see CNet::RunPollResumeTimer)
+      if (!m_PollPaused) {
+        Print("[TCP] accept failed (error " + to_string(error) + ") - retrying in " + to_string(SOCKET_POLL_RESUME_TICKS) + " ms");
+      }
+      PausePolling();
+      return false;
+  }
+}
+
+CStreamIOSocket* CTCPServer::Accept()
 {
   if (m_Socket == INVALID_SOCKET || m_HasError)
     return nullptr;
 
-  if (FD_ISSET(m_Socket, fd)) {
-    // a connection is waiting, accept it
+  if (!m_PollReadable)
+    return nullptr;
 
-    sockaddr_storage         address;
-    ADDRESS_LENGTH_TYPE      addressLength = GetAddressLength();
-    SOCKET                   NewSocket;
-    memset(&address, 0, addressLength);
+  // a connection may be waiting, accept it
 
-    if ((NewSocket = accept(m_Socket, reinterpret_cast<struct sockaddr*>(&address), &addressLength)) != INVALID_SOCKET) {
-      ++m_AcceptCounter;
-      CStreamIOSocket* incomingSocket = new CStreamIOSocket(NewSocket, address, this, m_AcceptCounter);
-      incomingSocket->SetKeepAlive(true, 180);
-      return incomingSocket;
+  sockaddr_storage         address;
+  ADDRESS_LENGTH_TYPE      addressLength = GetAddressLength();
+  SOCKET                   NewSocket;
+  memset(&address, 0, addressLength);
+
+  while ((NewSocket = accept(m_Socket, reinterpret_cast<struct sockaddr*>(&address), &addressLength)) == INVALID_SOCKET) {
+    if (!HandleAcceptError(GetLastOSError())) {
+      return nullptr;
     }
+    addressLength = GetAddressLength();
+    memset(&address, 0, addressLength);
   }
 
-  return nullptr;
+  ++m_AcceptCounter;
+  CStreamIOSocket* incomingSocket = new CStreamIOSocket(NewSocket, address, this, m_AcceptCounter);
+  incomingSocket->SetKeepAlive(true, 180);
+  return incomingSocket;
 }
 
-void CTCPServer::Discard(fd_set* fd)
+void CTCPServer::Discard()
 {
   if (m_Socket == INVALID_SOCKET || m_HasError)
     return;
 
-  if (FD_ISSET(m_Socket, fd)) {
-    // a connection is waiting, accept it
+  for (uint16_t i = 0; m_PollReadable && i < SOCKET_ACCEPT_MAX_PER_UPDATE; ++i) {
+    // a connection may be waiting, accept it
 
     sockaddr_storage         address;
     ADDRESS_LENGTH_TYPE      addressLength = GetAddressLength();
     SOCKET                   NewSocket;
     memset(&address, 0, addressLength);
 
-    if ((NewSocket = accept(m_Socket, reinterpret_cast<struct sockaddr*>(&address), &addressLength)) != INVALID_SOCKET) {
-      closesocket(NewSocket);
+    if ((NewSocket = accept(m_Socket, reinterpret_cast<struct sockaddr*>(&address), &addressLength)) == INVALID_SOCKET) {
+      if (!HandleAcceptError(GetLastOSError())) {
+        return;
+      }
+      continue;
     }
+    closesocket(NewSocket);
+  }
+
+  if (m_PollReadable && m_Poller) {
+    m_Poller->SetBacklogged();
   }
 }
 
@@ -940,35 +1153,56 @@ bool CUDPServer::Listen(sockaddr_storage& address, const uint16_t port, bool ret
   return true;
 }
 
-UDPPkt* CUDPServer::Accept(fd_set* fd) {
+bool CUDPServer::HandleRecvError(const int32_t error)
+{
+  switch (error) {
+    case EINTR:
+    case ECONNREFUSED:
+    case ECONNRESET:
+    case EMSGSIZE:
+      // interrupted call, ICMP errors reported for a previous datagram we sent (ECONNREFUSED, or ECONNRESET on Windows),
+      // or an oversized datagram that has already been discarded - more datagrams may be queued behind
+      return true;
+    case EWOULDBLOCK:
+      // drained - wait for the poller to report the socket again
+      m_PollReadable = false;
+      return false;
+    default:
+      // out of buffers (ENOBUFS, ENOMEM) - datagrams may still be queued, but retrying
+      // right away would just spin, so stop polling until the owner resumes it (see CNet::RunPollResumeTimer)
+      if (!m_PollPaused) {
+        Print("[UDP] receive failed (error " + to_string(error) + ") - retrying in " + to_string(SOCKET_POLL_RESUME_TICKS) + " ms");
+      }
+      PausePolling();
+      return false;
+  }
+}
+
+UDPPkt* CUDPServer::Accept() {
   if (m_Socket == INVALID_SOCKET || m_HasError) {
     return nullptr;
   }
 
-  if (!FD_ISSET(m_Socket, fd)) {
+  if (!m_PollReadable) {
     return nullptr;
   }
 
   char buffer[1024];
   sockaddr_storage* address = new sockaddr_storage(); // It's the responsibility of the caller to delete this.
-  ADDRESS_LENGTH_TYPE addressLength = sizeof(sockaddr_storage);
-
-  int bytesRead = recvfrom(m_Socket, buffer, sizeof(buffer), 0, reinterpret_cast<struct sockaddr*>(address), &addressLength);
-#ifdef _WIN32
-  if (bytesRead == SOCKET_ERROR) {
-    //int error = WSAGetLastError();
-#else
-  if (bytesRead < 0) {
-    //int error = errno;
-#endif
-    //Print("Error code " + to_string(error) + " receiving data from " + AddressToString(*pkt.sender));
-    delete address;
-    return nullptr;
-  }
-  if (bytesRead < W3GS_UDP_MIN_PACKET_SIZE) {
-    delete address;
-    return nullptr;
-  }
+  int bytesRead = 0;
+
+  // skip over runt datagrams, so that they don't hide valid ones queued behind them
+  do {
+    ADDRESS_LENGTH_TYPE addressLength = sizeof(sockaddr_storage);
+    bytesRead = recvfrom(m_Socket, buffer, sizeof(buffer), 0, reinterpret_cast<struct sockaddr*>(address), &addressLength);
+    if (bytesRead == SOCKET_ERROR) {
+      if (HandleRecvError(GetLastOSError())) {
+        continue;
+      }
+      delete address;
+      return nullptr;
+    }
+  } while (bytesRead < W3GS_UDP_MIN_PACKET_SIZE);
 
   UDPPkt* pkt = new UDPPkt();
   if (pkt == nullptr)
@@ -981,15 +1215,19 @@ UDPPkt* CUDPServer::Accept(fd_set* fd) {
   return pkt;
 }
 
-void CUDPServer::Discard(fd_set* fd) {
+void CUDPServer::Discard() {
   if (m_Socket == INVALID_SOCKET || m_HasError) {
     return;
   }
 
-  if (!FD_ISSET(m_Socket, fd)){
-    return;
-  }
-  
   char buffer[1024];
-  recv(m_Socket, buffer, sizeof(buffer), 0);
+  for (uint16_t i = 0; m_PollReadable && i < SOCKET_ACCEPT_MAX_PER_UPDATE; ++i) {
+    if (recv(m_Socket, buffer, sizeof(buffer), 0) == SOCKET_ERROR && !HandleRecvError(GetLastOSError())) {
+      break;
+    }
+  }
+
+  if (m_PollReadable && m_Poller) {
+    m_Poller->SetBacklogged();
+  }
 }
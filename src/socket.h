@@ -48,6 +48,8 @@
 
 #include "includes.h"
 #include "util.h"
+#include "stream_buffer.h"
+#include "protocol/packet_view.h"
 
 #ifdef _WIN32
 #pragma once
@@ -140,9 +142,11 @@
 #include <netdb.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
+#include <poll.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 typedef int32_t SOCKET;
@@ -399,7 +403,12 @@ public:
   uint16_t           m_Port;
   bool               m_HasError;
   bool               m_HasFin;
+  bool               m_PollReadable;
+  bool               m_PollWritable;
+  bool               m_PollPaused;      // readiness is not reported until ResumePolling()
   int                m_Error;
+  size_t             m_PollIndex;
+  CSocketPoller*     m_Poller;
   std::string        m_Name;
 
   CSocket(const uint8_t nFamily);
@@ -416,6 +425,12 @@ public:
   [[nodiscard]] inline bool                     HasError() const { return m_HasError; }
   [[nodiscard]] inline bool                     HasFin() const { return m_HasFin; }
   inline void                                   SetErrored(const bool nErrored) { m_HasError = nErrored; }
+  [[nodiscard]] inline bool                     GetIsReadable() const { return m_PollReadable; }
+  [[nodiscard]] inline bool                     GetIsWritable() const { return m_PollWritable; }
+  [[nodiscard]] inline bool                     GetIsPollPaused() const { return m_PollPaused; }
+  inline void                                   SetPollReady(const bool readable, const bool writable) { m_PollReadable = readable && !m_PollPaused; m_PollWritable = writable; }
+  inline void                                   PausePolling() { m_PollPaused = true; m_PollReadable = false; }
+  void                                          ResumePolling();
 
   [[nodiscard]] inline ADDRESS_LENGTH_TYPE  GetAddressLength() const {
     if (m_Family == AF_INET6)
@@ -423,13 +438,44 @@ public:
     return sizeof(sockaddr_in);
   }
 
-  void SetFD(fd_set* fd, fd_set* send_fd, int32_t* nfds);
+  void RegisterPoller();
+  void UnregisterPoller();
   void Reset();
   void Allocate(const uint8_t family, int type);
 
   virtual void SendReply(const sockaddr_storage* address, const std::vector<uint8_t>& packet);
 };
 
+//
+// SocketSendSlice
+//
+// Outgoing data is queued as a sequence of slices, which DoSend() hands to the kernel in a single vectored call.
+// Slices without an owner stand for the next m_Size bytes staged in m_SendBuffer.
+// Slices with an owner reference a shared payload (broadcast packets, map chunks) without copying it.
+//
+
+struct SocketSendSlice
+{
+  SharedPacket               m_Owner;
+  size_t                     m_Offset;
+  size_t                     m_Size;
+
+  SocketSendSlice(const size_t nSize)
+    : m_Offset(0),
+      m_Size(nSize)
+  {
+  }
+
+  SocketSendSlice(const SharedPacket& nOwner, const size_t nOffset, const size_t nSize)
+    : m_Owner(nOwner),
+      m_Offset(nOffset),
+      m_Size(nSize)
+  {
+  }
+
+  [[nodiscard]] inline bool GetIsStaged() const { return m_Owner == nullptr; }
+};
+
 //
 // CStreamIOSocket
 //
@@ -437,8 +483,10 @@ public:
 class CStreamIOSocket : public CSocket
 {
 public:
-  std::string                m_RecvBuffer;
-  std::string                m_SendBuffer;
+  CStreamBuffer              m_RecvBuffer;
+  CStreamBuffer              m_SendBuffer;
+  std::deque<SocketSendSlice> m_SendQueue;
+  size_t                     m_SendQueueSize;
   uint32_t                   m_RemoteSocketCounter;
   int64_t                    m_LastRecv;
   bool                       m_Connected;
@@ -469,27 +517,41 @@ public:
   [[nodiscard]] inline bool                       GetLogErrors() const { return m_LogErrors; }
   void Disconnect();
 
-  [[nodiscard]] inline std::string*               GetBytes() { return &m_RecvBuffer; }
-  [[nodiscard]] inline std::string::size_type     GetRecvBufferSize() { return m_RecvBuffer.size(); }
-  inline void ClearRecvBuffer() { m_RecvBuffer.clear(); }
-  inline void SubstrRecvBuffer(uint32_t i) { m_RecvBuffer = m_RecvBuffer.substr(i); }
-  bool DoRecv(fd_set* fd);
-  void Discard(fd_set* fd);
+  [[nodiscard]] inline CStreamBuffer*             GetBytes() { return &m_RecvBuffer; }
+  [[nodiscard]] inline size_t                     GetRecvBufferSize() const { return m_RecvBuffer.GetSize(); }
+  inline void ClearRecvBuffer() { m_RecvBuffer.Clear(); }
+  inline void ConsumeRecvBuffer(const size_t count) { m_RecvBuffer.Consume(count); }
+  bool DoRecv();
+  void Discard();
 
   inline size_t                                 PutBytes(const std::string& bytes) {
-    m_SendBuffer += bytes;
+    m_SendBuffer.Append(bytes);
+    StageSendBytes(bytes.size());
     return bytes.size();
   }
   inline size_t                                 PutBytes(const std::vector<uint8_t>& bytes) {
-    m_SendBuffer += std::string(begin(bytes), end(bytes));
+    m_SendBuffer.Append(bytes);
+    StageSendBytes(bytes.size());
     return bytes.size();
   }
-  [[nodiscard]] inline std::string::size_type   GetSendBufferSize() { return m_SendBuffer.size(); }
-  inline void                                   ClearSendBuffer() { m_SendBuffer.clear(); }
-  inline void                                   SubstrSendBuffer(uint32_t i) { m_SendBuffer = m_SendBuffer.substr(i); }
-  [[nodiscard]] inline bool                     GetIsSendPending() { return !m_SendBuffer.empty(); }
+  inline size_t                                 PutBytes(const uint8_t* bytes, const size_t size) {
+    m_SendBuffer.Append(bytes, size);
+    StageSendBytes(size);
+    return size;
+  }
+  inline size_t                                 PutBuffer(CStreamBuffer& buffer) {
+    const size_t size = buffer.GetSize();
+    m_SendBuffer.AppendMove(buffer);
+    StageSendBytes(size);
+    return size;
+  }
+  inline size_t                                 PutPacket(const SharedPacket& packet) { return PutSlice(packet, 0, packet->size()); }
+  size_t                                        PutSlice(const SharedPacket& owner, const size_t offset, const size_t size);
+  [[nodiscard]] inline size_t                   GetSendBufferSize() const { return m_SendQueueSize; }
+  void                                          ClearSendBuffer();
+  [[nodiscard]] inline bool                     GetIsSendPending() const { return m_SendQueueSize > 0; }
   [[nodiscard]] std::optional<uint32_t>         GetRTT() const;
-  void DoSend(fd_set* send_fd);
+  void DoSend();
   void Flush();
 
   void Close();
@@ -499,6 +561,10 @@ public:
   void SetQuickAck(const bool quickAck);
   void SetKeepAlive(const bool keepAlive, const uint32_t seconds);
   inline void SetLogErrors(const bool nLogErrors) { m_LogErrors = nLogErrors; }
+
+private:
+  void StageSendBytes(const size_t size);
+  void ConsumeSendQueue(size_t count);
 };
 
 //
@@ -538,8 +604,11 @@ public:
 
   [[nodiscard]] std::string       GetName() const;
   bool                            Listen(sockaddr_storage& address, const uint16_t port, bool retry);
-  [[nodiscard]] CStreamIOSocket*  Accept(fd_set* fd);
-  void                            Discard(fd_set* fd);
+  [[nodiscard]] CStreamIOSocket*  Accept();
+  void                            Discard();
+
+private:
+  bool                            HandleAcceptError(const int32_t error);
 };
 
 //
@@ -570,8 +639,11 @@ public:
 
   [[nodiscard]] std::string   GetName() const;
   bool                        Listen(sockaddr_storage& address, const uint16_t port, bool retry);
-  [[nodiscard]] UDPPkt*       Accept(fd_set* fd);
-  void                        Discard(fd_set* fd);
+  [[nodiscard]] UDPPkt*       Accept();
+  void                        Discard();
+
+private:
+  bool                        HandleRecvError(const int32_t error);
 };
 
 #endif // AURA_SOCKET_H_
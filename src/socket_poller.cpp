@@ -0,0 +1,254 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#ifdef _WIN32
+// winsock sizes fd_set at compile time, and defaults to just 64 sockets
+#define FD_SETSIZE 512
+#endif
+
+#include "socket_poller.h"
+#include "socket.h"
+#include "util.h"
+
+#ifdef AURA_HAS_EPOLL
+#include <sys/epoll.h>
+#endif
+
+using namespace std;
+
+//
+// CSocketPoller
+//
+
+CSocketPoller::CSocketPoller()
+  : m_Backlogged(false)
+{
+}
+
+CSocketPoller::~CSocketPoller()
+{
+  for (auto& socket : m_Sockets) {
+    socket->m_Poller = nullptr;
+    socket->SetPollReady(false, false);
+  }
+}
+
+void CSocketPoller::Register(CSocket* socket)
+{
+  if (!RegisterInner(socket)) {
+    return;
+  }
+  socket->m_Poller = this;
+  socket->m_PollIndex = m_Sockets.size();
+  socket->SetPollReady(false, false);
+  m_Sockets.push_back(socket);
+}
+
+void CSocketPoller::Unregister(CSocket* socket)
+{
+  UnregisterInner(socket);
+
+  // swap-and-pop, so that closing sockets is O(1)
+  CSocket* lastSocket = m_Sockets.back();
+  m_Sockets[socket->m_PollIndex] = lastSocket;
+  lastSocket->m_PollIndex = socket->m_PollIndex;
+  m_Sockets.pop_back();
+
+  socket->m_Poller = nullptr;
+  socket->m_PollIndex = 0;
+  socket->SetPollReady(false, false);
+}
+
+void CSocketPoller::Wait(int64_t usecBlock)
+{
+  if (m_Backlogged) {
+    usecBlock = 0;
+    m_Backlogged = false;
+  }
+  WaitInner(usecBlock);
+}
+
+CSocketPoller* CSocketPoller::GetThreadPoller()
+{
+  // Each thread running an event loop owns its poller.
+  // It's released on thread exit, after the sockets owned by that thread.
+  thread_local unique_ptr<CSocketPoller> threadPoller;
+
+  if (!threadPoller) {
+#ifdef AURA_HAS_EPOLL
+    CEPollPoller* ePollPoller = new CEPollPoller();
+    if (ePollPoller->GetIsValid()) {
+      threadPoller.reset(ePollPoller);
+    } else {
+      Print("[POLL] epoll unavailable (error " + to_string(GetLastOSError()) + ") - falling back to select()");
+      delete ePollPoller;
+      threadPoller.reset(new CSelectPoller());
+    }
+#else
+    threadPoller.reset(new CSelectPoller());
+#endif
+  }
+
+  return threadPoller.get();
+}
+
+//
+// CSelectPoller
+//
+
+CSelectPoller::CSelectPoller()
+{
+}
+
+CSelectPoller::~CSelectPoller()
+{
+}
+
+bool CSelectPoller::RegisterInner(CSocket* socket)
+{
+#ifdef _WIN32
+  if (m_Sockets.size() >= FD_SETSIZE) {
+#else
+  if (socket->m_Socket >= FD_SETSIZE) {
+#endif
+    Print("[POLL] warning - too many sockets for select() (max " + to_string(FD_SETSIZE) + "). [" + socket->GetName() + "] ignored.");
+    return false;
+  }
+  return true;
+}
+
+void CSelectPoller::UnregisterInner(CSocket* /*socket*/)
+{
+}
+
+void CSelectPoller::WaitInner(int64_t usecBlock)
+{
+  int32_t nfds = 0;
+  fd_set fd, send_fd;
+  FD_ZERO(&fd);
+  FD_ZERO(&send_fd);
+
+  for (const auto& socket : m_Sockets) {
+    // a paused socket would be reported readable over and over
+    if (!socket->GetIsPollPaused()) FD_SET(socket->m_Socket, &fd);
+    FD_SET(socket->m_Socket, &send_fd);
+#ifndef _WIN32
+    if (socket->m_Socket > nfds)
+      nfds = socket->m_Socket;
+#endif
+  }
+
+  struct timeval tv;
+  tv.tv_sec  = static_cast<long int>(usecBlock / 1000000);
+  tv.tv_usec = static_cast<long int>(usecBlock % 1000000);
+
+  struct timeval send_tv;
+  send_tv.tv_sec  = 0;
+  send_tv.tv_usec = 0;
+
+#ifdef _WIN32
+  select(1, &fd, nullptr, nullptr, &tv);
+  select(1, nullptr, &send_fd, nullptr, &send_tv);
+#else
+  select(nfds + 1, &fd, nullptr, nullptr, &tv);
+  select(nfds + 1, nullptr, &send_fd, nullptr, &send_tv);
+#endif
+
+  // level-triggered: readiness is fully recomputed on every call
+  for (auto& socket : m_Sockets) {
+    socket->SetPollReady(FD_ISSET(socket->m_Socket, &fd), FD_ISSET(socket->m_Socket, &send_fd));
+  }
+}
+
+#ifdef AURA_HAS_EPOLL
+
+//
+// CEPollPoller
+//
+
+CEPollPoller::CEPollPoller()
+  : m_EPollFD(epoll_create1(EPOLL_CLOEXEC))
+{
+}
+
+CEPollPoller::~CEPollPoller()
+{
+  if (m_EPollFD != -1) {
+    close(m_EPollFD);
+  }
+}
+
+bool CEPollPoller::RegisterInner(CSocket* socket)
+{
+  epoll_event event;
+  memset(&event, 0, sizeof(epoll_event));
+  event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+  event.data.ptr = socket;
+
+  if (epoll_ctl(m_EPollFD, EPOLL_CTL_ADD, socket->m_Socket, &event) == -1) {
+    Print("[POLL] error (epoll_ctl) - cannot register [" + socket->GetName() + "] - error " + to_string(GetLastOSError()));
+    return false;
+  }
+  return true;
+}
+
+void CEPollPoller::UnregisterInner(CSocket* socket)
+{
+  // must happen before the descriptor is closed, or a duplicated descriptor could keep it alive in the interest list
+  epoll_ctl(m_EPollFD, EPOLL_CTL_DEL, socket->m_Socket, nullptr);
+}
+
+void CEPollPoller::WaitInner(int64_t usecBlock)
+{
+  epoll_event events[SOCKET_POLLER_MAX_EVENTS];
+  int timeout = static_cast<int>((usecBlock + 999) / 1000);
+
+  while (true) {
+    int count = epoll_wait(m_EPollFD, events, SOCKET_POLLER_MAX_EVENTS, timeout);
+    if (count <= 0) {
+      // timed out, or interrupted by a signal
+      return;
+    }
+
+    // edge-triggered: flags are only raised here, and sockets lower them once they hit EWOULDBLOCK
+    for (int i = 0; i < count; ++i) {
+      CSocket* socket = static_cast<CSocket*>(events[i].data.ptr);
+      const uint32_t flags = events[i].events;
+      socket->SetPollReady(
+        socket->GetIsReadable() || (flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0,
+        socket->GetIsWritable() || (flags & (EPOLLOUT | EPOLLHUP | EPOLLERR)) != 0
+      );
+    }
+
+    if (count < SOCKET_POLLER_MAX_EVENTS) {
+      return;
+    }
+
+    // more events may be pending
+    timeout = 0;
+  }
+}
+
+#endif
@@ -0,0 +1,118 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#ifndef AURA_SOCKET_POLLER_H_
+#define AURA_SOCKET_POLLER_H_
+
+#include "includes.h"
+
+#if defined(__linux__) && !defined(DISABLE_EPOLL)
+#define AURA_HAS_EPOLL 1
+#endif
+
+//
+// CSocketPoller
+//
+// Sockets register themselves once their descriptor is allocated, and unregister before it's closed.
+// Wait() blocks until any of them becomes ready, and flags them through CSocket::SetPollReady,
+// so that owners may call DoRecv/DoSend/Accept without any per-loop bookkeeping.
+//
+// Readiness flags are sticky: they are only cleared by the socket itself, when an I/O call reports EWOULDBLOCK.
+// This allows the edge-triggered epoll backend to share the same contract as the level-triggered select() one.
+//
+
+class CSocketPoller
+{
+public:
+  std::vector<CSocket*>      m_Sockets;
+  bool                       m_Backlogged;
+
+  CSocketPoller();
+  virtual ~CSocketPoller();
+  CSocketPoller(CSocketPoller&) = delete;
+
+  [[nodiscard]] virtual const char* GetName() const = 0;
+  [[nodiscard]] inline size_t       GetSocketCount() const { return m_Sockets.size(); }
+
+  // A socket that stopped reading before hitting EWOULDBLOCK won't be notified again by edge-triggered backends.
+  // Marking the poller as backlogged ensures the next Wait() won't block.
+  inline void                       SetBacklogged() { m_Backlogged = true; }
+
+  void                              Register(CSocket* socket);
+  void                              Unregister(CSocket* socket);
+  void                              Wait(int64_t usecBlock);
+
+  [[nodiscard]] static CSocketPoller* GetThreadPoller();
+
+protected:
+  virtual bool                      RegisterInner(CSocket* socket) = 0;
+  virtual void                      UnregisterInner(CSocket* socket) = 0;
+  virtual void                      WaitInner(int64_t usecBlock) = 0;
+};
+
+//
+// CSelectPoller
+//
+
+class CSelectPoller final : public CSocketPoller
+{
+public:
+  CSelectPoller();
+  ~CSelectPoller() final;
+
+  [[nodiscard]] const char* GetName() const final { return "select"; }
+
+protected:
+  bool                      RegisterInner(CSocket* socket) final;
+  void                      UnregisterInner(CSocket* socket) final;
+  void                      WaitInner(int64_t usecBlock) final;
+};
+
+#ifdef AURA_HAS_EPOLL
+
+//
+// CEPollPoller
+//
+
+class CEPollPoller final : public CSocketPoller
+{
+public:
+  int                       m_EPollFD;
+
+  CEPollPoller();
+  ~CEPollPoller() final;
+
+  [[nodiscard]] const char*  GetName() const final { return "epoll"; }
+  [[nodiscard]] inline bool  GetIsValid() const { return m_EPollFD != -1; }
+
+protected:
+  bool                      RegisterInner(CSocket* socket) final;
+  void                      UnregisterInner(CSocket* socket) final;
+  void                      WaitInner(int64_t usecBlock) final;
+};
+
+#endif
+
+#endif // AURA_SOCKET_POLLER_H_
@@ -0,0 +1,122 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#include "stream_buffer.h"
+
+using namespace std;
+
+//
+// CStreamBuffer
+//
+
+CStreamBuffer::CStreamBuffer()
+  : m_Storage(nullptr),
+    m_Capacity(0),
+    m_Head(0),
+    m_Tail(0)
+{
+}
+
+CStreamBuffer::~CStreamBuffer()
+{
+  delete[] m_Storage;
+}
+
+void CStreamBuffer::Reserve(const size_t minSize)
+{
+  if (m_Capacity - m_Tail >= minSize) {
+    return;
+  }
+
+  const size_t dataSize = GetSize();
+  if (m_Head > 0 && m_Capacity - dataSize >= minSize && dataSize <= m_Capacity / 2) {
+    // there is enough room if we just slide the unread bytes back to the start
+    memmove(m_Storage, m_Storage + m_Head, dataSize);
+    m_Head = 0;
+    m_Tail = dataSize;
+    return;
+  }
+
+  size_t newCapacity = m_Capacity < STREAM_BUFFER_MIN_CAPACITY ? STREAM_BUFFER_MIN_CAPACITY : m_Capacity;
+  while (newCapacity - dataSize < minSize) {
+    newCapacity *= 2;
+  }
+
+  uint8_t* newStorage = new uint8_t[newCapacity];
+  if (dataSize > 0) {
+    memcpy(newStorage, m_Storage + m_Head, dataSize);
+  }
+  delete[] m_Storage;
+  m_Storage = newStorage;
+  m_Capacity = newCapacity;
+  m_Head = 0;
+  m_Tail = dataSize;
+}
+
+uint8_t* CStreamBuffer::PrepareWrite(const size_t minSize)
+{
+  Reserve(minSize);
+  return m_Storage + m_Tail;
+}
+
+void CStreamBuffer::Append(const uint8_t* data, const size_t size)
+{
+  if (size == 0) {
+    return;
+  }
+  Reserve(size);
+  memcpy(m_Storage + m_Tail, data, size);
+  m_Tail += size;
+}
+
+void CStreamBuffer::AppendMove(CStreamBuffer& other)
+{
+  if (GetIsEmpty()) {
+    Swap(other);
+  } else {
+    Append(other.GetData(), other.GetSize());
+  }
+  other.Clear();
+}
+
+void CStreamBuffer::Clear()
+{
+  m_Head = m_Tail = 0;
+
+  // don't hold on to the memory claimed by a burst, such as a map upload
+  if (m_Capacity > STREAM_BUFFER_MAX_IDLE_CAPACITY) {
+    delete[] m_Storage;
+    m_Storage = nullptr;
+    m_Capacity = 0;
+  }
+}
+
+void CStreamBuffer::Swap(CStreamBuffer& other)
+{
+  swap(m_Storage, other.m_Storage);
+  swap(m_Capacity, other.m_Capacity);
+  swap(m_Head, other.m_Head);
+  swap(m_Tail, other.m_Tail);
+}
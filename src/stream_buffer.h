@@ -0,0 +1,86 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#ifndef AURA_STREAM_BUFFER_H_
+#define AURA_STREAM_BUFFER_H_
+
+#include "includes.h"
+
+//
+// CStreamBuffer
+//
+// Growable byte queue backing socket I/O.
+// Unread bytes always lie in a single contiguous span [GetData(), GetData() + GetSize()),
+// so that packet parsers can peek at them in place, while consuming from the front is O(1).
+// The free space in front of the span is reclaimed lazily, by sliding the span back when writes run out of room.
+//
+
+class CStreamBuffer
+{
+public:
+  uint8_t*                  m_Storage;
+  size_t                    m_Capacity;
+  size_t                    m_Head;
+  size_t                    m_Tail;
+
+  CStreamBuffer();
+  ~CStreamBuffer();
+  CStreamBuffer(const CStreamBuffer&) = delete;
+  CStreamBuffer& operator=(const CStreamBuffer&) = delete;
+
+  [[nodiscard]] inline const uint8_t*   GetData() const { return m_Storage + m_Head; }
+  [[nodiscard]] inline size_t           GetSize() const { return m_Tail - m_Head; }
+  [[nodiscard]] inline bool             GetIsEmpty() const { return m_Tail == m_Head; }
+  [[nodiscard]] inline size_t           GetCapacity() const { return m_Capacity; }
+  [[nodiscard]] inline std::string_view GetView() const { return std::string_view(reinterpret_cast<const char*>(GetData()), GetSize()); }
+
+  inline void Consume(const size_t count) {
+    m_Head += count < GetSize() ? count : GetSize();
+    if (m_Head == m_Tail) {
+      m_Head = m_Tail = 0;
+    }
+  }
+
+  // Returns a pointer to at least minSize writable bytes past the end of the data.
+  // Bytes actually written must then be published with CommitWrite.
+  [[nodiscard]] uint8_t*                PrepareWrite(const size_t minSize);
+  inline void                           CommitWrite(const size_t count) { m_Tail += count; }
+
+  void Append(const uint8_t* data, const size_t size);
+  inline void Append(const std::vector<uint8_t>& data) { Append(data.data(), data.size()); }
+  inline void Append(const std::string& data) { Append(reinterpret_cast<const uint8_t*>(data.data()), data.size()); }
+
+  // Moves all bytes from another buffer to the end of this one.
+  // Swaps storage instead of copying whenever this buffer is empty.
+  void AppendMove(CStreamBuffer& other);
+
+  void Clear();
+  void Swap(CStreamBuffer& other);
+
+private:
+  void Reserve(const size_t minSize);
+};
+
+#endif // AURA_STREAM_BUFFER_H_
@@ -0,0 +1,382 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+#include "benchmark.h"
+#include "../util.h"
+#include "../file_util.h"
+#include "../file_hash.h"
+#include "../auradb.h"
+#include "../edit_distance.h"
+#include "../map.h"
+#include "../map_upload_scheduler.h"
+
+#include <crc32/crc32.h>
+#include <sha1/sha1.h>
+
+#include <deque>
+#include <fstream>
+
+using namespace std;
+
+namespace
+{
+  [[nodiscard]] int64_t GetElapsedMicroseconds(const chrono::steady_clock::time_point& start)
+  {
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+  }
+
+  [[nodiscard]] string GetThroughput(const size_t bytes, const int64_t microseconds)
+  {
+    if (microseconds <= 0) return "inf MB/s";
+    return to_string(static_cast<uint64_t>(static_cast<double>(bytes) / static_cast<double>(microseconds))) + " MB/s";
+  }
+
+  // Reference implementation: read and hash each block in turn, on a single thread.
+  [[nodiscard]] optional<FileHashDigest> HashFileSequential(const filesystem::path& filePath, const size_t blockSize)
+  {
+    optional<FileHashDigest> digest;
+    ifstream fileStream(filePath, ios::in | ios::binary);
+    if (!fileStream.is_open()) return digest;
+
+    vector<uint8_t> block(blockSize);
+    CSHA1 sha1;
+    sha1.Reset();
+    digest.emplace();
+    while (fileStream.read(reinterpret_cast<char*>(block.data()), block.size()) || fileStream.gcount() > 0) {
+      const size_t readSize = static_cast<size_t>(fileStream.gcount());
+      digest->crc32 = CRC32::CalculateCRC(block.data(), readSize, digest->crc32);
+      sha1.Update(block.data(), readSize);
+      digest->size += readSize;
+    }
+    sha1.Final();
+    sha1.GetHash(digest->sha1.data());
+    return digest;
+  }
+
+  // Reference implementation: the full dynamic programming table, skipped only by length.
+  [[nodiscard]] string::size_type GetEditDistanceTable(const string& s1, const string& s2, const string::size_type bestDistance)
+  {
+    const string::size_type m = s1.length(), n = s2.length();
+    if (m > n + bestDistance) return m - n;
+    if (n > m + bestDistance) return n - m;
+    vector<vector<string::size_type>> dp(m + 1, vector<string::size_type>(n + 1, 0));
+    for (string::size_type i = 0; i <= m; ++i) {
+      for (string::size_type j = 0; j <= n; ++j) {
+        if (i == 0) {
+          dp[i][j] = j;
+        } else if (j == 0) {
+          dp[i][j] = i;
+        } else if (s1[i - 1] == s2[j - 1]) {
+          dp[i][j] = dp[i - 1][j - 1];
+        } else {
+          string::size_type cost = (isdigit(s1[i - 1]) || isdigit(s2[j - 1])) ? 3 : 1;
+          dp[i][j] = min({ dp[i - 1][j] + 1, dp[i][j - 1] + 1, dp[i - 1][j - 1] + cost });
+        }
+      }
+    }
+    return dp[m][n];
+  }
+
+  // Scores every query against the whole corpus, as CSearchableMapData::Search does.
+  void BenchEditDistanceCorpus(const string& corpusName, const vector<string>& corpus)
+  {
+    if (corpus.empty()) {
+      Print("[BENCH] edit distance (" + corpusName + ") - corpus not found, skipped");
+      return;
+    }
+
+    // queries are corpus entries with a few reproducible typos
+    vector<string> queries;
+    uint32_t state = 0x9E3779B9;
+    for (size_t i = 0; i < 200; ++i) {
+      state = state * 1103515245 + 12345;
+      string query = corpus[(state >> 8) % corpus.size()];
+      for (uint8_t typos = 0; typos < 2 && !query.empty(); ++typos) {
+        state = state * 1103515245 + 12345;
+        query[(state >> 8) % query.size()] = static_cast<char>('a' + (state >> 24) % 26);
+      }
+      queries.push_back(move(query));
+    }
+
+    size_t tableChecksum = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (const auto& query : queries) {
+      string::size_type bestDistance = query.size() / 3 + 1;
+      for (const auto& element : corpus) {
+        string::size_type distance = GetEditDistanceTable(element, query, bestDistance);
+        if (distance < bestDistance) bestDistance = distance;
+      }
+      tableChecksum += bestDistance;
+    }
+    const int64_t tableTime = GetElapsedMicroseconds(start);
+
+    size_t bitParallelChecksum = 0;
+    start = chrono::steady_clock::now();
+    for (const auto& query : queries) {
+      string::size_type bestDistance = query.size() / 3 + 1;
+      optional<pair<size_t, string::size_type>> closest = CEditDistancePattern(query).FindClosest(corpus, bestDistance - 1);
+      if (closest.has_value()) bestDistance = closest->second;
+      bitParallelChecksum += bestDistance;
+    }
+    const int64_t bitParallelTime = GetElapsedMicroseconds(start);
+
+    Print(
+      "[BENCH] edit distance (" + corpusName + ", " + to_string(corpus.size()) + " names, " + to_string(queries.size()) + " queries) - " +
+      "table: " + to_string(tableTime) + " us, bit-parallel: " + to_string(bitParallelTime) + " us" +
+      (tableChecksum == bitParallelChecksum ? "" : " - MISMATCH")
+    );
+  }
+
+  // A downloader behind a link of fixed bandwidth and round-trip time.
+  // Its send queue is drained at link speed; map parts are acknowledged one round trip after they leave it.
+  struct SimulatedPeer
+  {
+    struct QueuedItem
+    {
+      bool                                      isChat;
+      uint32_t                                  offsetEnd;
+      size_t                                    remaining;
+      int64_t                                   queuedTicks;
+    };
+
+    string                                      name;
+    uint32_t                                    rtt;
+    uint32_t                                    bandwidth;              // bytes per second
+    uint8_t                                     weight;
+    MapTransfer                                 transfer;
+    deque<QueuedItem>                           queue;
+    size_t                                      queuedBytes;
+    deque<pair<int64_t, uint32_t>>              acks;
+    int64_t                                     finishedTicks;
+    int64_t                                     maxChatDelay;
+    int64_t                                     totalChatDelay;
+    uint32_t                                    chatCount;
+
+    SimulatedPeer(string nName, const uint32_t nRTT, const uint32_t nBandwidth, const uint8_t nWeight)
+     : name(move(nName)), rtt(nRTT), bandwidth(nBandwidth), weight(nWeight), queuedBytes(0),
+       finishedTicks(0), maxChatDelay(0), totalChatDelay(0), chatCount(0)
+    {
+      transfer.Start();
+    }
+
+    uint32_t GetNextMapPartSize(const uint32_t mapSize) const
+    {
+      return min(MAP_PART_SIZE, mapSize - transfer.GetLastSentOffsetEnd());
+    }
+
+    void SendMapPart(const uint32_t mapSize, const int64_t ticks)
+    {
+      const uint32_t size = GetNextMapPartSize(mapSize);
+      transfer.SetLastSentOffsetEnd(transfer.GetLastSentOffsetEnd() + size);
+      queue.push_back({false, transfer.GetLastSentOffsetEnd(), size + 12, ticks});
+      queuedBytes += size + 12;
+    }
+
+    // same as CGame::NextSendMap
+    void SendMapParts(const uint32_t maxBytes, const uint32_t mapSize, const int64_t ticks)
+    {
+      uint32_t sentBytes = 0;
+      while (sentBytes < maxBytes && transfer.GetLastSentOffsetEnd() < mapSize) {
+        const uint32_t size = GetNextMapPartSize(mapSize);
+        if (sentBytes + size > maxBytes) break;
+        SendMapPart(mapSize, ticks);
+        sentBytes += size;
+      }
+      transfer.SetUploadCredit(transfer.GetUploadCredit() + (maxBytes - sentBytes));
+    }
+
+    void Tick(const int64_t ticks, const int64_t elapsed, const uint32_t mapSize)
+    {
+      while (!acks.empty() && acks.front().first <= ticks) {
+        transfer.SetLastAck(acks.front().second);
+        acks.pop_front();
+      }
+      if (finishedTicks == 0 && transfer.GetLastAck() >= mapSize) {
+        finishedTicks = ticks;
+      }
+      size_t drain = static_cast<size_t>(static_cast<uint64_t>(bandwidth) * elapsed / 1000);
+      while (drain > 0 && !queue.empty()) {
+        QueuedItem& item = queue.front();
+        const size_t size = min(drain, item.remaining);
+        item.remaining -= size;
+        queuedBytes -= size;
+        drain -= size;
+        if (item.remaining > 0) break;
+        if (item.isChat) {
+          const int64_t delay = ticks + rtt / 2 - item.queuedTicks;
+          maxChatDelay = max(maxChatDelay, delay);
+          totalChatDelay += delay;
+          ++chatCount;
+        } else {
+          acks.emplace_back(ticks + rtt, item.offsetEnd);
+        }
+        queue.pop_front();
+      }
+    }
+  };
+
+  // Plays a lobby full of downloaders with mixed links, until they all have the map.
+  // Chat lines are queued to every downloader once per second, to see how late lobby traffic gets.
+  void BenchMapUploadsScenario(const bool useScheduler, const uint64_t budget, const uint32_t mapSize)
+  {
+    vector<SimulatedPeer> peers;
+    peers.emplace_back("LAN", 5, 8 * 1024 * 1024, MAP_UPLOAD_WEIGHT_PLAYER);
+    peers.emplace_back("cable", 40, 2 * 1024 * 1024, MAP_UPLOAD_WEIGHT_PLAYER);
+    peers.emplace_back("DSL", 120, 512 * 1024, MAP_UPLOAD_WEIGHT_PLAYER);
+    peers.emplace_back("overseas", 300, 256 * 1024, MAP_UPLOAD_WEIGHT_PLAYER);
+    peers.emplace_back("3G", 600, 96 * 1024, MAP_UPLOAD_WEIGHT_PLAYER);
+    peers.emplace_back("observer", 80, 4 * 1024 * 1024, MAP_UPLOAD_WEIGHT_OBSERVER);
+
+    CMapUploadScheduler scheduler;
+    const int64_t stepTicks = 10;
+    const int64_t maxTicks = 900000;
+    int64_t ticks = 1;
+    for (; ticks < maxTicks; ticks += stepTicks) {
+      bool allFinished = true;
+      for (auto& peer : peers) {
+        peer.Tick(ticks, stepTicks, mapSize);
+        if (peer.finishedTicks == 0) allFinished = false;
+      }
+      if (allFinished) break;
+
+      if (ticks % 1000 == 1) {
+        for (auto& peer : peers) {
+          if (peer.finishedTicks != 0) continue;
+          peer.queue.push_back({true, 0, 64, ticks});
+          peer.queuedBytes += 64;
+        }
+      }
+      if (ticks % 100 != 1) continue;
+
+      if (useScheduler) {
+        scheduler.Clear();
+        for (auto& peer : peers) {
+          scheduler.Add(&peer.transfer, peer.weight, mapSize, peer.queuedBytes, peer.rtt);
+        }
+        scheduler.Schedule(ticks, budget);
+        for (size_t i = 0; i < peers.size(); ++i) {
+          peers[i].SendMapParts(scheduler.GetGrant(i), mapSize, ticks);
+        }
+      } else {
+        // previous behavior: up to 1000 parts in flight each, first come first served against a global budget
+        uint64_t sentThisCycle = 0;
+        for (auto& peer : peers) {
+          while (
+            peer.transfer.GetLastSentOffsetEnd() < peer.transfer.GetLastAck() + MAP_PART_SIZE * 1000 &&
+            peer.transfer.GetLastSentOffsetEnd() < mapSize &&
+            !(budget > 0 && sentThisCycle > budget)
+          ) {
+            sentThisCycle += peer.GetNextMapPartSize(mapSize);
+            peer.SendMapPart(mapSize, ticks);
+          }
+        }
+      }
+    }
+
+    string results;
+    for (const auto& peer : peers) {
+      const string finished = peer.finishedTicks == 0 ? "unfinished" : ToFormattedString(static_cast<double>(peer.finishedTicks) / 1000.) + " s";
+      const int64_t averageChatDelay = peer.chatCount == 0 ? 0 : peer.totalChatDelay / peer.chatCount;
+      results += "\n  " + peer.name + " (" + to_string(peer.rtt) + " ms, " + to_string(peer.bandwidth / 1024) + " KB/s) - map in " + finished +
+        ", chat delay avg " + to_string(averageChatDelay) + " ms, max " + to_string(peer.maxChatDelay) + " ms";
+    }
+    Print(
+      "[BENCH] map uploads (" + string(useScheduler ? "scheduler" : "legacy") + ", " + (budget == 0 ? string("unlimited") : to_string(budget * 10 / 1024) + " KB/s") +
+      ", " + to_string(mapSize / (1024 * 1024)) + " MB map)" + results
+    );
+  }
+}
+
+void BenchmarkRunner::BenchFileHash()
+{
+  const filesystem::path filePath = filesystem::temp_directory_path() / "aura-bench-map.bin";
+  for (const size_t megaBytes : {8u, 32u, 128u}) {
+    const size_t fileSize = megaBytes * 1024 * 1024;
+    {
+      // incompressible, but reproducible contents
+      vector<uint8_t> contents(fileSize);
+      uint32_t state = 0x12345678;
+      for (auto& byte : contents) {
+        state = state * 1103515245 + 12345;
+        byte = static_cast<uint8_t>(state >> 24);
+      }
+      if (!FileWrite(filePath, contents.data(), contents.size())) {
+        Print("[BENCH] failed to write [" + PathToString(filePath) + "]");
+        return;
+      }
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    optional<FileHashDigest> sequential = HashFileSequential(filePath, MAP_FILE_PROCESSING_CHUNK_SIZE);
+    const int64_t sequentialTime = GetElapsedMicroseconds(start);
+
+    start = chrono::steady_clock::now();
+    optional<FileHashDigest> parallel = HashFileParallel(filePath, MAP_FILE_PROCESSING_CHUNK_SIZE, 0xFFFFFFFF);
+    const int64_t parallelTime = GetElapsedMicroseconds(start);
+
+    const bool matches = (
+      sequential.has_value() && parallel.has_value() &&
+      sequential->size == parallel->size && sequential->crc32 == parallel->crc32 && sequential->sha1 == parallel->sha1
+    );
+    Print(
+      "[BENCH] file hash (" + to_string(megaBytes) + " MB) - sequential: " + GetThroughput(fileSize, sequentialTime) +
+      ", parallel: " + GetThroughput(fileSize, parallelTime) + (matches ? "" : " - MISMATCH")
+    );
+  }
+  FileDelete(filePath);
+}
+
+void BenchmarkRunner::BenchEditDistance()
+{
+  CSearchableMapData twrpgData(MAP_TYPE_TWRPG);
+  if (FileExists("twrpg.json")) {
+    twrpgData.LoadData("twrpg.json");
+  }
+  BenchEditDistanceCorpus("TWRPG items", twrpgData.m_Items);
+
+  vector<string> mapNames;
+  for (const auto& directory : {filesystem::path("maps"), filesystem::path("mapcfgs")}) {
+    for (const auto& fileName : FilesMatch(directory, vector<PLATFORM_STRING_TYPE>())) {
+      mapNames.push_back(ToLowerCase(RemoveNonAlphanumeric(PathToString(fileName))));
+    }
+  }
+  BenchEditDistanceCorpus("map files", mapNames);
+}
+
+void BenchmarkRunner::BenchMapUploads()
+{
+  const uint32_t mapSize = 8 * 1024 * 1024;
+  for (const uint64_t budget : {static_cast<uint64_t>(0), static_cast<uint64_t>(1024 * 1024 / 10)}) {
+    BenchMapUploadsScenario(false, budget, mapSize);
+    BenchMapUploadsScenario(true, budget, mapSize);
+  }
+}
+
+uint16_t BenchmarkRunner::Run()
+{
+  BenchFileHash();
+  BenchEditDistance();
+  BenchMapUploads();
+  return 0;
+}
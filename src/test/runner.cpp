@@ -25,9 +25,87 @@
 
 #include "runner.h"
 #include "../util.h"
+#include "../stream_buffer.h"
+#include "../game_structs.h"
+#include "../geo_index.h"
+#include "../dns_resolver.h"
+#include "../log_writer.h"
+#include "../net.h"
+#include "../map_catalog.h"
+#include "../file_search_index.h"
+#include "../edit_distance.h"
+#include "../timer_queue.h"
+#include "../replay_writer.h"
+#include "../game_frame_log.h"
+#include "../file_util.h"
+#include "../ban_index.h"
+#include "../auradb.h"
+#include "../file_hash.h"
+#include "../map_download.h"
+#include "../map_upload_scheduler.h"
+#include "../map.h"
+
+#include <atomic>
+#include <thread>
+#include "../protocol/game_protocol.h"
+
+#include <zlib.h>
 
 using namespace std;
 
+namespace
+{
+  // Reference implementation: the full dynamic programming table.
+  [[nodiscard]] string::size_type GetEditDistanceReference(const string& s1, const string& s2)
+  {
+    vector<vector<string::size_type>> dp(s1.length() + 1, vector<string::size_type>(s2.length() + 1, 0));
+    for (string::size_type i = 0; i <= s1.length(); ++i) {
+      for (string::size_type j = 0; j <= s2.length(); ++j) {
+        if (i == 0) {
+          dp[i][j] = j;
+        } else if (j == 0) {
+          dp[i][j] = i;
+        } else if (s1[i - 1] == s2[j - 1]) {
+          dp[i][j] = dp[i - 1][j - 1];
+        } else {
+          string::size_type cost = (isdigit(s1[i - 1]) || isdigit(s2[j - 1])) ? 3 : 1;
+          dp[i][j] = min({ dp[i - 1][j] + 1, dp[i][j - 1] + 1, dp[i - 1][j - 1] + cost });
+        }
+      }
+    }
+    return dp[s1.length()][s2.length()];
+  }
+
+  // Reads back a .w3g file the same way CPacked::Decompress() does, without needing a CAura instance.
+  [[nodiscard]] bool ReadReplayReference(const filesystem::path& filePath, vector<uint8_t>& decompressed, uint32_t& replayLength)
+  {
+    vector<uint8_t> contents;
+    if (!FileRead(filePath, contents, MAX_READ_FILE_SIZE) || contents.size() < REPLAY_HEADER_SIZE) return false;
+    if (string(reinterpret_cast<const char*>(contents.data())) != "Warcraft III recorded game\x01A") return false;
+    const uint8_t* header = contents.data() + 28;
+    if (ByteArrayToUInt32(header, false) != REPLAY_HEADER_SIZE || ByteArrayToUInt32(header + 4, false) != contents.size()) return false;
+    const uint32_t decompressedSize = ByteArrayToUInt32(header + 12, false);
+    const uint32_t numBlocks = ByteArrayToUInt32(header + 16, false);
+    replayLength = ByteArrayToUInt32(header + 32, false);
+
+    size_t offset = REPLAY_HEADER_SIZE;
+    for (uint32_t i = 0; i < numBlocks; ++i) {
+      if (offset + 8 > contents.size()) return false;
+      const uint16_t compressedSize = ByteArrayToUInt16(contents.data() + offset, false);
+      uLongf blockSize = ByteArrayToUInt16(contents.data() + offset + 2, false);
+      offset += 8;
+      if (offset + compressedSize > contents.size()) return false;
+      vector<uint8_t> block(blockSize);
+      if (uncompress(block.data(), &blockSize, contents.data() + offset, compressedSize) != Z_OK) return false;
+      offset += compressedSize;
+      AppendByteArrayFast(decompressed, block);
+    }
+    if (offset != contents.size() || decompressed.size() < decompressedSize) return false;
+    decompressed.resize(decompressedSize);
+    return true;
+  }
+}
+
 bool TestRunner::CheckStatStrings()
 {
   bool success = true;
@@ -76,8 +154,1171 @@ bool TestRunner::CheckStatStrings()
   return success;
 }
 
+bool TestRunner::CheckStreamBuffer()
+{
+  bool success = true;
+  CStreamBuffer buffer;
+  vector<uint8_t> expected;
+
+  // interleave writes and partial reads, so that the unread span both slides back and grows
+  uint8_t nextByte = 0;
+  for (size_t round = 0; round < 64; ++round) {
+    const size_t writeSize = 1000 + round * 97;
+    uint8_t* target = buffer.PrepareWrite(writeSize);
+    for (size_t i = 0; i < writeSize; ++i) {
+      target[i] = nextByte;
+      expected.push_back(nextByte++);
+    }
+    buffer.CommitWrite(writeSize);
+
+    const size_t readSize = writeSize - 3 + (round % 7);
+    if (buffer.GetSize() != expected.size() || memcmp(buffer.GetData(), expected.data(), expected.size()) != 0) {
+      Print("[TEST] ERR - CStreamBuffer contents mismatch at round " + to_string(round));
+      success = false;
+      break;
+    }
+    buffer.Consume(readSize);
+    expected.erase(expected.begin(), expected.begin() + min(readSize, expected.size()));
+  }
+
+  CStreamBuffer other;
+  other.Append(string("abc"));
+  buffer.Clear();
+  buffer.AppendMove(other);
+  buffer.Append(vector<uint8_t>{'d'});
+  if (buffer.GetView() != "abcd" || !other.GetIsEmpty()) {
+    Print("[TEST] ERR - CStreamBuffer::AppendMove");
+    success = false;
+  }
+
+  return success;
+}
+
+bool TestRunner::CheckActionFrameEncoder()
+{
+  bool success = true;
+  CQueuedActionsFrame frame;
+
+  // enough bytes to overflow into several W3GS_INCOMING_ACTION2 packets
+  for (size_t round = 0; round < 3; ++round) {
+    for (size_t i = 0; i < 60 * round; ++i) {
+      vector<uint8_t> actionBytes(1 + (i * 31) % 97, static_cast<uint8_t>(i));
+      frame.AddAction(CIncomingAction(static_cast<uint8_t>(1 + i % 12), actionBytes));
+    }
+
+    vector<uint8_t> expected;
+    for (size_t i = 0; i + 1 < frame.actions.size(); ++i) {
+      AppendByteArrayFast(expected, GameProtocol::SEND_W3GS_INCOMING_ACTION2(frame.actions[i]));
+    }
+    AppendByteArrayFast(expected, GameProtocol::SEND_W3GS_INCOMING_ACTION(frame.actions.back(), 100));
+
+    if (frame.GetBytes(100) != expected) {
+      Print("[TEST] ERR - CQueuedActionsFrame encoding mismatch at round " + to_string(round));
+      success = false;
+    }
+
+    // repeated calls must not encode again, but still honor the send interval
+    vector<uint8_t> expectedRepeat;
+    for (size_t i = 0; i + 1 < frame.actions.size(); ++i) {
+      AppendByteArrayFast(expectedRepeat, GameProtocol::SEND_W3GS_INCOMING_ACTION2(frame.actions[i]));
+    }
+    AppendByteArrayFast(expectedRepeat, GameProtocol::SEND_W3GS_INCOMING_ACTION(frame.actions.back(), 250));
+    if (frame.GetBytes(250) != expectedRepeat || frame.GetBytes(100) != expected) {
+      Print("[TEST] ERR - CQueuedActionsFrame repeated encoding mismatch at round " + to_string(round));
+      success = false;
+    }
+
+    // actions added after encoding reopen it
+    vector<uint8_t> moreBytes(40, static_cast<uint8_t>(round));
+    frame.AddAction(CIncomingAction(1, moreBytes));
+    vector<uint8_t> expectedMore;
+    for (size_t i = 0; i + 1 < frame.actions.size(); ++i) {
+      AppendByteArrayFast(expectedMore, GameProtocol::SEND_W3GS_INCOMING_ACTION2(frame.actions[i]));
+    }
+    AppendByteArrayFast(expectedMore, GameProtocol::SEND_W3GS_INCOMING_ACTION(frame.actions.back(), 100));
+    if (frame.TakeBytes(100) != expectedMore) {
+      Print("[TEST] ERR - CQueuedActionsFrame encoding mismatch after adding actions at round " + to_string(round));
+      success = false;
+    }
+    frame.Reset();
+  }
+
+  {
+    // an oversized first action leaves an empty packet in front, which must survive being reopened
+    vector<uint8_t> largeBytes(1460, 7);
+    frame.AddAction(CIncomingAction(1, largeBytes));
+    frame.GetBytes(100);
+    vector<uint8_t> smallBytes(10, 8);
+    frame.AddAction(CIncomingAction(2, smallBytes));
+    vector<uint8_t> expected;
+    for (size_t i = 0; i + 1 < frame.actions.size(); ++i) {
+      AppendByteArrayFast(expected, GameProtocol::SEND_W3GS_INCOMING_ACTION2(frame.actions[i]));
+    }
+    AppendByteArrayFast(expected, GameProtocol::SEND_W3GS_INCOMING_ACTION(frame.actions.back(), 100));
+    if (frame.actions.size() != 3 || !frame.actions.front().empty() || frame.GetBytes(100) != expected) {
+      Print("[TEST] ERR - CQueuedActionsFrame encoding mismatch after reopening an empty leading packet");
+      success = false;
+    }
+    frame.Reset();
+  }
+
+  return success;
+}
+
+bool TestRunner::CheckGeoIndex()
+{
+  bool success = true;
+  CGeoIndex index;
+
+  // inserted out of order, with a gap, and an overlapping range that must be dropped
+  index.AddRange(0x0A000000u, 0x0AFFFFFFu, "US");
+  index.AddRange(0x01000000u, 0x010000FFu, "AU");
+  index.AddRange(0x0A000100u, 0x0A0001FFu, "DE");
+  index.AddRange(0xFF000000u, 0xFFFFFFFFu, "ZZ");
+  index.Seal();
+
+  const vector<pair<uint32_t, string>> cases = {
+    {0x00000000u, "??"}, {0x01000000u, "AU"}, {0x010000FFu, "AU"}, {0x01000100u, "??"},
+    {0x0A000150u, "US"}, {0x0AFFFFFFu, "US"}, {0x0B000000u, "??"}, {0xFFFFFFFFu, "ZZ"}
+  };
+  for (const auto& testCase : cases) {
+    string actual = index.GetCountry(testCase.first);
+    if (actual != testCase.second) {
+      Print("[TEST] ERR - CGeoIndex [" + to_string(testCase.first) + "] Expected <" + testCase.second + "> but got <" + actual + ">");
+      success = false;
+    }
+  }
+
+  return success;
+}
+
+bool TestRunner::CheckDNSResolver()
+{
+  bool success = true;
+
+  // stub resolver, so that no actual DNS traffic is needed
+  shared_ptr<atomic<uint32_t>> queryCount = make_shared<atomic<uint32_t>>(0);
+  CDNSResolver resolver([queryCount](const string& hostName, const int family) {
+    ++(*queryCount);
+    this_thread::sleep_for(chrono::milliseconds(10));
+    DNSQueryResult result;
+    if (hostName == "stub.test" && family == AF_INET) {
+      result.address = CNet::ParseAddress("192.0.2.1", ACCEPT_IPV4);
+    } else {
+      result.error = "NXDOMAIN";
+    }
+    return result;
+  });
+
+  uint8_t callbackCount = 0;
+  optional<sockaddr_storage> callbackAddress;
+  auto onResolved = [&callbackCount, &callbackAddress](const optional<sockaddr_storage>& address) {
+    ++callbackCount;
+    callbackAddress = address;
+  };
+
+  // concurrent lookups are coalesced
+  sockaddr_storage address;
+  resolver.Query("stub.test", AF_INET, onResolved);
+  resolver.Query("stub.test", AF_INET, onResolved);
+  if (resolver.Lookup("stub.test", AF_INET, address) != DNSStatus::kPending) {
+    Print("[TEST] ERR - CDNSResolver expected a pending lookup");
+    success = false;
+  }
+  resolver.Query("missing.test", AF_INET, onResolved);
+
+  for (int i = 0; i < 200 && resolver.GetHasPending(); ++i) {
+    this_thread::sleep_for(chrono::milliseconds(10));
+    resolver.Update();
+  }
+
+  if (callbackCount != 3 || *queryCount != 2) {
+    Print("[TEST] ERR - CDNSResolver expected 3 callbacks from 2 queries, but got " + to_string(callbackCount) + " callbacks from " + to_string(queryCount->load()) + " queries");
+    success = false;
+  }
+
+  // positive and negative answers are both cached
+  if (resolver.Lookup("stub.test", AF_INET, address) != DNSStatus::kResolved || AddressToString(address) != "192.0.2.1") {
+    Print("[TEST] ERR - CDNSResolver expected a cached answer for [stub.test]");
+    success = false;
+  }
+  if (resolver.Lookup("missing.test", AF_INET, address) != DNSStatus::kFailed || *queryCount != 2) {
+    Print("[TEST] ERR - CDNSResolver expected a cached failure for [missing.test]");
+    success = false;
+  }
+
+  return success;
+}
+
+bool TestRunner::CheckLogWriter()
+{
+  bool success = true;
+  const filesystem::path directory = filesystem::temp_directory_path() / filesystem::path("aura-test-logs");
+  error_code ec;
+  filesystem::remove_all(directory, ec);
+  filesystem::create_directories(directory, ec);
+
+  auto readFile = [](const filesystem::path& filePath) {
+    ifstream stream(filePath, ios::binary);
+    return string(istreambuf_iterator<char>(stream), istreambuf_iterator<char>());
+  };
+  auto countLines = [&readFile](const filesystem::path& filePath) {
+    const string contents = readFile(filePath);
+    return static_cast<size_t>(count(contents.begin(), contents.end(), '\n'));
+  };
+  auto waitFor = [](const function<bool()>& isDone, const int64_t maxTicks) {
+    const int64_t startTicks = GetTicks();
+    while (!isDone() && GetTicks() - startTicks < maxTicks) {
+      this_thread::sleep_for(chrono::milliseconds(5));
+    }
+    return GetTicks() - startTicks;
+  };
+
+  {
+    // lines are held back until a batch is full, or until the flush interval elapses
+    const filesystem::path filePath = directory / filesystem::path("batch.log");
+    CLogWriter writer;
+    for (size_t i = 0; i + 1 < LOG_WRITER_WAKE_THRESHOLD; ++i) {
+      writer.Push(filePath, "line " + to_string(i));
+    }
+    this_thread::sleep_for(chrono::milliseconds(100));
+    if (countLines(filePath) != 0) {
+      Print("[TEST] ERR - CLogWriter wrote a partial batch before the flush interval");
+      success = false;
+    }
+    writer.Push(filePath, "line " + to_string(LOG_WRITER_WAKE_THRESHOLD - 1));
+    int64_t waitTicks = waitFor([&]() { return countLines(filePath) == LOG_WRITER_WAKE_THRESHOLD; }, 2 * LOG_WRITER_FLUSH_INTERVAL_MS);
+    if (countLines(filePath) != LOG_WRITER_WAKE_THRESHOLD || waitTicks >= LOG_WRITER_FLUSH_INTERVAL_MS / 2) {
+      Print("[TEST] ERR - CLogWriter took " + to_string(waitTicks) + " ms to write a full batch");
+      success = false;
+    }
+
+    writer.Push(filePath, "late line");
+    this_thread::sleep_for(chrono::milliseconds(LOG_WRITER_FLUSH_INTERVAL_MS / 4));
+    if (countLines(filePath) != LOG_WRITER_WAKE_THRESHOLD) {
+      Print("[TEST] ERR - CLogWriter flushed a single line before the flush interval");
+      success = false;
+    }
+    waitTicks = waitFor([&]() { return countLines(filePath) == LOG_WRITER_WAKE_THRESHOLD + 1; }, 2 * LOG_WRITER_FLUSH_INTERVAL_MS);
+    if (countLines(filePath) != LOG_WRITER_WAKE_THRESHOLD + 1) {
+      Print("[TEST] ERR - CLogWriter did not flush a single line after " + to_string(waitTicks) + " ms");
+      success = false;
+    }
+    writer.Stop();
+    const string contents = readFile(filePath);
+    if (contents.find("line 0\n") == string::npos || contents.find("line 255\n") == string::npos || contents.find("late line\n") == string::npos) {
+      Print("[TEST] ERR - CLogWriter lost lines of the batch");
+      success = false;
+    }
+  }
+
+  {
+    // every rotated file stays within the size limit, give or take the line that crossed it
+    const filesystem::path filePath = directory / filesystem::path("rotate.log");
+    const string payload(100, 'x');
+    CLogWriter writer;
+    writer.SetOptions(LOG_FORMAT_TEXT, 1000, 0);
+    for (size_t i = 0; i < 30; ++i) {
+      writer.Push(filePath, payload);
+    }
+    writer.Stop();
+
+    size_t fileCount = 0, lineCount = 0;
+    for (const auto& entry : filesystem::directory_iterator(directory, ec)) {
+      const string fileName = PathToString(entry.path().filename());
+      if (fileName.rfind("rotate", 0) != 0) continue;
+      ++fileCount;
+      lineCount += countLines(entry.path());
+      if (entry.file_size() >= 1000 + 2 * payload.size()) {
+        Print("[TEST] ERR - CLogWriter rotated [" + fileName + "] at " + to_string(entry.file_size()) + " bytes");
+        success = false;
+      }
+    }
+    if (fileCount < 3 || lineCount != 30) {
+      Print("[TEST] ERR - CLogWriter rotated into " + to_string(fileCount) + " files with " + to_string(lineCount) + " lines");
+      success = false;
+    }
+  }
+
+  {
+    // <int64 unix time> <uint32 length> <bytes>
+    const filesystem::path filePath = directory / filesystem::path("records.bin");
+    const vector<string> texts = {"first", "", "multi\nline", string(300, 'z')};
+    const int64_t startTime = static_cast<int64_t>(chrono::system_clock::to_time_t(chrono::system_clock::now()));
+    CLogWriter writer;
+    writer.SetOptions(LOG_FORMAT_BINARY, 0, 0);
+    for (const auto& text : texts) {
+      writer.Push(filePath, text);
+    }
+    writer.Stop();
+
+    const string contents = readFile(filePath);
+    vector<string> records;
+    size_t offset = 0;
+    while (offset + sizeof(int64_t) + sizeof(uint32_t) <= contents.size()) {
+      int64_t time = 0;
+      uint32_t length = 0;
+      memcpy(&time, contents.data() + offset, sizeof(time));
+      memcpy(&length, contents.data() + offset + sizeof(time), sizeof(length));
+      offset += sizeof(time) + sizeof(length);
+      if (time < startTime || time > startTime + 60 || offset + length > contents.size()) break;
+      records.push_back(contents.substr(offset, length));
+      offset += length;
+    }
+    if (records != texts || offset != contents.size()) {
+      Print("[TEST] ERR - CLogWriter binary records did not round-trip, got " + to_string(records.size()) + " records");
+      success = false;
+    }
+  }
+
+  filesystem::remove_all(directory, ec);
+  return success;
+}
+
+bool TestRunner::CheckMapCatalog()
+{
+  bool success = true;
+  filesystem::path directory = filesystem::temp_directory_path();
+  filesystem::path cfgName = "aura-test-catalog.ini";
+  filesystem::path catalogPath = directory / filesystem::path("aura-test-catalog.bin");
+
+  const string cfgContents = "map.local_path = test.w3x\nmap.size = 1234\n";
+  FileWrite(directory / cfgName, reinterpret_cast<const uint8_t*>(cfgContents.data()), cfgContents.size());
+
+  {
+    CMapCatalog catalog;
+    static_cast<void>(catalog.Load(catalogPath));
+    catalog.Update(directory, cfgName, {{"map.local_path", "test.w3x"}, {"map.size", "1234"}});
+    if (!catalog.Save()) {
+      Print("[TEST] ERR - CMapCatalog failed to save [" + PathToString(catalogPath) + "]");
+      success = false;
+    }
+  }
+
+  {
+    CMapCatalog catalog;
+    const MapCatalogEntry* entry = catalog.Load(catalogPath) ? catalog.Get(directory, cfgName) : nullptr;
+    if (!entry || entry->config.size() != 2 || entry->config.at("map.local_path") != "test.w3x") {
+      Print("[TEST] ERR - CMapCatalog entry not restored");
+      success = false;
+    }
+
+    // edited configs invalidate their entry
+    const string editedContents = cfgContents + "map.size.extra = 1\n";
+    FileWrite(directory / cfgName, reinterpret_cast<const uint8_t*>(editedContents.data()), editedContents.size());
+    if (catalog.Get(directory, cfgName)) {
+      Print("[TEST] ERR - CMapCatalog returned a stale entry");
+      success = false;
+    }
+  }
+
+  FileDelete(directory / cfgName);
+  FileDelete(catalogPath);
+  return success;
+}
+
+bool TestRunner::CheckFileSearchIndex()
+{
+  bool success = true;
+  CFileSearchIndex index(FILE_EXTENSIONS_MAP);
+  index.Rebuild({
+    "DotA v6.83d.w3x", "(2)EchoIsles.w3x", "Legion TD Mega 4.2.w3x", "Island Defense.w3m", "readme.txt"
+  });
+
+  const vector<pair<string, string>> cases = {
+    {"dota", "DotA v6.83d.w3x"}, {"echo", "(2)EchoIsles.w3x"}, {"legion td", "Legion TD Mega 4.2.w3x"},
+    {"islnd defence", "Island Defense.w3m"}, {"readme", ""}
+  };
+  for (const auto& testCase : cases) {
+    vector<pair<string, int>> results = index.Search(testCase.first);
+    string actual = results.empty() ? string() : results[0].first;
+    if (actual != testCase.second) {
+      Print("[TEST] ERR - CFileSearchIndex [" + testCase.first + "] Expected <" + testCase.second + "> but got <" + actual + ">");
+      success = false;
+    }
+  }
+
+  // more fuzzy matches at the same distance than fit in the results, with different lengths
+  index.Rebuild({
+    "zbcdefgh.w3x", "bcdefgh.w3x", "abcdefgzh.w3x", "zabcdefgh.w3x", "abzdefgh.w3x", "abcdefg.w3x", "abcdzfgh.w3x"
+  });
+  const vector<string> expectedTies = {"abcdefg.w3x", "abcdefgzh.w3x", "abcdzfgh.w3x", "abzdefgh.w3x", "bcdefgh.w3x"};
+  vector<pair<string, int>> tieResults = index.Search("abcdefgh");
+  vector<string> actualTies;
+  for (const auto& result : tieResults) {
+    actualTies.push_back(result.first);
+  }
+  if (actualTies != expectedTies) {
+    Print("[TEST] ERR - CFileSearchIndex ties are not ranked by name");
+    success = false;
+  }
+
+  return success;
+}
+
+bool TestRunner::CheckEditDistance()
+{
+  bool success = true;
+
+  // reproducible strings over a small alphabet, so that both matches and digit substitutions are common
+  uint32_t state = 0x2545F491;
+  auto nextRandom = [&state](const uint32_t range) {
+    state = state * 1103515245 + 12345;
+    return (state >> 16) % range;
+  };
+  auto nextString = [&nextRandom](const uint32_t maxLength) {
+    static const string alphabet = "abcde0123";
+    string result(nextRandom(maxLength + 1), ' ');
+    for (auto& c : result) c = alphabet[nextRandom(static_cast<uint32_t>(alphabet.size()))];
+    return result;
+  };
+
+  for (uint32_t i = 0; i < 2000 && success; ++i) {
+    // lengths beyond 64 exercise the banded fallback
+    const uint32_t maxLength = i % 10 == 0 ? 80 : 12;
+    const string s1 = nextString(maxLength);
+    const string s2 = nextString(maxLength);
+    const string::size_type expected = GetEditDistanceReference(s1, s2);
+    const string::size_type actual = GetLevenshteinDistance(s1, s2);
+    if (actual != expected) {
+      Print("[TEST] ERR - GetLevenshteinDistance [" + s1 + "] [" + s2 + "] Expected <" + to_string(expected) + "> but got <" + to_string(actual) + ">");
+      success = false;
+    }
+    const string::size_type maxDistance = nextRandom(8);
+    const string::size_type bounded = CEditDistancePattern(s1).GetDistance(s2, maxDistance);
+    if (expected <= maxDistance ? bounded != expected : bounded <= maxDistance) {
+      Print("[TEST] ERR - CEditDistancePattern [" + s1 + "] [" + s2 + "] (max " + to_string(maxDistance) + ") Expected <" + to_string(expected) + "> but got <" + to_string(bounded) + ">");
+      success = false;
+    }
+  }
+
+  optional<pair<size_t, string::size_type>> closest = CEditDistancePattern("legion").FindClosest({"region", "legend", "legion4", "lesion"}, 3);
+  if (!closest.has_value() || closest->first != 0 || closest->second != 1) {
+    Print("[TEST] ERR - CEditDistancePattern::FindClosest did not keep the first best candidate");
+    success = false;
+  }
+
+  return success;
+}
+
+bool TestRunner::CheckTimerQueue()
+{
+  bool success = true;
+  CTimerQueue timers;
+  string fired;
+
+  TimerId first = timers.Schedule(100, [&fired]() { fired += "a"; });
+  TimerId cancelled = timers.Schedule(50, [&fired]() { fired += "x"; });
+  TimerId moved = timers.Schedule(300, [&fired]() { fired += "c"; });
+  TimerId repeating = 0;
+  std::function<void()> repeat = [&]() {
+    fired += "b";
+    if (fired.size() < 4) repeating = timers.Schedule(200 + static_cast<int64_t>(fired.size()), repeat);
+  };
+  repeating = timers.Schedule(200, repeat);
+  timers.Cancel(cancelled);
+  static_cast<void>(timers.Reschedule(moved, 150));
+
+  if (timers.GetNextDueTicks().value_or(0) != 100) {
+    Print("[TEST] ERR - CTimerQueue expected the next timer at 100 but got " + to_string(timers.GetNextDueTicks().value_or(0)));
+    success = false;
+  }
+  int64_t usecBlock = 50000;
+  timers.UpdateSelectBlockTime(usecBlock, 90);
+  if (usecBlock != 10000) {
+    Print("[TEST] ERR - CTimerQueue expected to block for 10000 us but got " + to_string(usecBlock));
+    success = false;
+  }
+
+  timers.RunExpired(99);
+  timers.RunExpired(1000);
+  if (fired != "acbb" || timers.GetSize() != 0 || timers.GetNextDueTicks().has_value() || first == 0 || cancelled != 0) {
+    Print("[TEST] ERR - CTimerQueue fired <" + fired + "> but expected <acbb>");
+    success = false;
+  }
+
+  return success;
+}
+
+bool TestRunner::CheckReplayWriter()
+{
+  bool success = true;
+  const filesystem::path filePath = filesystem::temp_directory_path() / filesystem::path("aura-test-replay.w3g");
+
+  ReplayHeaderInfo headerInfo;
+  headerInfo.m_War3Version = GAMEVER(1u, 26u);
+  headerInfo.m_BuildNumber = 6401;
+  headerInfo.m_GameName = "replay test";
+  headerInfo.m_Players = {{1, "Host"}, {2, "Guest"}};
+  headerInfo.m_SlotInfo = {0, 1, 2, 3, 4, 3, 0}; // no slots, random seed, layout, player slots
+
+  CReplayWriter writer(filePath, std::move(headerInfo));
+  if (!writer.Start()) {
+    Print("[TEST] ERR - CReplayWriter failed to start");
+    return false;
+  }
+
+  // enough actions to span several blocks
+  const vector<uint8_t> action = {2, 16, 0, 0x10, 0x42, 0, 0x03, 0x00, 0x0d, 0, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0, 0};
+  for (uint32_t i = 0; i < 2000; ++i) {
+    vector<uint8_t> packet = {GameProtocol::Magic::W3GS_HEADER, GameProtocol::Magic::INCOMING_ACTION, 0, 0, 100, 0, 0, 0};
+    if (i % 3 == 0) {
+      packet.resize(6);
+    } else {
+      AppendByteArrayFast(packet, action);
+    }
+    AssignLength(packet);
+    writer.AddFrame(GameFrame(i % 500 == 499 ? GAME_FRAME_TYPE_PAUSED : GAME_FRAME_TYPE_ACTIONS, MakeSharedPacket(std::move(packet))));
+  }
+  vector<uint8_t> latency = {50, 0};
+  writer.AddFrame(GameFrame(GAME_FRAME_TYPE_LATENCY, MakeSharedPacket(std::move(latency))));
+  vector<uint8_t> chat = GameProtocol::SEND_W3GS_CHAT_FROM_HOST_IN_GAME(1, {2}, 0x20, 0, "gl hf");
+  writer.AddFrame(GameFrame(GAME_FRAME_TYPE_CHAT, MakeSharedPacket(std::move(chat))));
+  vector<uint8_t> leaver = GameProtocol::SEND_W3GS_PLAYERLEAVE_OTHERS(2, 0x0D);
+  writer.AddFrame(GameFrame(GAME_FRAME_TYPE_LEAVER, MakeSharedPacket(std::move(leaver))));
+
+  if (!writer.Finish()) {
+    Print("[TEST] ERR - CReplayWriter failed to finish");
+    return false;
+  }
+
+  vector<uint8_t> decompressed;
+  uint32_t replayLength = 0;
+  if (!ReadReplayReference(filePath, decompressed, replayLength)) {
+    Print("[TEST] ERR - CReplayWriter wrote an unreadable replay");
+    FileDelete(filePath);
+    return false;
+  }
+
+  if (replayLength != 1996 * 100) {
+    Print("[TEST] ERR - CReplayWriter expected a replay length of 199600 ms but got " + to_string(replayLength));
+    success = false;
+  }
+
+  const vector<uint8_t> expectedTail = {
+    REPLAY_BLOCK_CHAT, 1, 11, 0, 0x20, 0, 0, 0, 0, 'g', 'l', ' ', 'h', 'f', 0,
+    REPLAY_BLOCK_LEAVE_GAME, 1, 0, 0, 0, 2, 0x0D, 0, 0, 0, 1, 0, 0, 0
+  };
+  // unknown, host record, game name, stat string, game header, guest record, game start record, start blocks, time slots
+  const size_t expectedSize = 4 + 9 + 12 + 2 + 12 + 14 + 10 + 15 + 2000 * 5 + 1333 * 20 + expectedTail.size();
+  if (decompressed.size() != expectedSize || !equal(expectedTail.begin(), expectedTail.end(), decompressed.end() - expectedTail.size())) {
+    Print("[TEST] ERR - CReplayWriter expected " + to_string(expectedSize) + " bytes ending with chat and leave blocks but got " + to_string(decompressed.size()) + " bytes");
+    success = false;
+  }
+
+  FileDelete(filePath);
+  return success;
+}
+
+bool TestRunner::CheckGameFrameLog()
+{
+  bool success = true;
+  auto getFrameBytes = [](const size_t index) {
+    vector<uint8_t> bytes(1 + index % 300, static_cast<uint8_t>(index));
+    bytes[0] = static_cast<uint8_t>(index >> 8);
+    return bytes;
+  };
+  auto frameMatches = [&getFrameBytes](const GameFrame& frame, const size_t index) {
+    const vector<uint8_t> expected = getFrameBytes(index);
+    return frame.GetType() == index % 4 && frame.GetSize() == expected.size() && equal(expected.begin(), expected.end(), frame.GetData());
+  };
+
+  {
+    CGameFrameLog log;
+    log.SetSpillPath(filesystem::temp_directory_path() / filesystem::path("aura-test-frames.bin"));
+    log.SetMaxResidentBytes(2 * GAME_FRAME_SEGMENT_SIZE);
+    CGameFrameCursor live;
+    live.Open(&log);
+
+    // a live reader keeps up with the writer, so only the most recent segments stay in memory
+    for (size_t i = 0; i < 4000; ++i) {
+      log.Append(static_cast<uint8_t>(i % 4), getFrameBytes(i));
+      while (live.GetHasNext()) {
+        if (!frameMatches(live.Peek(), live.GetPosition())) {
+          Print("[TEST] ERR - CGameFrameLog live cursor read a wrong frame at " + to_string(live.GetPosition()));
+          return false;
+        }
+        live.Advance();
+      }
+    }
+    log.Drain();
+    if (log.GetNumSegments() < 4 || log.GetResidentBytes() > 2 * GAME_FRAME_SEGMENT_SIZE) {
+      Print("[TEST] ERR - CGameFrameLog kept " + to_string(log.GetResidentBytes()) + " bytes in memory over " + to_string(log.GetNumSegments()) + " segments");
+      success = false;
+    }
+
+    // a late reader gets spilled frames back from disk
+    CGameFrameCursor late;
+    late.Open(&log);
+    size_t numPending = 0;
+    while (late.GetHasNext() && success) {
+      const GameFrame frame = late.Peek();
+      if (late.GetIsWaiting()) {
+        ++numPending;
+        log.Drain();
+        continue;
+      }
+      if (!frameMatches(frame, late.GetPosition())) {
+        Print("[TEST] ERR - CGameFrameLog late cursor read a wrong frame at " + to_string(late.GetPosition()));
+        success = false;
+      }
+      late.Advance();
+    }
+    if (late.GetPosition() != 4000 || numPending == 0 || log.GetResidentBytes() > 2 * GAME_FRAME_SEGMENT_SIZE) {
+      Print("[TEST] ERR - CGameFrameLog late cursor stopped at " + to_string(late.GetPosition()) + " with " + to_string(log.GetResidentBytes()) + " bytes in memory");
+      success = false;
+    }
+  }
+
+  {
+    // nothing is written to disk while the bound is not reached
+    const filesystem::path spillPath = filesystem::temp_directory_path() / filesystem::path("aura-test-frames-resident.bin");
+    CGameFrameLog log;
+    log.SetSpillPath(spillPath);
+    CGameFrameCursor live;
+    live.Open(&log);
+    size_t numBytes = 0;
+    for (size_t i = 0; i < 2000; ++i) {
+      const vector<uint8_t> bytes = getFrameBytes(i);
+      numBytes += bytes.size();
+      log.Append(static_cast<uint8_t>(i % 4), bytes);
+      while (live.GetHasNext()) live.Advance();
+    }
+    log.Drain();
+    if (filesystem::exists(spillPath) || log.GetResidentBytes() < numBytes) {
+      Print("[TEST] ERR - CGameFrameLog spilled frames under the memory bound");
+      success = false;
+    }
+  }
+
+  {
+    CGameFrameLog log;
+    log.SetKeepHistory(false);
+    for (size_t i = 0; i < 2000; ++i) {
+      log.Append(static_cast<uint8_t>(i % 4), getFrameBytes(i));
+    }
+    if (log.GetFirstAvailableFrame() == 0 || log.GetResidentBytes() > GAME_FRAME_SEGMENT_SIZE) {
+      Print("[TEST] ERR - CGameFrameLog kept unreachable frames in memory");
+      success = false;
+    }
+  }
+
+  {
+    // 100 ms per action frame, then 50 ms per action frame from 60 s onwards, with chat every 10th frame
+    CGameFrameLog log;
+    log.SetLatency(100);
+    for (size_t i = 0; i < 600; ++i) {
+      log.Append(GAME_FRAME_TYPE_ACTIONS, getFrameBytes(i));
+      if (i % 10 == 0) log.Append(GAME_FRAME_TYPE_CHAT, getFrameBytes(i));
+    }
+    const vector<uint8_t> latency = {50, 0};
+    log.Append(GAME_FRAME_TYPE_LATENCY, latency);
+    for (size_t i = 0; i < 600; ++i) {
+      log.Append(GAME_FRAME_TYPE_ACTIONS, getFrameBytes(i));
+    }
+    if (log.GetGameTicks() != 90000) {
+      Print("[TEST] ERR - CGameFrameLog counted " + to_string(log.GetGameTicks()) + " ms of game time");
+      success = false;
+    }
+    const vector<pair<int64_t, size_t>> expected = {{0, 0}, {50, 1}, {100, 1}, {30000, 330}, {60000, 661}, {60050, 662}, {75000, 961}, {999999, 1261}};
+    for (const auto& [ticks, frame] : expected) {
+      const size_t actual = log.GetFrameAtGameTicks(ticks);
+      if (actual != frame) {
+        Print("[TEST] ERR - CGameFrameLog found frame " + to_string(actual) + " at " + to_string(ticks) + " ms, expected " + to_string(frame));
+        success = false;
+      }
+    }
+  }
+
+  const vector<pair<string, optional<int64_t>>> timeStamps = {{"45", 45}, {"15:00", 900}, {"1:02:03", 3723}, {"1:60", nullopt}, {"", nullopt}, {"1::2", nullopt}, {"1:2:3:4", nullopt}, {"-5", nullopt}};
+  for (const auto& [input, seconds] : timeStamps) {
+    if (ParseTimeStamp(input) != seconds) {
+      Print("[TEST] ERR - ParseTimeStamp(" + input + ") failed");
+      success = false;
+    }
+  }
+
+  return success;
+}
+
+bool TestRunner::CheckBanIndex()
+{
+  bool success = true;
+
+  {
+    CIPPrefixTrie trie;
+    const vector<string> prefixes = {"203.0.113.7", "198.51.100.0/24", "10.0.0.0/8", "10.1.0.0/16", "2001:db8::/32", "2001:db8:1::/48"};
+    for (const auto& prefix : prefixes) {
+      optional<pair<CIPPrefixTrie::Key, uint8_t>> parsed = CIPPrefixTrie::ParsePrefix(prefix);
+      if (!parsed.has_value()) {
+        Print("[TEST] ERR - CIPPrefixTrie failed to parse [" + prefix + "]");
+        return false;
+      }
+      trie.Insert(parsed->first, parsed->second);
+    }
+    const vector<pair<string, bool>> lookups = {
+      {"203.0.113.7", true}, {"203.0.113.8", false}, {"198.51.100.255", true}, {"198.51.101.0", false},
+      {"10.200.3.4", true}, {"11.0.0.1", false}, {"::ffff:198.51.100.9", true}, {"2001:db8:ffff::1", true},
+      {"2001:db9::1", false}, {"::1", false}
+    };
+    auto checkLookups = [&](const vector<pair<string, bool>>& cases, const string& label) {
+      for (const auto& [ip, expected] : cases) {
+        if (trie.GetContains(CIPPrefixTrie::ParseAddress(ip).value()) != expected) {
+          Print("[TEST] ERR - CIPPrefixTrie " + label + " lookup of [" + ip + "] should be " + (expected ? "true" : "false"));
+          success = false;
+        }
+      }
+    };
+    checkLookups(lookups, "initial");
+
+    // 10.1.0.0/16 is nested within 10.0.0.0/8
+    optional<pair<CIPPrefixTrie::Key, uint8_t>> outer = CIPPrefixTrie::ParsePrefix("10.0.0.0/8");
+    optional<pair<CIPPrefixTrie::Key, uint8_t>> unknown = CIPPrefixTrie::ParsePrefix("10.2.0.0/16");
+    if (trie.Remove(unknown->first, unknown->second) || !trie.Remove(outer->first, outer->second) || trie.GetSize() != prefixes.size() - 1) {
+      Print("[TEST] ERR - CIPPrefixTrie removal failed");
+      success = false;
+    }
+    checkLookups({{"10.200.3.4", false}, {"10.1.3.4", true}, {"203.0.113.7", true}}, "post-removal");
+
+    for (const auto& invalid : {"10.0.0.0/33", "10.0.0.0/", "10.0.0/8", "2001:db8::/129", "example.com"}) {
+      if (CIPPrefixTrie::ParsePrefix(invalid).has_value()) {
+        Print("[TEST] ERR - CIPPrefixTrie accepted [" + string(invalid) + "]");
+        success = false;
+      }
+    }
+  }
+
+  {
+    CBanIndex index;
+    index.Add("Alice", "europe.battle.net", "", "203.0.113.7", nullopt);
+    index.Add("bob", "europe.battle.net", "", "198.51.100.0/24", 1000);
+    index.Add("carol", "europe.battle.net", "", "198.51.100.0/24", 2000);
+    if (!index.GetIsUserBanned("alice", "europe.battle.net", "", 0) || index.GetIsUserBanned("alice", "useast.battle.net", "", 0)) {
+      Print("[TEST] ERR - CBanIndex user lookup failed");
+      success = false;
+    }
+    if (!index.GetIsIPBanned("198.51.100.20", "", 1500) || index.GetIsUserBanned("bob", "europe.battle.net", "", 1500) || index.GetIsIPBanned("198.51.100.20", "realm", 1500)) {
+      Print("[TEST] ERR - CBanIndex expiry of overlapping IP bans failed");
+      success = false;
+    }
+    if (index.GetIsIPBanned("198.51.100.20", "", 2000) || !index.GetIsIPBanned("203.0.113.7", "", 2000) || index.GetNextExpiry().has_value()) {
+      Print("[TEST] ERR - CBanIndex expiry failed");
+      success = false;
+    }
+    if (!index.Remove("ALICE", "europe.battle.net", "") || index.GetIsIPBanned("203.0.113.7", "", 2000) || index.GetSize() != 0) {
+      Print("[TEST] ERR - CBanIndex removal failed");
+      success = false;
+    }
+    if (CBanIndex::ParseExpiry("2024-03-01") != optional<int64_t>(1709251200) || CBanIndex::ParseExpiry("").has_value()) {
+      Print("[TEST] ERR - CBanIndex failed to parse expiry dates");
+      success = false;
+    }
+  }
+
+  return success;
+}
+
+bool TestRunner::CheckDBWriter()
+{
+  bool success = true;
+  const filesystem::path filePath = filesystem::temp_directory_path() / filesystem::path("aura-test-writer.db");
+  FileDelete(filePath);
+
+  auto countRows = [](CSQLITE3& db) {
+    int64_t count = -1;
+    sqlite3_stmt* Statement = nullptr;
+    db.Prepare("SELECT COUNT(*), COALESCE(SUM(value), 0) FROM items", &Statement);
+    if (Statement && db.Step(Statement) == SQLITE_ROW) {
+      count = sqlite3_column_int64(Statement, 0) * 1000000 + sqlite3_column_int64(Statement, 1);
+    }
+    if (Statement) db.Finalize(Statement);
+    return count;
+  };
+  auto getInsertJob = [](const int64_t value) -> CDBWriter::Job {
+    return [value](CDBWriter& writer) {
+      sqlite3_stmt* Statement = writer.GetCachedStatement(0, "INSERT INTO items ( value ) VALUES ( ? )");
+      if (!Statement) return false;
+      sqlite3_bind_int64(Statement, 1, value);
+      const bool ok = writer.GetDB()->Step(Statement) == SQLITE_DONE;
+      writer.GetDB()->Reset(Statement);
+      return ok;
+    };
+  };
+
+  {
+    CSQLITE3 mainDB(filePath);
+    mainDB.Exec("PRAGMA journal_mode = WAL");
+    mainDB.Exec("CREATE TABLE items ( value INTEGER NOT NULL )");
+    mainDB.SetBusyTimeout(DB_MAIN_BUSY_TIMEOUT);
+
+    CDBWriter writer;
+    if (!writer.Open(filePath, {"PRAGMA synchronous = FULL"}) || !writer.GetIsAsync()) {
+      Print("[TEST] ERR - CDBWriter failed to open a second connection");
+      return false;
+    }
+    for (int64_t i = 0; i < 20; ++i) {
+      CDBWriter::Batch batch("test batch " + to_string(i), true);
+      for (int64_t j = 0; j < 12; ++j) {
+        batch.m_Jobs.push_back(getInsertJob(i * 12 + j));
+      }
+      writer.Submit(std::move(batch));
+    }
+    writer.Flush();
+    if (writer.GetHasPending() || countRows(mainDB) != 240 * 1000000 + 239 * 240 / 2) {
+      Print("[TEST] ERR - CDBWriter flushed " + to_string(countRows(mainDB)) + " (count * 10^6 + sum)");
+      success = false;
+    }
+
+    // failed writes are reported, but do not hold back the rest of their batch
+    CDBWriter::Batch failing("test failing batch", false);
+    failing.m_Jobs.push_back(getInsertJob(1000));
+    failing.m_Jobs.push_back([](CDBWriter& writer) {
+      return writer.GetDB()->Exec("INSERT INTO missing VALUES ( 1 )") == SQLITE_OK;
+    });
+    writer.Submit(std::move(failing));
+    writer.Close();
+    if (countRows(mainDB) != 241 * 1000000 + 239 * 240 / 2 + 1000) {
+      Print("[TEST] ERR - CDBWriter did not drain its queue when closed");
+      success = false;
+    }
+
+    CDBWriter inlineWriter;
+    inlineWriter.OpenInline(&mainDB);
+    CDBWriter::Batch batch("test inline batch", true);
+    batch.m_Jobs.push_back(getInsertJob(5));
+    inlineWriter.Submit(std::move(batch));
+    if (inlineWriter.GetIsAsync() || countRows(mainDB) != 242 * 1000000 + 239 * 240 / 2 + 1005) {
+      Print("[TEST] ERR - CDBWriter inline batch was not written synchronously");
+      success = false;
+    }
+  }
+
+  FileDelete(filePath);
+  FileDelete(filesystem::path(PathToString(filePath) + "-wal"));
+  FileDelete(filesystem::path(PathToString(filePath) + "-shm"));
+  return success;
+}
+
+bool TestRunner::CheckFileHashStream()
+{
+  bool success = true;
+  vector<uint8_t> data(300007);
+  uint32_t seed = 0x12345678;
+  for (auto& byte : data) {
+    seed = seed * 1103515245 + 12345;
+    byte = static_cast<uint8_t>(seed >> 16);
+  }
+  FileHashDigest expected = HashBufferParallel(data.data(), data.size());
+
+  // pieces of uneven size, as delivered by a network transfer
+  CFileHashStream hashStream;
+  size_t offset = 0, pieceSize = 1;
+  while (offset < data.size()) {
+    size_t size = min(pieceSize, data.size() - offset);
+    hashStream.Update(data.data() + offset, size);
+    offset += size;
+    pieceSize = (pieceSize * 7 + 13) % 16411;
+  }
+  FileHashDigest actual = hashStream.Final();
+  if (actual.size != expected.size || actual.crc32 != expected.crc32 || actual.sha1 != expected.sha1) {
+    Print("[TEST] ERR - CFileHashStream digest does not match HashBufferParallel");
+    success = false;
+  }
+
+  hashStream.Reset();
+  hashStream.Update(data.data(), 0);
+  FileHashDigest empty = hashStream.Final();
+  FileHashDigest expectedEmpty = HashBufferParallel(data.data(), 0);
+  if (empty.size != 0 || empty.crc32 != expectedEmpty.crc32 || empty.sha1 != expectedEmpty.sha1) {
+    Print("[TEST] ERR - CFileHashStream digest of empty input is wrong");
+    success = false;
+  }
+  return success;
+}
+
+bool TestRunner::CheckMapDownload()
+{
+  bool success = true;
+
+  optional<HTTPContentRange> range = ParseHTTPContentRange("bytes 100-199/5000");
+  if (!range.has_value() || range->m_Start != 100 || range->m_End != 199 || range->m_Total != optional<size_t>(5000)) {
+    Print("[TEST] ERR - ParseHTTPContentRange failed on a well-formed header");
+    success = false;
+  }
+  range = ParseHTTPContentRange("bytes 100-199/*");
+  if (!range.has_value() || range->m_Total.has_value()) {
+    Print("[TEST] ERR - ParseHTTPContentRange failed on an unknown total size");
+    success = false;
+  }
+  if (ParseHTTPContentRange("bytes 200-100/5000").has_value() || ParseHTTPContentRange("bytes 1x-2/3").has_value() || ParseHTTPContentRange("bytes 0-10/10").has_value()) {
+    Print("[TEST] ERR - ParseHTTPContentRange accepted a malformed header");
+    success = false;
+  }
+  if (ParseHTTPStatusLine("HTTP/1.1 206 Partial Content") != optional<uint16_t>(206) || ParseHTTPStatusLine("HTTP/2 200") != optional<uint16_t>(200) || ParseHTTPStatusLine("Content-Length: 5").has_value()) {
+    Print("[TEST] ERR - ParseHTTPStatusLine failed");
+    success = false;
+  }
+
+  vector<uint8_t> data(100003);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>((i * 31) ^ (i >> 7));
+  }
+  const FileHashDigest expected = HashBufferParallel(data.data(), data.size());
+  const string uri = "https://example.com/maps/test.w3x";
+  const filesystem::path filePath = filesystem::temp_directory_path() / filesystem::path("aura-test-download.w3x");
+  FileDelete(filePath);
+  FileDelete(CMapDownload::GetPartPath(filePath));
+  FileDelete(CMapDownload::GetSidecarPath(filePath));
+
+  auto sendHeaders = [](CMapDownload& download, const vector<string>& lines) {
+    download.BeginAttempt();
+    for (const auto& line : lines) {
+      download.OnHeader(line + "\r\n");
+    }
+    download.OnHeader("\r\n");
+  };
+  auto sendBody = [&data](CMapDownload& download, size_t start, size_t end) {
+    for (size_t offset = start; offset < end; offset += 4096) {
+      if (!download.OnData(data.data() + offset, min<size_t>(4096, end - offset))) return false;
+    }
+    return true;
+  };
+  auto checkCommit = [&](CMapDownload& download, const string& label) {
+    optional<FileHashDigest> digest = download.Commit();
+    vector<uint8_t> written;
+    if (!digest.has_value() || digest->size != expected.size || digest->crc32 != expected.crc32 || digest->sha1 != expected.sha1) {
+      Print("[TEST] ERR - CMapDownload " + label + " digest mismatch");
+      success = false;
+    } else if (!FileRead(filePath, written, MAX_MAP_SIZE_RF) || written != data) {
+      Print("[TEST] ERR - CMapDownload " + label + " file contents mismatch");
+      success = false;
+    } else if (CMapDownload::GetHasPartial(filePath)) {
+      Print("[TEST] ERR - CMapDownload " + label + " left partial files behind");
+      success = false;
+    }
+    FileDelete(filePath);
+  };
+
+  // interrupted at 40%, then resumed with a Range request
+  {
+    CMapDownload download(filePath, uri);
+    if (!download.Open() || download.GetIsResumed()) {
+      Print("[TEST] ERR - CMapDownload failed to open");
+      return false;
+    }
+    sendHeaders(download, {"HTTP/1.1 200 OK", "Content-Length: " + to_string(data.size())});
+    sendBody(download, 0, 40000);
+    download.SaveProgress();
+  }
+  if (!CMapDownload::GetCanResume(filePath, uri) || CMapDownload::GetCanResume(filePath, uri + "?other")) {
+    Print("[TEST] ERR - CMapDownload sidecar does not identify the interrupted download");
+    success = false;
+  }
+  {
+    CMapDownload download(filePath, uri);
+    if (!download.Open() || download.GetReceivedSize() != 40000 || download.GetRangeHeader() != "bytes=40000-") {
+      Print("[TEST] ERR - CMapDownload did not resume at 40000 bytes");
+      success = false;
+    }
+    sendHeaders(download, {"HTTP/1.1 302 Found", "Location: https://cdn.example.com/test.w3x"});
+    sendHeaders(download, {"HTTP/1.1 206 Partial Content", "Content-Range: bytes 40000-100002/100003"});
+    if (!sendBody(download, 40000, data.size()) || !download.GetIsComplete()) {
+      Print("[TEST] ERR - CMapDownload did not accept the remaining range");
+      success = false;
+    }
+    checkCommit(download, "resumed");
+  }
+
+  // interrupted, then the server ignores the Range header
+  {
+    CMapDownload download(filePath, uri);
+    (void)download.Open();
+    sendHeaders(download, {"HTTP/1.1 200 OK", "Content-Length: " + to_string(data.size())});
+    sendBody(download, 0, 12345);
+    download.SaveProgress();
+  }
+  {
+    CMapDownload download(filePath, uri);
+    (void)download.Open();
+    sendHeaders(download, {"HTTP/1.1 200 OK", "Content-Length: " + to_string(data.size())});
+    sendBody(download, 0, data.size());
+    checkCommit(download, "restarted");
+  }
+
+  // nothing received yet
+  {
+    CMapDownload download(filePath, uri);
+    (void)download.Open();
+    if (download.Commit().has_value()) {
+      Print("[TEST] ERR - CMapDownload committed an empty download");
+      success = false;
+    }
+    download.Discard();
+  }
+
+  // resumed, but the remote file changed size in the meantime, so it's retried in full
+  {
+    CMapDownload download(filePath, uri);
+    (void)download.Open();
+    sendHeaders(download, {"HTTP/1.1 200 OK", "Content-Length: 100010"});
+    sendBody(download, 0, 50000);
+    download.SaveProgress();
+  }
+  {
+    CMapDownload download(filePath, uri);
+    (void)download.Open();
+    sendHeaders(download, {"HTTP/1.1 206 Partial Content", "Content-Range: bytes 50000-100002/100003"});
+    sendBody(download, 50000, data.size());
+    if (download.GetReceivedSize() != 0 || download.GetRangeHeader() != "") {
+      Print("[TEST] ERR - CMapDownload spliced a range of a different file");
+      success = false;
+    }
+    if (download.EndAttempt(206, true) != MapDownloadStep::kRetry) {
+      Print("[TEST] ERR - CMapDownload gave up after restarting a changed file");
+      success = false;
+    }
+    sendHeaders(download, {"HTTP/1.1 200 OK", "Content-Length: " + to_string(data.size())});
+    sendBody(download, 0, data.size());
+    if (download.EndAttempt(200, true) != MapDownloadStep::kDone) {
+      Print("[TEST] ERR - CMapDownload did not finish the full retry");
+      success = false;
+    }
+    checkCommit(download, "retried");
+  }
+
+  // truncated transfers are retried, missing files are not
+  {
+    CMapDownload download(filePath, uri);
+    (void)download.Open();
+    sendHeaders(download, {"HTTP/1.1 200 OK", "Content-Length: " + to_string(data.size())});
+    sendBody(download, 0, 1000);
+    if (download.EndAttempt(200, false) != MapDownloadStep::kRetry || download.EndAttempt(0, false) != MapDownloadStep::kRetry) {
+      Print("[TEST] ERR - CMapDownload did not retry an interrupted transfer");
+      success = false;
+    }
+    sendHeaders(download, {"HTTP/1.1 404 Not Found"});
+    if (download.EndAttempt(404, true) != MapDownloadStep::kFail) {
+      Print("[TEST] ERR - CMapDownload retried a missing file");
+      success = false;
+    }
+    download.Discard();
+  }
+
+  // more bytes than advertised
+  {
+    CMapDownload download(filePath, uri);
+    (void)download.Open();
+    sendHeaders(download, {"HTTP/1.1 200 OK", "Content-Length: 1000"});
+    if (sendBody(download, 0, 5000) || !download.GetHasWriteError()) {
+      Print("[TEST] ERR - CMapDownload accepted more bytes than advertised");
+      success = false;
+    }
+    download.Discard();
+  }
+
+  return success;
+}
+
+bool TestRunner::CheckMapUploadScheduler()
+{
+  bool success = true;
+  const uint32_t mapSize = 64 * 1024 * 1024;
+
+  // nothing acknowledged yet - only the initial window goes out
+  {
+    CMapUploadScheduler scheduler;
+    MapTransfer transfer;
+    scheduler.Add(&transfer, MAP_UPLOAD_WEIGHT_PLAYER, mapSize, 0, 100);
+    scheduler.Schedule(1000, 0);
+    if (scheduler.GetGrant(0) != MAP_UPLOAD_INITIAL_WINDOW) {
+      Print("[TEST] ERR - CMapUploadScheduler granted " + to_string(scheduler.GetGrant(0)) + " bytes before any acknowledgement");
+      success = false;
+    }
+  }
+
+  // a tight budget is shared by weight, and no downloader starves
+  {
+    CMapUploadScheduler scheduler;
+    array<MapTransfer, 3> transfers;
+    const array<uint8_t, 3> weights = {MAP_UPLOAD_WEIGHT_PLAYER, MAP_UPLOAD_WEIGHT_PLAYER, MAP_UPLOAD_WEIGHT_OBSERVER};
+    array<uint64_t, 3> totals = {0, 0, 0};
+    for (auto& transfer : transfers) {
+      transfer.ackRate = 10 * 1024 * 1024;
+    }
+    for (int64_t cycle = 1; cycle <= 200; ++cycle) {
+      scheduler.Clear();
+      for (size_t i = 0; i < transfers.size(); ++i) {
+        scheduler.Add(&transfers[i], weights[i], mapSize, 0, 50);
+      }
+      scheduler.Schedule(cycle * 100, MAP_UPLOAD_QUANTUM * 3);
+      for (size_t i = 0; i < transfers.size(); ++i) {
+        // everything is acknowledged right away, so that pacing never kicks in
+        totals[i] += scheduler.GetGrant(i);
+        transfers[i].lastSentOffsetEnd += scheduler.GetGrant(i);
+        transfers[i].lastAck = transfers[i].lastSentOffsetEnd;
+        transfers[i].ackRate = 10 * 1024 * 1024;
+        transfers[i].ackRateSampleTicks = 0;
+      }
+    }
+    const uint64_t grandTotal = totals[0] + totals[1] + totals[2];
+    if (grandTotal != 200 * MAP_UPLOAD_QUANTUM * 3) {
+      Print("[TEST] ERR - CMapUploadScheduler did not use up its budget (" + to_string(grandTotal) + " bytes)");
+      success = false;
+    }
+    // 4:4:1 shares, allowing one quantum of slack per downloader
+    if (totals[2] == 0 || totals[0] + MAP_UPLOAD_QUANTUM * 4 < totals[2] * 4 || totals[2] * 4 + MAP_UPLOAD_QUANTUM * 4 < totals[0] || totals[0] > totals[1] + MAP_UPLOAD_QUANTUM * 4 || totals[1] > totals[0] + MAP_UPLOAD_QUANTUM * 4) {
+      Print("[TEST] ERR - CMapUploadScheduler shares are " + to_string(totals[0]) + " / " + to_string(totals[1]) + " / " + to_string(totals[2]));
+      success = false;
+    }
+  }
+
+  // a send queue that takes longer than the target delay to drain gets no more map parts
+  {
+    CMapUploadScheduler scheduler;
+    MapTransfer slow, fast;
+    slow.ackRate = 64 * 1024;
+    fast.ackRate = 64 * 1024;
+    const size_t queueLimit = 64 * 1024 * MAP_UPLOAD_TARGET_QUEUE_DELAY / 1000;
+    scheduler.Add(&slow, MAP_UPLOAD_WEIGHT_PLAYER, mapSize, queueLimit, 300);
+    scheduler.Add(&fast, MAP_UPLOAD_WEIGHT_PLAYER, mapSize, 0, 300);
+    scheduler.Schedule(1000, 0);
+    if (scheduler.GetGrant(0) != 0 || scheduler.GetGrant(1) != queueLimit) {
+      Print("[TEST] ERR - CMapUploadScheduler pacing granted " + to_string(scheduler.GetGrant(0)) + " / " + to_string(scheduler.GetGrant(1)) + " bytes");
+      success = false;
+    }
+
+    // in-flight bytes are bounded by what the acknowledged rate covers within a round trip, plus the queue delay
+    scheduler.Clear();
+    slow.lastSentOffsetEnd = static_cast<uint32_t>(64 * 1024 * (300 + MAP_UPLOAD_TARGET_QUEUE_DELAY) * MAP_UPLOAD_WINDOW_GAIN_PERCENT / 100000);
+    scheduler.Add(&slow, MAP_UPLOAD_WEIGHT_PLAYER, mapSize, 0, 300);
+    scheduler.Schedule(1000, 0);
+    if (scheduler.GetGrant(0) != 0) {
+      Print("[TEST] ERR - CMapUploadScheduler exceeded the congestion window");
+      success = false;
+    }
+  }
+
+  return success;
+}
+
 uint16_t TestRunner::Run()
 {
   if (!CheckStatStrings()) return 1;
+  if (!CheckStreamBuffer()) return 1;
+  if (!CheckActionFrameEncoder()) return 1;
+  if (!CheckGeoIndex()) return 1;
+  if (!CheckDNSResolver()) return 1;
+  if (!CheckLogWriter()) return 1;
+  if (!CheckMapCatalog()) return 1;
+  if (!CheckFileSearchIndex()) return 1;
+  if (!CheckEditDistance()) return 1;
+  if (!CheckTimerQueue()) return 1;
+  if (!CheckReplayWriter()) return 1;
+  if (!CheckGameFrameLog()) return 1;
+  if (!CheckBanIndex()) return 1;
+  if (!CheckDBWriter()) return 1;
+  if (!CheckFileHashStream()) return 1;
+  if (!CheckMapDownload()) return 1;
+  if (!CheckMapUploadScheduler()) return 1;
   return 0;
 }
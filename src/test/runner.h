@@ -34,6 +34,22 @@
 namespace TestRunner
 {
   [[nodiscard]] bool CheckStatStrings();
+  [[nodiscard]] bool CheckStreamBuffer();
+  [[nodiscard]] bool CheckActionFrameEncoder();
+  [[nodiscard]] bool CheckGeoIndex();
+  [[nodiscard]] bool CheckDNSResolver();
+  [[nodiscard]] bool CheckLogWriter();
+  [[nodiscard]] bool CheckMapCatalog();
+  [[nodiscard]] bool CheckFileSearchIndex();
+  [[nodiscard]] bool CheckEditDistance();
+  [[nodiscard]] bool CheckTimerQueue();
+  [[nodiscard]] bool CheckReplayWriter();
+  [[nodiscard]] bool CheckGameFrameLog();
+  [[nodiscard]] bool CheckBanIndex();
+  [[nodiscard]] bool CheckDBWriter();
+  [[nodiscard]] bool CheckFileHashStream();
+  [[nodiscard]] bool CheckMapDownload();
+  [[nodiscard]] bool CheckMapUploadScheduler();
   [[nodiscard]] uint16_t Run();
 };
 
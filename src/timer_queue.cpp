@@ -0,0 +1,152 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#include "timer_queue.h"
+
+using namespace std;
+
+namespace
+{
+  // std heap functions build max-heaps
+  [[nodiscard]] inline bool GetIsLaterEntry(const CTimerQueue::HeapEntry& a, const CTimerQueue::HeapEntry& b)
+  {
+    if (a.dueTicks != b.dueTicks) return a.dueTicks > b.dueTicks;
+    return a.id > b.id;
+  }
+}
+
+CTimerQueue::CTimerQueue()
+  : m_NextId(1)
+{
+}
+
+CTimerQueue::~CTimerQueue() = default;
+
+optional<int64_t> CTimerQueue::GetNextDueTicks() const
+{
+  optional<int64_t> result;
+  if (!m_Heap.empty()) {
+    // stale entries never stay on top
+    result = m_Heap.front().dueTicks;
+  }
+  return result;
+}
+
+TimerId CTimerQueue::Schedule(const int64_t dueTicks, function<void()> callback)
+{
+  const TimerId id = m_NextId++;
+  m_Timers[id] = Timer{dueTicks, move(callback)};
+  Push(dueTicks, id);
+  return id;
+}
+
+bool CTimerQueue::Reschedule(const TimerId id, const int64_t dueTicks)
+{
+  auto match = m_Timers.find(id);
+  if (match == m_Timers.end()) {
+    return false;
+  }
+  if (match->second.dueTicks != dueTicks) {
+    match->second.dueTicks = dueTicks;
+    Push(dueTicks, id);
+    PruneStale();
+  }
+  return true;
+}
+
+void CTimerQueue::Cancel(TimerId& id)
+{
+  if (id == 0) return;
+  m_Timers.erase(id);
+  id = 0;
+  PruneStale();
+}
+
+size_t CTimerQueue::RunExpired(const int64_t ticks)
+{
+  size_t count = 0;
+  while (!m_Heap.empty() && m_Heap.front().dueTicks <= ticks) {
+    const HeapEntry entry = m_Heap.front();
+    pop_heap(m_Heap.begin(), m_Heap.end(), GetIsLaterEntry);
+    m_Heap.pop_back();
+
+    auto match = m_Timers.find(entry.id);
+    if (match == m_Timers.end() || match->second.dueTicks != entry.dueTicks) {
+      continue;
+    }
+    function<void()> callback = move(match->second.callback);
+    m_Timers.erase(match);
+    ++count;
+    if (callback) {
+      callback();
+    }
+  }
+  PruneStale();
+  return count;
+}
+
+void CTimerQueue::UpdateSelectBlockTime(int64_t& usecBlockTime, const int64_t ticks) const
+{
+  optional<int64_t> dueTicks = GetNextDueTicks();
+  if (!dueTicks.has_value() || usecBlockTime == 0) {
+    return;
+  }
+  if (*dueTicks <= ticks) {
+    usecBlockTime = 0;
+    return;
+  }
+  const int64_t maybeBlockTime = (*dueTicks - ticks) * 1000;
+  if (maybeBlockTime < usecBlockTime) {
+    usecBlockTime = maybeBlockTime;
+  }
+}
+
+void CTimerQueue::Push(const int64_t dueTicks, const TimerId id)
+{
+  m_Heap.push_back(HeapEntry{dueTicks, id});
+  push_heap(m_Heap.begin(), m_Heap.end(), GetIsLaterEntry);
+
+  // too many stale entries, rebuild the heap from scratch
+  if (m_Heap.size() > 2 * m_Timers.size() + 64) {
+    m_Heap.clear();
+    for (const auto& timer : m_Timers) {
+      m_Heap.push_back(HeapEntry{timer.second.dueTicks, timer.first});
+    }
+    make_heap(m_Heap.begin(), m_Heap.end(), GetIsLaterEntry);
+  }
+}
+
+void CTimerQueue::PruneStale()
+{
+  while (!m_Heap.empty()) {
+    const HeapEntry& top = m_Heap.front();
+    auto match = m_Timers.find(top.id);
+    if (match != m_Timers.end() && match->second.dueTicks == top.dueTicks) {
+      return;
+    }
+    pop_heap(m_Heap.begin(), m_Heap.end(), GetIsLaterEntry);
+    m_Heap.pop_back();
+  }
+}
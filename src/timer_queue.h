@@ -0,0 +1,85 @@
+/*
+
+  Copyright [2025] [Leonardo Julca]
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be
+  included in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ */
+
+#ifndef AURA_TIMER_QUEUE_H_
+#define AURA_TIMER_QUEUE_H_
+
+#include "includes.h"
+
+#include <unordered_map>
+
+//
+// CTimerQueue
+//
+// Deadlines measured in GetTicks(), kept in a min-heap, so that the main loop knows
+// how long it may block in O(1), and only visits the timers that actually expired.
+//
+// Timers are one-shot. Callbacks may schedule, reschedule or cancel any timer, including their own.
+// A timer without a callback still wakes up the main loop when it's due.
+//
+// Cancelled and rescheduled timers leave stale heap entries behind, which are skipped lazily.
+//
+
+typedef uint64_t TimerId;  // 0 is never a valid id
+
+class CTimerQueue
+{
+public:
+  struct HeapEntry
+  {
+    int64_t                                     dueTicks;
+    TimerId                                     id;
+  };
+
+  struct Timer
+  {
+    int64_t                                     dueTicks;
+    std::function<void()>                       callback;
+  };
+
+  std::vector<HeapEntry>                        m_Heap;
+  std::unordered_map<TimerId, Timer>            m_Timers;
+  TimerId                                       m_NextId;
+
+  CTimerQueue();
+  ~CTimerQueue();
+  CTimerQueue(CTimerQueue&) = delete;
+
+  [[nodiscard]] inline size_t                   GetSize() const { return m_Timers.size(); }
+  [[nodiscard]] inline bool                     GetIsScheduled(const TimerId id) const { return m_Timers.find(id) != m_Timers.end(); }
+  [[nodiscard]] std::optional<int64_t>          GetNextDueTicks() const;
+
+  [[nodiscard]] TimerId                         Schedule(const int64_t dueTicks, std::function<void()> callback);
+  bool                                          Reschedule(const TimerId id, const int64_t dueTicks);
+  void                                          Cancel(TimerId& id);
+  size_t                                        RunExpired(const int64_t ticks);
+  void                                          UpdateSelectBlockTime(int64_t& usecBlockTime, const int64_t ticks) const;
+
+private:
+  void                                          Push(const int64_t dueTicks, const TimerId id);
+  void                                          PruneStale();
+};
+
+#endif // AURA_TIMER_QUEUE_H_
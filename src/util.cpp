@@ -44,6 +44,7 @@
  */
 
 #include "util.h"
+#include "edit_distance.h"
 
 #include <random>
 #include <regex>
@@ -193,6 +194,28 @@ string ToFormattedTimeStamp(const int64_t seconds)
   return ToFormattedTimeStamp(hh, mm, ss);
 }
 
+optional<int64_t> ParseTimeStamp(const string& input)
+{
+  // ss, mm:ss, or hh:mm:ss
+  optional<int64_t> result;
+  int64_t seconds = 0;
+  size_t start = 0;
+  for (uint8_t i = 0; i < 3; ++i) {
+    size_t end = input.find(':', start);
+    const string part = input.substr(start, end == string::npos ? string::npos : end - start);
+    if (part.empty() || part.size() > 6 || part.find_first_not_of("0123456789") != string::npos) return result;
+    const int64_t value = stoll(part);
+    if (0 < i && 60 <= value) return result;
+    seconds = seconds * 60 + value;
+    if (end == string::npos) {
+      result = seconds;
+      return result;
+    }
+    start = end + 1;
+  }
+  return result;
+}
+
 string ToDurationString(const int64_t seconds)
 {
   int64_t ss, mm, hh;
@@ -1260,62 +1283,17 @@ vector<string> SplitTokens(string_view s, const char delim)
 
 string::size_type GetLevenshteinDistance(const string& s1, const string& s2)
 {
-  string::size_type m = s1.length();
-  string::size_type n = s2.length();
-
-  // Create a 2D vector to store the distances
-  vector<vector<string::size_type>> dp(m + 1, vector<string::size_type>(n + 1, 0));
-
-  for (string::size_type i = 0; i <= m; ++i) {
-    for (string::size_type j = 0; j <= n; ++j) {
-      if (i == 0) {
-          dp[i][j] = j;
-      } else if (j == 0) {
-          dp[i][j] = i;
-      } else if (s1[i - 1] == s2[j - 1]) {
-          dp[i][j] = dp[i - 1][j - 1];
-      } else {
-        string::size_type cost = (s1[i - 1] == s2[j - 1]) ? 0 : (isdigit(s1[i - 1]) || isdigit(s2[j - 1])) ? 3 : 1;
-        dp[i][j] = min({ dp[i - 1][j] + 1, dp[i][j - 1] + 1, dp[i - 1][j - 1] + cost });
-      }
-    }
-  }
-
-  return dp[m][n];
+  return GetLevenshteinDistanceForSearch(s1, s2, s1.length() + s2.length());
 }
 
 string::size_type GetLevenshteinDistanceForSearch(const string& s1, const string& s2, const string::size_type bestDistance)
 {
-  string::size_type m = s1.length();
-  string::size_type n = s2.length();
-
-  if (m > n + bestDistance) {
-    return m - n;
-  }
-
-  if (n > m + bestDistance) {
-    return n - m;
-  }
-
-  // Create a 2D vector to store the distances
-  vector<vector<string::size_type>> dp(m + 1, vector<string::size_type>(n + 1, 0));
-
-  for (string::size_type i = 0; i <= m; ++i) {
-    for (string::size_type j = 0; j <= n; ++j) {
-      if (i == 0) {
-          dp[i][j] = j;
-      } else if (j == 0) {
-          dp[i][j] = i;
-      } else if (s1[i - 1] == s2[j - 1]) {
-          dp[i][j] = dp[i - 1][j - 1];
-      } else {
-        string::size_type cost = (s1[i - 1] == s2[j - 1]) ? 0 : (isdigit(s1[i - 1]) || isdigit(s2[j - 1])) ? 3 : 1;
-        dp[i][j] = min({ dp[i - 1][j] + 1, dp[i][j - 1] + 1, dp[i - 1][j - 1] + cost });
-      }
-    }
+  // Distances are symmetric, so the shorter string gets encoded as the pattern.
+  if (s1.length() <= s2.length()) {
+    return CEditDistancePattern(s1).GetDistance(s2, bestDistance);
+  } else {
+    return CEditDistancePattern(s2).GetDistance(s1, bestDistance);
   }
-
-  return dp[m][n];
 }
 
 string CheckIsValidHCLStandard(const string& s)
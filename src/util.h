@@ -97,6 +97,7 @@ void EllideEmptyElementsInPlace(std::vector<std::string>& list);
 [[nodiscard]] std::string ToDurationString(const int64_t hh, const int64_t mm, const int64_t ss);
 [[nodiscard]] std::string ToFormattedTimeStamp(const int64_t seconds);
 [[nodiscard]] std::string ToDurationString(const int64_t seconds);
+[[nodiscard]] std::optional<int64_t> ParseTimeStamp(const std::string& input);
 [[nodiscard]] std::string ToVersionString(const Version& version);
 [[nodiscard]] uint32_t ToVersionFlattened(const Version& version); // MDNS protocol
 [[nodiscard]] uint8_t ToVersionOrdinal(const Version& version); // Aura internal